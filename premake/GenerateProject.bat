@@ -12,7 +12,7 @@ if errorlevel 1 goto :error
 if /I "%TOOLSET%"=="v145" goto :success
 
 powershell -NoProfile -ExecutionPolicy Bypass -Command ^
-    "$path = '%~dp0..\project\TakeCEngine.vcxproj'; $content = [IO.File]::ReadAllText($path); $content = $content.Replace('<PlatformToolset>v145</PlatformToolset>', '<PlatformToolset>%TOOLSET%</PlatformToolset>'); [IO.File]::WriteAllText($path, $content, [Text.UTF8Encoding]::new($false))"
+    "Get-ChildItem '%~dp0..\project\*.vcxproj' | ForEach-Object { $path = $_.FullName; $content = [IO.File]::ReadAllText($path); $content = $content.Replace('<PlatformToolset>v145</PlatformToolset>', '<PlatformToolset>%TOOLSET%</PlatformToolset>'); [IO.File]::WriteAllText($path, $content, [Text.UTF8Encoding]::new($false)) }"
 if errorlevel 1 goto :error
 
 :success
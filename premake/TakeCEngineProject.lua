@@ -137,3 +137,45 @@ function ConfigureTakeCEngineConsumer(options)
 
     return paths
 end
+
+-- エンジンの静的ライブラリをリンクするコンソールアプリ(テスト・ベンチマーク用)
+local function DefineTakeCEngineConsoleProject(options, defaultName, sourceDirName, vpathName)
+    options = options or {}
+    local paths = ResolvePaths(options.repositoryRoot)
+    local sourceRoot = path.join(paths.projectRoot, sourceDirName)
+
+    project (options.projectName or defaultName)
+        location (options.projectLocation or paths.projectRoot)
+        kind "ConsoleApp"
+        targetdir (options.targetDir or path.join(paths.projectRoot, "bin/%{cfg.buildcfg}"))
+        objdir (options.objectDir or path.join(paths.projectRoot, "obj/%{prj.name}/%{cfg.buildcfg}"))
+        debugdir (paths.projectRoot)
+
+        files {
+            path.join(sourceRoot, "**.h"),
+            path.join(sourceRoot, "**.cpp")
+        }
+
+        vpaths {
+            [vpathName .. "/*"] = { path.join(sourceRoot, "**") }
+        }
+
+        ConfigureTakeCEngineConsumer {
+            repositoryRoot = paths.repositoryRoot,
+            projectName = options.engineProjectName
+        }
+
+        includedirs { sourceRoot }
+
+    return paths
+end
+
+-- GPUを使わないエンジンのコードを検証するヘッドレスのテスト
+function DefineTakeCEngineTestProject(options)
+    return DefineTakeCEngineConsoleProject(options, "TakeCEngineTests", "tests", "Tests")
+end
+
+-- エンジンのCPU処理の速度を計測するベンチマーク(Release構成で実行する)
+function DefineTakeCEngineBenchmarkProject(options)
+    return DefineTakeCEngineConsoleProject(options, "TakeCEngineBenchmarks", "benchmarks", "Benchmarks")
+end
@@ -40,3 +40,17 @@ DefineTakeCEngineProject {
     targetDir = "../project/bin/%{cfg.buildcfg}",
     objectDir = "../project/obj/%{prj.name}/%{cfg.buildcfg}"
 }
+
+DefineTakeCEngineTestProject {
+    repositoryRoot = "..",
+    projectLocation = "../project",
+    targetDir = "../project/bin/%{cfg.buildcfg}",
+    objectDir = "../project/obj/%{prj.name}/%{cfg.buildcfg}"
+}
+
+DefineTakeCEngineBenchmarkProject {
+    repositoryRoot = "..",
+    projectLocation = "../project",
+    targetDir = "../project/bin/%{cfg.buildcfg}",
+    objectDir = "../project/obj/%{prj.name}/%{cfg.buildcfg}"
+}
@@ -0,0 +1,158 @@
+#include "Benchmark.h"
+#include "engine/Animation/Animator.h"
+#include "engine/math/Easing.h"
+#include "engine/math/FastRandom.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// キーフレームのサンプリングのベンチマーク
+//============================================================================
+// AnimationManager::CalculateValue は以前、キーフレームを先頭から線形に探索していた。
+// 現在は二分探索で補間区間を求め、KeyframeCursor を渡すと前回の区間から探索を再開する。
+// 30fpsで焼いた10k個のキーフレームを持つカーブを、60fpsの再生と同じ順にサンプリングする場合と
+// 時刻を飛ばしてサンプリングする場合(カーソルが外れて二分探索になる)で、3通りの時間を比べる。
+// 以前の線形探索はこのファイルに同じ内容を残して比較に使う。
+
+namespace {
+
+	//キーフレームの数と、焼き込みのフレームレート
+	constexpr uint32_t kKeyframeCount = 10000;
+	constexpr float kBakeFrameRate = 30.0f;
+	//再生のフレームレート
+	constexpr float kPlaybackFrameRate = 60.0f;
+	//計測の繰り返し回数(線形探索は1回が長いため少なくする)
+	constexpr uint32_t kRepeatCount = 5;
+
+	//以前の AnimationManager::CalculateValue と同じ線形探索
+	Vector3 CalculateValuePrevious(const std::vector<KeyframeVector3>& keyframes, float time) {
+		if (keyframes.size() == 1 || time <= keyframes[0].time) {
+			return keyframes[0].value;
+		}
+
+		for (size_t index = 0; index < keyframes.size() - 1; ++index) {
+			size_t nextIndex = index + 1;
+			if (time >= keyframes[index].time && time <= keyframes[nextIndex].time) {
+				//範囲内を補間する
+				float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+				return Easing::Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
+			}
+		}
+
+		//最後のキーフレームを返す
+		return (*keyframes.rbegin()).value;
+	}
+
+	Quaternion CalculateValuePrevious(const std::vector<KeyframeQuaternion>& keyframes, float time) {
+		if (keyframes.size() == 1 || time <= keyframes[0].time) {
+			return keyframes[0].value;
+		}
+
+		for (size_t index = 0; index < keyframes.size() - 1; ++index) {
+			size_t nextIndex = index + 1;
+			if (time >= keyframes[index].time && time <= keyframes[nextIndex].time) {
+				//範囲内を補間する
+				float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+				return Easing::Slerp(keyframes[index].value, keyframes[nextIndex].value, t);
+			}
+		}
+
+		//最後のキーフレームを返す
+		return (*keyframes.rbegin()).value;
+	}
+
+	//30fpsで焼いた移動と回転のカーブ
+	void MakeCurves(std::vector<KeyframeVector3>& translate, std::vector<KeyframeQuaternion>& rotate) {
+		translate.resize(kKeyframeCount);
+		rotate.resize(kKeyframeCount);
+		for (uint32_t i = 0; i < kKeyframeCount; ++i) {
+			const float time = static_cast<float>(i) / kBakeFrameRate;
+			translate[i] = { time, { std::sin(time), 0.5f * time, std::cos(time * 0.5f) } };
+			const float halfAngle = 0.5f * std::sin(time * 2.0f);
+			rotate[i] = { time, { 0.0f, std::sin(halfAngle), 0.0f, std::cos(halfAngle) } };
+		}
+	}
+
+	template<typename T>
+	bool IsBitwiseEqual(const T& a, const T& b) {
+		return std::memcmp(&a, &b, sizeof(T)) == 0;
+	}
+
+	/// <summary>
+	/// サンプリングの時刻の並びを1つ計測する
+	/// </summary>
+	void MeasureSampling(const char* label, const std::vector<KeyframeVector3>& translate,
+		const std::vector<KeyframeQuaternion>& rotate, const std::vector<float>& times) {
+
+		//3通りの結果がビット単位で一致する
+		uint32_t mismatchCount = 0;
+		KeyframeCursor translateCursor;
+		KeyframeCursor rotateCursor;
+		for (float time : times) {
+			const Vector3 expectedTranslate = CalculateValuePrevious(translate, time);
+			const Quaternion expectedRotate = CalculateValuePrevious(rotate, time);
+			mismatchCount += IsBitwiseEqual(AnimationManager::CalculateValue(translate, time), expectedTranslate) ? 0 : 1;
+			mismatchCount += IsBitwiseEqual(AnimationManager::CalculateValue(rotate, time), expectedRotate) ? 0 : 1;
+			mismatchCount += IsBitwiseEqual(AnimationManager::CalculateValue(translate, time, translateCursor), expectedTranslate) ? 0 : 1;
+			mismatchCount += IsBitwiseEqual(AnimationManager::CalculateValue(rotate, time, rotateCursor), expectedRotate) ? 0 : 1;
+		}
+		TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+		const Benchmark::Result linear = Benchmark::Measure(kRepeatCount, [&]() {
+			for (float time : times) {
+				Benchmark::DoNotOptimize(CalculateValuePrevious(translate, time));
+				Benchmark::DoNotOptimize(CalculateValuePrevious(rotate, time));
+			}
+		});
+		const Benchmark::Result binary = Benchmark::Measure(kRepeatCount, [&]() {
+			for (float time : times) {
+				Benchmark::DoNotOptimize(AnimationManager::CalculateValue(translate, time));
+				Benchmark::DoNotOptimize(AnimationManager::CalculateValue(rotate, time));
+			}
+		});
+		const Benchmark::Result cursor = Benchmark::Measure(kRepeatCount, [&]() {
+			KeyframeCursor measureTranslateCursor;
+			KeyframeCursor measureRotateCursor;
+			for (float time : times) {
+				Benchmark::DoNotOptimize(AnimationManager::CalculateValue(translate, time, measureTranslateCursor));
+				Benchmark::DoNotOptimize(AnimationManager::CalculateValue(rotate, time, measureRotateCursor));
+			}
+		});
+
+		std::printf("  %s: %u keyframes, %zu samples x 2 channels\n", label, kKeyframeCount, times.size());
+		Benchmark::Report("linear scan (previous)", linear);
+		Benchmark::Report("CalculateValue (binary search)", binary, &linear);
+		Benchmark::Report("CalculateValue (KeyframeCursor)", cursor, &linear);
+	}
+}
+
+//============================================================================
+// 10k個のキーフレーム: 線形探索・二分探索・カーソル
+//============================================================================
+TAKEC_BENCHMARK(KeyframeSampling_10kKeyframes) {
+	std::vector<KeyframeVector3> translate;
+	std::vector<KeyframeQuaternion> rotate;
+	MakeCurves(translate, rotate);
+	const float duration = translate.back().time;
+
+	//60fpsの再生(最後のキーフレームより少し後ろまで)
+	std::vector<float> playbackTimes;
+	for (uint32_t frame = 0; static_cast<float>(frame) / kPlaybackFrameRate <= duration + 0.1f; ++frame) {
+		playbackTimes.push_back(static_cast<float>(frame) / kPlaybackFrameRate);
+	}
+	MeasureSampling("playback", translate, rotate, playbackTimes);
+
+	//時刻を飛ばしたサンプリング(キーフレームちょうどの時刻を含む)
+	FastRandom random(7);
+	std::vector<float> randomTimes(playbackTimes.size());
+	for (float& time : randomTimes) {
+		time = (random.NextUInt() % 4 == 0) ? translate[random.NextUInt() % kKeyframeCount].time : random.NextFloat(-0.1f, duration + 0.1f);
+	}
+	MeasureSampling("random seek", translate, rotate, randomTimes);
+}
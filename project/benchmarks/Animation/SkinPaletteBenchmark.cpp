@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// スキニングのパレット計算のベンチマーク
+//============================================================================
+// SkinCluster::ComputePalette は各ジョイントの行列(逆バインドポーズとスケルトン空間行列の積)から
+// 法線用の逆転置行列を求める。以前は一般の Transpose(Inverse) を使っていたが、現在はアフィン専用の
+// InverseTransposeAffine を使う。256ジョイントのパレットで、一般の逆行列・アフィン専用・
+// 回転と一様スケール専用(InverseTransposeAffineUniformScale)の時間を比べる。
+// SkinCluster の生成にはデバイスが必要なため、ComputePalette と同じ手順をこのファイルで行う。
+
+namespace {
+
+	//パレットのジョイント数と、計測の繰り返し回数
+	constexpr uint32_t kJointCount = 256;
+	constexpr uint32_t kRepeatCount = 2000;
+	//一般の逆行列との許容誤差(要素の大きさに対する相対誤差)
+	constexpr float kTolerance = 1e-5f;
+
+	/// <summary>
+	/// パレットの1要素(WellForGPU と同じ内容)
+	/// </summary>
+	struct PaletteEntry {
+		Matrix4x4 skeletonSpaceMatrix;
+		Matrix4x4 skeletonSpaceInvTransposeMatrix;
+	};
+
+	/// <summary>
+	/// パレットの計算に使うジョイントの行列
+	/// </summary>
+	struct JointMatrices {
+		std::vector<Matrix4x4> inverseBindPose;
+		std::vector<Matrix4x4> skeletonSpace;
+	};
+
+	//ジョイントの行列を作る(uniformScale の場合は各ジョイントを一様スケールにする)
+	JointMatrices MakeJointMatrices(FastRandom& random, bool uniformScale) {
+		auto makeAffine = [&random, uniformScale]() {
+			Vector3 scale = { random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f) };
+			if (uniformScale) {
+				scale = { scale.x, scale.x, scale.x };
+			}
+			const Vector3 rotate = { random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) };
+			const Vector3 translate = { random.NextFloat(-2.0f, 2.0f), random.NextFloat(-2.0f, 2.0f), random.NextFloat(-2.0f, 2.0f) };
+			return MatrixMath::MakeAffineMatrix(scale, rotate, translate);
+		};
+
+		JointMatrices joints;
+		joints.inverseBindPose.resize(kJointCount);
+		joints.skeletonSpace.resize(kJointCount);
+		for (uint32_t i = 0; i < kJointCount; ++i) {
+			joints.inverseBindPose[i] = makeAffine();
+			joints.skeletonSpace[i] = makeAffine();
+		}
+		return joints;
+	}
+
+	//SkinCluster::ComputePalette と同じ手順で、逆転置行列の求め方だけを差し替える
+	template<typename InverseTransposeFunc>
+	void ComputePalette(const JointMatrices& joints, std::vector<PaletteEntry>& palette, InverseTransposeFunc inverseTranspose) {
+		for (uint32_t jointIndex = 0; jointIndex < kJointCount; ++jointIndex) {
+			palette[jointIndex].skeletonSpaceMatrix = joints.inverseBindPose[jointIndex] * joints.skeletonSpace[jointIndex];
+			palette[jointIndex].skeletonSpaceInvTransposeMatrix = inverseTranspose(palette[jointIndex].skeletonSpaceMatrix);
+		}
+	}
+
+	Matrix4x4 InverseTransposeGeneral(const Matrix4x4& m) {
+		return MatrixMath::Transpose(MatrixMath::Inverse(m));
+	}
+
+	Matrix4x4 InverseTransposeAffine(const Matrix4x4& m) {
+		return MatrixMath::InverseTransposeAffine(m);
+	}
+
+	Matrix4x4 InverseTransposeUniformScale(const Matrix4x4& m) {
+		return MatrixMath::InverseTransposeAffineUniformScale(m);
+	}
+
+	//2つのパレットの逆転置行列が許容誤差内で一致しない数
+	uint32_t CountMismatches(const std::vector<PaletteEntry>& a, const std::vector<PaletteEntry>& b) {
+		uint32_t mismatchCount = 0;
+		for (uint32_t jointIndex = 0; jointIndex < kJointCount; ++jointIndex) {
+			const Matrix4x4& expected = b[jointIndex].skeletonSpaceInvTransposeMatrix;
+			const Matrix4x4& actual = a[jointIndex].skeletonSpaceInvTransposeMatrix;
+			float maxElement = 0.0f;
+			float maxError = 0.0f;
+			for (int row = 0; row < 4; row++) {
+				for (int col = 0; col < 4; col++) {
+					maxElement = (std::max)(maxElement, std::abs(expected.m[row][col]));
+					maxError = (std::max)(maxError, std::abs(actual.m[row][col] - expected.m[row][col]));
+				}
+			}
+			mismatchCount += (maxError <= kTolerance * maxElement) ? 0 : 1;
+		}
+		return mismatchCount;
+	}
+}
+
+//============================================================================
+// 256ジョイントのパレット: 一般の逆行列とアフィン専用の逆転置行列
+//============================================================================
+TAKEC_BENCHMARK(SkinPalette_InverseTranspose256Joints) {
+	for (bool uniformScale : { false, true }) {
+		FastRandom random(uniformScale ? 7 : 6);
+		const JointMatrices joints = MakeJointMatrices(random, uniformScale);
+
+		//一般の逆行列で求めたパレットと一致する(一様スケール専用は一様スケールのジョイントだけで比べる)
+		std::vector<PaletteEntry> expected(kJointCount);
+		std::vector<PaletteEntry> palette(kJointCount);
+		ComputePalette(joints, expected, &InverseTransposeGeneral);
+		ComputePalette(joints, palette, &InverseTransposeAffine);
+		TAKEC_BENCHMARK_CHECK(CountMismatches(palette, expected) == 0);
+		if (uniformScale) {
+			ComputePalette(joints, palette, &InverseTransposeUniformScale);
+			TAKEC_BENCHMARK_CHECK(CountMismatches(palette, expected) == 0);
+		}
+
+		auto measure = [&](auto inverseTranspose) {
+			return Benchmark::Measure(kRepeatCount, [&]() {
+				ComputePalette(joints, palette, inverseTranspose);
+				Benchmark::DoNotOptimize(palette[kJointCount - 1]);
+			});
+		};
+		const Benchmark::Result general = measure(&InverseTransposeGeneral);
+		const Benchmark::Result affine = measure(&InverseTransposeAffine);
+
+		std::printf("  %u joints, %s scale\n", kJointCount, uniformScale ? "uniform" : "non-uniform");
+		Benchmark::Report("Transpose(Inverse)", general);
+		Benchmark::Report("InverseTransposeAffine", affine, &general);
+		if (uniformScale) {
+			const Benchmark::Result uniform = measure(&InverseTransposeUniformScale);
+			Benchmark::Report("InverseTransposeAffineUniformScale", uniform, &general);
+		}
+	}
+}
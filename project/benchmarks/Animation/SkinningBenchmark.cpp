@@ -0,0 +1,247 @@
+#include "Benchmark.h"
+#include "engine/3d/Model.h"
+#include "engine/Animation/AnimatorController.h"
+#include "engine/Animation/SkinningScheduler.h"
+#include "engine/Utility/JobSystem.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// 多数のキャラクターのスキニングのベンチマーク
+//============================================================================
+// SkinningScheduler::Flush は、登録された AnimatorController の再生時間を進めて同じ姿勢になる更新をまとめ(姿勢の共有)、
+// 代表の評価と、代表の結果をコピーする更新をそれぞれ JobSystem::ParallelFor で処理する。
+// 500体を Enqueue して Flush する1フレームを、登録時にその場で処理する場合(SetEnabled(false))と、
+// Flush で姿勢の共有なし・ありの場合で比べる。キャラクターは4種類のクリップのどれかを再生し、
+// 再生位置がばらばらの場合(共有はほぼ起きない)と、8つのグループで同時に出現した場合を計測する。
+// Model はデバイスを使わない InitializeSkinningOnly で作り、パレットはCPU側の配列に書き込む。
+
+namespace {
+
+	//キャラクター数と、計測の繰り返し回数(1回が1フレーム)
+	constexpr uint32_t kCharacterCount = 500;
+	constexpr uint32_t kRepeatCount = 60;
+	//一致を確認するフレーム数
+	constexpr uint32_t kCheckFrameCount = 30;
+	//フレームの時間
+	constexpr float kDeltaTime = 1.0f / 60.0f;
+	//骨格の深さ(根元から3段は3つに分岐し、その先は1本の鎖になる)
+	constexpr int kSkeletonDepth = 6;
+	constexpr int kBranchDepth = 3;
+	//クリップの種類と、同時に出現するグループの数
+	constexpr uint32_t kClipCount = 4;
+	constexpr uint32_t kSpawnGroupCount = 8;
+
+	/// <summary>
+	/// キャラクター1体分
+	/// </summary>
+	struct Character {
+		Model model;
+		AnimatorController controller;
+		std::vector<WellForGPU> palette; //Model がパレットを書き込むCPU側の配列
+	};
+
+	/// <summary>
+	/// 再生位置の分布
+	/// </summary>
+	enum class Phase {
+		Random,      //キャラクター毎にばらばら
+		SpawnGroups, //kSpawnGroupCount 個のグループで揃っている
+	};
+
+	/// <summary>
+	/// 1フレームの処理の方法
+	/// </summary>
+	enum class Mode {
+		Immediate,   //登録時にその場で処理する(SetEnabled(false))
+		Flush,       //Flush で並列に処理し、姿勢は共有しない
+		FlushShared, //Flush で並列に処理し、同じ姿勢を共有する
+	};
+
+	//ジョイントの階層を作る
+	Node MakeNode(int& jointCount, int depth) {
+		Node node;
+		node.name = "joint" + std::to_string(jointCount++);
+		node.transform = { { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.3f, 0.0f } };
+		node.localMatrix = MatrixMath::MakeIdentity4x4();
+		if (depth > 0) {
+			const int childCount = (depth > kBranchDepth) ? 3 : 1;
+			for (int i = 0; i < childCount; ++i) {
+				node.children.push_back(MakeNode(jointCount, depth - 1));
+			}
+		}
+		return node;
+	}
+
+	//全ジョイントを動かす2秒のアニメーション(30fpsで焼いたもの。クリップ毎に動きの速さを変える)
+	std::unique_ptr<Animation> MakeAnimation(int jointCount, uint32_t clipIndex) {
+		auto animation = std::make_unique<Animation>();
+		animation->name = "clip" + std::to_string(clipIndex);
+		animation->duration = 2.0f;
+		animation->serial = AnimationManager::IssueAnimationSerial();
+		const float speed = static_cast<float>(clipIndex + 1);
+		for (int joint = 0; joint < jointCount; ++joint) {
+			NodeAnimation nodeAnimation;
+			for (int frame = 0; frame <= 60; ++frame) {
+				const float time = static_cast<float>(frame) / 30.0f;
+				const float halfAngle = 0.02f * speed * static_cast<float>(frame) + 0.1f * static_cast<float>(joint);
+				nodeAnimation.translate.keyframes.push_back({ time, { 0.0f, 0.3f, 0.01f * speed * static_cast<float>(frame) } });
+				nodeAnimation.rotate.keyframes.push_back({ time, { std::sin(halfAngle), 0.0f, 0.0f, std::cos(halfAngle) } });
+				nodeAnimation.scale.keyframes.push_back({ time, { 1.0f, 1.0f, 1.0f } });
+			}
+			animation->nodeAnimations["joint" + std::to_string(joint)] = nodeAnimation;
+		}
+		return animation;
+	}
+
+	//キャラクターの生成(同じシードなら同じクリップ・再生位置になる)
+	std::vector<std::unique_ptr<Character>> MakeCharacters(const Node& root, int jointCount,
+		const std::vector<std::unique_ptr<Animation>>& clips, Phase phase) {
+
+		FastRandom random(23);
+		std::vector<std::unique_ptr<Character>> characters;
+		for (uint32_t i = 0; i < kCharacterCount; ++i) {
+			auto character = std::make_unique<Character>();
+			character->palette.resize(jointCount);
+			character->model.InitializeSkinningOnly(root, std::vector<Matrix4x4>(jointCount, MatrixMath::MakeIdentity4x4()), character->palette);
+			character->controller.Initialize(character->model.GetSkeleton());
+			character->controller.TransitionTo(clips[random.NextUInt() % kClipCount].get(), 0.0f);
+
+			const float startTime = (phase == Phase::Random) ?
+				random.NextFloat(0.0f, 2.0f) : 0.37f * static_cast<float>(random.NextUInt() % kSpawnGroupCount);
+			character->controller.Update(startTime);
+			characters.push_back(std::move(character));
+		}
+		return characters;
+	}
+
+	//1フレーム分の登録と処理
+	void RunFrame(std::vector<std::unique_ptr<Character>>& characters, Mode mode) {
+		SkinningScheduler& scheduler = SkinningScheduler::GetInstance();
+		scheduler.SetEnabled(mode != Mode::Immediate);
+		scheduler.SetPoseSharingEnabled(mode == Mode::FlushShared);
+		for (std::unique_ptr<Character>& character : characters) {
+			scheduler.Enqueue(&character->model, &character->controller, kDeltaTime);
+		}
+		scheduler.Flush();
+	}
+
+	//パレットの行列の要素の差の最大値
+	float MaxPaletteDifference(const std::vector<WellForGPU>& a, const std::vector<WellForGPU>& b) {
+		constexpr size_t kFloatCount = sizeof(WellForGPU) / sizeof(float);
+		float maxDifference = 0.0f;
+		for (size_t joint = 0; joint < a.size(); ++joint) {
+			const float* fa = reinterpret_cast<const float*>(&a[joint]);
+			const float* fb = reinterpret_cast<const float*>(&b[joint]);
+			for (size_t i = 0; i < kFloatCount; ++i) {
+				maxDifference = (std::max)(maxDifference, std::abs(fa[i] - fb[i]));
+			}
+		}
+		return maxDifference;
+	}
+
+	/// <summary>
+	/// 計測中だけワーカースレッドを起動し、SkinningScheduler の設定を既定に戻す
+	/// </summary>
+	struct ScopedWorkers {
+		ScopedWorkers() { JobSystem::GetInstance().Initialize(); }
+		~ScopedWorkers() {
+			SkinningScheduler::GetInstance().SetEnabled(true);
+			SkinningScheduler::GetInstance().SetPoseSharingEnabled(true);
+			JobSystem::GetInstance().Finalize();
+		}
+	};
+
+	/// <summary>
+	/// 1つの再生位置の分布で、3つの処理の方法を確認・計測する
+	/// </summary>
+	void RunScenario(const char* name, const Node& root, int jointCount, const std::vector<std::unique_ptr<Animation>>& clips, Phase phase) {
+
+		//その場で処理した結果と、Flush(共有なし)はビット単位で一致する
+		//共有ありは再生時間を1フレーム未満の単位で丸めた姿勢なので、差は1フレームの間の動きの最大値に収まる
+		{
+			std::vector<std::unique_ptr<Character>> immediate = MakeCharacters(root, jointCount, clips, phase);
+			std::vector<std::unique_ptr<Character>> flushed = MakeCharacters(root, jointCount, clips, phase);
+			std::vector<std::unique_ptr<Character>> shared = MakeCharacters(root, jointCount, clips, phase);
+			std::vector<std::vector<WellForGPU>> previous(kCharacterCount);
+			float maxFrameMotion = 0.0f;
+			for (uint32_t frame = 0; frame < kCheckFrameCount; ++frame) {
+				RunFrame(immediate, Mode::Immediate);
+				RunFrame(flushed, Mode::Flush);
+				RunFrame(shared, Mode::FlushShared);
+				for (uint32_t i = 0; i < kCharacterCount; ++i) {
+					if (frame > 0) {
+						maxFrameMotion = (std::max)(maxFrameMotion, MaxPaletteDifference(previous[i], immediate[i]->palette));
+					}
+					previous[i] = immediate[i]->palette;
+				}
+			}
+
+			uint32_t mismatchCount = 0;
+			float maxSharedDifference = 0.0f;
+			for (uint32_t i = 0; i < kCharacterCount; ++i) {
+				const std::vector<WellForGPU>& expected = immediate[i]->palette;
+				mismatchCount += (std::memcmp(expected.data(), flushed[i]->palette.data(), sizeof(WellForGPU) * expected.size()) == 0) ? 0 : 1;
+				maxSharedDifference = (std::max)(maxSharedDifference, MaxPaletteDifference(expected, shared[i]->palette));
+			}
+			TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+			TAKEC_BENCHMARK_CHECK(maxSharedDifference <= maxFrameMotion);
+		}
+
+		std::vector<std::unique_ptr<Character>> characters = MakeCharacters(root, jointCount, clips, phase);
+		const Benchmark::Result immediate = Benchmark::Measure(kRepeatCount, [&characters]() {
+			RunFrame(characters, Mode::Immediate);
+		});
+		characters = MakeCharacters(root, jointCount, clips, phase);
+		const Benchmark::Result flushed = Benchmark::Measure(kRepeatCount, [&characters]() {
+			RunFrame(characters, Mode::Flush);
+		});
+		characters = MakeCharacters(root, jointCount, clips, phase);
+		uint64_t lookupCount = 0;
+		uint64_t hitCount = 0;
+		const Benchmark::Result shared = Benchmark::Measure(kRepeatCount, [&]() {
+			RunFrame(characters, Mode::FlushShared);
+			const SkinningScheduler::PoseShareStats& stats = SkinningScheduler::GetInstance().GetLastPoseShareStats();
+			lookupCount += stats.lookupCount;
+			hitCount += stats.hitCount;
+		});
+
+		std::printf("  [%s] pose sharing hit rate %.1f%%\n", name, lookupCount > 0 ? 100.0 * static_cast<double>(hitCount) / static_cast<double>(lookupCount) : 0.0);
+		Benchmark::Report("immediate (scheduler disabled)", immediate);
+		Benchmark::Report("Flush, pose sharing off", flushed, &immediate);
+		Benchmark::Report("Flush, pose sharing on", shared, &immediate);
+	}
+}
+
+//============================================================================
+// 500体のスキニング: その場での処理と SkinningScheduler::Flush(姿勢の共有なし・あり)
+//============================================================================
+TAKEC_BENCHMARK(Skinning_500Characters) {
+	int jointCount = 0;
+	const Node root = MakeNode(jointCount, kSkeletonDepth);
+	std::vector<std::unique_ptr<Animation>> clips;
+	for (uint32_t clipIndex = 0; clipIndex < kClipCount; ++clipIndex) {
+		clips.push_back(MakeAnimation(jointCount, clipIndex));
+	}
+
+	//TakeCFrameWork と同じ、ハードウェアスレッド数-1個のワーカー
+	ScopedWorkers workers;
+
+	std::printf("  %u characters, %d joints, %u clips, %u worker thread(s)\n", kCharacterCount, jointCount, kClipCount, JobSystem::GetInstance().GetWorkerCount());
+	if (JobSystem::GetInstance().GetWorkerCount() == 0) {
+		std::printf("  warning: no worker threads, ParallelFor runs on the calling thread\n");
+	}
+	RunScenario("random phases", root, jointCount, clips, Phase::Random);
+	RunScenario("8 spawn groups", root, jointCount, clips, Phase::SpawnGroups);
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//============================================================================
+// Benchmark
+//============================================================================
+/// <summary>
+/// TakeCEngineBenchmarksで使う最小限の計測の仕組みです。
+/// TAKEC_BENCHMARK で定義した関数は静的初期化時に登録され、main から順に実行されます。
+/// Measure で処理を繰り返し実行して1回あたりの時間を求め、Report で出力します。
+/// 比較する実装同士の結果の一致は TAKEC_BENCHMARK_CHECK で確認し、不一致は失敗として記録します。
+/// </summary>
+namespace TakeC::Benchmark {
+
+	/// <summary>
+	/// 登録されたベンチマーク1件分
+	/// </summary>
+	struct BenchmarkCase {
+		const char* name = nullptr;
+		void (*function)() = nullptr;
+	};
+
+	/// <summary>
+	/// 計測結果(1回あたりの時間)
+	/// </summary>
+	struct Result {
+		double medianMicroseconds = 0.0;
+		double minMicroseconds = 0.0;
+	};
+
+	/// <summary>
+	/// 登録済みベンチマークの取得(静的初期化の順序に依存しないよう関数内staticで保持する)
+	/// </summary>
+	std::vector<BenchmarkCase>& GetBenchmarks();
+
+	/// <summary>
+	/// 失敗の記録。実行中のベンチマークを失敗扱いにして内容を出力する
+	/// </summary>
+	/// <param name="file">ファイル名</param>
+	/// <param name="line">行番号</param>
+	/// <param name="expression">失敗した条件</param>
+	void ReportFailure(const char* file, int line, const char* expression);
+
+	/// <summary>
+	/// 計測結果の出力
+	/// </summary>
+	/// <param name="label">計測した処理の名前</param>
+	/// <param name="result">計測結果</param>
+	/// <param name="baseline">比較の基準にする計測結果(指定すると中央値の比を出力する)</param>
+	void Report(const char* label, const Result& result, const Result* baseline = nullptr);
+
+	/// <summary>
+	/// 値を使ったことにする(別の翻訳単位で定義し、計算が最適化で消されないようにする)
+	/// </summary>
+	void UseValue(const volatile void* value);
+
+	template<typename T>
+	void DoNotOptimize(const T& value) {
+		UseValue(&value);
+	}
+
+	/// <summary>
+	/// 処理を1回実行してから repeatCount 回計測し、1回あたりの時間の中央値と最小値を返す
+	/// </summary>
+	template<typename Func>
+	Result Measure(uint32_t repeatCount, Func&& func) {
+		func();
+
+		std::vector<double> times;
+		times.reserve(repeatCount);
+		for (uint32_t i = 0; i < repeatCount; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			func();
+			auto end = std::chrono::steady_clock::now();
+			times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		}
+		if (times.empty()) {
+			return {};
+		}
+		std::sort(times.begin(), times.end());
+		return { times[times.size() / 2], times.front() };
+	}
+
+	/// <summary>
+	/// ベンチマークの静的登録用
+	/// </summary>
+	struct BenchmarkRegistrar {
+		BenchmarkRegistrar(const char* name, void (*function)()) {
+			GetBenchmarks().push_back({ name, function });
+		}
+	};
+}
+
+//ベンチマークの定義
+#define TAKEC_BENCHMARK(name) \
+	static void name(); \
+	static const TakeC::Benchmark::BenchmarkRegistrar name##Registrar_(#name, &name); \
+	static void name()
+
+//比較する実装同士の結果の判定
+#define TAKEC_BENCHMARK_CHECK(expression) \
+	do { \
+		if (!(expression)) { \
+			TakeC::Benchmark::ReportFailure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
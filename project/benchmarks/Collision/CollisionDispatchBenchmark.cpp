@@ -0,0 +1,148 @@
+#include "Benchmark.h"
+#include "engine/3d/Object3d.h"
+#include "engine/Collision/BoxCollider.h"
+#include "engine/Collision/SphereCollider.h"
+#include "engine/math/FastRandom.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// CollisionDispatcher のベンチマーク
+//============================================================================
+// Collider::CheckCollision は以前、BoxCollider/SphereCollider がそれぞれ相手を dynamic_cast で判定して
+// 判定関数を選んでいた。同じコライダーの組を、形状タグのテーブル(現在の Collider::CheckCollision)・
+// 以前と同じ dynamic_cast の連鎖・振り分け無しの直接呼び出しで判定し、1組あたりの振り分けの費用を比べる。
+// コライダーは Initialize(デバイスが必要)を呼ばず、原点に置いた Object3d とオフセットで位置を決めて Update する。
+
+namespace {
+
+	//判定する組の数と、計測の繰り返し回数
+	constexpr uint32_t kPairCount = 100000;
+	constexpr uint32_t kRepeatCount = 20;
+
+	/// <summary>
+	/// 判定する組(形状の組み合わせが偏らないよう、Box/Sphereを混ぜて選ぶ)
+	/// </summary>
+	struct ColliderPair {
+		Collider* a = nullptr;
+		Collider* b = nullptr;
+	};
+
+	//以前の BoxCollider::CheckCollision と同じ振り分け
+	bool CheckCollisionBoxDynamicCast(BoxCollider* box, Collider* other) {
+		if (BoxCollider* otherBox = dynamic_cast<BoxCollider*>(other)) {
+			return box->CheckCollisionBox(otherBox);
+		}
+		if (SphereCollider* sphere = dynamic_cast<SphereCollider*>(other)) {
+			return sphere->CheckCollisionOBB(box);
+		}
+		return false;
+	}
+
+	//以前の SphereCollider::CheckCollision と同じ振り分け
+	bool CheckCollisionSphereDynamicCast(SphereCollider* sphere, Collider* other) {
+		if (BoxCollider* box = dynamic_cast<BoxCollider*>(other)) {
+			return sphere->CheckCollisionOBB(box);
+		}
+		if (SphereCollider* otherSphere = dynamic_cast<SphereCollider*>(other)) {
+			return sphere->CheckCollisionSphere(otherSphere);
+		}
+		return false;
+	}
+
+	//以前の仮想関数呼び出しの代わりに、自分の形状は形状タグで選ぶ(相手の判定だけがdynamic_castになる)
+	bool CheckCollisionDynamicCast(Collider* a, Collider* b) {
+		if (a->GetShape() == ColliderShape::Box) {
+			return CheckCollisionBoxDynamicCast(static_cast<BoxCollider*>(a), b);
+		}
+		return CheckCollisionSphereDynamicCast(static_cast<SphereCollider*>(a), b);
+	}
+
+	//振り分け無しで判定関数を直接呼ぶ(組の形状が分かっている場合の下限)
+	bool CheckCollisionDirect(Collider* a, Collider* b) {
+		const bool isBoxA = a->GetShape() == ColliderShape::Box;
+		const bool isBoxB = b->GetShape() == ColliderShape::Box;
+		if (isBoxA && isBoxB) {
+			return static_cast<BoxCollider*>(a)->CheckCollisionBox(static_cast<BoxCollider*>(b));
+		}
+		if (isBoxA) {
+			return static_cast<SphereCollider*>(b)->CheckCollisionOBB(static_cast<BoxCollider*>(a));
+		}
+		if (isBoxB) {
+			return static_cast<SphereCollider*>(a)->CheckCollisionOBB(static_cast<BoxCollider*>(b));
+		}
+		return static_cast<SphereCollider*>(a)->CheckCollisionSphere(static_cast<SphereCollider*>(b));
+	}
+}
+
+//============================================================================
+// 1組あたりの振り分けの費用: 形状タグのテーブルと dynamic_cast の連鎖
+//============================================================================
+TAKEC_BENCHMARK(CollisionDispatch_TableVsDynamicCast) {
+	constexpr uint32_t kColliderCount = 512;
+	constexpr float kExtent = 8.0f;
+
+	FastRandom random(3);
+
+	//値初期化した Object3d はワールド座標が原点になる。回転だけをコライダーに渡す
+	auto object = std::make_unique<Object3d>();
+	std::vector<std::unique_ptr<Collider>> colliders;
+	for (uint32_t i = 0; i < kColliderCount; ++i) {
+		const Vector3 position = { random.NextFloat(-kExtent, kExtent), random.NextFloat(-kExtent, kExtent), random.NextFloat(-kExtent, kExtent) };
+		object->SetRotate({ random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) });
+
+		std::unique_ptr<Collider> collider;
+		if (random.NextUInt() & 1) {
+			collider = std::make_unique<BoxCollider>();
+			collider->SetHalfSize({ random.NextFloat(0.5f, 4.0f), random.NextFloat(0.5f, 4.0f), random.NextFloat(0.5f, 4.0f) });
+		} else {
+			collider = std::make_unique<SphereCollider>();
+			collider->SetRadius(random.NextFloat(0.5f, 4.0f));
+		}
+		collider->SetOffset(position);
+		collider->Update(object.get());
+		colliders.push_back(std::move(collider));
+	}
+
+	std::vector<ColliderPair> pairs(kPairCount);
+	for (ColliderPair& pair : pairs) {
+		pair.a = colliders[random.NextUInt() % kColliderCount].get();
+		pair.b = colliders[random.NextUInt() % kColliderCount].get();
+	}
+
+	//3通りの判定結果が一致する
+	uint32_t hitCount = 0;
+	uint32_t mismatchCount = 0;
+	for (const ColliderPair& pair : pairs) {
+		const bool expected = CheckCollisionDirect(pair.a, pair.b);
+		hitCount += expected ? 1 : 0;
+		mismatchCount += (pair.a->CheckCollision(pair.b) == expected) ? 0 : 1;
+		mismatchCount += (CheckCollisionDynamicCast(pair.a, pair.b) == expected) ? 0 : 1;
+	}
+	TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+	auto measure = [&pairs](auto check) {
+		return Benchmark::Measure(kRepeatCount, [&pairs, &check]() {
+			uint32_t count = 0;
+			for (const ColliderPair& pair : pairs) {
+				count += check(pair.a, pair.b) ? 1 : 0;
+			}
+			Benchmark::DoNotOptimize(count);
+		});
+	};
+	const Benchmark::Result direct = measure(&CheckCollisionDirect);
+	const Benchmark::Result dynamicCast = measure(&CheckCollisionDynamicCast);
+	const Benchmark::Result table = measure([](Collider* a, Collider* b) { return a->CheckCollision(b); });
+
+	std::printf("  %u pairs (%u hits), per pair: direct %.2f ns, dynamic_cast %.2f ns, table %.2f ns\n", kPairCount, hitCount,
+		direct.medianMicroseconds * 1000.0 / kPairCount, dynamicCast.medianMicroseconds * 1000.0 / kPairCount,
+		table.medianMicroseconds * 1000.0 / kPairCount);
+	Benchmark::Report("direct call (no dispatch)", direct);
+	Benchmark::Report("dynamic_cast chain", dynamicCast, &direct);
+	Benchmark::Report("Collider::CheckCollision (table)", table, &direct);
+}
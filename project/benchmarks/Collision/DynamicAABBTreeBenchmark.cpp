@@ -0,0 +1,218 @@
+#include "Benchmark.h"
+#include "engine/Collision/DynamicAABBTree.h"
+#include "engine/math/FastRandom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// DynamicAABBTree のベンチマーク
+//============================================================================
+// CollisionManager::RayCast は以前、登録された全コライダーを線形に判定していた。
+// 1k/10k/50k個の箱を同じ密度で並べ、同じレイを線形走査とBVHの走査で判定した時間を比べる。
+// コライダーの生成にはデバイスが必要なため、コライダーの代わりに箱(AABB)と線分の判定を使う。
+
+namespace {
+
+	//レイの本数と長さ
+	constexpr uint32_t kRayCount = 1000;
+	constexpr float kRayDistance = 50.0f;
+	//計測の繰り返し回数
+	constexpr uint32_t kRepeatCount = 10;
+
+	/// <summary>
+	/// 判定対象の箱
+	/// </summary>
+	struct BenchmarkBox {
+		AABB bounds;
+		uint32_t layerMask = 0;
+	};
+
+	/// <summary>
+	/// レイ
+	/// </summary>
+	struct BenchmarkRay {
+		Vector3 origin;
+		Vector3 direction;
+	};
+
+	//BVHにはコライダーの代わりに箱のアドレスを登録する(BVHはポインタを参照しない)
+	Collider* ToCollider(const BenchmarkBox& box) {
+		return reinterpret_cast<Collider*>(const_cast<BenchmarkBox*>(&box));
+	}
+	const BenchmarkBox& ToBox(const Collider* collider) {
+		return *reinterpret_cast<const BenchmarkBox*>(collider);
+	}
+
+	//線分と箱の判定(スラブ法)
+	bool IntersectsSegment(const AABB& bounds, const BenchmarkRay& ray, float maxDistance, float& outDistance) {
+		const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+		const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+		const float boundsMin[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+		const float boundsMax[3] = { bounds.max.x, bounds.max.y, bounds.max.z };
+
+		float tMin = 0.0f;
+		float tMax = maxDistance;
+		for (int axis = 0; axis < 3; ++axis) {
+			if (std::abs(direction[axis]) < 1e-6f) {
+				if (origin[axis] < boundsMin[axis] || origin[axis] > boundsMax[axis]) {
+					return false;
+				}
+				continue;
+			}
+			float t1 = (boundsMin[axis] - origin[axis]) / direction[axis];
+			float t2 = (boundsMax[axis] - origin[axis]) / direction[axis];
+			tMin = (std::max)(tMin, (std::min)(t1, t2));
+			tMax = (std::min)(tMax, (std::max)(t1, t2));
+			if (tMin > tMax) {
+				return false;
+			}
+		}
+		outDistance = tMin;
+		return true;
+	}
+
+	//以前の CollisionManager::RayCast と同じ、全ての箱を判定する線形走査
+	const BenchmarkBox* RayCastLinear(const std::vector<BenchmarkBox>& boxes, const BenchmarkRay& ray, uint32_t layerMask) {
+		const BenchmarkBox* hit = nullptr;
+		float closestDistance = kRayDistance;
+		for (const BenchmarkBox& box : boxes) {
+			if ((box.layerMask & layerMask) == 0) {
+				continue;
+			}
+			float distance = 0.0f;
+			if (IntersectsSegment(box.bounds, ray, kRayDistance, distance) && distance < closestDistance) {
+				closestDistance = distance;
+				hit = &box;
+			}
+		}
+		return hit;
+	}
+
+	//CollisionManager::RayCast と同じ手順のBVHの走査
+	const BenchmarkBox* RayCastTree(const DynamicAABBTree& tree, const BenchmarkRay& ray, uint32_t layerMask) {
+		const BenchmarkBox* hit = nullptr;
+		float closestDistance = kRayDistance;
+		tree.RayCast(ray.origin, ray.direction, kRayDistance, 0.0f, layerMask, [&](Collider* collider) {
+			const BenchmarkBox& box = ToBox(collider);
+			float distance = 0.0f;
+			if ((box.layerMask & layerMask) != 0 && IntersectsSegment(box.bounds, ray, kRayDistance, distance) && distance < closestDistance) {
+				closestDistance = distance;
+				hit = &box;
+			}
+			return (std::max)(closestDistance, 0.0f);
+		});
+		return hit;
+	}
+
+	//数に関わらず同じ密度になるよう、箱を並べる範囲を数の立方根に比例させる
+	std::vector<BenchmarkBox> MakeBoxes(FastRandom& random, uint32_t count, float& outExtent) {
+		outExtent = 5.0f * std::cbrt(static_cast<float>(count));
+		std::vector<BenchmarkBox> boxes(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			const Vector3 center = { random.NextFloat(-outExtent, outExtent), random.NextFloat(-outExtent, outExtent), random.NextFloat(-outExtent, outExtent) };
+			const Vector3 halfSize = { random.NextFloat(0.2f, 3.0f), random.NextFloat(0.2f, 3.0f), random.NextFloat(0.2f, 3.0f) };
+			boxes[i].bounds = { center - halfSize, center + halfSize };
+			boxes[i].layerMask = 1u << (i % 4);
+		}
+		return boxes;
+	}
+
+	std::vector<BenchmarkRay> MakeRays(FastRandom& random, float extent) {
+		std::vector<BenchmarkRay> rays(kRayCount);
+		for (BenchmarkRay& ray : rays) {
+			ray.origin = { random.NextFloat(-extent, extent), random.NextFloat(-extent, extent), random.NextFloat(-extent, extent) };
+			ray.direction = Vector3{ random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f) }.Normalize();
+		}
+		return rays;
+	}
+}
+
+//============================================================================
+// レイキャスト: 線形走査とBVH(1k/10k/50k)
+//============================================================================
+TAKEC_BENCHMARK(DynamicAABBTree_RayCastVsLinearScan) {
+	//判定するレイヤー(4種類のうち2種類)
+	constexpr uint32_t kLayerMask = 1u | 4u;
+
+	for (uint32_t count : { 1000u, 10000u, 50000u }) {
+		FastRandom random(count);
+		float extent = 0.0f;
+		const std::vector<BenchmarkBox> boxes = MakeBoxes(random, count, extent);
+		const std::vector<BenchmarkRay> rays = MakeRays(random, extent);
+
+		DynamicAABBTree tree;
+		for (const BenchmarkBox& box : boxes) {
+			tree.CreateProxy(box.bounds, box.layerMask, ToCollider(box));
+		}
+
+		//両方の走査で同じ箱に当たる
+		uint32_t hitCount = 0;
+		uint32_t mismatchCount = 0;
+		for (const BenchmarkRay& ray : rays) {
+			const BenchmarkBox* expected = RayCastLinear(boxes, ray, kLayerMask);
+			hitCount += expected ? 1 : 0;
+			mismatchCount += (RayCastTree(tree, ray, kLayerMask) == expected) ? 0 : 1;
+		}
+		TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+		const Benchmark::Result linear = Benchmark::Measure(kRepeatCount, [&]() {
+			for (const BenchmarkRay& ray : rays) {
+				Benchmark::DoNotOptimize(RayCastLinear(boxes, ray, kLayerMask));
+			}
+		});
+		const Benchmark::Result bvh = Benchmark::Measure(kRepeatCount, [&]() {
+			for (const BenchmarkRay& ray : rays) {
+				Benchmark::DoNotOptimize(RayCastTree(tree, ray, kLayerMask));
+			}
+		});
+
+		std::printf("  %u boxes, %u rays (%u hits), tree height %d\n", count, kRayCount, hitCount, tree.GetHeight());
+		Benchmark::Report("linear scan", linear);
+		Benchmark::Report("DynamicAABBTree::RayCast", bvh, &linear);
+	}
+}
+
+//============================================================================
+// 全ての箱が少しずつ動いた時のBVHの更新(1k/10k/50k)
+//============================================================================
+// BVHの走査の代わりに毎フレーム払う MoveProxy の費用(fat AABBからはみ出した箱だけ挿し直す)
+TAKEC_BENCHMARK(DynamicAABBTree_MoveProxy) {
+	for (uint32_t count : { 1000u, 10000u, 50000u }) {
+		FastRandom random(count + 1);
+		float extent = 0.0f;
+		std::vector<BenchmarkBox> boxes = MakeBoxes(random, count, extent);
+
+		DynamicAABBTree tree;
+		std::vector<int32_t> proxyIds(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			proxyIds[i] = tree.CreateProxy(boxes[i].bounds, boxes[i].layerMask, ToCollider(boxes[i]));
+		}
+
+		//1フレームに最大0.1移動する(60fpsで秒速6程度)
+		std::vector<Vector3> velocities(count);
+		for (Vector3& velocity : velocities) {
+			velocity = { random.NextFloat(-0.1f, 0.1f), random.NextFloat(-0.1f, 0.1f), random.NextFloat(-0.1f, 0.1f) };
+		}
+
+		uint32_t reinsertCount = 0;
+		uint32_t frameCount = 0;
+		const Benchmark::Result result = Benchmark::Measure(kRepeatCount * 6, [&]() {
+			for (uint32_t i = 0; i < count; ++i) {
+				boxes[i].bounds = { boxes[i].bounds.min + velocities[i], boxes[i].bounds.max + velocities[i] };
+				reinsertCount += tree.MoveProxy(proxyIds[i], boxes[i].bounds, boxes[i].layerMask) ? 1 : 0;
+			}
+			++frameCount;
+		});
+		TAKEC_BENCHMARK_CHECK(tree.GetProxyCount() == count);
+
+		std::printf("  %u boxes, %.1f%% reinserted per frame, tree height %d\n", count,
+			100.0 * static_cast<double>(reinsertCount) / (static_cast<double>(count) * frameCount), tree.GetHeight());
+		Benchmark::Report("MoveProxy (all boxes)", result);
+	}
+}
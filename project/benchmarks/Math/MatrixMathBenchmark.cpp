@@ -0,0 +1,280 @@
+#include "Benchmark.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// MatrixMath(SSE)のベンチマーク
+//============================================================================
+// Matrix4x4 の積・MatrixMath::Inverse・MatrixMath::Transform の時間を、SSE化する前の実装と比べる。
+// 以前の実装は、積が m2 の列を _mm_set_ps で集めて内積を水平加算するもの、逆行列が余因子展開のスカラー計算、
+// 座標変換がスカラー計算で、このファイルに同じ内容を残して比較に使う。
+// 結果の一致は、積と逆行列が許容誤差内、座標変換がビット単位(加算の順序が同じため)で確認する。
+
+namespace {
+
+	//行列の数と、計測の繰り返し回数
+	constexpr uint32_t kMatrixCount = 10000;
+	constexpr uint32_t kRepeatCount = 50;
+	//以前の実装との許容誤差(要素の大きさに対する相対誤差)
+	constexpr float kTolerance = 1e-5f;
+
+	//以前の行列の積(m2 の列を集めて内積を水平加算する)
+	Matrix4x4 MultiplyPrevious(const Matrix4x4& m1, const Matrix4x4& m2) {
+		Matrix4x4 result;
+		for (int row = 0; row < 4; row++) {
+			__m128 r = _mm_set_ps(m1.m[row][3], m1.m[row][2], m1.m[row][1], m1.m[row][0]);
+			for (int col = 0; col < 4; col++) {
+				__m128 c = _mm_set_ps(m2.m[3][col], m2.m[2][col], m2.m[1][col], m2.m[0][col]);
+				__m128 mul = _mm_mul_ps(r, c);
+				__m128 hadd = _mm_add_ps(mul, _mm_movehl_ps(mul, mul));
+				hadd = _mm_add_ss(hadd, _mm_shuffle_ps(hadd, hadd, 1));
+				result.m[row][col] = _mm_cvtss_f32(hadd);
+			}
+		}
+		return result;
+	}
+
+	//以前の逆行列(余因子展開)
+	Matrix4x4 InversePrevious(const Matrix4x4& m) {
+		float determinant =
+			(m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3])
+			+ (m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1])
+			+ (m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2])
+			- (m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1])
+			- (m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3])
+			- (m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2])
+			- (m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3])
+			- (m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1])
+			- (m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2])
+			+ (m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1])
+			+ (m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3])
+			+ (m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2])
+			+ (m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3])
+			+ (m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1])
+			+ (m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2])
+			- (m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1])
+			- (m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3])
+			- (m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2])
+			- (m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0])
+			- (m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0])
+			- (m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0])
+			+ (m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0])
+			+ (m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0])
+			+ (m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0]);
+
+		Matrix4x4 result;
+		result.m[0][0] = 1.0f / determinant *
+			(m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[1][3] * m.m[2][1] * m.m[3][2]
+				- m.m[1][3] * m.m[2][2] * m.m[3][1] - m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[1][1] * m.m[2][3] * m.m[3][2]);
+
+		result.m[0][1] = 1.0f / determinant *
+			(-m.m[0][1] * m.m[2][2] * m.m[3][3] - m.m[0][2] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[2][1] * m.m[3][2]
+				+ m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[2][3] * m.m[3][2]);
+
+		result.m[0][2] = 1.0f / determinant *
+			(m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[3][2]
+				- m.m[0][3] * m.m[1][2] * m.m[3][1] - m.m[0][2] * m.m[1][1] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[3][2]);
+
+		result.m[0][3] = 1.0f / determinant *
+			(-m.m[0][1] * m.m[1][2] * m.m[2][3] - m.m[0][2] * m.m[1][3] * m.m[2][1] - m.m[0][3] * m.m[1][1] * m.m[2][2]
+				+ m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] + m.m[0][1] * m.m[1][3] * m.m[2][2]);
+
+		result.m[1][0] = 1.0f / determinant *
+			(-m.m[1][0] * m.m[2][2] * m.m[3][3] - m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[1][3] * m.m[2][0] * m.m[3][2]
+				+ m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[1][0] * m.m[2][3] * m.m[3][2]);
+
+		result.m[1][1] = 1.0f / determinant *
+			(m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] + m.m[0][3] * m.m[2][0] * m.m[3][2]
+				- m.m[0][3] * m.m[2][2] * m.m[3][0] - m.m[0][2] * m.m[2][0] * m.m[3][3] - m.m[0][0] * m.m[2][3] * m.m[3][2]);
+
+		result.m[1][2] = 1.0f / determinant *
+			(-m.m[0][0] * m.m[1][2] * m.m[3][3] - m.m[0][2] * m.m[1][3] * m.m[3][0] - m.m[0][3] * m.m[1][0] * m.m[3][2]
+				+ m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] + m.m[0][0] * m.m[1][3] * m.m[3][2]);
+
+		result.m[1][3] = 1.0f / determinant *
+			(m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] + m.m[0][3] * m.m[1][0] * m.m[2][2]
+				- m.m[0][3] * m.m[1][2] * m.m[2][0] - m.m[0][2] * m.m[1][0] * m.m[2][3] - m.m[0][0] * m.m[1][3] * m.m[2][2]);
+
+		result.m[2][0] = 1.0f / determinant *
+			(m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[1][3] * m.m[2][0] * m.m[3][1]
+				- m.m[1][3] * m.m[2][1] * m.m[3][0] - m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[1][0] * m.m[2][3] * m.m[3][1]);
+
+		result.m[2][1] = 1.0f / determinant *
+			(-m.m[0][0] * m.m[2][1] * m.m[3][3] - m.m[0][1] * m.m[2][3] * m.m[3][0] - m.m[0][3] * m.m[2][0] * m.m[3][1]
+				+ m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] + m.m[0][0] * m.m[2][3] * m.m[3][1]);
+
+		result.m[2][2] = 1.0f / determinant *
+			(m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] + m.m[0][3] * m.m[1][0] * m.m[3][1]
+				- m.m[0][3] * m.m[1][1] * m.m[3][0] - m.m[0][1] * m.m[1][0] * m.m[3][3] - m.m[0][0] * m.m[1][3] * m.m[3][1]);
+
+		result.m[2][3] = 1.0f / determinant *
+			(-m.m[0][0] * m.m[1][1] * m.m[2][3] - m.m[0][1] * m.m[1][3] * m.m[2][0] - m.m[0][3] * m.m[1][0] * m.m[2][1]
+				+ m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] + m.m[0][0] * m.m[1][3] * m.m[2][1]);
+
+		result.m[3][0] = 1.0f / determinant *
+			(-m.m[1][0] * m.m[2][1] * m.m[3][2] - m.m[1][1] * m.m[2][2] * m.m[3][0] - m.m[1][2] * m.m[2][0] * m.m[3][1]
+				+ m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] + m.m[1][0] * m.m[2][2] * m.m[3][1]);
+
+		result.m[3][1] = 1.0f / determinant *
+			(m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] + m.m[0][2] * m.m[2][0] * m.m[3][1]
+				- m.m[0][2] * m.m[2][1] * m.m[3][0] - m.m[0][1] * m.m[2][0] * m.m[3][2] - m.m[0][0] * m.m[2][2] * m.m[3][1]);
+
+		result.m[3][2] = 1.0f / determinant *
+			(-m.m[0][0] * m.m[1][1] * m.m[3][2] - m.m[0][1] * m.m[1][2] * m.m[3][0] - m.m[0][2] * m.m[1][0] * m.m[3][1]
+				+ m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] + m.m[0][0] * m.m[1][2] * m.m[3][1]);
+
+		result.m[3][3] = 1.0f / determinant *
+			(m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] + m.m[0][2] * m.m[1][0] * m.m[2][1]
+				- m.m[0][2] * m.m[1][1] * m.m[2][0] - m.m[0][1] * m.m[1][0] * m.m[2][2] - m.m[0][0] * m.m[1][2] * m.m[2][1]);
+
+		return result;
+	}
+
+	//以前の座標変換
+	Vector3 TransformPrevious(const Vector3& vector, const Matrix4x4& matrix) {
+		Vector3 result;
+		result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+		result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+		result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+		float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+		result.x /= w;
+		result.y /= w;
+		result.z /= w;
+		return result;
+	}
+
+	//回転・拡大縮小・平行移動をランダムに組み合わせたアフィン行列
+	std::vector<Matrix4x4> MakeAffineMatrices(FastRandom& random) {
+		std::vector<Matrix4x4> matrices(kMatrixCount);
+		for (Matrix4x4& matrix : matrices) {
+			const Vector3 scale = { random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f) };
+			const Vector3 rotate = { random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) };
+			const Vector3 translate = { random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f) };
+			matrix = MatrixMath::MakeAffineMatrix(scale, rotate, translate);
+		}
+		return matrices;
+	}
+
+	//2つの行列の差が許容誤差内か(行列の最大要素を基準にする)
+	bool IsNear(const Matrix4x4& a, const Matrix4x4& b) {
+		float maxElement = 0.0f;
+		float maxError = 0.0f;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				maxElement = (std::max)(maxElement, std::abs(b.m[row][col]));
+				maxError = (std::max)(maxError, std::abs(a.m[row][col] - b.m[row][col]));
+			}
+		}
+		return maxError <= kTolerance * maxElement;
+	}
+}
+
+//============================================================================
+// 行列の積: 以前の実装(列の内積)とSSE(行の線形結合)
+//============================================================================
+TAKEC_BENCHMARK(MatrixMath_Multiply) {
+	FastRandom random(5);
+	const std::vector<Matrix4x4> world = MakeAffineMatrices(random);
+	const std::vector<Matrix4x4> viewProjection = MakeAffineMatrices(random);
+	std::vector<Matrix4x4> results(kMatrixCount);
+
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		mismatchCount += IsNear(MatrixMath::Multiply(world[i], viewProjection[i]), MultiplyPrevious(world[i], viewProjection[i])) ? 0 : 1;
+	}
+	TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+	auto measure = [&](auto multiply) {
+		return Benchmark::Measure(kRepeatCount, [&]() {
+			for (uint32_t i = 0; i < kMatrixCount; ++i) {
+				results[i] = multiply(world[i], viewProjection[i]);
+			}
+			Benchmark::DoNotOptimize(results[kMatrixCount - 1]);
+		});
+	};
+	const Benchmark::Result previous = measure(&MultiplyPrevious);
+	const Benchmark::Result sse = measure([](const Matrix4x4& a, const Matrix4x4& b) { return MatrixMath::Multiply(a, b); });
+
+	std::printf("  %u products, per product: previous %.2f ns, SSE %.2f ns\n", kMatrixCount,
+		previous.medianMicroseconds * 1000.0 / kMatrixCount, sse.medianMicroseconds * 1000.0 / kMatrixCount);
+	Benchmark::Report("previous (column dot products)", previous);
+	Benchmark::Report("MatrixMath::Multiply (SSE)", sse, &previous);
+}
+
+//============================================================================
+// 逆行列: 以前の実装(余因子展開)とSSE(2x2のブロック)
+//============================================================================
+TAKEC_BENCHMARK(MatrixMath_Inverse) {
+	FastRandom random(6);
+	const std::vector<Matrix4x4> matrices = MakeAffineMatrices(random);
+	std::vector<Matrix4x4> results(kMatrixCount);
+
+	uint32_t mismatchCount = 0;
+	for (const Matrix4x4& matrix : matrices) {
+		mismatchCount += IsNear(MatrixMath::Inverse(matrix), InversePrevious(matrix)) ? 0 : 1;
+	}
+	TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+	auto measure = [&](auto inverse) {
+		return Benchmark::Measure(kRepeatCount, [&]() {
+			for (uint32_t i = 0; i < kMatrixCount; ++i) {
+				results[i] = inverse(matrices[i]);
+			}
+			Benchmark::DoNotOptimize(results[kMatrixCount - 1]);
+		});
+	};
+	const Benchmark::Result previous = measure(&InversePrevious);
+	const Benchmark::Result sse = measure([](const Matrix4x4& m) { return MatrixMath::Inverse(m); });
+
+	std::printf("  %u inverses, per inverse: previous %.2f ns, SSE %.2f ns\n", kMatrixCount,
+		previous.medianMicroseconds * 1000.0 / kMatrixCount, sse.medianMicroseconds * 1000.0 / kMatrixCount);
+	Benchmark::Report("previous (cofactor expansion)", previous);
+	Benchmark::Report("MatrixMath::Inverse (SSE)", sse, &previous);
+}
+
+//============================================================================
+// 座標変換: 以前の実装(スカラー)とSSE
+//============================================================================
+TAKEC_BENCHMARK(MatrixMath_Transform) {
+	FastRandom random(7);
+	const std::vector<Matrix4x4> matrices = MakeAffineMatrices(random);
+	std::vector<Vector3> points(kMatrixCount);
+	for (Vector3& point : points) {
+		point = { random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f) };
+	}
+	std::vector<Vector3> results(kMatrixCount);
+
+	//加算の順序が同じため、ビット単位で一致する
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		const Vector3 expected = TransformPrevious(points[i], matrices[i]);
+		const Vector3 actual = MatrixMath::Transform(points[i], matrices[i]);
+		mismatchCount += (std::memcmp(&actual, &expected, sizeof(Vector3)) == 0) ? 0 : 1;
+	}
+	TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+
+	auto measure = [&](auto transform) {
+		return Benchmark::Measure(kRepeatCount, [&]() {
+			for (uint32_t i = 0; i < kMatrixCount; ++i) {
+				results[i] = transform(points[i], matrices[i]);
+			}
+			Benchmark::DoNotOptimize(results[kMatrixCount - 1]);
+		});
+	};
+	const Benchmark::Result previous = measure(&TransformPrevious);
+	const Benchmark::Result sse = measure([](const Vector3& v, const Matrix4x4& m) { return MatrixMath::Transform(v, m); });
+
+	std::printf("  %u points, per point: previous %.2f ns, SSE %.2f ns\n", kMatrixCount,
+		previous.medianMicroseconds * 1000.0 / kMatrixCount, sse.medianMicroseconds * 1000.0 / kMatrixCount);
+	Benchmark::Report("previous (scalar)", previous);
+	Benchmark::Report("MatrixMath::Transform (SSE)", sse, &previous);
+}
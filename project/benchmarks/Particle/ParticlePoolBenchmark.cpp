@@ -0,0 +1,236 @@
+#include "Benchmark.h"
+#include "engine/3d/Particle/ParticlePool.h"
+#include "engine/base/TakeCFrameWork.h"
+#include "engine/math/FastRandom.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// ParticlePool のベンチマーク
+//============================================================================
+// BaseParticleGroup は以前、生存中のパーティクルを std::list<Particle> で保持し、Emit で作った一時リストを
+// SpliceParticles で結合して、Update で寿命の来た要素を erase していた。現在は要素毎の配列(ParticlePool)に
+// 詰めて保持し、削除は末尾との入れ替えで行う。32k個のパーティクルを、毎フレーム寿命の来た分を削除して
+// 同じ数だけ発生させながら更新し、1フレームあたりの時間を比べる。
+// PrimitiveParticle の生成にはデバイスが必要なため、Update の移動・削除・GPU用データの書き込みと
+// Emit の手順をこのファイルで再現する。
+
+namespace {
+
+	//パーティクルの上限(PrimitiveParticle::kNumMaxInstance_ と同じ)
+	constexpr uint32_t kMaxParticleCount = 32768;
+	//1回のEmitで発生させる数
+	constexpr uint32_t kEmitCount = 64;
+	//一致を確認するフレーム数と、計測の繰り返し回数(1回が1フレーム)
+	constexpr uint32_t kCheckFrameCount = 120;
+	constexpr uint32_t kRepeatCount = 200;
+	//重力加速度
+	constexpr float kGravity = 9.8f;
+
+	/// <summary>
+	/// 発生させるパーティクルの列(両方の実装に同じ順で渡す)
+	/// </summary>
+	class ParticleSource {
+	public:
+
+		explicit ParticleSource(uint64_t seed) {
+			FastRandom random(seed);
+			particles_.resize(kMaxParticleCount * 2);
+			for (Particle& particle : particles_) {
+				particle.transforms_.translate = { random.NextFloat(-10.0f, 10.0f), random.NextFloat(0.0f, 10.0f), random.NextFloat(-10.0f, 10.0f) };
+				particle.transforms_.scale = { 1.0f, 1.0f, 1.0f };
+				particle.transforms_.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+				particle.velocity_ = { random.NextFloat(-5.0f, 5.0f), random.NextFloat(0.0f, 10.0f), random.NextFloat(-5.0f, 5.0f) };
+				particle.color_ = { random.NextFloat(), random.NextFloat(), random.NextFloat(), 1.0f };
+				particle.lifeTimer_.Initialize(random.NextFloat(0.5f, 2.0f), 0.0f);
+			}
+		}
+
+		const Particle& Next() {
+			const Particle& particle = particles_[next_];
+			next_ = (next_ + 1) % particles_.size();
+			return particle;
+		}
+
+	private:
+
+		std::vector<Particle> particles_;
+		size_t next_ = 0;
+	};
+
+	//1個分の移動の更新(PrimitiveParticle::UpdateMovement の重力の分)
+	void UpdateMovement(Vector3& translate, Vector3& velocity, Timer& lifeTimer) {
+		const float deltaTime = TakeCFrameWork::GetDeltaTime();
+		velocity.y -= kGravity * deltaTime;
+		translate += velocity * deltaTime;
+		lifeTimer.Update();
+	}
+
+	/// <summary>
+	/// 以前の BaseParticleGroup / PrimitiveParticle と同じ std::list での保持
+	/// </summary>
+	class ListParticleGroup {
+	public:
+
+		//Emit で一時リストを作り、SpliceParticles で結合する
+		void Emit(ParticleSource& source, uint32_t count) {
+			std::list<Particle> emitted;
+			for (uint32_t i = 0; i < count; ++i) {
+				emitted.push_back(source.Next());
+			}
+			particles_.splice(particles_.end(), emitted);
+		}
+
+		uint32_t Update(std::vector<ParticleForGPU>& particleData) {
+			uint32_t numInstance = 0;
+			for (std::list<Particle>::iterator it = particles_.begin(); it != particles_.end(); ) {
+				if (numInstance < kMaxParticleCount) {
+					//寿命が来たら削除
+					if ((*it).lifeTimer_.IsFinished()) {
+						it = particles_.erase(it);
+						continue;
+					}
+
+					UpdateMovement((*it).transforms_.translate, (*it).velocity_, (*it).lifeTimer_);
+
+					particleData[numInstance].scale = (*it).transforms_.scale;
+					particleData[numInstance].rotate = (*it).transforms_.rotate;
+					particleData[numInstance].translate = (*it).transforms_.translate;
+					particleData[numInstance].velocity = (*it).velocity_;
+					particleData[numInstance].color = (*it).color_;
+					particleData[numInstance].lifeTime = (*it).lifeTimer_.GetDuration();
+					particleData[numInstance].currentTime = (*it).lifeTimer_.GetProgress() * (*it).lifeTimer_.GetDuration();
+					++numInstance;
+				}
+				++it;
+			}
+			return numInstance;
+		}
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(particles_.size()); }
+
+	private:
+
+		std::list<Particle> particles_;
+	};
+
+	/// <summary>
+	/// 現在の ParticlePool での保持
+	/// </summary>
+	class PoolParticleGroup {
+	public:
+
+		PoolParticleGroup() {
+			particles_.Initialize(kMaxParticleCount);
+		}
+
+		//満杯になったら打ち切る
+		void Emit(ParticleSource& source, uint32_t count) {
+			for (uint32_t i = 0; i < count; ++i) {
+				if (!particles_.Add(source.Next())) {
+					return;
+				}
+			}
+		}
+
+		uint32_t Update(std::vector<ParticleForGPU>& particleData) {
+			for (uint32_t index = 0; index < particles_.GetCount(); ) {
+				//寿命が来たら末尾と入れ替えて削除
+				if (particles_.lifeTimer[index].IsFinished()) {
+					particles_.Remove(index);
+					continue;
+				}
+
+				UpdateMovement(particles_.translate[index], particles_.velocity[index], particles_.lifeTimer[index]);
+				particles_.WriteForGPU(index, particleData[index]);
+				++index;
+			}
+			return particles_.GetCount();
+		}
+
+		uint32_t GetCount() const { return particles_.GetCount(); }
+
+	private:
+
+		ParticlePool particles_;
+	};
+
+	//1フレーム分の更新と、上限までの発生
+	template<typename Group>
+	uint32_t RunFrame(Group& group, ParticleSource& source, std::vector<ParticleForGPU>& particleData) {
+		const uint32_t numInstance = group.Update(particleData);
+		while (group.GetCount() < kMaxParticleCount) {
+			group.Emit(source, (std::min)(kEmitCount, kMaxParticleCount - group.GetCount()));
+		}
+		return numInstance;
+	}
+
+	//GPU用データを位置で並べ替える(削除の方法で並び順が変わるため、集合として比べる)
+	std::vector<Vector3> SortedTranslates(const std::vector<ParticleForGPU>& particleData, uint32_t count) {
+		std::vector<Vector3> translates(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			translates[i] = particleData[i].translate;
+		}
+		std::sort(translates.begin(), translates.end(), [](const Vector3& a, const Vector3& b) {
+			return (a.x != b.x) ? (a.x < b.x) : (a.y != b.y) ? (a.y < b.y) : (a.z < b.z);
+		});
+		return translates;
+	}
+}
+
+//============================================================================
+// 32k個のパーティクルの更新: std::list と ParticlePool
+//============================================================================
+TAKEC_BENCHMARK(ParticlePool_Update32k) {
+	std::vector<ParticleForGPU> listData(kMaxParticleCount);
+	std::vector<ParticleForGPU> poolData(kMaxParticleCount);
+
+	//同じ列から発生させると、毎フレーム同じパーティクルの集合がGPU用データに書き込まれる
+	{
+		ParticleSource listSource(9);
+		ParticleSource poolSource(9);
+		ListParticleGroup list;
+		PoolParticleGroup pool;
+		list.Emit(listSource, kMaxParticleCount);
+		pool.Emit(poolSource, kMaxParticleCount);
+
+		uint32_t mismatchCount = 0;
+		uint32_t numInstance = 0;
+		for (uint32_t frame = 0; frame < kCheckFrameCount; ++frame) {
+			numInstance = RunFrame(list, listSource, listData);
+			mismatchCount += (RunFrame(pool, poolSource, poolData) == numInstance) ? 0 : 1;
+		}
+		const std::vector<Vector3> listTranslates = SortedTranslates(listData, numInstance);
+		const std::vector<Vector3> poolTranslates = SortedTranslates(poolData, numInstance);
+		mismatchCount += (std::memcmp(listTranslates.data(), poolTranslates.data(), sizeof(Vector3) * numInstance) == 0) ? 0 : 1;
+		TAKEC_BENCHMARK_CHECK(mismatchCount == 0);
+	}
+
+	ParticleSource listSource(10);
+	ListParticleGroup list;
+	list.Emit(listSource, kMaxParticleCount);
+	uint32_t listInstance = 0;
+	const Benchmark::Result listResult = Benchmark::Measure(kRepeatCount, [&]() {
+		listInstance = RunFrame(list, listSource, listData);
+	});
+
+	ParticleSource poolSource(10);
+	PoolParticleGroup pool;
+	pool.Emit(poolSource, kMaxParticleCount);
+	uint32_t poolInstance = 0;
+	const Benchmark::Result poolResult = Benchmark::Measure(kRepeatCount, [&]() {
+		poolInstance = RunFrame(pool, poolSource, poolData);
+	});
+	TAKEC_BENCHMARK_CHECK(listInstance == poolInstance);
+
+	std::printf("  %u particles, about %u replaced per frame\n", kMaxParticleCount, kMaxParticleCount - poolInstance);
+	Benchmark::Report("std::list (previous)", listResult);
+	Benchmark::Report("ParticlePool", poolResult, &listResult);
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstring>
+
+//============================================================================
+// TakeCEngineBenchmarks
+//============================================================================
+// 使い方: TakeCEngineBenchmarks.exe [ベンチマーク名の一部]
+// 引数を指定した場合は名前にその文字列を含むベンチマークだけを実行する。
+// 時間はRelease構成で計測する。比較する実装同士の結果が一致しなかった場合は終了コード1を返す。
+
+namespace {
+
+	//実行中のベンチマークの失敗数
+	int currentFailureCount = 0;
+}
+
+std::vector<TakeC::Benchmark::BenchmarkCase>& TakeC::Benchmark::GetBenchmarks() {
+	static std::vector<BenchmarkCase> benchmarks;
+	return benchmarks;
+}
+
+void TakeC::Benchmark::ReportFailure(const char* file, int line, const char* expression) {
+	++currentFailureCount;
+	std::printf("  %s(%d): failed: %s\n", file, line, expression);
+}
+
+void TakeC::Benchmark::Report(const char* label, const Result& result, const Result* baseline) {
+	std::printf("  %-48s %12.2f us (min %12.2f us)", label, result.medianMicroseconds, result.minMicroseconds);
+	if (baseline && result.medianMicroseconds > 0.0) {
+		std::printf("  x%.2f", baseline->medianMicroseconds / result.medianMicroseconds);
+	}
+	std::printf("\n");
+}
+
+void TakeC::Benchmark::UseValue(const volatile void*) {
+}
+
+int main(int argc, char** argv) {
+
+	const char* filter = (argc > 1) ? argv[1] : nullptr;
+
+#if defined(_DEBUG)
+	std::printf("warning: running an unoptimized Debug build\n");
+#endif
+
+	int runCount = 0;
+	int failedCount = 0;
+	for (const TakeC::Benchmark::BenchmarkCase& benchmark : TakeC::Benchmark::GetBenchmarks()) {
+		if (filter && !std::strstr(benchmark.name, filter)) {
+			continue;
+		}
+
+		std::printf("[ BENCH  ] %s\n", benchmark.name);
+		currentFailureCount = 0;
+		benchmark.function();
+		++runCount;
+
+		if (currentFailureCount != 0) {
+			std::printf("[ FAILED ] %s\n", benchmark.name);
+			++failedCount;
+		}
+	}
+
+	std::printf("%d benchmark(s) run, %d failed\n", runCount, failedCount);
+	return (failedCount == 0) ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 #include "Model.h"
 
 // STL
+#include <cassert>
 #include <fstream>
 #include <sstream>
 
@@ -70,6 +71,21 @@ void Model::Initialize(ModelCommon* ModelCommon, ModelData* modelData) {
 	}
 }
 
+//=============================================================================
+// スケルトンとCPU側のパレットだけの初期化
+//=============================================================================
+
+void Model::InitializeSkinningOnly(const Node& rootNode, std::vector<Matrix4x4> inverseBindPoseMatrices, std::span<WellForGPU> palette) {
+	skeleton_ = std::make_unique<Skeleton>();
+	skeleton_->Create(rootNode);
+	assert(inverseBindPoseMatrices.size() == skeleton_->GetJointCount() && palette.size() == skeleton_->GetJointCount());
+
+	//SkinClusterはパレットの計算・書き込みに使う部分だけを設定する
+	skinCluster_.inverseBindPoseMatrices = std::move(inverseBindPoseMatrices);
+	skinCluster_.mappedPalette = palette;
+	haveSkeleton_ = true;
+}
+
 //=============================================================================
 // 更新処理
 //=============================================================================
@@ -97,9 +113,9 @@ void Model::Update(Animation* animation, float animationTime) {
 
 		//rootNodeのAnimationを取得
 		NodeAnimation& rootNodeAnimation = animation->nodeAnimations[modelData_->rootNode.name];
-		translate_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.translate.keyframes, animationTime);
-		rotate_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.rotate.keyframes, animationTime);
-		scale_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.scale.keyframes, animationTime);
+		translate_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.translate, animationTime);
+		rotate_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.rotate, animationTime);
+		scale_ = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.scale, animationTime);
 		localMatrix_ = MatrixMath::MakeAffineMatrix(scale_, rotate_, translate_);
 	}
 }
@@ -112,6 +128,39 @@ void Model::UpdateSkinningFromSkeleton() {
 	// Skeletonのjoint.skeletonSpaceMatrix は AnimatorController が skeleton_->Update() まで済ませている前提
 	skinCluster_.Update(skeleton_.get());
 }
+//=============================================================================
+// パレットの補間(アニメーションLOD)
+//=============================================================================
+
+void Model::BeginPaletteInterpolation(float blend) {
+	if (!haveSkeleton_ || !skeleton_) { return; }
+	skinCluster_.BeginInterpolation(skeleton_.get(), blend);
+}
+
+void Model::EndPaletteInterpolation() {
+	skinCluster_.EndInterpolation();
+}
+
+void Model::WriteInterpolatedPalette(float blend) {
+	if (!haveSkeleton_ || !skeleton_) { return; }
+	skinCluster_.WriteInterpolated(blend);
+}
+
+//=============================================================================
+// パレットの共有
+//=============================================================================
+
+void Model::BuildSkinPalette(std::vector<WellForGPU>& palette) {
+	if (!haveSkeleton_ || !skeleton_) { return; }
+	palette.resize(skinCluster_.mappedPalette.size());
+	skinCluster_.ComputePalette(skeleton_.get(), palette);
+}
+
+void Model::WriteSkinPalette(std::span<const WellForGPU> palette) {
+	if (!haveSkeleton_ || !skeleton_) { return; }
+	skinCluster_.WritePalette(palette);
+}
+
 
 //=============================================================================
 // ImGui更新
@@ -38,12 +38,39 @@ namespace TakeC {
 		/// </summary>
 		void Initialize(TakeC::ModelCommon* ModelCommon,TakeC::ModelData* modelData);
 
+		/// <summary>
+		/// スケルトンとCPU側のパレットだけで初期化する(デバイスを使わない。スキニングのテスト・ベンチマーク用)
+		/// </summary>
+		/// <param name="rootNode">スケルトンの根のノード</param>
+		/// <param name="inverseBindPoseMatrices">ジョイント毎の逆バインドポーズ行列</param>
+		/// <param name="palette">パレットの書き込み先(ジョイント数分)</param>
+		void InitializeSkinningOnly(const Node& rootNode, std::vector<Matrix4x4> inverseBindPoseMatrices, std::span<WellForGPU> palette);
+
 		/// <summary>
 		/// 更新処理
 		/// </summary>
 		void Update(Animation* animation, float animationTime);
 		void UpdateSkinningFromSkeleton();
 
+		/// <summary>
+		/// パレットの補間の開始・終了・書き込み(アニメーションLODで評価を間引く場合に使用)
+		/// </summary>
+		/// <param name="blend">Begin: 直前に表示していた補間率 / Write: 今回の補間率</param>
+		void BeginPaletteInterpolation(float blend);
+		void EndPaletteInterpolation();
+		void WriteInterpolatedPalette(float blend);
+
+		/// <summary>
+		/// 現在のスケルトンからパレットを計算する(書き込みは行わない)
+		/// </summary>
+		/// <param name="palette">計算結果の出力先(ジョイント数に合わせてリサイズする)</param>
+		void BuildSkinPalette(std::vector<WellForGPU>& palette);
+
+		/// <summary>
+		/// 計算済みのパレットを書き込む(同じModelDataのモデルとパレットを共有する場合に使用)
+		/// </summary>
+		void WriteSkinPalette(std::span<const WellForGPU> palette);
+
 		/// <summary>
 		/// ImGui更新
 		/// </summary>
@@ -100,6 +127,8 @@ namespace TakeC {
 		const std::string& GetTextureFilePath() const { return modelData_->material.textureFilePath; }
 		//ローカル行列の取得
 		const Matrix4x4& GetLocalMatrix() const { return localMatrix_; }
+		//SkinningSchedulerに登録された更新のインデックスの取得(未登録ならkNoSkinningTask)
+		uint32_t GetSkinningTaskIndex() const { return skinningTaskIndex_; }
 
 		//----- setter ---------------------------
 		
@@ -107,6 +136,13 @@ namespace TakeC {
 		void SetMesh(TakeC::Mesh* mesh) { mesh_.reset(mesh); }
 		//ModelCommonの設定
 		void SetModelCommon(TakeC::ModelCommon* modelCommon) { modelCommon_ = modelCommon; }
+		//SkinningSchedulerに登録された更新のインデックスの設定
+		void SetSkinningTaskIndex(uint32_t index) { skinningTaskIndex_ = index; }
+
+	public:
+
+		//SkinningSchedulerに未登録であることを表すインデックス
+		static constexpr uint32_t kNoSkinningTask = UINT32_MAX;
 
 	private:
 
@@ -135,5 +171,7 @@ namespace TakeC {
 		bool haveSkeleton_ = true;
 		//inputVertexのインデックス
 		uint32_t inputIndex_ = 0;
+		//SkinningSchedulerに登録された更新のインデックス
+		uint32_t skinningTaskIndex_ = kNoSkinningTask;
 	};
 } // namespace TakeC
\ No newline at end of file
@@ -8,7 +8,10 @@
 #include "CameraManager.h"
 #include "ImGuiManager.h"
 #include "TakeCFrameWork.h"
+#include "Animation/SkinningScheduler.h"
+#include "Vector3Math.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <cassert>
@@ -16,6 +19,10 @@
 using namespace TakeC;
 
 Object3d::~Object3d() {
+	//並列更新の登録が残っていれば取り消す
+	if (model_) {
+		SkinningScheduler::GetInstance().Cancel(model_.get());
+	}
 	wvpResource_.Reset();
 	shadowWvpResource_.Reset();
 	model_ = nullptr;
@@ -96,18 +103,29 @@ void Object3d::Update() {
 	}
 
 	worldPosition_ = MatrixMath::Transform({ 0.0f,0.0f,0.0f }, worldMatrix_);
+
+	//逆転置行列の更新(親がなく一様スケールなら回転・一様スケール専用の計算で済ませる)
+	const Vector3& scale = transform_.scale;
+	if (!parentWorldMatrix_ && scale.x == scale.y && scale.y == scale.z) {
+		WorldInverseTransposeMatrix_ = MatrixMath::InverseTransposeAffineUniformScale(worldMatrix_);
+	} else {
+		WorldInverseTransposeMatrix_ = MatrixMath::InverseTransposeAffine(worldMatrix_);
+	}
 	
 	//Skeletonがある場合は更新
 	if (model_->GetSkeleton()) {
-		WorldInverseTransposeMatrix_ = MatrixMath::InverseTranspose(worldMatrix_);
 		transformMatrixData_->World = worldMatrix_;
 		transformMatrixData_->WVP = WVPMatrix_;
 		transformMatrixData_->WorldInverseTranspose = WorldInverseTransposeMatrix_;
 		//外部からアニメーションを設定する場合はAnimatorControllerの更新
 		//そうでない場合はAnimationUpdateを呼び出す
+		//(スケルトンの更新はSkinningSchedulerに登録し、全モデル分をまとめて並列に処理する)
 		if (useExternalAnimation_) {
 			if (useAnimatorController_) {
-				animatorController_->Update(TakeC::TakeCFrameWork::GetDeltaTime());
+				//LODで評価を間引いた分は、評価するフレームでまとめて進める
+				AnimationLodDecision lod = DecideAnimationLod();
+				float deltaTime = TakeC::TakeCFrameWork::GetDeltaTime() * static_cast<float>(lod.advanceFrames);
+				SkinningScheduler::GetInstance().Enqueue(model_.get(), animatorController_.get(), deltaTime, lod);
 			}
 		}
 		else {
@@ -116,13 +134,11 @@ void Object3d::Update() {
 	} 
 	else { //Skeletonがない場合
 		if (animation_->duration != 0.0f) {
-			WorldInverseTransposeMatrix_ = MatrixMath::InverseTranspose(worldMatrix_);
 			transformMatrixData_->World = model_->GetLocalMatrix() * worldMatrix_;
 			transformMatrixData_->WVP = model_->GetLocalMatrix() * WVPMatrix_;
 			transformMatrixData_->WorldInverseTranspose = WorldInverseTransposeMatrix_;
 			AnimationUpdate();
 		} else {
-			WorldInverseTransposeMatrix_ = MatrixMath::InverseTranspose(worldMatrix_);
 			transformMatrixData_->World = worldMatrix_;
 			transformMatrixData_->WVP = model_->GetModelData()->rootNode.localMatrix * WVPMatrix_;
 			transformMatrixData_->WorldInverseTranspose = WorldInverseTransposeMatrix_;
@@ -144,13 +160,41 @@ void Object3d::AnimationUpdate() {
 		animationTime_ += 1.0f / 60.0f;
 	}
 
-	//スケルトン・スキンクラスターの更新
-	model_->Update(animation_.get(), animationTime_);
+	//スケルトン・スキンクラスターの更新(スケルトンがある場合は並列更新に登録する)
+	if (model_->GetSkeleton()) {
+		//LODで評価する場合は次の評価フレームの姿勢を計算する
+		AnimationLodDecision lod = DecideAnimationLod();
+		float evaluateTime = animationTime_ + static_cast<float>(lod.lookaheadFrames) / 60.0f;
+		if (animation_->duration > 0.0f) {
+			evaluateTime = std::fmod(evaluateTime, animation_->duration);
+		}
+		SkinningScheduler::GetInstance().Enqueue(model_.get(), animation_.get(), evaluateTime, lod);
+	} else {
+		model_->Update(animation_.get(), animationTime_);
+	}
 
 	//最後まで行ったら最初からリピート再生する
 	animationTime_ = std::fmod(animationTime_, animation_->duration);
 }
 
+//=============================================================================
+// アニメーションLODの判定
+//=============================================================================
+
+AnimationLodDecision Object3d::DecideAnimationLod() {
+
+	//カメラがない場合は常に毎フレーム評価する距離として扱う
+	float distance = 0.0f;
+	if (camera_) {
+		const Vector3& cameraPosition = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetTranslate();
+		//大きいモデルほど画面上で大きく見えるので、距離を大きさで割って近いものとして扱う
+		const Vector3& scale = transform_.scale;
+		float size = std::max({ std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z), 0.001f });
+		distance = Vector3Math::Length(worldPosition_ - cameraPosition) / size;
+	}
+	return AnimationLod::GetInstance().Decide(animationLod_, distance);
+}
+
 //=============================================================================
 // ImGuiの更新
 //=============================================================================
@@ -239,6 +283,12 @@ void Object3d::SetWorldMatrix(const Matrix4x4& worldMatrix) {
 void Object3d::SetAnimation(Animation* animation) {
 	if (animation) {
 		animation_ = std::make_unique<Animation>(*animation);
+		//コピーは別のAnimationとして扱わせる(Skeletonの対応表が古いコピーを指さないように)
+		animation_->serial = TakeC::AnimationManager::IssueAnimationSerial();
+		//破棄した古いコピーの対応表が残り続けないよう破棄する
+		if (model_->GetSkeleton()) {
+			model_->GetSkeleton()->ClearAnimationBindings();
+		}
 	}
 	animationTime_ = 0.0f;
 }
\ No newline at end of file
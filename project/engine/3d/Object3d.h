@@ -11,6 +11,7 @@
 #include "engine/math/TransformMatrix.h"
 #include "engine/base/PSOType.h"
 #include "engine/Animation/AnimatorController.h"
+#include "engine/Animation/AnimationLod.h"
 
 namespace TakeC {
 	class Object3dCommon;
@@ -122,6 +123,9 @@ namespace TakeC {
 		//アニメーション処理
 		void AnimationUpdate();
 
+		//アニメーションLODの判定(カメラからの距離をモデルの大きさで割った値で判定する)
+		AnimationLodDecision DecideAnimationLod();
+
 	protected: // privateメンバ変数
 
 		//Object3d共通情報
@@ -144,6 +148,8 @@ namespace TakeC {
 		//アニメーションコントローラー
 		std::unique_ptr<AnimatorController> animatorController_;
 		bool useAnimatorController_ = false;
+		//アニメーションLODの状態
+		AnimationLodState animationLod_;
 		//TransformationMatrix用の頂点リソース
 		ComPtr<ID3D12Resource> wvpResource_;
 		ComPtr<ID3D12Resource> shadowWvpResource_;
@@ -11,6 +11,8 @@
 #include "TextureManager.h"
 #include "engine/base/TakeCFrameWork.h"
 #include "camera/CameraManager.h"
+#include "3d/Particle/ParticleEmitterAllocater.h"
+#include <algorithm>
 #include <numbers>
 
 //=============================================================================
@@ -29,207 +31,225 @@ void BaseParticleGroup::Draw() {
 
 
 //=============================================================================
-// パーティクルの生成
+// パーティクルの発生
+//=============================================================================
+void BaseParticleGroup::Emit(const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount) {
+	EmitBatch(random_, 0, emitterPos, direction, { 1.0f, 1.0f, 1.0f }, particleCount);
+}
+
+void BaseParticleGroup::EmitWithEmitter(uint32_t emitterID, const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount) {
+
+	// エミッター毎の乱数を使い、エミッターのシードを固定すれば同じ発生を再現できるようにする
+	ParticleEmitter* emitter = TakeC::TakeCFrameWork::GetParticleManager()->GetEmitterAllocator()->GetEmitter(emitterID);
+	if (emitter == nullptr) {
+		EmitBatch(random_, emitterID, emitterPos, direction, { 1.0f, 1.0f, 1.0f }, particleCount);
+		return;
+	}
+	EmitBatch(emitter->GetRandom(), emitterID, emitterPos, direction, emitter->GetScale(), particleCount);
+}
+
 //=============================================================================
-Particle BaseParticleGroup::MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate, const Vector3& directoin) {
-
-	ParticleAttributes attributes = particlePreset_.attribute;
-	//スケールをランダムに設定
-	std::uniform_real_distribution<float> distScale(attributes.scaleRange.min, attributes.scaleRange.max);
-	//回転をランダムに設定
-	std::uniform_real_distribution<float> distRotate(attributes.rotateRange.min, attributes.rotateRange.max);
-	//位置をランダムに設定
-	std::uniform_real_distribution<float> distPosition(attributes.positionRange.min, attributes.positionRange.max);
-	//速度をランダムに設定
-	std::uniform_real_distribution<float> distVelocity(attributes.velocityRange.min, attributes.velocityRange.max);
-	//色をランダムに設定
-	std::uniform_real_distribution<float> distColor(attributes.colorRange.min, attributes.colorRange.max);
-	//寿命をランダムに設定
-	std::uniform_real_distribution<float> distTime(attributes.lifetimeRange.min, attributes.lifetimeRange.max);
-
-	Particle particle;
-	particle.transforms_.scale = { attributes.scale.x,attributes.scale.y,attributes.scale.z };
-	// 回転を単位クォータニオンで初期化
-	particle.transforms_.rotate = QuaternionMath::IdentityQuaternion();
-
-	// 回転の設定を条件分岐で明確に分ける
-	if (!attributes.isDirectional && attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Default)) {
+// パーティクルの一括発生
+//=============================================================================
+uint32_t BaseParticleGroup::EmitBatch(FastRandom& random, uint32_t emitterID, const Vector3& emitterPos,
+	const Vector3& direction, const Vector3& emitterScale, uint32_t particleCount) {
+
+	const ParticleAttributes& attributes = particlePreset_.attribute;
+
+	// プールの末尾に領域を確保し、各要素の配列へ直接書き込む
+	const uint32_t begin = particles_.GetCount();
+	const uint32_t count = particles_.Extend(particleCount);
+	const uint32_t end = begin + count;
+	if (count == 0) {
+		return 0;
+	}
+
+	const bool isDefaultTarget = attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Default);
+	const bool isRadial = attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Radial);
+	const bool isConverge = attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Converge);
+
+	//--- スケール・色・寿命などの発生時の初期値 ---
+	const Vector3 scale = {
+		attributes.scale.x * emitterScale.x,
+		attributes.scale.y * emitterScale.y,
+		attributes.scale.z * emitterScale.z };
+	for (uint32_t index = begin; index < end; ++index) {
+		particles_.scale[index] = scale;
+		particles_.trailSpawnTimer[index] = 0.0f;
+		if (particles_.IsTrailEnabled()) {
+			particles_.trailHistory[index] = {};
+		}
+		particles_.emitterID[index] = static_cast<int32_t>(emitterID);
+		particles_.lifeTimer[index].Initialize(
+			random.NextFloat(attributes.lifetimeRange.min, attributes.lifetimeRange.max), 0.0f);
+	}
+
+	//--- 回転 ---
+	if (!attributes.isDirectional && isDefaultTarget) {
 		// ランダムなZ軸回転をクォータニオンとして設定
-		float angle = distRotate(randomEngine);
-		particle.transforms_.rotate = QuaternionMath::MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, angle);
+		for (uint32_t index = begin; index < end; ++index) {
+			float angle = random.NextFloat(attributes.rotateRange.min, attributes.rotateRange.max);
+			particles_.rotate[index] = QuaternionMath::MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, angle);
+		}
+	} else {
+		std::fill(particles_.rotate.begin() + begin, particles_.rotate.begin() + end, QuaternionMath::IdentityQuaternion());
 	}
 
-	Vector3 randomTranslate = { 0.0f, 0.0f, 0.0f };
+	//--- 位置(エミッターからのオフセットは速度の計算まで velocity に置いておく) ---
 	if (attributes.emitterShape == static_cast<uint32_t>(EmitterShape::Sphere)) {
-		// 球面上のランダムな点を計算
-		float phi = std::uniform_real_distribution<float>(0.0f, 2.0f * std::numbers::pi_v<float>)(randomEngine);
-		float costheta = std::uniform_real_distribution<float>(-1.0f, 1.0f)(randomEngine);
-		float theta = std::acos(costheta);
-		float r = distPosition(randomEngine); // positionRange を半径として使用
-
-		randomTranslate.x = r * std::sin(theta) * std::cos(phi);
-		randomTranslate.y = r * std::sin(theta) * std::sin(phi);
-		randomTranslate.z = r * std::cos(theta);
+		// 球面上のランダムな点(sinθ は cosθ から求める)
+		for (uint32_t index = begin; index < end; ++index) {
+			float phi = random.NextFloat(0.0f, 2.0f * std::numbers::pi_v<float>);
+			float cosTheta = random.NextFloat(-1.0f, 1.0f);
+			float sinTheta = std::sqrt((std::max)(0.0f, 1.0f - cosTheta * cosTheta));
+			float r = random.NextFloat(attributes.positionRange.min, attributes.positionRange.max); // positionRange を半径として使用
+			particles_.velocity[index] = { r * sinTheta * std::cos(phi), r * sinTheta * std::sin(phi), r * cosTheta };
+		}
 	} else {
 		// Box内のランダムな点
-		randomTranslate = { distPosition(randomEngine), distPosition(randomEngine), distPosition(randomEngine) };
+		for (uint32_t index = begin; index < end; ++index) {
+			particles_.velocity[index] = {
+				random.NextFloat(attributes.positionRange.min, attributes.positionRange.max),
+				random.NextFloat(attributes.positionRange.min, attributes.positionRange.max),
+				random.NextFloat(attributes.positionRange.min, attributes.positionRange.max) };
+		}
+	}
+	for (uint32_t index = begin; index < end; ++index) {
+		particles_.translate[index] = emitterPos + particles_.velocity[index];
 	}
-	particle.transforms_.translate = translate + randomTranslate;
 
+	//--- 速度と向き ---
+	Quaternion targetRotate;
 	if (attributes.isDirectional) {
-		//方向に沿って移動
-		attributes.direction = directoin;
-		particle.velocity_ = attributes.direction * distVelocity(randomEngine);
-	}
-	else if (attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Radial)) {
-		// 中心から外側に向かうベクトル
-		Vector3 radialDir = randomTranslate;
-		if (Vector3Math::LengthSq(radialDir) > 1e-6f) {
-			radialDir = Vector3Math::Normalize(radialDir);
-		} else {
-			radialDir = { 0.0f, 1.0f, 0.0f }; // フォールバック
+		// 方向に沿って移動(向きは全パーティクル共通なので1回だけ計算する)
+		for (uint32_t index = begin; index < end; ++index) {
+			particles_.velocity[index] = direction * random.NextFloat(attributes.velocityRange.min, attributes.velocityRange.max);
 		}
-		particle.velocity_ = radialDir * distVelocity(randomEngine);
-		attributes.direction = radialDir;
-	}
-	else if (attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Converge)) {
-		// 外側から中心に向かうベクトル
-		Vector3 convergeDir = -randomTranslate;
-		if (Vector3Math::LengthSq(convergeDir) > 1e-6f) {
-			convergeDir = Vector3Math::Normalize(convergeDir);
-		} else {
-			convergeDir = { 0.0f, -1.0f, 0.0f }; // フォールバック
+		if (attributes.alignRotationToEmitter && MakeAlignRotation(direction, targetRotate)) {
+			const Quaternion rotate = BlendAlignRotation(QuaternionMath::IdentityQuaternion(), targetRotate);
+			std::fill(particles_.rotate.begin() + begin, particles_.rotate.begin() + end, rotate);
+		}
+	}
+	else if (isRadial || isConverge) {
+		// 中心から外側(Converge は外側から中心)に向かうベクトル
+		const float sign = isRadial ? 1.0f : -1.0f;
+		const Vector3 fallback = { 0.0f, sign, 0.0f };
+		for (uint32_t index = begin; index < end; ++index) {
+			Vector3 dir = particles_.velocity[index] * sign;
+			dir = Vector3Math::LengthSq(dir) > 1e-6f ? Vector3Math::Normalize(dir) : fallback;
+			particles_.velocity[index] = dir * random.NextFloat(attributes.velocityRange.min, attributes.velocityRange.max);
+
+			if (attributes.alignRotationToEmitter && MakeAlignRotation(dir, targetRotate)) {
+				particles_.rotate[index] = BlendAlignRotation(particles_.rotate[index], targetRotate);
+			}
 		}
-		particle.velocity_ = convergeDir * distVelocity(randomEngine);
-		attributes.direction = convergeDir;
 	}
 	else {
 		//ランダムな方向に飛ばす
-		particle.velocity_ = { distVelocity(randomEngine),distVelocity(randomEngine),distVelocity(randomEngine) };
-	}
-
-	if (attributes.alignRotationToEmitter) {
-
-		Vector3 dir = attributes.direction;
-		if (Vector3Math::LengthSq(dir) > 1e-6f) {
-
-			Vector3 to = Vector3Math::Normalize(dir);
-
-			// パーティクルの基準前方向（ローカル +Z を前と仮定）
-			Vector3 from = { 0.0f, 0.0f, 1.0f };
-			// PrimitiveTypeごとのデフォルトの向きに合わせて基準ベクトルを変更
-			switch (particlePreset_.primitiveType) {
-			case PRIMITIVE_CONE:
-			case PRIMITIVE_CYLINDER:
-				from = { 0.0f, 1.0f, 0.0f }; // 円錐・円柱はY軸が高さ方向
-				break;
-			case PRIMITIVE_PLANE:
-				from = { 0.0f, 0.0f, -1.0f }; // Planeは法線が-Zを向いている
-				break;
-			default:
-				from = { 0.0f, 0.0f, 1.0f }; // その他（Ring, Sphere, Cube）はZ軸基準
-				break;
-			}
-
-			float d = Vector3Math::Dot(from, to);
-			d = std::clamp(d, -1.0f, 1.0f);
-
-			Quaternion targetRotate;
-
-			if (d > 1.0f - 1e-5f) {
-				targetRotate = QuaternionMath::IdentityQuaternion();
-			}
-			else if (d < -1.0f + 1e-5f) {
-				// 真逆(180度)は軸が不定なので、fromと直交する軸を適当に選ぶ
-				Vector3 ortho = (std::fabs(from.y) < 0.999f) ? Vector3{ 0,1,0 } : Vector3{ 1,0,0 };
-				Vector3 axis = Vector3Math::Normalize(Vector3Math::Cross(from, ortho));
-				targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, std::numbers::pi_v<float>);
-			}
-			else {
-				Vector3 axis = Vector3Math::Cross(from, to);
-				axis = Vector3Math::Normalize(axis);
-				float angle = std::acos(d);
-				targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, angle);
-			}
-
-			Quaternion& current = particle.transforms_.rotate;
-
-			// shortest-arc
-			if (QuaternionMath::Dot(current, targetRotate) < 0.0f) {
-				targetRotate = -targetRotate;
+		for (uint32_t index = begin; index < end; ++index) {
+			particles_.velocity[index] = {
+				random.NextFloat(attributes.velocityRange.min, attributes.velocityRange.max),
+				random.NextFloat(attributes.velocityRange.min, attributes.velocityRange.max),
+				random.NextFloat(attributes.velocityRange.min, attributes.velocityRange.max) };
+		}
+		// プリセットの方向へ向ける(目標の回転は全パーティクル共通)
+		if (attributes.alignRotationToEmitter && MakeAlignRotation(attributes.direction, targetRotate)) {
+			for (uint32_t index = begin; index < end; ++index) {
+				particles_.rotate[index] = BlendAlignRotation(particles_.rotate[index], targetRotate);
 			}
-
-			current = Easing::Slerp(current, targetRotate, 0.1f); // 例: 0.05f〜0.3f
-			current = QuaternionMath::Normalize(current);
 		}
-
 	}
 
-
+	//--- 色 ---
 	if (attributes.editColor) {
 		//色を編集する場合
-		particle.color_ = {
-			attributes.color.x,
-			attributes.color.y,
-			attributes.color.z,
-			1.0f };
-	}
-	else {
+		const Vector4 color = { attributes.color.x, attributes.color.y, attributes.color.z, 1.0f };
+		std::fill(particles_.color.begin() + begin, particles_.color.begin() + end, color);
+	} else {
 		//ランダムな色にする場合
-		particle.color_ = { distColor(randomEngine),distColor(randomEngine),distColor(randomEngine),1.0f };
+		for (uint32_t index = begin; index < end; ++index) {
+			particles_.color[index] = {
+				random.NextFloat(attributes.colorRange.min, attributes.colorRange.max),
+				random.NextFloat(attributes.colorRange.min, attributes.colorRange.max),
+				random.NextFloat(attributes.colorRange.min, attributes.colorRange.max),
+				1.0f };
+		}
 	}
-
-	//寿命の設定
-	particle.lifeTimer_.Initialize(distTime(randomEngine), 0.0f);
-	//トレイルエフェクトの親フラグ初期化
-	particle.isTrailParent_ = true;
+	std::copy(particles_.color.begin() + begin, particles_.color.begin() + end, particles_.drawColor.begin() + begin);
 
 	if (attributes.isBillboard == true) {
 		//Billboardの場合
 		perViewData_->isBillboard = true;
 	}
 
-	return particle;
+	return count;
 }
 
-Particle BaseParticleGroup::MakeNewParticleWithEmitter(uint32_t emitterID, std::mt19937& randomEngine, const Vector3& translate, const Vector3& direction) {
-	Particle particle = MakeNewParticle(randomEngine, translate, direction);
-	particle.emitterID_ = emitterID;
+//=============================================================================
+// 指定方向へ向けるための回転の計算
+//=============================================================================
+bool BaseParticleGroup::MakeAlignRotation(const Vector3& dir, Quaternion& targetRotate) const {
+	return MakeAlignRotation(GetAlignForward(particlePreset_.primitiveType), dir, targetRotate);
+}
 
-	// エミッターのスケールを適用
-	if (auto emitterScale = TakeC::TakeCFrameWork::GetParticleManager()->GetEmitterScale(emitterID)) {
-		particle.transforms_.scale.x *= emitterScale->x;
-		particle.transforms_.scale.y *= emitterScale->y;
-		particle.transforms_.scale.z *= emitterScale->z;
+bool BaseParticleGroup::MakeAlignRotation(const Vector3& forward, const Vector3& dir, Quaternion& targetRotate) {
+
+	if (Vector3Math::LengthSq(dir) <= 1e-6f) {
+		return false;
 	}
 
-	return particle;
-}
+	Vector3 to = Vector3Math::Normalize(dir);
+	const Vector3& from = forward;
 
-//=============================================================================
-// パーティクルの発生
-//=============================================================================
-std::list<Particle> BaseParticleGroup::Emit(const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount) {
-	std::list<Particle> particles;
-	for (uint32_t index = 0; index < particleCount; ++index) {
-		particles.push_back(MakeNewParticle(randomEngine_, emitterPos, direction));
+	float d = Vector3Math::Dot(from, to);
+	d = std::clamp(d, -1.0f, 1.0f);
+
+	if (d > 1.0f - 1e-5f) {
+		targetRotate = QuaternionMath::IdentityQuaternion();
+	}
+	else if (d < -1.0f + 1e-5f) {
+		// 真逆(180度)は軸が不定なので、fromと直交する軸を適当に選ぶ
+		Vector3 ortho = (std::fabs(from.y) < 0.999f) ? Vector3{ 0,1,0 } : Vector3{ 1,0,0 };
+		Vector3 axis = Vector3Math::Normalize(Vector3Math::Cross(from, ortho));
+		targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, std::numbers::pi_v<float>);
 	}
-	return particles;
+	else {
+		Vector3 axis = Vector3Math::Cross(from, to);
+		axis = Vector3Math::Normalize(axis);
+		float angle = std::acos(d);
+		targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, angle);
+	}
+	return true;
 }
 
-std::list<Particle> BaseParticleGroup::EmitWithEmitter(uint32_t emitterID, const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount) {
-	std::list<Particle> particles;
-	for (uint32_t index = 0; index < particleCount; ++index) {
-		particles.push_back(MakeNewParticleWithEmitter(emitterID, randomEngine_, emitterPos, direction));
+//=============================================================================
+// 回転を合わせる際の基準前方向
+//=============================================================================
+Vector3 BaseParticleGroup::GetAlignForward(PrimitiveType primitiveType) {
+	// PrimitiveTypeごとのデフォルトの向きに合わせて基準ベクトルを変更
+	switch (primitiveType) {
+	case PRIMITIVE_CONE:
+	case PRIMITIVE_CYLINDER:
+		return { 0.0f, 1.0f, 0.0f }; // 円錐・円柱はY軸が高さ方向
+	case PRIMITIVE_PLANE:
+		return { 0.0f, 0.0f, -1.0f }; // Planeは法線が-Zを向いている
+	default:
+		return { 0.0f, 0.0f, 1.0f }; // その他（Ring, Sphere, Cube）はZ軸基準
 	}
-	return particles;
 }
 
 //=============================================================================
-// パーティクルの配列の結合処理
+// 現在の回転を目標の回転へ近づける
 //=============================================================================
-void BaseParticleGroup::SpliceParticles(std::list<Particle> particles) {
-	particles_.splice(particles_.end(), particles);
+Quaternion BaseParticleGroup::BlendAlignRotation(const Quaternion& current, Quaternion targetRotate, float t) {
+
+	// shortest-arc
+	if (QuaternionMath::Dot(current, targetRotate) < 0.0f) {
+		targetRotate = -targetRotate;
+	}
+
+	Quaternion rotate = Easing::Slerp(current, targetRotate, t);
+	return QuaternionMath::Normalize(rotate);
 }
 
 void BaseParticleGroup::SetPreset(const ParticlePreset& preset) {
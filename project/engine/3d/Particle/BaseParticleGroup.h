@@ -3,32 +3,16 @@
 #include "engine/math/Transform.h"
 #include "engine/math/TransformMatrix.h"
 #include "engine/math/AABB.h"
+#include "engine/math/FastRandom.h"
 #include "engine/3d/Model.h"
 #include "engine/3d/Particle/ParticleAttribute.h"
 #include "engine/3d/Particle/ParticleForGPU.h"
+#include "engine/3d/Particle/ParticlePool.h"
 #include "engine/camera/PerView.h"
 #include "engine/Utility/Timer.h"
 
 #include <d3d12.h>
 #include <wrl.h>
-#include <random>
-#include <list>
-
-//Particle1個分のデータ
-/// <summary>
-/// Particleに必要な値をまとめて保持する構造体です。
-/// </summary>
-struct Particle {
-	QuaternionTransform transforms_;  //位置
-	Vector3 velocity_; 	    //速度
-	Vector4 color_;         //色
-	Timer lifeTimer_;    //寿命タイマー
-
-	float trailSpawnTimer_ = 0.0f; //トレイルエフェクトの生成タイマー
-	bool isTrailParent_ = false; //トレイルエフェクトの親かどうか
-
-	int32_t emitterID_ = 0;  // 0 = エミッター追従なし
-};
 
 // 前方宣言
 class ParticleCommon;
@@ -71,25 +55,26 @@ public:
 	virtual void Draw();
 
 	/// <summary>
-	/// パーティクルの生成
+	/// パーティクルの発生(プールが満杯になった時点で打ち切る)
 	/// </summary>
-	Particle MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate,const Vector3& directoin);
+	void Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
 
-	Particle MakeNewParticleWithEmitter(uint32_t emitterID, std::mt19937& randomEngine, const Vector3& translate, const Vector3& direction);
+	//エミッターID付き(エミッターの乱数とスケールを使用する)
+	void EmitWithEmitter(uint32_t emitterID, const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount);
 
 	/// <summary>
-	/// パーティクルの発生
+	/// パーティクルの一括発生
+	/// プリセット由来の値は発生前に1回だけ解決し、ParticlePoolの末尾へ直接書き込む
 	/// </summary>
-	std::list<Particle> Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
-
-	//エミッターID付き
-	std::list<Particle> EmitWithEmitter(uint32_t emitterID, const Vector3& emitterPos, const Vector3& direction, uint32_t particleCount);
-
-	/// <summary>
-	/// パーティクルの追加
-	/// </summary>
-	/// <param name="particles"></param>
-	void SpliceParticles(std::list<Particle> particles);
+	/// <param name="random">使用する乱数(同じシードなら同じ発生を再現できる)</param>
+	/// <param name="emitterID">追従するエミッターのID(0なら追従なし)</param>
+	/// <param name="emitterPos">発生位置</param>
+	/// <param name="direction">発生方向</param>
+	/// <param name="emitterScale">スケールに掛けるエミッターのスケール</param>
+	/// <param name="particleCount">発生数</param>
+	/// <returns>実際に発生した数(プールが満杯になった時点で打ち切る)</returns>
+	uint32_t EmitBatch(FastRandom& random, uint32_t emitterID, const Vector3& emitterPos,
+		const Vector3& direction, const Vector3& emitterScale, uint32_t particleCount);
 
 public:
 
@@ -105,6 +90,12 @@ public:
 	/// <returns></returns>
 	const ParticlePreset& GetPreset() const { return particlePreset_; }
 
+	/// <summary>
+	/// 生存中のパーティクル数の取得
+	/// </summary>
+	/// <returns></returns>
+	uint32_t GetParticleCount() const { return particles_.GetCount(); }
+
 	//----- setter ---------------
 
 	/// <summary>
@@ -120,6 +111,44 @@ public:
 	void SetEmitterPosition(const Vector3& position);
 	void SetEmitDirection(const Vector3& direction);
 
+	/// <summary>
+	/// エミッターIDを持たない発生で使う乱数のシード設定
+	/// </summary>
+	/// <param name="seed"></param>
+	void SetRandomSeed(uint64_t seed) { random_.SetSeed(seed); }
+
+protected:
+
+	/// <summary>
+	/// 指定方向へ向けるための回転の計算(基準の前方向はPrimitiveTypeで決まる)
+	/// </summary>
+	/// <param name="dir">向ける方向</param>
+	/// <param name="targetRotate">向けた回転</param>
+	/// <returns>方向が0ベクトルに近く計算できない場合false</returns>
+	bool MakeAlignRotation(const Vector3& dir, Quaternion& targetRotate) const;
+
+	/// <summary>
+	/// 基準の前方向を指定方向へ向けるための回転の計算(発生時・更新時の向き合わせで共通)
+	/// </summary>
+	/// <param name="forward">基準の前方向(正規化済み)</param>
+	/// <param name="dir">向ける方向</param>
+	/// <param name="targetRotate">向けた回転</param>
+	/// <returns>方向が0ベクトルに近く計算できない場合false</returns>
+	static bool MakeAlignRotation(const Vector3& forward, const Vector3& dir, Quaternion& targetRotate);
+
+	/// <summary>
+	/// PrimitiveType毎の、回転を合わせる際の基準前方向の取得
+	/// </summary>
+	static Vector3 GetAlignForward(PrimitiveType primitiveType);
+
+	/// <summary>
+	/// 現在の回転を目標の回転へ近づける
+	/// </summary>
+	/// <param name="current">現在の回転</param>
+	/// <param name="targetRotate">目標の回転</param>
+	/// <param name="t">近づける割合(発生時は0.1、更新時は1で目標の回転にする)</param>
+	static Quaternion BlendAlignRotation(const Quaternion& current, Quaternion targetRotate, float t = 0.1f);
+
 protected:
 
 	//Particleの総数
@@ -128,8 +157,8 @@ protected:
 	float kDeltaTime_;
 	//描画するインスタンス数
 	uint32_t numInstance_ = 0; 
-	//Particleの配列
-	std::list<Particle> particles_; 
+	//Particleの配列(要素毎の配列で保持)
+	TakeC::ParticlePool particles_;
 
 	//パーティクルの属性
 	ParticlePreset particlePreset_;
@@ -154,6 +183,6 @@ protected:
 	//ビュー行列用リソース
 	ComPtr<ID3D12Resource> perViewResource_;
 
-	//ランダムエンジン
-	std::mt19937 randomEngine_{ std::random_device{}() };
+	//エミッターIDを持たない発生で使う乱数
+	FastRandom random_;
 };
\ No newline at end of file
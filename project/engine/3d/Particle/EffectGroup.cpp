@@ -397,6 +397,36 @@ void EffectGroup::Reset() {
 	}
 }
 
+//==================================================================================
+// 初期化直後の状態へ戻す
+//==================================================================================
+void EffectGroup::Recycle() {
+	Reset();
+
+	// 前回の使用者が変更したトランスフォーム・状態を戻す
+	transform_.scale = config_.defaultScale;
+	transform_.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+	transform_.translate = { 0.0f, 0.0f, 0.0f };
+	direction_ = { 0.0f, 1.0f, 0.0f };
+	parentMatrix_ = nullptr;
+	isPaused_ = false;
+	isLoopingSuspended_ = false;
+	isPlaying_ = false;
+
+	// エミッター個別の設定も戻す(エミッター本体・プリセットは作り直さない)
+	for (size_t i = 0; i < emitterInstances_.size() && i < config_.emitters.size(); ++i) {
+		EmitterInstance& instance = emitterInstances_[i];
+		instance.config = config_.emitters[i];
+		instance.emitter->SetEmitDirection({ 0.0f, 0.0f, 1.0f });
+		instance.emitter->ReassignEmitterID();
+
+		if (instance.config.autoStart) {
+			isPlaying_ = true;
+		}
+	}
+	UpdateEmitterPositions();
+}
+
 //==================================================================================
 // 特定のエミッターを有効/無効化
 //==================================================================================
@@ -75,6 +75,11 @@ namespace TakeC {
 		/// </summary>
 		void Reset();
 
+		/// <summary>
+		/// 構築済みのエミッターを残したまま、初期化直後の状態へ戻す（プールからの再利用用）
+		/// </summary>
+		void Recycle();
+
 		//======================================================================
 		// トランスフォーム設定
 		//======================================================================
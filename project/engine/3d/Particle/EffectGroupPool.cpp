@@ -0,0 +1,243 @@
+#include "EffectGroupPool.h"
+#include "engine/base/TakeCFrameWork.h"
+#include "engine/base/ImGuiManager.h"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace TakeC;
+
+//=============================================================================
+// コンストラクタ
+//=============================================================================
+EffectGroupPool::EffectGroupPool() : EffectGroupPool([](const std::string& configFilePath) {
+	return TakeCFrameWork::GetJsonLoader()->LoadJsonData<EffectGroupConfig>(configFilePath);
+}) {}
+
+EffectGroupPool::EffectGroupPool(ConfigLoader configLoader) : configLoader_(std::move(configLoader)) {}
+
+//=============================================================================
+// 指定数まで構築
+//=============================================================================
+void EffectGroupPool::Prewarm(const std::string& configFilePath, uint32_t count) {
+
+	Bucket& bucket = GetBucket(configFilePath);
+	bucket.entries.reserve(count);
+	while (bucket.entries.size() < count) {
+		Construct(bucket);
+		++bucket.stats.prewarmCount;
+	}
+}
+
+//=============================================================================
+// 貸し出し
+//=============================================================================
+EffectGroup* EffectGroupPool::Acquire(const std::string& configFilePath) {
+
+	Bucket& bucket = GetBucket(configFilePath);
+
+	if (bucket.freeIndices.empty()) {
+		Construct(bucket);
+		++bucket.stats.missCount;
+	} else {
+		++bucket.stats.hitCount;
+	}
+
+	uint32_t index = bucket.freeIndices.back();
+	bucket.freeIndices.pop_back();
+
+	Entry& entry = bucket.entries[index];
+	entry.isInUse = true;
+	entry.isAutoRelease = false;
+
+	// 前回の使用者の状態を消す
+	entry.effect->Recycle();
+	entry.effect->SetLooping(bucket.config.isLooping);
+
+	bucket.stats.inUseCount++;
+	bucket.stats.peakInUse = (std::max)(bucket.stats.peakInUse, bucket.stats.inUseCount);
+	return entry.effect.get();
+}
+
+//=============================================================================
+// 返却
+//=============================================================================
+void EffectGroupPool::Release(EffectGroup* effect) {
+
+	auto it = locations_.find(effect);
+	assert(it != locations_.end() && "プールで管理していないエフェクトです");
+	if (it == locations_.end()) {
+		return;
+	}
+
+	// PlayOneShotで再生中のものを返却した場合は自動返却の対象から外す
+	Location location = it->second;
+	if (location.bucket->entries[location.index].isAutoRelease) {
+		std::erase(oneShots_, effect);
+	}
+	ReleaseEntry(*location.bucket, location.index);
+}
+
+//=============================================================================
+// 1回再生
+//=============================================================================
+EffectGroup* EffectGroupPool::PlayOneShot(const std::string& configFilePath, const Vector3& position) {
+
+	EffectGroup* effect = Acquire(configFilePath);
+
+	// ループ設定のエフェクトでも1回で終わらせる
+	effect->SetLooping(false);
+	effect->Play(position);
+
+	const Location& location = locations_[effect];
+	location.bucket->entries[location.index].isAutoRelease = true;
+	oneShots_.push_back(effect);
+	return effect;
+}
+
+//=============================================================================
+// 更新処理
+//=============================================================================
+void EffectGroupPool::Update() {
+
+	for (size_t i = 0; i < oneShots_.size();) {
+		EffectGroup* effect = oneShots_[i];
+		effect->Update();
+
+		if (effect->IsFinished()) {
+			// 返却し、末尾と入れ替えて削除
+			const Location& location = locations_[effect];
+			ReleaseEntry(*location.bucket, location.index);
+			oneShots_[i] = oneShots_.back();
+			oneShots_.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+//=============================================================================
+// 全て返却
+//=============================================================================
+void EffectGroupPool::ReleaseAll() {
+
+	for (auto& [path, bucket] : buckets_) {
+		for (uint32_t index = 0; index < bucket.entries.size(); ++index) {
+			if (bucket.entries[index].isInUse) {
+				ReleaseEntry(bucket, index);
+			}
+		}
+	}
+	oneShots_.clear();
+}
+
+//=============================================================================
+// 全て破棄
+//=============================================================================
+void EffectGroupPool::Clear() {
+	oneShots_.clear();
+	locations_.clear();
+	buckets_.clear();
+}
+
+//=============================================================================
+// 統計の取得
+//=============================================================================
+const EffectGroupPool::Stats* EffectGroupPool::GetStats(const std::string& configFilePath) const {
+	auto it = buckets_.find(configFilePath);
+	return it != buckets_.end() ? &it->second.stats : nullptr;
+}
+
+EffectGroupPool::Stats EffectGroupPool::GetTotalStats() const {
+	Stats total;
+	for (const auto& [path, bucket] : buckets_) {
+		total.hitCount += bucket.stats.hitCount;
+		total.missCount += bucket.stats.missCount;
+		total.prewarmCount += bucket.stats.prewarmCount;
+		total.inUseCount += bucket.stats.inUseCount;
+		total.totalCount += bucket.stats.totalCount;
+	}
+	return total;
+}
+
+//=============================================================================
+// ImGui更新処理
+//=============================================================================
+void EffectGroupPool::UpdateImGui() {
+#if defined(_DEBUG) || defined(_DEVELOP)
+	if (ImGui::TreeNode("EffectGroupPool")) {
+		Stats total = GetTotalStats();
+		uint32_t requestCount = total.hitCount + total.missCount;
+		ImGui::Text("Hit / Miss : %u / %u (%.1f%%)", total.hitCount, total.missCount,
+			requestCount > 0 ? 100.0f * total.hitCount / requestCount : 0.0f);
+		ImGui::Text("In Use : %u / %u", total.inUseCount, total.totalCount);
+		ImGui::Text("OneShots : %u", static_cast<uint32_t>(oneShots_.size()));
+
+		for (const auto& [path, bucket] : buckets_) {
+			const Stats& stats = bucket.stats;
+			if (ImGui::TreeNode(path.c_str())) {
+				ImGui::Text("Hit : %u", stats.hitCount);
+				ImGui::Text("Miss : %u", stats.missCount);
+				ImGui::Text("Prewarmed : %u", stats.prewarmCount);
+				ImGui::Text("In Use : %u (Peak %u)", stats.inUseCount, stats.peakInUse);
+				ImGui::Text("Total : %u", stats.totalCount);
+				ImGui::TreePop();
+			}
+		}
+		ImGui::TreePop();
+	}
+#endif // _DEBUG
+}
+
+//=============================================================================
+// 設定ファイルのプールを取得
+//=============================================================================
+EffectGroupPool::Bucket& EffectGroupPool::GetBucket(const std::string& configFilePath) {
+
+	auto it = buckets_.find(configFilePath);
+	if (it != buckets_.end()) {
+		return it->second;
+	}
+
+	// 設定の読み込みは設定ファイル毎に1回だけ行う
+	Bucket& bucket = buckets_[configFilePath];
+	bucket.config = configLoader_(configFilePath);
+	return bucket;
+}
+
+//=============================================================================
+// エフェクトを1つ構築
+//=============================================================================
+void EffectGroupPool::Construct(Bucket& bucket) {
+
+	Entry entry;
+	entry.effect = std::make_unique<EffectGroup>();
+	entry.effect->Initialize(bucket.config);
+
+	// 構築直後から発生しないよう、使うまで停止させておく
+	entry.effect->Stop();
+
+	uint32_t index = static_cast<uint32_t>(bucket.entries.size());
+	locations_[entry.effect.get()] = { &bucket, index };
+	bucket.entries.push_back(std::move(entry));
+	bucket.freeIndices.push_back(index);
+	++bucket.stats.totalCount;
+}
+
+//=============================================================================
+// エントリの返却
+//=============================================================================
+void EffectGroupPool::ReleaseEntry(Bucket& bucket, uint32_t index) {
+
+	Entry& entry = bucket.entries[index];
+	if (!entry.isInUse) {
+		return;
+	}
+
+	// 返却後に発生し続けないよう停止する(発生済みのパーティクルは寿命まで残る)
+	entry.effect->Stop();
+	entry.isInUse = false;
+	entry.isAutoRelease = false;
+	bucket.freeIndices.push_back(index);
+	bucket.stats.inUseCount--;
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include "engine/3d/Particle/EffectGroup.h"
+#include "engine/math/Vector3.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//============================================================================
+// EffectGroupPool class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// 構築済みのEffectGroupをエフェクトの設定ファイル毎にプールして再利用するクラスです。
+	/// 貸し出し時はRecycleで状態を戻すだけで、JSONの読み込みやエミッターの生成を行いません。
+	/// シーンの読み込み時にPrewarmで必要数を作っておくと、再生中のメモリ確保を避けられます。
+	/// </summary>
+	class EffectGroupPool {
+	public:
+
+		/// <summary>
+		/// 設定ファイル毎の貸し出し統計
+		/// </summary>
+		struct Stats {
+			uint32_t hitCount = 0;    //プールから再利用した回数
+			uint32_t missCount = 0;   //空きがなく新しく構築した回数
+			uint32_t prewarmCount = 0;//Prewarmで構築した数
+			uint32_t inUseCount = 0;  //貸し出し中の数
+			uint32_t peakInUse = 0;   //貸し出し中の数の最大値
+			uint32_t totalCount = 0;  //構築済みの総数
+		};
+
+		/// <summary>
+		/// 設定ファイルから設定を読み込む関数
+		/// </summary>
+		using ConfigLoader = std::function<EffectGroupConfig(const std::string& configFilePath)>;
+
+	public:
+
+		/// <summary>
+		/// コンストラクタ(設定はJsonLoaderで読み込む)
+		/// </summary>
+		EffectGroupPool();
+
+		/// <summary>
+		/// 設定の読み込み方を指定するコンストラクタ(JsonLoaderを使わないテストなど)
+		/// </summary>
+		/// <param name="configLoader">設定ファイル毎に1回だけ呼ばれる読み込み関数</param>
+		explicit EffectGroupPool(ConfigLoader configLoader);
+
+		~EffectGroupPool() = default;
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// 指定数まで構築しておく(不足分のみ構築する)
+		/// </summary>
+		/// <param name="configFilePath">エフェクトの設定ファイル</param>
+		/// <param name="count">プールに用意しておく数</param>
+		void Prewarm(const std::string& configFilePath, uint32_t count);
+
+		/// <summary>
+		/// エフェクトを貸し出す(空きがなければ新しく構築する)
+		/// 返したエフェクトの更新は呼び出し側で行い、不要になったらReleaseで返却する
+		/// </summary>
+		/// <param name="configFilePath">エフェクトの設定ファイル</param>
+		/// <returns>初期化直後の状態のエフェクト</returns>
+		EffectGroup* Acquire(const std::string& configFilePath);
+
+		/// <summary>
+		/// エフェクトを返却する
+		/// </summary>
+		/// <param name="effect">Acquireで貸し出したエフェクト</param>
+		void Release(EffectGroup* effect);
+
+		/// <summary>
+		/// 指定位置で1回再生し、終了したら自動で返却する
+		/// </summary>
+		/// <param name="configFilePath">エフェクトの設定ファイル</param>
+		/// <param name="position">再生位置</param>
+		/// <returns>再生したエフェクト(自動で返却されるため保持しないこと)</returns>
+		EffectGroup* PlayOneShot(const std::string& configFilePath, const Vector3& position);
+
+		/// <summary>
+		/// 更新処理(PlayOneShotで再生したエフェクトの更新と返却。ParticleManager::Updateの前に呼ぶ)
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// 貸し出し中のエフェクトを全て停止して返却する(シーン切り替え時用)
+		/// </summary>
+		void ReleaseAll();
+
+		/// <summary>
+		/// 全てのエフェクトを破棄する
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// ImGui更新処理
+		/// </summary>
+		void UpdateImGui();
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//設定ファイル毎の統計の取得(未使用の設定ファイルの場合はnullptr)
+		const Stats* GetStats(const std::string& configFilePath) const;
+		//全設定ファイルの統計の合計の取得(peakInUseは集計しない)
+		Stats GetTotalStats() const;
+
+	private:
+
+		/// <summary>
+		/// プール内の1エフェクト
+		/// </summary>
+		struct Entry {
+			std::unique_ptr<EffectGroup> effect;
+			bool isInUse = false;       //貸し出し中かどうか
+			bool isAutoRelease = false; //終了時に自動で返却するかどうか
+		};
+
+		/// <summary>
+		/// 設定ファイル毎のプール
+		/// </summary>
+		struct Bucket {
+			EffectGroupConfig config;     //読み込み済みの設定(構築時に使い回す)
+			std::vector<Entry> entries;   //構築済みのエフェクト
+			std::vector<uint32_t> freeIndices; //空いているエントリのインデックス
+			Stats stats;
+		};
+
+		/// <summary>
+		/// エフェクトの所属先
+		/// </summary>
+		struct Location {
+			Bucket* bucket = nullptr;
+			uint32_t index = 0;
+		};
+
+	private:
+
+		/// <summary>
+		/// 設定ファイルのプールを取得(なければ設定を読み込んで作成)
+		/// </summary>
+		Bucket& GetBucket(const std::string& configFilePath);
+
+		/// <summary>
+		/// エフェクトを1つ構築して空きに加える
+		/// </summary>
+		void Construct(Bucket& bucket);
+
+		/// <summary>
+		/// エントリを返却する
+		/// </summary>
+		void ReleaseEntry(Bucket& bucket, uint32_t index);
+
+	private:
+
+		ConfigLoader configLoader_; //設定の読み込み
+		std::unordered_map<std::string, Bucket> buckets_;
+		std::unordered_map<const EffectGroup*, Location> locations_; //エフェクト → 所属先
+		std::vector<EffectGroup*> oneShots_; //PlayOneShotで再生中のエフェクト
+	};
+}
+
+using TakeC::EffectGroupPool;
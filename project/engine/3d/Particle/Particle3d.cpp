@@ -48,6 +48,9 @@ void Particle3d::Initialize(ParticleCommon* particleCommon, const std::string& f
 	//Mapping
 	particleResource_->Map(0, nullptr, reinterpret_cast<void**>(&particleData_));
 
+	//パーティクル配列の初期化
+	particles_.Initialize(kNumMaxInstance_);
+
 	ParticleAttributes& attributes = particlePreset_.attribute;
 
 	//属性初期化
@@ -70,45 +73,30 @@ void Particle3d::Initialize(ParticleCommon* particleCommon, const std::string& f
 //=============================================================================
 
 void Particle3d::Update() {
-	numInstance_ = 0;
-	for (std::list<Particle>::iterator particleIterator = particles_.begin();
-		particleIterator != particles_.end(); ) {
-
-		// MEMO: Particleの総出現数だけ繰り返す  
-		if (numInstance_ < kNumMaxInstance_) {
-
-			// 寿命が来たら削除  
-			if ((*particleIterator).lifeTimer_.IsFinished()) {
-				particleIterator = particles_.erase(particleIterator);
-				continue;
-			}
-
-			// particle1つの位置更新  
-			UpdateMovement(particleIterator);
-			//alphaの計算
-			float alpha = 1.0f - ((*particleIterator).lifeTimer_.GetProgress());
-
-			particleData_[numInstance_].color = {
-				(*particleIterator).color_.x,
-				(*particleIterator).color_.y,
-				(*particleIterator).color_.z,
-				alpha
-			};
-			particleData_[numInstance_].scale = (*particleIterator).transforms_.scale;
-			particleData_[numInstance_].rotate = (*particleIterator).transforms_.rotate;
-			particleData_[numInstance_].translate = (*particleIterator).transforms_.translate;
-			particleData_[numInstance_].velocity = (*particleIterator).velocity_;
-			particleData_[numInstance_].lifeTime = (*particleIterator).lifeTimer_.GetDuration();
-			particleData_[numInstance_].currentTime = (*particleIterator).lifeTimer_.GetProgress() * (*particleIterator).lifeTimer_.GetDuration();
-
-			// データをGPUに転送  
-			perViewData_->viewProjection = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetViewProjectionMatrix();
-			perViewData_->billboardMatrix = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetRotationMatrix();
-
-			++numInstance_; // 次のインスタンスに進める  
+	for (uint32_t index = 0; index < particles_.GetCount(); ) {
+
+		// 寿命が来たら削除(末尾の要素がindexに入るので、indexは進めない)
+		if (particles_.lifeTimer[index].IsFinished()) {
+			particles_.Remove(index);
+			continue;
 		}
-		++particleIterator; // 次のイテレータに進める  
+
+		// particle1つの位置更新  
+		UpdateMovement(index);
+		//alphaの計算
+		float alpha = 1.0f - particles_.lifeTimer[index].GetProgress();
+
+		const Vector4& color = particles_.color[index];
+		particles_.drawColor[index] = { color.x, color.y, color.z, alpha };
+		particles_.WriteForGPU(index, particleData_[index]);
+
+		++index; // 次のパーティクルに進める  
 	}
+	numInstance_ = particles_.GetCount();
+
+	// データをGPUに転送  
+	perViewData_->viewProjection = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetViewProjectionMatrix();
+	perViewData_->billboardMatrix = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetRotationMatrix();
 }
 
 //=============================================================================
@@ -149,30 +137,13 @@ void Particle3d::Draw() {
 
 
 
-//=============================================================================
-// パーティクルの生成
-//=============================================================================
-
-Particle Particle3d::MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate,const Vector3& direction) {
-
-	return BaseParticleGroup::MakeNewParticle(randomEngine,direction, translate);
-}
-
 //=============================================================================
 // パーティクルの発生
 //=============================================================================
 
-std::list<Particle> Particle3d::Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount) {
-
-	return BaseParticleGroup::Emit(emitterPos,direction, particleCount);
-}
-
-//=============================================================================
-// パーティクルの配列の結合処理
-//=============================================================================
+void Particle3d::Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount) {
 
-void Particle3d::SpliceParticles(std::list<Particle> particles) {
-	BaseParticleGroup::SpliceParticles(particles);
+	BaseParticleGroup::Emit(emitterPos,direction, particleCount);
 }
 
 //=============================================================================
@@ -183,30 +154,33 @@ void Particle3d::SetModel(const std::string& filePath) {
 	model_ = TakeC::ModelManager::GetInstance().FindModel(filePath);
 }
 
-void Particle3d::UpdateMovement(std::list<Particle>::iterator particleIterator) {
+void Particle3d::UpdateMovement(uint32_t index) {
 	//particle1つの位置更新
 	ParticleAttributes& attributes = particlePreset_.attribute;
+	Vector3& translate = particles_.translate[index];
+	Vector3& scale = particles_.scale[index];
+	Timer& lifeTimer = particles_.lifeTimer[index];
 
 	if (attributes.isTranslate) {
 		if (attributes.enableFollowEmitter) {
 			//エミッターに追従する場合
-			(*particleIterator).transforms_.translate = emitterPos_;
+			translate = emitterPos_;
 		} else {
-			(*particleIterator).transforms_.translate += (*particleIterator).velocity_ * kDeltaTime_;
+			translate += particles_.velocity[index] * kDeltaTime_;
 			
 		}
 	}
 
 	if (attributes.scaleSetting) {
 		//スケールの更新
-		(*particleIterator).transforms_.scale.x = Easing::Lerp(
+		scale.x = Easing::Lerp(
 			attributes.scaleRange.min,
 			attributes.scaleRange.max,
-			(*particleIterator).lifeTimer_.GetProgress());
+			lifeTimer.GetProgress());
 
-		(*particleIterator).transforms_.scale.y = (*particleIterator).transforms_.scale.x;
-		(*particleIterator).transforms_.scale.z = (*particleIterator).transforms_.scale.x;
+		scale.y = scale.x;
+		scale.z = scale.x;
 	}
 	//経過時間の更新
-	(*particleIterator).lifeTimer_.Update();
+	lifeTimer.Update();
 }
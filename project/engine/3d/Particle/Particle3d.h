@@ -52,20 +52,10 @@ public:
 	/// <param name="preset"></param>
 	void SetPreset(const ParticlePreset& preset) override { particlePreset_ = preset; }
 
-	/// <summary>
-	/// パーティクルの生成
-	/// </summary>
-	Particle MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate,const Vector3& direction);
-
 	/// <summary>
 	/// パーティクルの発生
 	/// </summary>
-	std::list<Particle> Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
-
-	/// <summary>
-	/// パーティクルの配列の結合処理
-	/// </summary>
-	void SpliceParticles(std::list<Particle> particles);
+	void Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
 
 private:
 
@@ -83,5 +73,6 @@ private:
 	/// <summary>
 	/// パーティクルの移動更新
 	/// </summary>
-	void UpdateMovement(std::list<Particle>::iterator particleIterator);
+	/// <param name="index">ParticlePool内のインデックス</param>
+	void UpdateMovement(uint32_t index);
 };
\ No newline at end of file
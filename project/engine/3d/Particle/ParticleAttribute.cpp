@@ -46,6 +46,8 @@ void to_json(nlohmann::json& j, const ParticleAttributes& attributes) {
 	j["colorEasingType"] = attributes.colorEasingType;
 	j["gravity"] = attributes.gravity;
 	j["enableGravity"] = attributes.enableGravity;
+	j["budgetPriority"] = attributes.budgetPriority;
+	j["depthSortMode"] = attributes.depthSortMode;
 }
 
 //============================================================================
@@ -134,6 +136,8 @@ void from_json(const nlohmann::json& j, ParticleAttributes& attributes) {
 	attributes.colorEasingType = j.value("colorEasingType", attributes.colorEasingType);
 	attributes.gravity = j.value("gravity", attributes.gravity);
 	attributes.enableGravity = j.value("enableGravity", attributes.enableGravity);
+	attributes.budgetPriority = j.value("budgetPriority", attributes.budgetPriority);
+	attributes.depthSortMode = j.value("depthSortMode", attributes.depthSortMode);
 }
 
 //============================================================================
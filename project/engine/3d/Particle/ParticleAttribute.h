@@ -52,6 +52,20 @@ enum class ScaleSetting {
 	ScaleDown = 2, //スケールの更新(縮小)
 };
 
+// 発生予算が足りない時の優先度を表す列挙型
+enum class ParticlePriority {
+	Low = 0,    //上限の7割まで
+	Normal = 1, //上限の9割まで
+	High = 2,   //上限まで
+};
+
+// 半透明描画時の深度ソートの方法を表す列挙型
+enum class DepthSortMode {
+	None = 0,         //ソートしない(格納順に描画)
+	Always = 1,       //毎フレーム奥から手前に並べる
+	OnCameraMove = 2, //カメラが一定以上動いた時だけ並べ直す
+};
+
 // パーティクルの属性を保持する構造体
 /// <summary>
 /// ParticleAttributesに必要な値をまとめて保持する構造体です。
@@ -84,17 +98,20 @@ struct ParticleAttributes {
 	bool isEmitterTrail = false;         //エミッターの移動に応じてトレイルを生成するかどうか
 	bool isParticleTrail = false;        //パーティクルによるトレイルを有効にするかどうか
 	uint32_t scaleSetting = 0;           //スケールの更新処理方法
-	uint32_t particlesPerInterpolation = 5; //一度の補間で生成するパーティクル数
+	uint32_t particlesPerInterpolation = 5; //トレイルの1区間(軌跡のサンプル間)に描画するインスタンス数
 	uint32_t emitCount = 1;                 //1回あたりのパーティクル発生数
 	
 	uint32_t emitterShape = 0;              // エミッターの形状（Box/Sphere）
 	uint32_t velocityTarget = 0;            // 速度の方向（Default/Radial/Converge）
 	bool isDecelerate = false;              // スパーク用：徐々に減速するかどうか
 
-	float trailEmitInterval = 0.016f; //トレイルエフェクトの生成間隔
+	float trailEmitInterval = 0.016f; //トレイルの軌跡を記録する間隔
 
 	Vector3 gravity = { 0.0f,0.0f,0.0f }; //重力
 	bool enableGravity = false; //重力を有効にするかどうか
+
+	uint32_t budgetPriority = static_cast<uint32_t>(ParticlePriority::Normal); //発生予算が足りない時の優先度
+	uint32_t depthSortMode = static_cast<uint32_t>(DepthSortMode::Always); //半透明描画時の深度ソートの方法
 };
 
 // パーティクルプリセットを保持する構造体
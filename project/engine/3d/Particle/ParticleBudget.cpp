@@ -0,0 +1,159 @@
+#include "ParticleBudget.h"
+#include "engine/base/ImGuiManager.h"
+#include "engine/math/Vector3Math.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+using namespace TakeC;
+
+//=============================================================================
+// 初期化
+//=============================================================================
+void ParticleBudget::Initialize(uint32_t maxParticles) {
+	maxParticles_ = maxParticles;
+	liveCount_ = 0;
+	hasView_ = false;
+	culledEmitCount_ = 0;
+	droppedCount_ = 0;
+}
+
+//=============================================================================
+// フレームの開始
+//=============================================================================
+void ParticleBudget::BeginFrame(uint32_t liveCount) {
+	liveCount_ = liveCount;
+	culledEmitCount_ = 0;
+	droppedCount_ = 0;
+}
+
+//=============================================================================
+// カメラの設定
+//=============================================================================
+void ParticleBudget::SetView(const Matrix4x4& viewProjection, const Vector3& cameraPosition) {
+
+	cameraPosition_ = cameraPosition;
+	hasView_ = true;
+
+	// 行ベクトル(v * M)の行列から視錐台の6平面を取り出す
+	auto column = [&viewProjection](int index) {
+		return Vector4{ viewProjection.m[0][index], viewProjection.m[1][index], viewProjection.m[2][index], viewProjection.m[3][index] };
+	};
+	const Vector4 c0 = column(0);
+	const Vector4 c1 = column(1);
+	const Vector4 c2 = column(2);
+	const Vector4 c3 = column(3);
+
+	frustumPlanes_[0] = { c3.x + c0.x, c3.y + c0.y, c3.z + c0.z, c3.w + c0.w }; // 左
+	frustumPlanes_[1] = { c3.x - c0.x, c3.y - c0.y, c3.z - c0.z, c3.w - c0.w }; // 右
+	frustumPlanes_[2] = { c3.x + c1.x, c3.y + c1.y, c3.z + c1.z, c3.w + c1.w }; // 下
+	frustumPlanes_[3] = { c3.x - c1.x, c3.y - c1.y, c3.z - c1.z, c3.w - c1.w }; // 上
+	frustumPlanes_[4] = { c2.x, c2.y, c2.z, c2.w };                             // 近(z: 0～1)
+	frustumPlanes_[5] = { c3.x - c2.x, c3.y - c2.y, c3.z - c2.z, c3.w - c2.w }; // 遠
+
+	// 距離で判定できるように法線を正規化する
+	for (Vector4& plane : frustumPlanes_) {
+		float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f) {
+			plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+		}
+	}
+}
+
+//=============================================================================
+// 発生数の割り当て
+//=============================================================================
+uint32_t ParticleBudget::RequestEmit(const ParticleAttributes& attributes, const Vector3& position, uint32_t count) {
+
+	if (count == 0) {
+		return 0;
+	}
+
+	// 画面外のエミッターは発生させない
+	float rate = ComputeEmitRate(attributes, position);
+	if (rate <= 0.0f) {
+		++culledEmitCount_;
+		droppedCount_ += count;
+		return 0;
+	}
+
+	// 距離に応じて間引く(端数は確率で切り上げ、平均の発生率を保つ)
+	uint32_t scaledCount = count;
+	if (rate < 1.0f) {
+		float exactCount = static_cast<float>(count) * rate;
+		scaledCount = static_cast<uint32_t>(exactCount);
+		if (random_.NextFloat() < exactCount - static_cast<float>(scaledCount)) {
+			++scaledCount;
+		}
+	}
+
+	// 優先度毎の上限までに収める
+	uint32_t priority = (std::min)(attributes.budgetPriority, static_cast<uint32_t>(kPriorityShare_.size() - 1));
+	uint32_t limit = static_cast<uint32_t>(static_cast<float>(maxParticles_) * kPriorityShare_[priority]);
+	uint32_t allowed = liveCount_ < limit ? (std::min)(scaledCount, limit - liveCount_) : 0;
+
+	droppedCount_ += count - allowed;
+	liveCount_ += allowed;
+	return allowed;
+}
+
+//=============================================================================
+// 発生位置の発生率
+//=============================================================================
+float ParticleBudget::ComputeEmitRate(const ParticleAttributes& attributes, const Vector3& position) const {
+
+	if (!hasView_) {
+		return 1.0f;
+	}
+
+	// 発生範囲を含む球で視錐台と判定する
+	if (enableCulling_) {
+		float extent = (std::max)(std::fabs(attributes.positionRange.min), std::fabs(attributes.positionRange.max));
+		if (!IsVisible(position, extent * std::numbers::sqrt3_v<float> + kCullMargin_)) {
+			return 0.0f;
+		}
+	}
+
+	// lodNear_ までは全て発生させ、lodFar_ で minEmitRate_ になるよう線形に下げる
+	float distance = Vector3Math::Length(position - cameraPosition_);
+	if (distance <= lodNear_ || lodFar_ <= lodNear_) {
+		return 1.0f;
+	}
+	float t = (std::min)((distance - lodNear_) / (lodFar_ - lodNear_), 1.0f);
+	return 1.0f + (minEmitRate_ - 1.0f) * t;
+}
+
+//=============================================================================
+// 球が視錐台と重なるかどうか
+//=============================================================================
+bool ParticleBudget::IsVisible(const Vector3& center, float radius) const {
+	for (const Vector4& plane : frustumPlanes_) {
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//=============================================================================
+// ImGui更新処理
+//=============================================================================
+void ParticleBudget::UpdateImGui() {
+#if defined(_DEBUG) || defined(_DEVELOP)
+	if (ImGui::TreeNode("Budget")) {
+		ImGui::Text("Live : %u / %u", liveCount_, maxParticles_);
+		ImGui::Text("Culled Emits : %u", culledEmitCount_);
+		ImGui::Text("Dropped : %u", droppedCount_);
+
+		int maxParticles = static_cast<int>(maxParticles_);
+		if (ImGui::DragInt("Max Particles", &maxParticles, 256.0f, 0, 1 << 20)) {
+			maxParticles_ = static_cast<uint32_t>((std::max)(maxParticles, 0));
+		}
+		ImGui::DragFloat("LOD Near", &lodNear_, 0.5f, 0.0f, 1000.0f);
+		ImGui::DragFloat("LOD Far", &lodFar_, 0.5f, 0.0f, 1000.0f);
+		ImGui::SliderFloat("Min Emit Rate", &minEmitRate_, 0.0f, 1.0f);
+		ImGui::Checkbox("Enable Culling", &enableCulling_);
+		ImGui::TreePop();
+	}
+#endif // _DEBUG
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "engine/3d/Particle/ParticleAttribute.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/Matrix4x4.h"
+#include "engine/math/Vector3.h"
+#include "engine/math/Vector4.h"
+#include <array>
+#include <cstdint>
+
+//============================================================================
+// ParticleBudget class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// 全パーティクルグループ共通の発生予算を管理するクラスです。
+	/// 生存数の上限(プリセットの優先度毎に使える割合が異なる)、カメラからの距離による発生数の間引き、
+	/// 画面外のエミッターの発生停止を行い、負荷の大きい場面でも更新・描画の数を一定以下に保ちます。
+	/// </summary>
+	class ParticleBudget {
+	public:
+
+		ParticleBudget() = default;
+		~ParticleBudget() = default;
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="maxParticles">全グループ合計の生存数の上限</param>
+		void Initialize(uint32_t maxParticles = kDefaultMaxParticles_);
+
+		/// <summary>
+		/// フレームの開始(生存数の設定と統計のリセット)
+		/// </summary>
+		/// <param name="liveCount">全グループ合計の生存数</param>
+		void BeginFrame(uint32_t liveCount);
+
+		/// <summary>
+		/// 距離・視錐台の判定に使うカメラの設定
+		/// </summary>
+		/// <param name="viewProjection">ビュープロジェクション行列</param>
+		/// <param name="cameraPosition">カメラのワールド座標</param>
+		void SetView(const Matrix4x4& viewProjection, const Vector3& cameraPosition);
+
+		/// <summary>
+		/// カメラの解除(距離による間引きと画面外判定を行わない)
+		/// </summary>
+		void ClearView() { hasView_ = false; }
+
+		/// <summary>
+		/// 発生数の割り当て。割り当てた数はこのフレームの生存数に加算される
+		/// </summary>
+		/// <param name="attributes">発生させるパーティクルの属性(優先度・発生範囲)</param>
+		/// <param name="position">発生位置</param>
+		/// <param name="count">発生させたい数</param>
+		/// <returns>発生してよい数</returns>
+		uint32_t RequestEmit(const ParticleAttributes& attributes, const Vector3& position, uint32_t count);
+
+		/// <summary>
+		/// 生存数の上限までの残り
+		/// </summary>
+		uint32_t GetRemaining() const { return liveCount_ < maxParticles_ ? maxParticles_ - liveCount_ : 0; }
+
+		/// <summary>
+		/// ImGui更新処理
+		/// </summary>
+		void UpdateImGui();
+
+	public:
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//----- getter ---------------
+
+		//生存数の上限
+		uint32_t GetMaxParticles() const { return maxParticles_; }
+		//生存数(このフレームに割り当てた数を含む)
+		uint32_t GetLiveCount() const { return liveCount_; }
+		//このフレームに画面外で発生しなかった回数
+		uint32_t GetCulledEmitCount() const { return culledEmitCount_; }
+		//このフレームに間引き・上限で発生しなかった数
+		uint32_t GetDroppedCount() const { return droppedCount_; }
+
+		//----- setter ---------------
+
+		//生存数の上限
+		void SetMaxParticles(uint32_t maxParticles) { maxParticles_ = maxParticles; }
+		//発生数を間引き始める距離と、最小の発生率になる距離
+		void SetLodDistance(float nearDistance, float farDistance) { lodNear_ = nearDistance; lodFar_ = farDistance; }
+		//最も遠い距離での発生率
+		void SetMinEmitRate(float rate) { minEmitRate_ = rate; }
+		//画面外のエミッターの発生を止めるかどうか
+		void SetEnableCulling(bool enable) { enableCulling_ = enable; }
+		//間引きの端数処理に使う乱数のシード
+		void SetRandomSeed(uint64_t seed) { random_.SetSeed(seed); }
+
+	public:
+
+		static const uint32_t kDefaultMaxParticles_ = 65536; //生存数の上限の既定値
+
+	private:
+
+		/// <summary>
+		/// 発生位置の発生率(画面外なら0、距離に応じて minEmitRate_～1)
+		/// </summary>
+		float ComputeEmitRate(const ParticleAttributes& attributes, const Vector3& position) const;
+
+		/// <summary>
+		/// 球が視錐台と重なるかどうか
+		/// </summary>
+		bool IsVisible(const Vector3& center, float radius) const;
+
+	private:
+
+		// 優先度毎に使える生存数の上限の割合(低い優先度は上限の手前で止め、高い優先度の分を残す)
+		static constexpr std::array<float, 3> kPriorityShare_ = { 0.7f, 0.9f, 1.0f };
+		// 視錐台判定で発生範囲に足す余白
+		static constexpr float kCullMargin_ = 1.0f;
+
+		uint32_t maxParticles_ = kDefaultMaxParticles_;
+		uint32_t liveCount_ = 0;
+
+		// 距離による間引き
+		float lodNear_ = 30.0f;
+		float lodFar_ = 150.0f;
+		float minEmitRate_ = 0.2f;
+
+		// カメラ
+		bool hasView_ = false;
+		bool enableCulling_ = true;
+		Vector3 cameraPosition_ = { 0.0f, 0.0f, 0.0f };
+		std::array<Vector4, 6> frustumPlanes_ = {}; //(nx, ny, nz, d) 内側が正
+
+		// 統計
+		uint32_t culledEmitCount_ = 0;
+		uint32_t droppedCount_ = 0;
+
+		// 間引き後の端数を確率で切り上げるための乱数
+		FastRandom random_{ 0x5EEDull };
+	};
+}
+
+using TakeC::ParticleBudget;
@@ -233,6 +233,18 @@ void ParticleEditor::DrawParticleAttributesEditor() {
 	ImGui::SliderInt("Particles Per Interpolation", reinterpret_cast<int*>(&attributes.particlesPerInterpolation), 1, 20);
 	ImGui::DragFloat("Trail Emit Interval", &attributes.trailEmitInterval, 0.001f, 0.001f, 1.0f);
 
+	const char* priorityItems[] = { "Low", "Normal", "High" };
+	int currentPriority = static_cast<int>(attributes.budgetPriority);
+	if (ImGui::Combo("Budget Priority", &currentPriority, priorityItems, IM_ARRAYSIZE(priorityItems))) {
+		attributes.budgetPriority = static_cast<uint32_t>(currentPriority);
+	}
+
+	const char* depthSortItems[] = { "None", "Always", "On Camera Move" };
+	int currentDepthSort = static_cast<int>(attributes.depthSortMode);
+	if (ImGui::Combo("Depth Sort", &currentDepthSort, depthSortItems, IM_ARRAYSIZE(depthSortItems))) {
+		attributes.depthSortMode = static_cast<uint32_t>(currentDepthSort);
+	}
+
 	//設定の適用
 	if (ImGui::Button("Apply Attributes")) {
 		// 現在のグループに属性を適用
@@ -162,4 +162,13 @@ void ParticleEmitter::SetParticleName(const std::string& particleName) {
 void ParticleEmitter::Reset() {
 	frequencyTime_ = frequency_; // 最初から発生するようにリセット
 	prevTranslate_ = transforms_.translate; // 位置もリセットしてトレイルが変な場所に伸びないようにする
+}
+
+//==================================================================================
+// エミッターIDの振り直し
+//==================================================================================
+void ParticleEmitter::ReassignEmitterID() {
+	// 解放すると世代が進むため、古いIDを持つパーティクルからは参照されなくなる
+	TakeC::TakeCFrameWork::GetParticleManager()->EmitterRelease(emitterID_);
+	emitterID_ = TakeC::TakeCFrameWork::GetParticleManager()->EmitterAllocate(this);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "engine/base/PipelineStateObject.h"
 #include "engine/base/PerFrame.h"
 #include "engine/3d/Particle/ParticleAttribute.h"
+#include "engine/math/FastRandom.h"
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -74,6 +75,11 @@ public:
 	/// </summary>
 	void Reset();
 
+	/// <summary>
+	/// エミッターIDを振り直す(プールから再利用する際、前回の使用者が発生させた追従パーティクルを切り離す)
+	/// </summary>
+	void ReassignEmitterID();
+
 public:
 
 	//==================================================================================
@@ -102,6 +108,9 @@ public:
 	//スケール取得
 	const Vector3& GetScale() const { return transforms_.scale; }
 
+	//パーティクル発生用の乱数取得
+	FastRandom& GetRandom() { return random_; }
+
 	//----- setter ---------------
 
 	//発生させるParticleの名前設定
@@ -124,6 +133,8 @@ public:
 	void SetParticleCount(uint32_t count) { particleCount_ = count; }
 	//発生方向設定
 	void SetEmitDirection(const Vector3& direction) { emitDirection_ = direction; }
+	//パーティクル発生用の乱数のシード設定(同じシードなら同じ発生を再現できる)
+	void SetRandomSeed(uint64_t seed) { random_.SetSeed(seed); }
 
 private:
 
@@ -141,6 +152,7 @@ private:
 	Vector3 emitDirection_; //発生方向
 	std::string emitterName_; //emitterの名前
 	std::string particleName_; //発生させるParticleの名前
+	FastRandom random_; //パーティクル発生用の乱数
 
 	uint32_t particlesPerInterpolation = 5; //一度の補間で生成するパーティクル数
 	float trailEmitInterval = 0.016f; //トレイルエフェクトの生成間隔
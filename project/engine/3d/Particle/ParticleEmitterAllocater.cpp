@@ -8,42 +8,54 @@ uint32_t ParticleEmitterAllocator::Allocate(ParticleEmitter* emitter) {
 	assert(emitter != nullptr && "エミッターがnullptrです");
 
 	// 上限に達していないかチェック
-	assert(activeEmitters_.size() < kMaxEmitterCount_ && "エミッターの上限に達しています");
+	assert(activeEmitterCount_ < kMaxEmitterCount_ && "エミッターの上限に達しています");
 
-	uint32_t emitterID = 0;
+	uint32_t index = 0;
 
-	// 解放されたIDがあれば再利用
-	if (!freeIDs_.empty()) {
-		emitterID = freeIDs_.back();
-		freeIDs_.pop_back();
+	// 空きスロットがあれば再利用
+	if (!freeSlots_.empty()) {
+		index = freeSlots_.back();
+		freeSlots_.pop_back();
 	} else {
-		// 新しいIDを発行
-		emitterID = nextEmitterID_++;
+		// 新しいスロットを追加
+		index = static_cast<uint32_t>(slots_.size());
+		slots_.emplace_back();
+		transforms_.emplace_back();
 	}
 
-	// エミッターを登録
-	activeEmitters_[emitterID] = emitter;
+	// エミッターを登録し、次のSyncTransformsまでの姿勢を書き込んでおく
+	Slot& slot = slots_[index];
+	slot.emitter = emitter;
+	transforms_[index] = { emitter->GetPosition(), emitter->GetEmitDirection(), emitter->GetScale() };
+	++activeEmitterCount_;
 
-	return emitterID;
+	return MakeEmitterID(index, slot.generation);
 }
 
 //==================================================================================
 // エミッターIDの解放（登録解除）
 //==================================================================================
 void ParticleEmitterAllocator::Release(uint32_t emitterID) {
-	// エミッターIDが0（無効）の場合は何もしない
-	if (emitterID == 0) {
+	// 無効なID・解放済みのIDの場合は何もしない
+	if (FindSlot(emitterID) == nullptr) {
 		return;
 	}
+	ReleaseSlot(ToSlotIndex(emitterID));
+}
 
-	// エミッターが登録されているか確認
-	auto it = activeEmitters_.find(emitterID);
-	if (it != activeEmitters_.end()) {
-		// エミッターを削除
-		activeEmitters_.erase(it);
-
-		// IDを再利用リストに追加
-		freeIDs_.push_back(emitterID);
+//==================================================================================
+// 全エミッターの姿勢をスロットへ書き写す
+//==================================================================================
+void ParticleEmitterAllocator::SyncTransforms() {
+	for (size_t index = 0; index < slots_.size(); ++index) {
+		const ParticleEmitter* emitter = slots_[index].emitter;
+		if (emitter == nullptr) {
+			continue;
+		}
+		EmitterTransform& transform = transforms_[index];
+		transform.position = emitter->GetPosition();
+		transform.direction = emitter->GetEmitDirection();
+		transform.scale = emitter->GetScale();
 	}
 }
 
@@ -51,9 +63,9 @@ void ParticleEmitterAllocator::Release(uint32_t emitterID) {
 // エミッターIDから現在のエミッター位置を取得
 //==================================================================================
 std::optional<Vector3> ParticleEmitterAllocator::GetEmitterPosition(uint32_t emitterID) const {
-	auto it = activeEmitters_.find(emitterID);
-	if (it != activeEmitters_.end() && it->second != nullptr) {
-		return it->second->GetPosition();
+	const Slot* slot = FindSlot(emitterID);
+	if (slot != nullptr) {
+		return slot->emitter->GetPosition();
 	}
 	return std::nullopt; // エミッターが見つからない
 }
@@ -62,9 +74,9 @@ std::optional<Vector3> ParticleEmitterAllocator::GetEmitterPosition(uint32_t emi
 // エミッターIDから発射方向を取得
 //=================================================================================
 std::optional<Vector3> ParticleEmitterAllocator::GetEmitDirection(uint32_t emitterID) const {
-	auto it = activeEmitters_.find(emitterID);
-	if (it != activeEmitters_.end() && it->second != nullptr) {
-		return it->second->GetEmitDirection();
+	const Slot* slot = FindSlot(emitterID);
+	if (slot != nullptr) {
+		return slot->emitter->GetEmitDirection();
 	}
 	return std::nullopt; // エミッターが見つからない
 }
@@ -73,9 +85,9 @@ std::optional<Vector3> ParticleEmitterAllocator::GetEmitDirection(uint32_t emitt
 // エミッターIDから現在のスケールを取得
 //=================================================================================
 std::optional<Vector3> ParticleEmitterAllocator::GetEmitterScale(uint32_t emitterID) const {
-	auto it = activeEmitters_.find(emitterID);
-	if (it != activeEmitters_.end() && it->second != nullptr) {
-		return it->second->GetScale();
+	const Slot* slot = FindSlot(emitterID);
+	if (slot != nullptr) {
+		return slot->emitter->GetScale();
 	}
 	return std::nullopt; // エミッターが見つからない
 }
@@ -84,18 +96,45 @@ std::optional<Vector3> ParticleEmitterAllocator::GetEmitterScale(uint32_t emitte
 // エミッターIDからエミッターポインタを取得
 //==================================================================================
 ParticleEmitter* ParticleEmitterAllocator::GetEmitter(uint32_t emitterID) const {
-	auto it = activeEmitters_.find(emitterID);
-	if (it != activeEmitters_.end()) {
-		return it->second;
-	}
-	return nullptr;
+	const Slot* slot = FindSlot(emitterID);
+	return slot != nullptr ? slot->emitter : nullptr;
 }
 
 //==================================================================================
 // 全エミッターのクリア
 //==================================================================================
 void ParticleEmitterAllocator::Clear() {
-	activeEmitters_.clear();
-	freeIDs_.clear();
-	nextEmitterID_ = 1; // IDカウンターをリセット
-}
\ No newline at end of file
+	// 世代を進めて、クリア前に発行したIDを全て無効にする
+	for (uint32_t index = 0; index < static_cast<uint32_t>(slots_.size()); ++index) {
+		if (slots_[index].emitter != nullptr) {
+			ReleaseSlot(index);
+		}
+	}
+}
+
+//==================================================================================
+// 有効なIDならスロットを取得
+//==================================================================================
+const ParticleEmitterAllocator::Slot* ParticleEmitterAllocator::FindSlot(uint32_t emitterID) const {
+	const uint32_t index = ToSlotIndex(emitterID);
+	if (index >= slots_.size()) {
+		return nullptr;
+	}
+	const Slot& slot = slots_[index];
+	if (slot.emitter == nullptr || slot.generation != ToGeneration(emitterID)) {
+		return nullptr;
+	}
+	return &slot;
+}
+
+//==================================================================================
+// スロットを空きにして世代を進める
+//==================================================================================
+void ParticleEmitterAllocator::ReleaseSlot(uint32_t index) {
+	Slot& slot = slots_[index];
+	slot.emitter = nullptr;
+	// 世代は1～kMaxGeneration_を循環させる(0のIDは無効として予約)
+	slot.generation = slot.generation >= kMaxGeneration_ ? 1 : slot.generation + 1;
+	--activeEmitterCount_;
+	freeSlots_.push_back(index);
+}
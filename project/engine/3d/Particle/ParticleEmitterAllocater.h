@@ -3,12 +3,25 @@
 #include "ParticleCommon.h"
 #include "DirectXCommon.h"
 #include "SrvManager.h"
+#include <optional>
+#include <vector>
 
 //============================================================================
 // ParticleEmitterAllocator class
 //============================================================================
+/// <summary>
+/// エミッターの姿勢のスナップショット(SyncTransformsで毎フレーム更新)
+/// </summary>
+struct EmitterTransform {
+	Vector3 position;  //位置
+	Vector3 direction; //発射方向
+	Vector3 scale;     //スケール
+};
+
 /// <summary>
 /// パーティクルエミッター用リソースの割り当てと再利用を管理するクラスです。
+/// エミッターIDは「世代(上位ビット) | スロット番号(下位16bit)」で、スロット配列を直接引けます。
+/// スロットの解放時に世代を進めるため、解放済み・再利用済みのIDは世代の不一致で検出できます。
 /// </summary>
 class ParticleEmitterAllocator {
 public:
@@ -32,9 +45,42 @@ public:
 	/// <param name="emitterID">解放するエミッターID</param>
 	void Release(uint32_t emitterID);
 
+	/// <summary>
+	/// 全エミッターの姿勢をスロットへ書き写す(パーティクル更新の前に1回呼ぶ)
+	/// </summary>
+	void SyncTransforms();
+
+	/// <summary>
+	/// エミッターIDから姿勢のスナップショットを取得
+	/// 書き込みはSyncTransforms・Allocateのみのため、パーティクル更新中は複数スレッドから呼べる
+	/// </summary>
+	/// <param name="emitterID">エミッターID</param>
+	/// <returns>姿勢(解放済み・無効なIDの場合はnullptr)</returns>
+	const EmitterTransform* FindTransform(uint32_t emitterID) const {
+		const uint32_t index = ToSlotIndex(emitterID);
+		if (index >= slots_.size()) {
+			return nullptr;
+		}
+		const Slot& slot = slots_[index];
+		if (slot.emitter == nullptr || slot.generation != ToGeneration(emitterID)) {
+			return nullptr;
+		}
+		return &transforms_[index];
+	}
+
+	/// <summary>
+	/// エミッターIDから現在の位置を取得
+	/// </summary>
+	/// <param name="emitterID">エミッターID</param>
+	/// <returns>エミッターの位置（存在しない場合はnullopt）</returns>
 	std::optional<Vector3> GetEmitterPosition(uint32_t emitterID) const;
 
-	std::optional<Vector3> GetEmitDirection(uint32_t emitterID )const;
+	/// <summary>
+	/// エミッターIDから現在の発射方向を取得
+	/// </summary>
+	/// <param name="emitterID">エミッターID</param>
+	/// <returns>エミッターの発射方向（存在しない場合はnullopt）</returns>
+	std::optional<Vector3> GetEmitDirection(uint32_t emitterID) const;
 
 	/// <summary>
 	/// エミッターIDから現在のスケールを取得
@@ -58,7 +104,7 @@ public:
 	/// <summary>
 	/// 登録されているエミッター数を取得
 	/// </summary>
-	uint32_t GetActiveEmitterCount() const { return static_cast<uint32_t>(activeEmitters_.size()); }
+	uint32_t GetActiveEmitterCount() const { return activeEmitterCount_; }
 
 public:
 
@@ -66,13 +112,47 @@ public:
 
 private:
 
-	// エミッターID管理
-	uint32_t nextEmitterID_ = 1; // 0は無効なIDとして予約
-	
-	// アクティブなエミッターの管理(参照用)
-	std::unordered_map<uint32_t, ParticleEmitter*> activeEmitters_;
-	
-	// 解放されたIDの再利用リスト（オプション：メモリ効率化）
-	std::vector<uint32_t> freeIDs_;
+	/// <summary>
+	/// エミッター1個分のスロット
+	/// </summary>
+	struct Slot {
+		ParticleEmitter* emitter = nullptr; //登録中のエミッター(空きスロットはnullptr)
+		uint32_t generation = 1;            //世代(解放する度に進める。0は使わない)
+	};
+
+	static constexpr uint32_t kSlotIndexBits_ = 16;
+	static constexpr uint32_t kSlotIndexMask_ = (1u << kSlotIndexBits_) - 1;
+	// パーティクル側ではIDをint32_tで保持するため、世代は15bitに収める
+	static constexpr uint32_t kMaxGeneration_ = 0x7FFFu;
+
+	static_assert(kMaxEmitterCount_ <= kSlotIndexMask_ + 1, "スロット番号がIDの下位ビットに収まりません");
+
+	static uint32_t ToSlotIndex(uint32_t emitterID) { return emitterID & kSlotIndexMask_; }
+	static uint32_t ToGeneration(uint32_t emitterID) { return emitterID >> kSlotIndexBits_; }
+	static uint32_t MakeEmitterID(uint32_t index, uint32_t generation) { return (generation << kSlotIndexBits_) | index; }
+
+	/// <summary>
+	/// 有効なIDならスロットを取得
+	/// </summary>
+	const Slot* FindSlot(uint32_t emitterID) const;
+
+	/// <summary>
+	/// スロットを空きにして世代を進める
+	/// </summary>
+	void ReleaseSlot(uint32_t index);
+
+private:
+
+	// スロット番号で引くエミッターと世代(IDの世代と一致する場合のみ有効)
+	std::vector<Slot> slots_;
+
+	// スロット番号で引く姿勢のスナップショット(slots_と同じ並び)
+	std::vector<EmitterTransform> transforms_;
+
+	// 空きスロット番号の再利用リスト
+	std::vector<uint32_t> freeSlots_;
+
+	// 登録中のエミッター数
+	uint32_t activeEmitterCount_ = 0;
 };
 
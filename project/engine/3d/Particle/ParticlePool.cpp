@@ -0,0 +1,180 @@
+#include "ParticlePool.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace TakeC;
+
+//=============================================================================
+// 初期化
+//=============================================================================
+void ParticlePool::Initialize(uint32_t poolCapacity) {
+	Clear();
+	capacity = poolCapacity;
+
+	//上限分を先に確保し、発生の多いフレームで配列の再確保とコピーが起きないようにする
+	//(伸長に任せると最後の伸長で上限を超える分まで確保される)
+	translate.reserve(capacity);
+	rotate.reserve(capacity);
+	scale.reserve(capacity);
+	velocity.reserve(capacity);
+	color.reserve(capacity);
+	drawColor.reserve(capacity);
+	lifeTimer.reserve(capacity);
+	trailSpawnTimer.reserve(capacity);
+	emitterID.reserve(capacity);
+	if (isTrailEnabled) {
+		trailHistory.reserve(capacity);
+	}
+}
+
+//=============================================================================
+// パーティクルの追加
+//=============================================================================
+bool ParticlePool::Add(const Particle& particle) {
+	if (IsFull()) {
+		return false;
+	}
+
+	translate.push_back(particle.transforms_.translate);
+	rotate.push_back(particle.transforms_.rotate);
+	scale.push_back(particle.transforms_.scale);
+	velocity.push_back(particle.velocity_);
+	color.push_back(particle.color_);
+	drawColor.push_back(particle.color_);
+	lifeTimer.push_back(particle.lifeTimer_);
+	trailSpawnTimer.push_back(particle.trailSpawnTimer_);
+	if (isTrailEnabled) {
+		trailHistory.push_back({});
+	}
+	emitterID.push_back(particle.emitterID_);
+	return true;
+}
+
+//=============================================================================
+// 末尾への要素の追加
+//=============================================================================
+uint32_t ParticlePool::Extend(uint32_t count) {
+	const uint32_t current = GetCount();
+	const uint32_t added = (std::min)(count, capacity > current ? capacity - current : 0u);
+	if (added == 0) {
+		return 0;
+	}
+
+	const size_t newCount = static_cast<size_t>(current) + added;
+	translate.resize(newCount);
+	rotate.resize(newCount);
+	scale.resize(newCount);
+	velocity.resize(newCount);
+	color.resize(newCount);
+	drawColor.resize(newCount);
+	lifeTimer.resize(newCount);
+	trailSpawnTimer.resize(newCount);
+	if (isTrailEnabled) {
+		trailHistory.resize(newCount);
+	}
+	emitterID.resize(newCount);
+	return added;
+}
+
+//=============================================================================
+// パーティクルの削除(末尾の要素と入れ替えて詰める)
+//=============================================================================
+void ParticlePool::Remove(uint32_t index) {
+	assert(index < GetCount());
+
+	const uint32_t last = GetCount() - 1;
+	if (index != last) {
+		translate[index] = translate[last];
+		rotate[index] = rotate[last];
+		scale[index] = scale[last];
+		velocity[index] = velocity[last];
+		color[index] = color[last];
+		drawColor[index] = drawColor[last];
+		lifeTimer[index] = lifeTimer[last];
+		trailSpawnTimer[index] = trailSpawnTimer[last];
+		if (isTrailEnabled) {
+			trailHistory[index] = trailHistory[last];
+		}
+		emitterID[index] = emitterID[last];
+	}
+
+	translate.pop_back();
+	rotate.pop_back();
+	scale.pop_back();
+	velocity.pop_back();
+	color.pop_back();
+	drawColor.pop_back();
+	lifeTimer.pop_back();
+	trailSpawnTimer.pop_back();
+	if (isTrailEnabled) {
+		trailHistory.pop_back();
+	}
+	emitterID.pop_back();
+}
+
+//=============================================================================
+// 全パーティクルの削除(確保済みの領域は残す)
+//=============================================================================
+void ParticlePool::Clear() {
+	translate.clear();
+	rotate.clear();
+	scale.clear();
+	velocity.clear();
+	color.clear();
+	drawColor.clear();
+	lifeTimer.clear();
+	trailSpawnTimer.clear();
+	trailHistory.clear();
+	emitterID.clear();
+}
+
+//=============================================================================
+// トレイルの軌跡を保持するかどうかの設定
+//=============================================================================
+void ParticlePool::SetTrailEnabled(bool enabled) {
+	if (enabled == isTrailEnabled) {
+		return;
+	}
+
+	isTrailEnabled = enabled;
+	if (enabled) {
+		//軌跡は1要素が約200バイトあるため、トレイルを使うプールだけが持つ
+		trailHistory.reserve(capacity);
+		trailHistory.assign(GetCount(), {});
+	} else {
+		trailHistory.clear();
+		trailHistory.shrink_to_fit();
+	}
+}
+
+//=============================================================================
+// 指定したパーティクルの取得
+//=============================================================================
+Particle ParticlePool::Get(uint32_t index) const {
+	assert(index < GetCount());
+
+	Particle particle;
+	particle.transforms_.translate = translate[index];
+	particle.transforms_.rotate = rotate[index];
+	particle.transforms_.scale = scale[index];
+	particle.velocity_ = velocity[index];
+	particle.color_ = color[index];
+	particle.lifeTimer_ = lifeTimer[index];
+	particle.trailSpawnTimer_ = trailSpawnTimer[index];
+	particle.emitterID_ = emitterID[index];
+	return particle;
+}
+
+//=============================================================================
+// GPU用データの書き込み
+//=============================================================================
+void ParticlePool::WriteForGPU(uint32_t index, ParticleForGPU& particleForGPU) const {
+	const Timer& timer = lifeTimer[index];
+	particleForGPU.scale = scale[index];
+	particleForGPU.rotate = rotate[index];
+	particleForGPU.translate = translate[index];
+	particleForGPU.velocity = velocity[index];
+	particleForGPU.color = drawColor[index];
+	particleForGPU.lifeTime = timer.GetDuration();
+	particleForGPU.currentTime = timer.GetProgress() * timer.GetDuration();
+}
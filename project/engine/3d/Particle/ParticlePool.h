@@ -0,0 +1,162 @@
+#pragma once
+#include "engine/math/Transform.h"
+#include "engine/math/Vector4.h"
+#include "engine/3d/Particle/ParticleForGPU.h"
+#include "engine/Utility/Timer.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+//Particle1個分のデータ
+/// <summary>
+/// Particleに必要な値をまとめて保持する構造体です。
+/// 生成時の受け渡しに使い、生存中のパーティクルはParticlePoolに要素毎の配列で保持されます。
+/// </summary>
+struct Particle {
+	QuaternionTransform transforms_;  //位置
+	Vector3 velocity_; 	    //速度
+	Vector4 color_;         //色
+	Timer lifeTimer_;    //寿命タイマー
+
+	float trailSpawnTimer_ = 0.0f; //トレイルエフェクトの生成タイマー
+
+	int32_t emitterID_ = 0;  // 0 = エミッター追従なし
+};
+
+namespace TakeC {
+
+	//============================================================================
+	// TrailHistory struct
+	//============================================================================
+	/// <summary>
+	/// パーティクル1個分のトレイルの軌跡を固定数のリングバッファで保持する構造体です。
+	/// 満杯になると最も古いサンプルから上書きされます。
+	/// </summary>
+	struct TrailHistory {
+
+		//保持できるサンプル数
+		static constexpr uint32_t kMaxSamples = 16;
+
+		/// <summary>
+		/// サンプルの追加
+		/// </summary>
+		/// <param name="position">追加する位置</param>
+		void Push(const Vector3& position) {
+			positions[head] = position;
+			head = static_cast<uint8_t>((head + 1) % kMaxSamples);
+			if (count < kMaxSamples) {
+				++count;
+			}
+		}
+
+		/// <summary>
+		/// 古い方から数えてindex番目のサンプルの取得
+		/// </summary>
+		/// <param name="index">0 が最も古いサンプル</param>
+		const Vector3& GetSample(uint32_t index) const {
+			return positions[(head + kMaxSamples - count + index) % kMaxSamples];
+		}
+
+		std::array<Vector3, kMaxSamples> positions; //サンプルの位置
+		uint8_t head = 0;  //次に書き込む位置
+		uint8_t count = 0; //保持しているサンプル数
+	};
+
+	//============================================================================
+	// ParticlePool struct
+	//============================================================================
+	/// <summary>
+	/// 生存中のパーティクルを要素毎の配列(SoA)で保持するプールです。
+	/// 生存中の要素は常に [0, GetCount()) に詰めて並び、削除は末尾の要素との入れ替えで行います。
+	/// 配列は初期化時に上限分を確保するため、追加・削除でメモリ確保が発生しません
+	/// (トレイルの軌跡はトレイルを有効にした時に確保します)。
+	/// </summary>
+	struct ParticlePool {
+
+		//=========================================================================
+		// functions
+		//=========================================================================
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="capacity">保持できる最大数</param>
+		void Initialize(uint32_t capacity);
+
+		/// <summary>
+		/// パーティクルの追加
+		/// </summary>
+		/// <param name="particle"></param>
+		/// <returns>満杯で追加できなかった場合false</returns>
+		bool Add(const Particle& particle);
+
+		/// <summary>
+		/// 末尾に要素を追加する(満杯になる分までで打ち切る)
+		/// 追加した要素は [追加前のGetCount(), GetCount()) に並び、値は呼び出し側で書き込む
+		/// </summary>
+		/// <param name="count">追加したい要素数</param>
+		/// <returns>実際に追加した要素数</returns>
+		uint32_t Extend(uint32_t count);
+
+		/// <summary>
+		/// パーティクルの削除(末尾の要素をindexへ移動する)
+		/// </summary>
+		/// <param name="index"></param>
+		void Remove(uint32_t index);
+
+		/// <summary>
+		/// 全パーティクルの削除
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// トレイルの軌跡を保持するかどうかの設定
+		/// 有効にすると生存中の要素に空の軌跡を割り当て、無効にすると軌跡の領域を解放する
+		/// </summary>
+		/// <param name="enabled"></param>
+		void SetTrailEnabled(bool enabled);
+
+		/// <summary>
+		/// 指定したパーティクルをParticleとしてまとめて取得
+		/// </summary>
+		/// <param name="index"></param>
+		/// <returns></returns>
+		Particle Get(uint32_t index) const;
+
+		/// <summary>
+		/// 指定したパーティクルのGPU用データの書き込み
+		/// </summary>
+		/// <param name="index"></param>
+		/// <param name="particleForGPU"></param>
+		void WriteForGPU(uint32_t index, ParticleForGPU& particleForGPU) const;
+
+		//生存中のパーティクル数
+		uint32_t GetCount() const { return static_cast<uint32_t>(translate.size()); }
+		//保持できる最大数
+		uint32_t GetCapacity() const { return capacity; }
+		//満杯かどうか
+		bool IsFull() const { return GetCount() >= capacity; }
+		//トレイルの軌跡を保持しているかどうか
+		bool IsTrailEnabled() const { return isTrailEnabled; }
+
+		//=========================================================================
+		// variables
+		//=========================================================================
+
+		std::vector<Vector3> translate;        //位置
+		std::vector<Quaternion> rotate;        //回転
+		std::vector<Vector3> scale;            //拡縮
+		std::vector<Vector3> velocity;         //速度
+		std::vector<Vector4> color;            //色
+		std::vector<Vector4> drawColor;        //描画色(色遷移・alphaを適用した色。更新処理で書き込む)
+		std::vector<Timer> lifeTimer;          //寿命タイマー
+		std::vector<float> trailSpawnTimer;    //トレイルエフェクトの生成タイマー
+		std::vector<TrailHistory> trailHistory; //トレイルの軌跡(IsTrailEnabled()の間だけ他の配列と同じ要素数を持つ)
+		std::vector<int32_t> emitterID;        //追従するエミッターのID
+
+		uint32_t capacity = 0; //保持できる最大数
+		bool isTrailEnabled = false; //トレイルの軌跡を保持しているかどうか
+	};
+}
+
+using TakeC::ParticlePool;
@@ -9,10 +9,24 @@
 #include "math/Easing.h"
 #include "camera/CameraManager.h"
 #include "3d/Particle/ParticleCommon.h"
-#include <numbers>
+#include "3d/Particle/ParticleEmitterAllocater.h"
+#include "Utility/JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
 
 using namespace TakeC;
 
+namespace {
+	// 描画順で結果が変わるブレンドモードかどうか(加算・乗算などは順序に依らない)
+	bool IsOrderDependentBlend(BlendState blendState) {
+		return blendState == BlendState::NORMAL ||
+			blendState == BlendState::SPRITE ||
+			blendState == BlendState::PREMULTIPLIED_ALPHA;
+	}
+}
+
 //=============================================================================
 // コンストラクタ・デストラクタ
 //=============================================================================
@@ -51,6 +65,9 @@ void PrimitiveParticle::Initialize(ParticleCommon* particleCommon, const std::st
 	//Mapping
 	particleResource_->Map(0, nullptr, reinterpret_cast<void**>(&particleData_));
 
+	//パーティクル配列の初期化
+	particles_.Initialize(kNumMaxInstance_);
+
 	
 
 	//テクスチャファイルパスの設定
@@ -64,46 +81,173 @@ void PrimitiveParticle::Initialize(ParticleCommon* particleCommon, const std::st
 //=============================================================================
 void PrimitiveParticle::Update() {
 
-	numInstance_ = 0;
-	for (std::list<Particle>::iterator particleIterator = particles_.begin();
-		particleIterator != particles_.end(); ) {
+	uint32_t updateCount = BeginUpdate();
+	UpdateRange(0, updateCount);
+	uint32_t writeCount = MergeUpdate();
+	WriteRange(0, writeCount);
+}
 
-		// MEMO: Particleの総出現数だけ繰り返す  
-		if (numInstance_ < kNumMaxInstance_) {
+//=============================================================================
+// 並列更新の準備
+//=============================================================================
+uint32_t PrimitiveParticle::BeginUpdate() {
 
-			// 寿命が来たら削除  
-			if ((*particleIterator).lifeTimer_.IsFinished()) {
-				particleIterator = particles_.erase(particleIterator);
-				continue;
-			}
+	uint32_t count = particles_.GetCount();
+	deadFlags_.resize(count);
+
+	// エミッターの姿勢はフレーム毎に1回だけ参照先を解決し、更新中はスロットを直接引く
+	emitterAllocator_ = TakeC::TakeCFrameWork::GetParticleManager()->GetEmitterAllocator();
+
+	// 属性はエディタから変更されるため、フレーム毎に処理列と軌跡の領域の有無を決め直す
+	particles_.SetTrailEnabled(particlePreset_.attribute.isParticleTrail);
+	BuildMovementPasses();
+	return count;
+}
+
+//=============================================================================
+// 範囲の移動更新
+//=============================================================================
+void PrimitiveParticle::UpdateRange(uint32_t begin, uint32_t end) {
+
+	MovementBlock block;
+
+	for (uint32_t blockBegin = begin; blockBegin < end; blockBegin += kMovementBlockSize_) {
+		block.begin = blockBegin;
+		block.count = (std::min)(end - blockBegin, kMovementBlockSize_);
+
+		// 寿命判定とイージングの評価をまとめて行い、選択済みの処理を順に適用する
+		PrepareMovementBlock(block);
+		for (uint32_t i = 0; i < movementPassCount_; ++i) {
+			(this->*movementPasses_[i])(block);
+		}
+	}
+}
+
+//=============================================================================
+// 同期点: 削除・描画順の決定・トレイルの描画数の集計
+//=============================================================================
+uint32_t PrimitiveParticle::MergeUpdate() {
+
+	const ParticleAttributes& attributes = particlePreset_.attribute;
+	const Camera* camera = TakeC::CameraManager::GetInstance().GetActiveCamera();
+	Vector3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+	Vector3 cameraForward = { 0.0f, 0.0f, 1.0f };
+	if (camera) {
+		const Matrix4x4& cameraWorld = camera->GetWorldMatrix();
+		cameraPosition = { cameraWorld.m[3][0], cameraWorld.m[3][1], cameraWorld.m[3][2] };
+		cameraForward = Vector3Math::Normalize({ cameraWorld.m[2][0], cameraWorld.m[2][1], cameraWorld.m[2][2] });
+	}
+
+	// 半透明のブレンドモードの時だけ奥から手前の順に描画する
+	DepthSortMode sortMode = IsOrderDependentBlend(particlePreset_.blendState) ?
+		static_cast<DepthSortMode>(attributes.depthSortMode) : DepthSortMode::None;
+	const uint32_t mergeCount = particles_.GetCount();
+	bool needsSort = false;
+	bool keepsOrder = false;
+	if (sortMode != DepthSortMode::None) {
+		if (camera) {
+			needsSort = NeedsDepthSort(sortMode, cameraPosition, cameraForward, mergeCount);
+			keepsOrder = !needsSort;
+		} else {
+			// カメラが無い(シーン切り替え中など)場合は並べ替えず、前回の並びが使えればそれを使う
+			keepsOrder = drawOrder_.size() == orderedCount_ && mergeCount >= orderedCount_ && mergeCount > 0;
+		}
+	}
+	if (keepsOrder) {
+		// 前回の並びを使い回すため、削除による移動を追跡する
+		slotOwners_.resize(mergeCount);
+		std::iota(slotOwners_.begin(), slotOwners_.end(), 0u);
+	}
 
-			// particle1つの位置更新  
-			UpdateMovement(particleIterator);
-			
-			particleData_[numInstance_].scale = (*particleIterator).transforms_.scale;
-			particleData_[numInstance_].rotate = (*particleIterator).transforms_.rotate;
-			particleData_[numInstance_].translate = (*particleIterator).transforms_.translate;
-			particleData_[numInstance_].velocity = (*particleIterator).velocity_;
-			particleData_[numInstance_].lifeTime = (*particleIterator).lifeTimer_.GetDuration();
-			particleData_[numInstance_].currentTime = (*particleIterator).lifeTimer_.GetProgress() * (*particleIterator).lifeTimer_.GetDuration();
-			
-			++numInstance_; // 次のインスタンスに進める  
+	// 寿命が来たものを削除(末尾の要素がindexに入るので、indexは進めない)
+	// 削除順が固定なので、スレッド数によらず同じ並びになる
+	for (uint32_t index = 0; index < particles_.GetCount(); ) {
+		if (deadFlags_[index]) {
+			uint32_t last = particles_.GetCount() - 1;
+			deadFlags_[index] = deadFlags_[last];
+			deadFlags_.pop_back();
+			if (keepsOrder) {
+				slotOwners_[index] = slotOwners_[last];
+				slotOwners_.pop_back();
+			}
+			particles_.Remove(index);
+			continue;
 		}
-		++particleIterator; // 次のイテレータに進める  
+		++index;
+	}
+	const uint32_t particleCount = particles_.GetCount();
+	numInstance_ = particleCount;
+
+	// 描画順の決定
+	if (needsSort) {
+		SortByDepth(cameraPosition, cameraForward);
+	} else if (keepsOrder) {
+		RemapDrawOrder(mergeCount);
+		++sortKeepFrames_;
+	} else {
+		drawOrder_.clear();
 	}
 
-	if (!pendingParticles_.empty()) {
-		// 末尾にまとめて追加
-		particles_.insert(particles_.end(), pendingParticles_.begin(), pendingParticles_.end());
-		pendingParticles_.clear();
+	// トレイルは各パーティクルの直前に並べ、描画順の各位置に「軌跡→本体」の組を詰める(奥から手前に並べた場合も
+	// 組ごとにその順で描かれる)。各描画位置の書き込み先をここで決めておき、WriteRangeを範囲毎に並列に行えるようにする
+	// (バッファに収まらない分は描画順の後ろのパーティクルの軌跡から省き、パーティクル本体は全て描画する)
+	trailSegmentInstanceCount_ = particles_.IsTrailEnabled() ? attributes.particlesPerInterpolation : 0;
+	if (trailSegmentInstanceCount_ > 0) {
+		instanceOffsets_.resize(particleCount + 1);
+		uint32_t trailBudget = kNumMaxInstance_ - particleCount;
+		uint32_t instanceCount = 0;
+		for (uint32_t slot = 0; slot < particleCount; ++slot) {
+			uint32_t index = drawOrder_.empty() ? slot : drawOrder_[slot];
+			uint32_t trailCount = (std::min)(particles_.trailHistory[index].count * trailSegmentInstanceCount_, trailBudget);
+			trailBudget -= trailCount;
+			instanceOffsets_[slot] = instanceCount;
+			instanceCount += trailCount + 1;
+		}
+		instanceOffsets_[particleCount] = instanceCount;
+		numInstance_ = instanceCount;
 	}
 
-	// データをGPUに転送  
+	// データをGPUに転送(カメラが無い場合は前回の行列のまま)
 	perViewData_->isBillboard = particlePreset_.attribute.isBillboard;
-	perViewData_->viewProjection = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetViewProjectionMatrix();
-	perViewData_->billboardMatrix = TakeC::CameraManager::GetInstance().GetActiveCamera()->GetRotationMatrix();
+	if (camera) {
+		perViewData_->viewProjection = camera->GetViewProjectionMatrix();
+		perViewData_->billboardMatrix = camera->GetRotationMatrix();
+	}
 	auto& primitiveMaterial = TakeC::TakeCFrameWork::GetPrimitiveDrawer()->GetBaseData(primitiveHandle_)->material;
 	primitiveMaterial->SetEnableLighting(particlePreset_.attribute.enableLighting);
+
+	return particleCount;
+}
+
+//=============================================================================
+// GPU用データの書き込み
+//=============================================================================
+void PrimitiveParticle::WriteRange(uint32_t begin, uint32_t end) {
+
+	// [begin, end) は描画位置。描画順が決まっていればその順にパーティクルを詰める
+	if (trailSegmentInstanceCount_ == 0) {
+		if (drawOrder_.empty()) {
+			for (uint32_t slot = begin; slot < end; ++slot) {
+				particles_.WriteForGPU(slot, particleData_[slot]);
+			}
+		} else {
+			for (uint32_t slot = begin; slot < end; ++slot) {
+				particles_.WriteForGPU(drawOrder_[slot], particleData_[slot]);
+			}
+		}
+		return;
+	}
+
+	// 各パーティクルの軌跡を本体の直前に書き込む(軌跡は書き込む本体の値から作り、バッファは読み戻さない)
+	for (uint32_t slot = begin; slot < end; ++slot) {
+		uint32_t index = drawOrder_.empty() ? slot : drawOrder_[slot];
+		uint32_t firstInstance = instanceOffsets_[slot];
+		uint32_t trailCount = instanceOffsets_[slot + 1] - firstInstance - 1;
+		ParticleForGPU parent;
+		particles_.WriteForGPU(index, parent);
+		WriteTrailInstances(index, firstInstance, trailCount, parent);
+		particleData_[firstInstance + trailCount] = parent;
+	}
 }
 
 //=============================================================================
@@ -154,28 +298,12 @@ void PrimitiveParticle::Draw() {
 		particleCommon_->GetGraphicPSO(BlendState::NORMAL), numInstance_, particlePreset_.primitiveType, primitiveHandle_);
 }
 
-//=============================================================================
-// パーティクルの生成
-//=============================================================================
-Particle PrimitiveParticle::MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate,const Vector3& direction) {
-
-	return BaseParticleGroup::MakeNewParticle(randomEngine, translate,direction);
-}
-
 //=============================================================================
 // パーティクルの発生
 //=============================================================================
-std::list<Particle> PrimitiveParticle::Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount) {
-
-	return BaseParticleGroup::Emit(emitterPos,direction, particleCount);
-}
-
-//=============================================================================
-// パーティクルの配列の結合
-//=============================================================================
-void PrimitiveParticle::SpliceParticles(std::list<Particle> particles) {
+void PrimitiveParticle::Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount) {
 
-	BaseParticleGroup::SpliceParticles(particles);
+	BaseParticleGroup::Emit(emitterPos,direction, particleCount);
 }
 
 //=============================================================================
@@ -216,7 +344,7 @@ void PrimitiveParticle::SetTextureFilePath(const std::string& filePath) {
 void PrimitiveParticle::EraseParticle() {
 
 	// 全パーティクルの削除
-	particles_.clear();
+	particles_.Clear();
 }
 
 void PrimitiveParticle::GeneratePrimitive() {
@@ -298,220 +426,411 @@ void PrimitiveParticle::GeneratePrimitive() {
 }
 
 //=============================================================================
-// パーティクル1つの位置更新
+// 移動更新の処理列とイージングの解決
 //=============================================================================
-void PrimitiveParticle::UpdateMovement(std::list<Particle>::iterator particleIterator) {
+void PrimitiveParticle::BuildMovementPasses() {
 
-	//particle1つの位置更新
-	ParticleAttributes& attributes = particlePreset_.attribute;
+	const ParticleAttributes& attributes = particlePreset_.attribute;
+
+	movementPassCount_ = 0;
+	auto addPass = [this](MovementPass pass) {
+		assert(movementPassCount_ < kMaxMovementPasses_);
+		movementPasses_[movementPassCount_++] = pass;
+	};
 
-	// 前フレームの位置を保存
-	Vector3 oldPosition = (*particleIterator).transforms_.translate;
-	float lifeTimeProgress = (*particleIterator).lifeTimer_.GetEase(attributes.lifeTimeEasingType);
-	float velocityProgress = (*particleIterator).lifeTimer_.GetEase(attributes.velocityEasingType);
-	float scaleProgress = (*particleIterator).lifeTimer_.GetEase(attributes.scaleEasingType);
-	float oldTime = (*particleIterator).lifeTimer_.GetProgress() * (*particleIterator).lifeTimer_.GetDuration();
+	// 追従しない場合と方向移動の場合のみ速度で移動する
+	bool useVelocity = attributes.isTranslate && (!attributes.enableFollowEmitter || attributes.isDirectional);
+	bool useScale = attributes.scaleSetting == static_cast<uint32_t>(ScaleSetting::ScaleUp) ||
+		attributes.scaleSetting == static_cast<uint32_t>(ScaleSetting::ScaleDown);
 
+	//--- 処理列の組み立て(元の1パーティクル毎の処理と同じ順序) ---
+	if (attributes.isParticleTrail) {
+		addPass(&PrimitiveParticle::SaveTrailOrigin);
+	}
 	if (attributes.enableGravity) {
-		(*particleIterator).velocity_ += attributes.gravity * kDeltaTime_;
+		addPass(&PrimitiveParticle::ApplyGravity);
 	}
-
 	if (attributes.isTranslate) {
 		if (attributes.enableFollowEmitter) {
-			// エミッターIDから現在のエミッター位置を取得
-			std::optional<Vector3> emitterPos =
-				TakeC::TakeCFrameWork::GetParticleManager()->GetEmitterPosition((*particleIterator).emitterID_);
-
-			if (emitterPos.has_value()) {
-				(*particleIterator).transforms_.translate = emitterPos.value();
-			}
-
+			addPass(&PrimitiveParticle::FollowEmitter);
 			if (attributes.alignRotationToEmitter) {
-				Vector3 dir = { 0, 0, 1 };
-				bool hasDir = false;
-
+				// RadialやConvergeの場合、自身の速度（進行方向）の向きを使用する
 				if (attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Radial) ||
 					attributes.velocityTarget == static_cast<uint32_t>(VelocityTarget::Converge)) {
-					// RadialやConvergeの場合、自身の速度（進行方向）の向きを使用する
-					dir = (*particleIterator).velocity_;
-					hasDir = true;
+					addPass(&PrimitiveParticle::AlignToVelocity);
 				} else {
-					auto emitDir = TakeC::TakeCFrameWork::GetParticleManager()->GetEmitDirection((*particleIterator).emitterID_);
-					if (emitDir.has_value()) {
-						dir = emitDir.value();
-						hasDir = true;
-					}
-				}
-
-				if (hasDir) {
-					if (Vector3Math::LengthSq(dir) > 1e-6f) {
-
-						Vector3 to = Vector3Math::Normalize(dir);
-
-						// パーティクルの基準前方向（ローカル +Z を前と仮定）
-						Vector3 from = { 0.0f, 0.0f, 1.0f };
-						// PrimitiveTypeごとのデフォルトの向きに合わせて基準ベクトルを変更
-						switch (particlePreset_.primitiveType) {
-						case PRIMITIVE_CONE:
-						case PRIMITIVE_CYLINDER:
-							from = { 0.0f, 1.0f, 0.0f }; // 円錐・円柱はY軸が高さ方向
-							break;
-						case PRIMITIVE_PLANE:
-							from = { 0.0f, 0.0f, -1.0f }; // Planeは法線が-Zを向いている
-							break;
-						default:
-							from = { 0.0f, 0.0f, 1.0f }; // その他（Ring, Sphere, Cube）はZ軸基準
-							break;
-						}
-
-						float d = Vector3Math::Dot(from, to);
-						d = std::clamp(d, -1.0f, 1.0f);
-
-						Quaternion targetRotate;
-
-						if (d > 1.0f - 1e-5f) {
-							targetRotate = QuaternionMath::IdentityQuaternion();
-						}
-						else if (d < -1.0f + 1e-5f) {
-							// 真逆(180度)は軸が不定なので、fromと直交する軸を適当に選ぶ
-							Vector3 ortho = (std::fabs(from.y) < 0.999f) ? Vector3{ 0,1,0 } : Vector3{ 1,0,0 };
-							Vector3 axis = Vector3Math::Normalize(Vector3Math::Cross(from, ortho));
-							targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, std::numbers::pi_v<float>);
-						}
-						else {
-							Vector3 axis = Vector3Math::Cross(from, to);
-							axis = Vector3Math::Normalize(axis);
-							float angle = std::acos(d);
-							targetRotate = QuaternionMath::MakeRotateAxisAngleQuaternion(axis, angle);
-						}
-
-						Quaternion& current = (*particleIterator).transforms_.rotate;
-
-						// shortest-arc
-						if (QuaternionMath::Dot(current, targetRotate) < 0.0f) {
-							targetRotate = -targetRotate;
-						}
-
-						current = Easing::Slerp(current, targetRotate, 1.0f); // 例: 0.05f〜0.3f
-						current = QuaternionMath::Normalize(current);
-					}
+					addPass(&PrimitiveParticle::AlignToEmitter);
 				}
 			}
-		
 		} else {
-			if (attributes.isDecelerate) {
-				(*particleIterator).transforms_.translate += (*particleIterator).velocity_ * (1.0f - velocityProgress) * kDeltaTime_;
-			} else {
-				(*particleIterator).transforms_.translate += (*particleIterator).velocity_ * velocityProgress * kDeltaTime_;
-			}
+			addPass(&PrimitiveParticle::IntegrateVelocity);
+		}
+		if (attributes.isDirectional) {
+			addPass(&PrimitiveParticle::MoveDirectional);
 		}
+	}
+	if (useScale) {
+		addPass(&PrimitiveParticle::UpdateScale);
+	}
+	if (attributes.editColorGradient) {
+		addPass(&PrimitiveParticle::UpdateColorGradient);
+	} else {
+		addPass(&PrimitiveParticle::UpdateColorFade);
+	}
+	addPass(&PrimitiveParticle::UpdateLifeTimer);
+	if (attributes.isParticleTrail) {
+		addPass(&PrimitiveParticle::RecordTrails);
+	}
 
-		if(attributes.isDirectional){
-			//方向に沿って移動
-			(*particleIterator).velocity_ += attributes.direction * kDeltaTime_;
-			if (attributes.isDecelerate) {
-				(*particleIterator).transforms_.translate += (*particleIterator).velocity_ * (1.0f - velocityProgress) * kDeltaTime_;
-			} else {
-				(*particleIterator).transforms_.translate += (*particleIterator).velocity_ * velocityProgress * kDeltaTime_;
+	//--- イージングの解決 ---
+	lifeTimeEaseBatch_ = Easing::GetEaseBatch(attributes.lifeTimeEasingType);
+	velocityEaseBatch_ = useVelocity ? Easing::GetEaseBatch(attributes.velocityEasingType) : nullptr;
+	scaleEaseBatch_ = useScale ? Easing::GetEaseBatch(attributes.scaleEasingType) : nullptr;
+	colorEaseBatch_ = attributes.editColorGradient ? Easing::GetEaseBatch(attributes.colorEasingType) : nullptr;
+	isDecelerate_ = attributes.isDecelerate;
+
+	//--- 属性由来の定数 ---
+	if (attributes.scaleSetting == static_cast<uint32_t>(ScaleSetting::ScaleUp)) {
+		scaleFrom_ = attributes.scaleRange.min;
+		scaleTo_ = attributes.scaleRange.max;
+	} else {
+		scaleFrom_ = attributes.scaleRange.max;
+		scaleTo_ = attributes.scaleRange.min;
+	}
+
+	// PrimitiveTypeごとのデフォルトの向きに合わせて基準ベクトルを変更(発生時と同じものを使う)
+	alignForward_ = GetAlignForward(particlePreset_.primitiveType);
+}
+
+//=============================================================================
+// ブロックの寿命判定とイージングの一括評価
+//=============================================================================
+void PrimitiveParticle::PrepareMovementBlock(MovementBlock& block) {
+
+	for (uint32_t i = 0; i < block.count; ++i) {
+		const Timer& lifeTimer = particles_.lifeTimer[block.begin + i];
+		// 寿命が来たものはMergeUpdateで削除する(削除されるため、他の処理の結果は使われない)
+		deadFlags_[block.begin + i] = lifeTimer.IsFinished() ? 1 : 0;
+		block.progress[i] = lifeTimer.GetProgress();
+	}
+
+	lifeTimeEaseBatch_(block.progress, block.lifeTimeEase, block.count);
+
+	if (velocityEaseBatch_) {
+		velocityEaseBatch_(block.progress, block.velocityFactor, block.count);
+		if (isDecelerate_) {
+			// スパーク用：徐々に減速する
+			for (uint32_t i = 0; i < block.count; ++i) {
+				block.velocityFactor[i] = 1.0f - block.velocityFactor[i];
 			}
 		}
 	}
+	if (scaleEaseBatch_) {
+		scaleEaseBatch_(block.progress, block.scaleEase, block.count);
+	}
+	if (colorEaseBatch_) {
+		colorEaseBatch_(block.progress, block.colorEase, block.count);
+	}
+}
 
-	if (attributes.scaleSetting == static_cast<uint32_t>(ScaleSetting::ScaleUp)) {
-		//スケールの更新(拡大)
-		(*particleIterator).transforms_.scale.x = Easing::Lerp(
-			attributes.scaleRange.min,
-			attributes.scaleRange.max,
-			scaleProgress);
-
-		(*particleIterator).transforms_.scale.y = Easing::Lerp(
-			attributes.scaleRange.min,
-			attributes.scaleRange.max,
-			scaleProgress);
-		(*particleIterator).transforms_.scale.z = Easing::Lerp(
-			attributes.scaleRange.min,
-			attributes.scaleRange.max,
-			scaleProgress);
-
-	} else if (attributes.scaleSetting == static_cast<uint32_t>(ScaleSetting::ScaleDown)) {
-		//スケールの更新(縮小)
-		(*particleIterator).transforms_.scale.x = Easing::Lerp(
-			attributes.scaleRange.max,
-			attributes.scaleRange.min,
-			scaleProgress);
-		(*particleIterator).transforms_.scale.y = Easing::Lerp(
-			attributes.scaleRange.max,
-			attributes.scaleRange.min,
-			scaleProgress);
-		(*particleIterator).transforms_.scale.z = Easing::Lerp(
-			attributes.scaleRange.max,
-			attributes.scaleRange.min,
-			scaleProgress);
-	}
-
-	//alphaの計算
-	float alpha = 1.0f - lifeTimeProgress;
-	//色の設定
-	if (attributes.editColorGradient) {
+//=============================================================================
+// 更新前の位置の保存
+//=============================================================================
+void PrimitiveParticle::SaveTrailOrigin(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		block.oldPosition[i] = particles_.translate[block.begin + i];
+	}
+}
+
+//=============================================================================
+// 重力
+//=============================================================================
+void PrimitiveParticle::ApplyGravity(MovementBlock& block) {
+	const Vector3 gravity = particlePreset_.attribute.gravity * kDeltaTime_;
+	for (uint32_t i = 0; i < block.count; ++i) {
+		particles_.velocity[block.begin + i] += gravity;
+	}
+}
+
+//=============================================================================
+// エミッター追従
+//=============================================================================
+void PrimitiveParticle::FollowEmitter(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		// エミッターIDから現在のエミッター姿勢を取得(解放済みのエミッターはnullptr)
+		const EmitterTransform* emitterTransform =
+			emitterAllocator_->FindTransform(static_cast<uint32_t>(particles_.emitterID[index]));
+		if (emitterTransform != nullptr) {
+			particles_.translate[index] = emitterTransform->position;
+		}
+	}
+}
+
+//=============================================================================
+// エミッターの発射方向に回転を合わせる
+//=============================================================================
+void PrimitiveParticle::AlignToEmitter(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		const EmitterTransform* emitterTransform =
+			emitterAllocator_->FindTransform(static_cast<uint32_t>(particles_.emitterID[index]));
+		if (emitterTransform != nullptr) {
+			AlignRotation(particles_.rotate[index], emitterTransform->direction);
+		}
+	}
+}
+
+//=============================================================================
+// 速度の向きに回転を合わせる
+//=============================================================================
+void PrimitiveParticle::AlignToVelocity(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		AlignRotation(particles_.rotate[index], particles_.velocity[index]);
+	}
+}
+
+//=============================================================================
+// 速度による移動
+//=============================================================================
+void PrimitiveParticle::IntegrateVelocity(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		particles_.translate[index] += particles_.velocity[index] * block.velocityFactor[i] * kDeltaTime_;
+	}
+}
+
+//=============================================================================
+// 方向に沿った加速と移動
+//=============================================================================
+void PrimitiveParticle::MoveDirectional(MovementBlock& block) {
+	const Vector3 acceleration = particlePreset_.attribute.direction * kDeltaTime_;
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		Vector3& velocity = particles_.velocity[index];
+		velocity += acceleration;
+		particles_.translate[index] += velocity * block.velocityFactor[i] * kDeltaTime_;
+	}
+}
+
+//=============================================================================
+// スケールの補間
+//=============================================================================
+void PrimitiveParticle::UpdateScale(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		float scale = Easing::Lerp(scaleFrom_, scaleTo_, block.scaleEase[i]);
+		particles_.scale[block.begin + i] = { scale, scale, scale };
+	}
+}
+
+//=============================================================================
+// 色遷移と透明度
+//=============================================================================
+void PrimitiveParticle::UpdateColorGradient(MovementBlock& block) {
+	const ParticleAttributes& attributes = particlePreset_.attribute;
+	for (uint32_t i = 0; i < block.count; ++i) {
 		// 色遷移：startColor → endColor をイージングで補間
-		float colorT = (*particleIterator).lifeTimer_.GetEase(attributes.colorEasingType);
-		Vector3 rgb = {
+		float colorT = block.colorEase[i];
+		particles_.drawColor[block.begin + i] = {
 			Easing::Lerp(attributes.startColor.x, attributes.endColor.x, colorT),
 			Easing::Lerp(attributes.startColor.y, attributes.endColor.y, colorT),
-			Easing::Lerp(attributes.startColor.z, attributes.endColor.z, colorT)
-		};
-		particleData_[numInstance_].color = { rgb.x, rgb.y, rgb.z, alpha };
-	} else {
-		particleData_[numInstance_].color = {
-			(*particleIterator).color_.x,
-			(*particleIterator).color_.y,
-			(*particleIterator).color_.z,
-			alpha
+			Easing::Lerp(attributes.startColor.z, attributes.endColor.z, colorT),
+			1.0f - block.lifeTimeEase[i]
 		};
 	}
+}
+
+//=============================================================================
+// 透明度
+//=============================================================================
+void PrimitiveParticle::UpdateColorFade(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		const Vector4& color = particles_.color[index];
+		particles_.drawColor[index] = { color.x, color.y, color.z, 1.0f - block.lifeTimeEase[i] };
+	}
+}
+
+//=============================================================================
+// 寿命タイマーの更新
+//=============================================================================
+void PrimitiveParticle::UpdateLifeTimer(MovementBlock& block) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		particles_.lifeTimer[block.begin + i].Update();
+	}
+}
 
-	//経過時間の更新
-	(*particleIterator).lifeTimer_.Update(); 
+//=============================================================================
+// トレイルの軌跡の記録
+//=============================================================================
+void PrimitiveParticle::RecordTrails(MovementBlock& block) {
 
-	float newTime = (*particleIterator).lifeTimer_.GetProgress() * (*particleIterator).lifeTimer_.GetDuration();
+	const float interval = particlePreset_.attribute.trailEmitInterval;
 
-	// --- トレイル（補間）処理 ---
-	if (attributes.isParticleTrail && (*particleIterator).isTrailParent_) {
+	for (uint32_t i = 0; i < block.count; ++i) {
+		uint32_t index = block.begin + i;
+		if (deadFlags_[index]) {
+			continue;
+		}
 
 		// タイマーを更新（残りを保持するために減算方式）
-		(*particleIterator).trailSpawnTimer_ += kDeltaTime_;
-
-		// もし interval を複数回超えていたら、複数回分生成できるようにループする
-		while ((*particleIterator).trailSpawnTimer_ >= attributes.trailEmitInterval) {
-			// 残り時間を減らす（0 にリセットするより正確）
-			(*particleIterator).trailSpawnTimer_ -= attributes.trailEmitInterval;
-
-			// 指定回数分、位置を補間して子パーティクルを生成
-			size_t n = attributes.particlesPerInterpolation;
-			for (size_t i = 0; i < n; ++i) {
-				float t = static_cast<float>(i + 1) / static_cast<float>(n + 1);
-
-				Particle trailParticle = *particleIterator; // 親をコピー
-				// 補間位置
-				trailParticle.transforms_.translate =
-					Easing::Lerp(oldPosition, (*particleIterator).transforms_.translate, t);
-				// 補間経過時間（親の oldTime -> newTime）
-				float lerpedTime = Easing::Lerp(oldTime, newTime, t);
-				trailParticle.lifeTimer_.Initialize((*particleIterator).lifeTimer_.GetDuration(), lerpedTime);
-
-				//移動させる必要がないため、速度を0に設定
-				trailParticle.velocity_ = Vector3(0.0f, 0.0f, 0.0f);
-
-				// トレイルは親化しない（更なるトレイルを作らない）
-				trailParticle.isTrailParent_ = false;
-				// トレイル固有のタイマーはリセット
-				trailParticle.trailSpawnTimer_ = 0.0f;
-
-				// 直接 particles_ に挿入せず pending に積む（次フレーム扱いにする）
-				pendingParticles_.push_back(std::move(trailParticle));
-			}
+		float& spawnTimer = particles_.trailSpawnTimer[index];
+		spawnTimer += kDeltaTime_;
+		uint32_t sampleCount = 0;
+		while (spawnTimer >= interval) {
+			spawnTimer -= interval;
+			++sampleCount;
+		}
+
+		// 間隔を複数回超えていたら、前フレームからの移動を等分した位置をその数だけ記録する
+		// (リングバッファに残らない古い分は飛ばす)
+		TrailHistory& history = particles_.trailHistory[index];
+		uint32_t firstSample = sampleCount > TrailHistory::kMaxSamples ? sampleCount - TrailHistory::kMaxSamples : 0;
+		for (uint32_t sample = firstSample; sample < sampleCount; ++sample) {
+			float t = static_cast<float>(sample) / static_cast<float>(sampleCount);
+			history.Push(Easing::Lerp(block.oldPosition[i], particles_.translate[index], t));
 		}
 	}
+}
 
-	
-}
\ No newline at end of file
+//=============================================================================
+// トレイルのインスタンスの書き込み
+//=============================================================================
+void PrimitiveParticle::WriteTrailInstances(uint32_t index, uint32_t firstInstance, uint32_t instanceCount, const ParticleForGPU& parent) {
+
+	const TrailHistory& history = particles_.trailHistory[index];
+	if (instanceCount == 0) {
+		return;
+	}
+
+	// 区間(古いサンプル→次のサンプル、最新のサンプル→現在位置)を等分した位置に、親と同じ姿勢で並べる
+	// 古い位置ほど透明にして、末尾に向かって細っていく帯に見せる(書き込み数が足りない分は古い方から省く)
+	const uint32_t totalCount = history.count * trailSegmentInstanceCount_;
+	const uint32_t skipCount = totalCount - instanceCount;
+	ParticleForGPU trail = parent;
+	trail.velocity = { 0.0f, 0.0f, 0.0f };
+	const float stepT = 1.0f / static_cast<float>(trailSegmentInstanceCount_);
+	const float stepAlpha = parent.color.w / static_cast<float>(totalCount);
+
+	for (uint32_t instance = skipCount; instance < totalCount; ++instance) {
+		const uint32_t segment = instance / trailSegmentInstanceCount_;
+		const uint32_t step = instance % trailSegmentInstanceCount_;
+		const Vector3& from = history.GetSample(segment);
+		const Vector3& to = segment + 1 < history.count ? history.GetSample(segment + 1) : parent.translate;
+		trail.translate = Easing::Lerp(from, to, static_cast<float>(step) * stepT);
+		trail.color.w = stepAlpha * static_cast<float>(instance + 1);
+		particleData_[firstInstance + instance - skipCount] = trail;
+	}
+}
+
+//=============================================================================
+// 描画順を並べ直すかどうか
+//=============================================================================
+bool PrimitiveParticle::NeedsDepthSort(DepthSortMode sortMode, const Vector3& cameraPosition, const Vector3& cameraForward, uint32_t particleCount) const {
+
+	if (sortMode == DepthSortMode::Always) {
+		return true;
+	}
+
+	// 前回の並びが無い・パーティクルがクリアされた場合は使い回せない
+	if (drawOrder_.size() != orderedCount_ || particleCount < orderedCount_ || particleCount == 0) {
+		return true;
+	}
+
+	// カメラが一定以上動いた・向きを変えた場合と、一定フレーム毎に並べ直す
+	return Vector3Math::LengthSq(cameraPosition - sortedCameraPosition_) > kSortCameraMoveDistance_ * kSortCameraMoveDistance_ ||
+		Vector3Math::Dot(cameraForward, sortedCameraForward_) < kSortCameraTurnCos_ ||
+		sortKeepFrames_ >= kMaxSortKeepFrames_;
+}
+
+//=============================================================================
+// 前回の描画順の付け替え
+//=============================================================================
+void PrimitiveParticle::RemapDrawOrder(uint32_t particleCount) {
+
+	// 削除前 → 削除後のインデックス(削除されたものは無効値)
+	constexpr uint32_t kRemoved = (std::numeric_limits<uint32_t>::max)();
+	remapIndices_.assign(particleCount, kRemoved);
+	for (uint32_t index = 0; index < static_cast<uint32_t>(slotOwners_.size()); ++index) {
+		remapIndices_[slotOwners_[index]] = index;
+	}
+
+	// 前回の並びを保ったまま詰め、並べた後に発生したものは末尾(手前)に足す
+	uint32_t writeCount = 0;
+	for (uint32_t index : drawOrder_) {
+		if (remapIndices_[index] != kRemoved) {
+			drawOrder_[writeCount++] = remapIndices_[index];
+		}
+	}
+	drawOrder_.resize(writeCount);
+	for (uint32_t index = orderedCount_; index < particleCount; ++index) {
+		if (remapIndices_[index] != kRemoved) {
+			drawOrder_.push_back(remapIndices_[index]);
+		}
+	}
+	assert(drawOrder_.size() == particles_.GetCount());
+	orderedCount_ = particles_.GetCount();
+}
+
+//=============================================================================
+// 奥行きによる並べ替え
+//=============================================================================
+void PrimitiveParticle::SortByDepth(const Vector3& cameraPosition, const Vector3& cameraForward) {
+
+	JobSystem& jobSystem = JobSystem::GetInstance();
+	const uint32_t count = particles_.GetCount();
+	const uint32_t chunkCount = JobSystem::GetChunkCount(count, RadixSort::kGrainSize_);
+
+	depths_.resize(count);
+	depthKeys_.resize(count);
+	drawOrder_.resize(count);
+	std::iota(drawOrder_.begin(), drawOrder_.end(), 0u);
+
+	// 奥行きと、量子化に使うチャンク毎の範囲
+	depthChunkRanges_.resize(chunkCount);
+	jobSystem.ParallelFor(count, RadixSort::kGrainSize_, [&](uint32_t begin, uint32_t end) {
+		float minDepth = (std::numeric_limits<float>::max)();
+		float maxDepth = std::numeric_limits<float>::lowest();
+		for (uint32_t index = begin; index < end; ++index) {
+			float depth = Vector3Math::Dot(particles_.translate[index] - cameraPosition, cameraForward);
+			depths_[index] = depth;
+			minDepth = (std::min)(minDepth, depth);
+			maxDepth = (std::max)(maxDepth, depth);
+		}
+		depthChunkRanges_[begin / RadixSort::kGrainSize_] = { minDepth, maxDepth };
+	});
+	float minDepth = (std::numeric_limits<float>::max)();
+	float maxDepth = std::numeric_limits<float>::lowest();
+	for (const auto& [chunkMin, chunkMax] : depthChunkRanges_) {
+		minDepth = (std::min)(minDepth, chunkMin);
+		maxDepth = (std::max)(maxDepth, chunkMax);
+	}
+
+	// 奥ほど小さいキーにして昇順に並べる(= 奥から手前)
+	const float range = maxDepth - minDepth;
+	const float scale = range > 0.0f ? 65535.0f / range : 0.0f;
+	jobSystem.ParallelFor(count, RadixSort::kGrainSize_, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t index = begin; index < end; ++index) {
+			depthKeys_[index] = static_cast<uint16_t>((maxDepth - depths_[index]) * scale);
+		}
+	});
+	depthSorter_.Sort(depthKeys_.data(), drawOrder_);
+
+	orderedCount_ = count;
+	sortKeepFrames_ = 0;
+	sortedCameraPosition_ = cameraPosition;
+	sortedCameraForward_ = cameraForward;
+}
+
+//=============================================================================
+// パーティクルの回転を指定方向へ合わせる
+//=============================================================================
+void PrimitiveParticle::AlignRotation(Quaternion& rotate, const Vector3& dir) const {
+
+	// 発生時と同じ計算で、BuildMovementPassesで解決済みの基準前方向を向ける
+	Quaternion targetRotate;
+	if (MakeAlignRotation(alignForward_, dir, targetRotate)) {
+		rotate = BlendAlignRotation(rotate, targetRotate, 1.0f);
+	}
+}
@@ -1,6 +1,10 @@
 #pragma once
 #include "3d/Particle/BaseParticleGroup.h"
 #include "Primitive/PrimitiveType.h"
+#include "Utility/RadixSort.h"
+#include <array>
+
+class ParticleEmitterAllocator;
 
 //============================================================================
 // PrimitiveParticle class
@@ -24,10 +28,34 @@ public:
 	void Initialize(ParticleCommon* particleCommon, const std::string& filePath) override;
 
 	/// <summary>
-	/// 更新処理
+	/// 更新処理(BeginUpdate～WriteRangeを呼び出し元スレッドで順に行う)
 	/// </summary>
 	void Update() override;
 
+	/// <summary>
+	/// 並列更新の準備
+	/// </summary>
+	/// <returns>UpdateRangeで更新するパーティクル数</returns>
+	uint32_t BeginUpdate();
+
+	/// <summary>
+	/// [begin, end) のパーティクルの移動更新
+	/// begin は kUpdateChunkSize_ の倍数とし、異なる範囲同士は別スレッドから同時に呼び出せる
+	/// </summary>
+	void UpdateRange(uint32_t begin, uint32_t end);
+
+	/// <summary>
+	/// 同期点。寿命の尽きたパーティクルの削除、描画順の決定(半透明時の深度ソート)、トレイルの描画数の集計を行う
+	/// </summary>
+	/// <returns>WriteRangeで書き込むパーティクル数</returns>
+	uint32_t MergeUpdate();
+
+	/// <summary>
+	/// [begin, end) のパーティクルとそのトレイルをGPU用データへ書き込む
+	/// 異なる範囲同士は別スレッドから同時に呼び出せる
+	/// </summary>
+	void WriteRange(uint32_t begin, uint32_t end);
+
 	/// <summary>
 	/// ImGui更新処理
 	/// </summary>
@@ -38,23 +66,15 @@ public:
 	/// </summary>
 	void Draw() override;
 
-	/// <summary>
-	/// パーティクルの生成
-	/// </summary>
-	Particle MakeNewParticle(std::mt19937& randomEngine, const Vector3& translate,const Vector3& direction);
-
 	/// <summary>
 	/// パーティクルの発生
 	/// </summary>
-	std::list<Particle> Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
+	void Emit(const Vector3& emitterPos,const Vector3& direction, uint32_t particleCount);
 
 	uint32_t GetPrimitiveHandle() const { return primitiveHandle_; }
 
-	/// <summary>
-	/// パーティクルの配列の結合処理
-	/// </summary>
-	/// <param name="particles"></param>
-	void SpliceParticles(std::list<Particle> particles);
+	//並列更新で1度に処理するパーティクル数
+	static constexpr uint32_t kUpdateChunkSize_ = 2048;
 
 	/// <summary>
 	/// パーティクルのプリセット設定
@@ -73,14 +93,134 @@ public:
 	void GeneratePrimitive();
 
 private:
+
+	// 移動更新を一括で行う1ブロックの要素数
+	static constexpr uint32_t kMovementBlockSize_ = 256;
+	// 移動更新の処理の最大数
+	static constexpr uint32_t kMaxMovementPasses_ = 10;
+	// OnCameraMove で並べ直すカメラの移動量・向きの変化(前方向の内積)
+	static constexpr float kSortCameraMoveDistance_ = 0.5f;
+	static constexpr float kSortCameraTurnCos_ = 0.9994f; //約2度
+	// OnCameraMove でも並べ直す間隔(フレーム数。新しく発生したパーティクルを並びに入れるため)
+	static constexpr uint32_t kMaxSortKeepFrames_ = 30;
+
+	/// <summary>
+	/// 移動更新1ブロック分の作業領域(UpdateRangeのスタック上に置く)
+	/// </summary>
+	struct MovementBlock {
+		uint32_t begin = 0; //ブロック先頭のインデックス
+		uint32_t count = 0; //ブロックの要素数
+		float progress[kMovementBlockSize_];       //寿命の進捗(更新前)
+		float lifeTimeEase[kMovementBlockSize_];   //寿命のイージング
+		float velocityFactor[kMovementBlockSize_]; //速度のイージング(減速時は 1 - イージング)
+		float scaleEase[kMovementBlockSize_];      //スケールのイージング
+		float colorEase[kMovementBlockSize_];      //色遷移のイージング
+		Vector3 oldPosition[kMovementBlockSize_];  //更新前の位置(トレイル用)
+	};
+
+	// ブロック単位の移動更新処理
+	using MovementPass = void (PrimitiveParticle::*)(MovementBlock& block);
+
 	uint32_t primitiveHandle_ = 0; // プリミティブのハンドル
 
-	std::list<Particle> pendingParticles_; // 発生待ちパーティクルのリスト
+	std::vector<uint8_t> deadFlags_; // 更新前に寿命が尽きていたかどうか
+	std::vector<uint32_t> instanceOffsets_;      // 描画位置毎の書き込み先の先頭(軌跡→本体の順。末尾は総インスタンス数)
+	uint32_t trailSegmentInstanceCount_ = 0;     // トレイルの1区間に描画するインスタンス数(0ならトレイルなし)
+
+	// 深度ソート(描画順はインデックスで持ち、パーティクル本体は並べ替えない)
+	RadixSort depthSorter_;
+	std::vector<float> depths_;          // 各パーティクルのカメラからの奥行き
+	std::vector<std::pair<float, float>> depthChunkRanges_; // 並列処理のチャンク毎の奥行きの範囲(量子化用)
+	std::vector<uint16_t> depthKeys_;    // 奥行きを量子化したキー(奥ほど小さい)
+	std::vector<uint32_t> drawOrder_;    // 描画順に並べたパーティクルのインデックス(空なら格納順)
+	std::vector<uint32_t> slotOwners_;   // 削除前のインデックス(並びを使い回す時の付け替え用)
+	std::vector<uint32_t> remapIndices_; // 削除前 → 削除後のインデックス
+	uint32_t orderedCount_ = 0;          // drawOrder_を決めた時点のパーティクル数(以降に発生したものは末尾に足す)
+	uint32_t sortKeepFrames_ = 0;        // 並べ直さずに使い回したフレーム数
+	Vector3 sortedCameraPosition_ = { 0.0f, 0.0f, 0.0f }; // 並べた時のカメラ位置
+	Vector3 sortedCameraForward_ = { 0.0f, 0.0f, 1.0f };  // 並べた時のカメラ前方向
+	const ParticleEmitterAllocator* emitterAllocator_ = nullptr; // エミッター姿勢の参照先(BeginUpdateで取得)
+
+	// 属性の組み合わせから選んだ移動更新の処理列(BeginUpdateで組み立てる)
+	std::array<MovementPass, kMaxMovementPasses_> movementPasses_{};
+	uint32_t movementPassCount_ = 0;
+
+	// BeginUpdateで解決したイージング(使わないものはnullptr)
+	Easing::EasingBatchFunction lifeTimeEaseBatch_ = nullptr;
+	Easing::EasingBatchFunction velocityEaseBatch_ = nullptr;
+	Easing::EasingBatchFunction scaleEaseBatch_ = nullptr;
+	Easing::EasingBatchFunction colorEaseBatch_ = nullptr;
+
+	// BeginUpdateで解決した属性由来の定数
+	Vector3 alignForward_ = { 0.0f, 0.0f, 1.0f }; // 回転を合わせる際の基準前方向
+	float scaleFrom_ = 0.0f;  // スケールの補間開始値
+	float scaleTo_ = 0.0f;    // スケールの補間終了値
+	bool isDecelerate_ = false; // 速度のイージングを反転するかどうか
+
 private:
 
 	/// <summary>
-	/// パーティクルの移動更新
+	/// 属性の組み合わせから移動更新の処理列とイージングを解決する
+	/// </summary>
+	void BuildMovementPasses();
+
+	/// <summary>
+	/// ブロックの寿命判定とイージングの一括評価
+	/// </summary>
+	void PrepareMovementBlock(MovementBlock& block);
+
+	//=========================================================================
+	// 移動更新の各処理(ブロック内の全要素に同じ処理を行う)
+	//=========================================================================
+
+	void SaveTrailOrigin(MovementBlock& block);    //更新前の位置の保存
+	void ApplyGravity(MovementBlock& block);       //重力
+	void FollowEmitter(MovementBlock& block);      //エミッター追従
+	void AlignToEmitter(MovementBlock& block);     //エミッターの発射方向に回転を合わせる
+	void AlignToVelocity(MovementBlock& block);    //速度の向きに回転を合わせる
+	void IntegrateVelocity(MovementBlock& block);  //速度による移動
+	void MoveDirectional(MovementBlock& block);    //方向に沿った加速と移動
+	void UpdateScale(MovementBlock& block);        //スケールの補間
+	void UpdateColorGradient(MovementBlock& block);//色遷移と透明度
+	void UpdateColorFade(MovementBlock& block);    //透明度
+	void UpdateLifeTimer(MovementBlock& block);    //寿命タイマー
+	void RecordTrails(MovementBlock& block);       //トレイルの軌跡の記録
+
+	/// <summary>
+	/// トレイルの軌跡を区間毎に補間し、インスタンスとして書き込む
+	/// </summary>
+	/// <param name="index">パーティクルのインデックス</param>
+	/// <param name="firstInstance">書き込み先の先頭のインスタンス</param>
+	/// <param name="instanceCount">書き込むインスタンス数(軌跡の全インスタンスより少なければ古い方から省く)</param>
+	/// <param name="parent">パーティクル本体のGPU用データ</param>
+	void WriteTrailInstances(uint32_t index, uint32_t firstInstance, uint32_t instanceCount, const ParticleForGPU& parent);
+
+	/// <summary>
+	/// 描画順を並べ直すかどうか(並びを使い回せない・カメラが動いた場合true)
+	/// </summary>
+	/// <param name="sortMode">深度ソートの方法</param>
+	/// <param name="cameraPosition">カメラの位置</param>
+	/// <param name="cameraForward">カメラの前方向</param>
+	/// <param name="particleCount">削除前のパーティクル数</param>
+	bool NeedsDepthSort(DepthSortMode sortMode, const Vector3& cameraPosition, const Vector3& cameraForward, uint32_t particleCount) const;
+
+	/// <summary>
+	/// 前回の描画順を削除後のインデックスに付け替え、その後に発生したパーティクルを末尾に足す
+	/// </summary>
+	/// <param name="particleCount">削除前のパーティクル数</param>
+	void RemapDrawOrder(uint32_t particleCount);
+
+	/// <summary>
+	/// 奥行きを量子化したキーで奥から手前の順に並べる
+	/// </summary>
+	/// <param name="cameraPosition">カメラの位置</param>
+	/// <param name="cameraForward">カメラの前方向</param>
+	void SortByDepth(const Vector3& cameraPosition, const Vector3& cameraForward);
+
+	/// <summary>
+	/// パーティクルの回転を指定方向へ合わせる
 	/// </summary>
-	/// <param name="particleIterator"></param>
-	void UpdateMovement(std::list<Particle>::iterator particleIterator);
+	/// <param name="rotate">更新する回転</param>
+	/// <param name="dir">向ける方向</param>
+	void AlignRotation(Quaternion& rotate, const Vector3& dir) const;
 };
\ No newline at end of file
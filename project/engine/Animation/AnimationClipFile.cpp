@@ -0,0 +1,247 @@
+#include "AnimationClipFile.h"
+#include "engine/Animation/Animator.h"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+using namespace TakeC;
+
+namespace {
+
+	//キーフレームはファイル上の並びのままコピーする
+	static_assert(std::is_trivially_copyable_v<KeyframeVector3> && sizeof(KeyframeVector3) == 16);
+	static_assert(std::is_trivially_copyable_v<KeyframeQuaternion> && sizeof(KeyframeQuaternion) == 20);
+
+	//[offset, offset + count * elementSize) がファイル内に収まるかどうか
+	bool IsInRange(uint64_t fileSize, uint64_t offset, uint64_t count, uint64_t elementSize) {
+		return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+	}
+
+	//バッファの末尾にPODを追加し、追加した位置を返す
+	template <typename T>
+	uint32_t Append(std::vector<char>& buffer, const T* data, size_t count) {
+		uint32_t offset = static_cast<uint32_t>(buffer.size());
+		buffer.resize(buffer.size() + sizeof(T) * count);
+		if (count > 0) {
+			std::memcpy(buffer.data() + offset, data, sizeof(T) * count);
+		}
+		return offset;
+	}
+}
+
+//=============================================================================
+// 元ファイルの識別情報の取得
+//=============================================================================
+AnimationClipFile::SourceStamp AnimationClipFile::MakeSourceStamp(const std::filesystem::path& sourcePath) {
+	namespace fs = std::filesystem;
+
+	SourceStamp stamp;
+	std::error_code error;
+	uintmax_t size = fs::file_size(sourcePath, error);
+	if (error) {
+		return stamp;
+	}
+	fs::file_time_type writeTime = fs::last_write_time(sourcePath, error);
+	if (error) {
+		return stamp;
+	}
+	stamp.size = static_cast<uint64_t>(size);
+	stamp.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+	return stamp;
+}
+
+//=============================================================================
+// 焼き込んで保存
+//=============================================================================
+bool AnimationClipFile::Save(const std::filesystem::path& filePath, const SourceStamp& stamp,
+	const std::map<std::string, Animation*>& animations) {
+	namespace fs = std::filesystem;
+
+	// 各領域の内容を先に集める
+	std::vector<AnimationRecord> animationRecords;
+	std::vector<ChannelRecord> channelRecords;
+	std::vector<KeyframeVector3> vector3Keys;
+	std::vector<KeyframeQuaternion> quaternionKeys;
+	std::string strings;
+
+	auto addString = [&strings](const std::string& value, uint32_t& offset, uint32_t& length) {
+		offset = static_cast<uint32_t>(strings.size());
+		length = static_cast<uint32_t>(value.size());
+		strings += value;
+	};
+
+	for (const auto& [animationName, animation] : animations) {
+		AnimationRecord& animationRecord = animationRecords.emplace_back();
+		addString(animationName, animationRecord.nameOffset, animationRecord.nameLength);
+		animationRecord.duration = animation->duration;
+		animationRecord.firstChannel = static_cast<uint32_t>(channelRecords.size());
+		animationRecord.channelCount = static_cast<uint32_t>(animation->nodeAnimations.size());
+
+		// mapの順(名前順)で並べるため、読み込み時は末尾への挿入で済む
+		for (const auto& [nodeName, nodeAnimation] : animation->nodeAnimations) {
+			//圧縮後のカーブは保存できないので、圧縮前に保存すること
+			assert(!nodeAnimation.translate.IsCompressed() && !nodeAnimation.rotate.IsCompressed() && !nodeAnimation.scale.IsCompressed());
+			ChannelRecord& channel = channelRecords.emplace_back();
+			addString(nodeName, channel.nameOffset, channel.nameLength);
+
+			const auto& translateKeys = nodeAnimation.translate.keyframes;
+			channel.translateFirst = static_cast<uint32_t>(vector3Keys.size());
+			channel.translateCount = static_cast<uint32_t>(translateKeys.size());
+			vector3Keys.insert(vector3Keys.end(), translateKeys.begin(), translateKeys.end());
+
+			const auto& rotateKeys = nodeAnimation.rotate.keyframes;
+			channel.rotateFirst = static_cast<uint32_t>(quaternionKeys.size());
+			channel.rotateCount = static_cast<uint32_t>(rotateKeys.size());
+			quaternionKeys.insert(quaternionKeys.end(), rotateKeys.begin(), rotateKeys.end());
+
+			const auto& scaleKeys = nodeAnimation.scale.keyframes;
+			channel.scaleFirst = static_cast<uint32_t>(vector3Keys.size());
+			channel.scaleCount = static_cast<uint32_t>(scaleKeys.size());
+			vector3Keys.insert(vector3Keys.end(), scaleKeys.begin(), scaleKeys.end());
+		}
+	}
+
+	// 1つのバッファにまとめる
+	FileHeader header = {};
+	std::memcpy(header.magic, kMagic_, sizeof(header.magic));
+	header.version = kVersion_;
+	header.sourceSize = stamp.size;
+	header.sourceWriteTime = stamp.writeTime;
+	header.animationCount = static_cast<uint32_t>(animationRecords.size());
+	header.channelCount = static_cast<uint32_t>(channelRecords.size());
+	header.vector3KeyCount = static_cast<uint32_t>(vector3Keys.size());
+	header.quaternionKeyCount = static_cast<uint32_t>(quaternionKeys.size());
+	header.stringSize = static_cast<uint32_t>(strings.size());
+
+	std::vector<char> buffer(sizeof(FileHeader));
+	header.animationOffset = Append(buffer, animationRecords.data(), animationRecords.size());
+	header.channelOffset = Append(buffer, channelRecords.data(), channelRecords.size());
+	header.vector3KeyOffset = Append(buffer, vector3Keys.data(), vector3Keys.size());
+	header.quaternionKeyOffset = Append(buffer, quaternionKeys.data(), quaternionKeys.size());
+	header.stringOffset = Append(buffer, strings.data(), strings.size());
+	header.fileSize = buffer.size();
+	std::memcpy(buffer.data(), &header, sizeof(FileHeader));
+
+	// 書きかけのファイルを読まないよう、一時ファイルに書いてから置き換える
+	std::error_code error;
+	fs::create_directories(filePath.parent_path(), error);
+	fs::path tempPath = filePath;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if (!file) {
+			return false;
+		}
+	}
+	fs::rename(tempPath, filePath, error);
+	return !error;
+}
+
+//=============================================================================
+// 焼き込んだアニメーションの読み込み
+//=============================================================================
+bool AnimationClipFile::Load(const std::filesystem::path& filePath, const SourceStamp& stamp,
+	std::map<std::string, Animation*>& animations) {
+
+	// ファイル全体を1回で読み込む
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		return false;
+	}
+	const std::streamoff fileSize = file.tellg();
+	if (fileSize < static_cast<std::streamoff>(sizeof(FileHeader))) {
+		return false;
+	}
+	std::vector<char> buffer(static_cast<size_t>(fileSize));
+	file.seekg(0);
+	if (!file.read(buffer.data(), fileSize)) {
+		return false;
+	}
+
+	// ヘッダと各領域の範囲の確認
+	FileHeader header;
+	std::memcpy(&header, buffer.data(), sizeof(FileHeader));
+	if (std::memcmp(header.magic, kMagic_, sizeof(header.magic)) != 0 || header.version != kVersion_) {
+		return false;
+	}
+	if (header.fileSize != static_cast<uint64_t>(fileSize)) {
+		return false;
+	}
+	if (header.sourceSize != stamp.size || header.sourceWriteTime != stamp.writeTime) {
+		return false;
+	}
+	const uint64_t size = header.fileSize;
+	if (!IsInRange(size, header.animationOffset, header.animationCount, sizeof(AnimationRecord)) ||
+		!IsInRange(size, header.channelOffset, header.channelCount, sizeof(ChannelRecord)) ||
+		!IsInRange(size, header.vector3KeyOffset, header.vector3KeyCount, sizeof(KeyframeVector3)) ||
+		!IsInRange(size, header.quaternionKeyOffset, header.quaternionKeyCount, sizeof(KeyframeQuaternion)) ||
+		!IsInRange(size, header.stringOffset, header.stringSize, sizeof(char))) {
+		return false;
+	}
+
+	// 各領域は4バイト境界に置いているので、そのまま参照する
+	const char* base = buffer.data();
+	const auto* animationRecords = reinterpret_cast<const AnimationRecord*>(base + header.animationOffset);
+	const auto* channelRecords = reinterpret_cast<const ChannelRecord*>(base + header.channelOffset);
+	const auto* vector3Keys = reinterpret_cast<const KeyframeVector3*>(base + header.vector3KeyOffset);
+	const auto* quaternionKeys = reinterpret_cast<const KeyframeQuaternion*>(base + header.quaternionKeyOffset);
+	const char* strings = base + header.stringOffset;
+
+	auto isValidString = [&header](uint32_t offset, uint32_t length) {
+		return offset <= header.stringSize && length <= header.stringSize - offset;
+	};
+	auto isValidKeys = [](uint32_t first, uint32_t count, uint32_t total) {
+		return first <= total && count <= total - first;
+	};
+
+	// 範囲外を参照するレコードがあれば何も追加せずに失敗させる
+	for (uint32_t i = 0; i < header.animationCount; ++i) {
+		const AnimationRecord& record = animationRecords[i];
+		if (!isValidString(record.nameOffset, record.nameLength) ||
+			!isValidKeys(record.firstChannel, record.channelCount, header.channelCount)) {
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < header.channelCount; ++i) {
+		const ChannelRecord& channel = channelRecords[i];
+		if (!isValidString(channel.nameOffset, channel.nameLength) ||
+			!isValidKeys(channel.translateFirst, channel.translateCount, header.vector3KeyCount) ||
+			!isValidKeys(channel.rotateFirst, channel.rotateCount, header.quaternionKeyCount) ||
+			!isValidKeys(channel.scaleFirst, channel.scaleCount, header.vector3KeyCount)) {
+			return false;
+		}
+	}
+
+	// キーフレームは連続した範囲をそのままコピーする
+	for (uint32_t i = 0; i < header.animationCount; ++i) {
+		const AnimationRecord& record = animationRecords[i];
+
+		Animation* animation = new Animation();
+		animation->serial = AnimationManager::IssueAnimationSerial();
+		animation->name.assign(strings + record.nameOffset, record.nameLength);
+		animation->duration = record.duration;
+
+		for (uint32_t c = record.firstChannel; c < record.firstChannel + record.channelCount; ++c) {
+			const ChannelRecord& channel = channelRecords[c];
+			auto it = animation->nodeAnimations.emplace_hint(animation->nodeAnimations.end(),
+				std::string(strings + channel.nameOffset, channel.nameLength), NodeAnimation{});
+			NodeAnimation& nodeAnimation = it->second;
+
+			const KeyframeVector3* translate = vector3Keys + channel.translateFirst;
+			nodeAnimation.translate.keyframes.assign(translate, translate + channel.translateCount);
+			const KeyframeQuaternion* rotate = quaternionKeys + channel.rotateFirst;
+			nodeAnimation.rotate.keyframes.assign(rotate, rotate + channel.rotateCount);
+			const KeyframeVector3* scale = vector3Keys + channel.scaleFirst;
+			nodeAnimation.scale.keyframes.assign(scale, scale + channel.scaleCount);
+		}
+
+		animations[animation->name] = animation;
+	}
+	return true;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include "engine/Animation/NodeAnimation.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+//============================================================================
+// AnimationClipFile class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// Assimpで読み込んだアニメーションを焼き込んだバイナリ形式の読み書きを行うクラスです。
+	/// 左手系への変換・秒への変換は焼き込み時に済ませ、キーフレームは種類毎に連続した配列で保存します。
+	/// ファイル内の参照は全てファイル先頭からのオフセットで、読み込みは1回の読み出しとコピーのみで行います。
+	/// 元ファイルのサイズと更新日時を記録し、元ファイルが変わった場合は読み込みに失敗させて焼き直させます。
+	/// </summary>
+	class AnimationClipFile {
+	public:
+
+		/// <summary>
+		/// 焼き込み元のファイルを識別する情報
+		/// </summary>
+		struct SourceStamp {
+			uint64_t size = 0;      //ファイルサイズ
+			int64_t writeTime = 0;  //最終更新日時
+		};
+
+		//ファイルの識別子とバージョン(形式を変えたらバージョンを上げる)
+		static constexpr char kMagic_[4] = { 'T', 'C', 'A', 'C' };
+		static constexpr uint32_t kVersion_ = 1;
+		//焼き込んだファイルの拡張子
+		static constexpr const char* kExtension_ = ".anim";
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// 元ファイルの識別情報の取得
+		/// </summary>
+		/// <param name="sourcePath">元ファイルのパス</param>
+		/// <returns>識別情報(ファイルがない場合は0)</returns>
+		static SourceStamp MakeSourceStamp(const std::filesystem::path& sourcePath);
+
+		/// <summary>
+		/// アニメーションを焼き込んで保存する
+		/// </summary>
+		/// <param name="filePath">保存先</param>
+		/// <param name="stamp">元ファイルの識別情報</param>
+		/// <param name="animations">保存するアニメーション(アニメーション名, アニメーション)</param>
+		/// <returns>保存できた場合true</returns>
+		static bool Save(const std::filesystem::path& filePath, const SourceStamp& stamp,
+			const std::map<std::string, Animation*>& animations);
+
+		/// <summary>
+		/// 焼き込んだアニメーションを読み込む
+		/// </summary>
+		/// <param name="filePath">読み込むファイル</param>
+		/// <param name="stamp">元ファイルの識別情報(記録と一致しなければ失敗する)</param>
+		/// <param name="animations">読み込んだアニメーションの追加先(失敗時は変更しない)</param>
+		/// <returns>読み込めた場合true</returns>
+		static bool Load(const std::filesystem::path& filePath, const SourceStamp& stamp,
+			std::map<std::string, Animation*>& animations);
+
+	private:
+
+		//========================================================================
+		// ファイル形式(全てリトルエンディアン・4バイト境界)
+		// [FileHeader][AnimationRecord...][ChannelRecord...][KeyframeVector3...][KeyframeQuaternion...][文字列]
+		//========================================================================
+
+		/// <summary>
+		/// ファイルヘッダ
+		/// </summary>
+		struct FileHeader {
+			char magic[4];
+			uint32_t version;
+			uint64_t fileSize;
+			uint64_t sourceSize;
+			int64_t sourceWriteTime;
+			uint32_t animationCount;
+			uint32_t channelCount;
+			uint32_t vector3KeyCount;    //移動・拡縮のキーフレーム数
+			uint32_t quaternionKeyCount; //回転のキーフレーム数
+			uint32_t stringSize;
+			uint32_t animationOffset;
+			uint32_t channelOffset;
+			uint32_t vector3KeyOffset;
+			uint32_t quaternionKeyOffset;
+			uint32_t stringOffset;
+		};
+
+		/// <summary>
+		/// アニメーション1つ分の情報
+		/// </summary>
+		struct AnimationRecord {
+			uint32_t nameOffset;   //文字列領域内の位置
+			uint32_t nameLength;
+			float duration;        //秒
+			uint32_t firstChannel; //ChannelRecordの先頭
+			uint32_t channelCount;
+		};
+
+		/// <summary>
+		/// Node1つ分のアニメーションの情報(キーフレームは各配列の範囲で持つ)
+		/// </summary>
+		struct ChannelRecord {
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t translateFirst;
+			uint32_t translateCount;
+			uint32_t rotateFirst;
+			uint32_t rotateCount;
+			uint32_t scaleFirst;
+			uint32_t scaleCount;
+		};
+	};
+}
+
+using TakeC::AnimationClipFile;
@@ -0,0 +1,254 @@
+#include "AnimationCompressor.h"
+#include "engine/Animation/Animator.h"
+#include "Easing.h"
+#include "Vector3Math.h"
+
+using namespace TakeC;
+
+namespace {
+
+	//=============================================================================
+	// 値の種類毎の補間と誤差
+	//=============================================================================
+
+	Vector3 Interpolate(const Vector3& v0, const Vector3& v1, float t) {
+		return Easing::Lerp(v0, v1, t);
+	}
+	Quaternion Interpolate(const Quaternion& q0, const Quaternion& q1, float t) {
+		return Easing::Slerp(q0, q1, t);
+	}
+
+	//距離
+	float Difference(const Vector3& v0, const Vector3& v1) {
+		return Vector3Math::Length(v0 - v1);
+	}
+	//なす角(q と -q は同じ回転として扱う)
+	//acos(dot)は角度が小さいとfloatの精度が足りないため、差の長さから求める
+	float Difference(const Quaternion& q0, const Quaternion& q1) {
+		float sign = (q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w) < 0.0f ? -1.0f : 1.0f;
+		float dx = q0.x - q1.x * sign;
+		float dy = q0.y - q1.y * sign;
+		float dz = q0.z - q1.z * sign;
+		float dw = q0.w - q1.w * sign;
+		float chord = std::sqrt(dx * dx + dy * dy + dz * dz + dw * dw);
+		return 4.0f * std::asin(std::min(chord * 0.5f, 1.0f));
+	}
+
+	//=============================================================================
+	// キーフレームの削除
+	//=============================================================================
+
+	//[first, last]の区間を両端の補間で置き換えても、間のキーフレームが許容誤差に収まるか
+	template <typename T>
+	bool IsSegmentWithinTolerance(const std::vector<Keyframe<T>>& keyframes, size_t first, size_t last, float tolerance) {
+		const Keyframe<T>& k0 = keyframes[first];
+		const Keyframe<T>& k1 = keyframes[last];
+		for (size_t i = first + 1; i < last; ++i) {
+			float t = (keyframes[i].time - k0.time) / (k1.time - k0.time);
+			if (Difference(Interpolate(k0.value, k1.value, t), keyframes[i].value) > tolerance) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//前後のキーフレームの補間で再現できるキーフレームを削除する
+	template <typename T>
+	std::vector<Keyframe<T>> ReduceKeyframes(const std::vector<Keyframe<T>>& keyframes, float tolerance) {
+		if (keyframes.size() <= 1) {
+			return keyframes;
+		}
+
+		//全体が一定なら1つにまとめる(1つだけのカーブは全時刻で同じ値を返す)
+		bool isConstant = std::all_of(keyframes.begin(), keyframes.end(), [&](const Keyframe<T>& keyframe) {
+			return Difference(keyframe.value, keyframes.front().value) <= tolerance;
+		});
+		if (isConstant) {
+			return { keyframes.front() };
+		}
+
+		//先頭から、補間で置き換えられる範囲を可能な限り延ばしていく
+		std::vector<Keyframe<T>> reduced;
+		reduced.push_back(keyframes.front());
+		size_t anchor = 0;
+		while (anchor + 1 < keyframes.size()) {
+			size_t last = anchor + 1;
+			while (last + 1 < keyframes.size() && IsSegmentWithinTolerance(keyframes, anchor, last + 1, tolerance)) {
+				++last;
+			}
+			reduced.push_back(keyframes[last]);
+			anchor = last;
+		}
+		return reduced;
+	}
+
+	//=============================================================================
+	// 量子化
+	//=============================================================================
+
+	//量子化による誤差の上限(範囲の1/65535の半分を3軸分)
+	float EstimateQuantizationError(const std::vector<KeyframeVector3>& keyframes) {
+		Vector3 minValue = keyframes.front().value;
+		Vector3 maxValue = keyframes.front().value;
+		for (const KeyframeVector3& keyframe : keyframes) {
+			minValue = { std::min(minValue.x, keyframe.value.x), std::min(minValue.y, keyframe.value.y), std::min(minValue.z, keyframe.value.z) };
+			maxValue = { std::max(maxValue.x, keyframe.value.x), std::max(maxValue.y, keyframe.value.y), std::max(maxValue.z, keyframe.value.z) };
+		}
+		return Vector3Math::Length(maxValue - minValue) * (0.5f / AnimationCompressor::kVector3Max_);
+	}
+	//15bitのsmallest-threeによる回転の誤差の上限(ラジアン)
+	float EstimateQuantizationError(const std::vector<KeyframeQuaternion>&) {
+		return 0.0002f;
+	}
+
+	void Quantize(const std::vector<KeyframeVector3>& keyframes, AnimationCurve<Vector3>& curve) {
+		Vector3 minValue = keyframes.front().value;
+		Vector3 maxValue = keyframes.front().value;
+		for (const KeyframeVector3& keyframe : keyframes) {
+			minValue = { std::min(minValue.x, keyframe.value.x), std::min(minValue.y, keyframe.value.y), std::min(minValue.z, keyframe.value.z) };
+			maxValue = { std::max(maxValue.x, keyframe.value.x), std::max(maxValue.y, keyframe.value.y), std::max(maxValue.z, keyframe.value.z) };
+		}
+		curve.rangeMin = minValue;
+		curve.rangeExtent = maxValue - minValue;
+
+		auto quantize = [](float value, float rangeMin, float extent) -> uint16_t {
+			if (extent <= 0.0f) {
+				return 0;
+			}
+			float normalized = std::clamp((value - rangeMin) / extent, 0.0f, 1.0f);
+			return static_cast<uint16_t>(std::lround(normalized * AnimationCompressor::kVector3Max_));
+		};
+
+		curve.times.clear();
+		curve.packedValues.clear();
+		curve.times.reserve(keyframes.size());
+		curve.packedValues.reserve(keyframes.size() * AnimationCompressor::kPackedStride_);
+		for (const KeyframeVector3& keyframe : keyframes) {
+			curve.times.push_back(keyframe.time);
+			curve.packedValues.push_back(quantize(keyframe.value.x, curve.rangeMin.x, curve.rangeExtent.x));
+			curve.packedValues.push_back(quantize(keyframe.value.y, curve.rangeMin.y, curve.rangeExtent.y));
+			curve.packedValues.push_back(quantize(keyframe.value.z, curve.rangeMin.z, curve.rangeExtent.z));
+		}
+		curve.keyframes.clear();
+		curve.keyframes.shrink_to_fit();
+	}
+
+	//smallest-three: 絶対値が最大の成分を省略し、残りの3成分を15bitずつに量子化する
+	void Quantize(const std::vector<KeyframeQuaternion>& keyframes, AnimationCurve<Quaternion>& curve) {
+		curve.times.clear();
+		curve.packedValues.clear();
+		curve.times.reserve(keyframes.size());
+		curve.packedValues.reserve(keyframes.size() * AnimationCompressor::kPackedStride_);
+
+		for (const KeyframeQuaternion& keyframe : keyframes) {
+			const Quaternion& q = keyframe.value;
+			float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+			float components[4] = { q.x, q.y, q.z, q.w };
+			uint32_t largestIndex = 0;
+			for (uint32_t i = 1; i < 4; ++i) {
+				if (std::fabs(components[i]) > std::fabs(components[largestIndex])) {
+					largestIndex = i;
+				}
+			}
+			//省略する成分が正になるよう符号を揃える(q と -q は同じ回転)
+			float scale = (components[largestIndex] < 0.0f ? -1.0f : 1.0f) / (length > 0.0f ? length : 1.0f);
+
+			uint16_t packed[3];
+			for (uint32_t i = 0, s = 0; i < 4; ++i) {
+				if (i == largestIndex) continue;
+				float normalized = std::clamp(components[i] * scale / AnimationCompressor::kQuaternionRange_ * 0.5f + 0.5f, 0.0f, 1.0f);
+				packed[s++] = static_cast<uint16_t>(std::lround(normalized * AnimationCompressor::kQuaternionMax_));
+			}
+			packed[0] |= static_cast<uint16_t>((largestIndex & 1) << 15);
+			packed[1] |= static_cast<uint16_t>((largestIndex >> 1) << 15);
+
+			curve.times.push_back(keyframe.time);
+			curve.packedValues.insert(curve.packedValues.end(), packed, packed + 3);
+		}
+		curve.keyframes.clear();
+		curve.keyframes.shrink_to_fit();
+	}
+
+	//=============================================================================
+	// 1カーブ分の圧縮
+	//=============================================================================
+
+	//圧縮前後のサンプリング結果の最大誤差(元のキーフレームの時刻とその中間で比較する)
+	template <typename T>
+	float MeasureMaxError(const std::vector<Keyframe<T>>& source, const AnimationCurve<T>& compressed) {
+		float maxError = 0.0f;
+		KeyframeCursor sourceCursor;
+		KeyframeCursor compressedCursor;
+		for (size_t i = 0; i < source.size(); ++i) {
+			float times[2] = { source[i].time, source[i].time };
+			if (i + 1 < source.size()) {
+				times[1] = (source[i].time + source[i + 1].time) * 0.5f;
+			}
+			for (float time : times) {
+				T expected = AnimationManager::CalculateValue(source, time, sourceCursor);
+				T actual = AnimationManager::CalculateValue(compressed, time, compressedCursor);
+				maxError = std::max(maxError, Difference(expected, actual));
+			}
+		}
+		return maxError;
+	}
+
+	template <typename T>
+	float CompressCurve(AnimationCurve<T>& curve, float tolerance, bool isQuantize, AnimationCompressor::Stats& stats) {
+		if (curve.IsCompressed() || curve.keyframes.empty()) {
+			return 0.0f;
+		}
+
+		std::vector<Keyframe<T>> source = std::move(curve.keyframes);
+
+		//量子化の誤差が許容誤差の半分を超えるカーブ(範囲の広いルートの移動など)は量子化しない
+		//量子化する場合は、キーフレームの削除に使える誤差を量子化の分だけ減らす
+		float quantizationError = isQuantize ? EstimateQuantizationError(source) : 0.0f;
+		bool canQuantize = isQuantize && quantizationError <= tolerance * 0.5f;
+		float reduceTolerance = canQuantize ? tolerance - quantizationError : tolerance;
+
+		std::vector<Keyframe<T>> reduced = ReduceKeyframes(source, reduceTolerance);
+		stats.sourceBytes += source.size() * sizeof(Keyframe<T>);
+		stats.sourceKeyframeCount += static_cast<uint32_t>(source.size());
+		stats.keptKeyframeCount += static_cast<uint32_t>(reduced.size());
+
+		if (canQuantize) {
+			Quantize(reduced, curve);
+		} else {
+			curve.keyframes = std::move(reduced);
+		}
+		stats.compressedBytes += AnimationCompressor::GetCurveBytes(curve);
+		return MeasureMaxError(source, curve);
+	}
+}
+
+//=============================================================================
+// 圧縮結果の合算
+//=============================================================================
+void AnimationCompressor::Stats::Accumulate(const Stats& other) {
+	sourceBytes += other.sourceBytes;
+	compressedBytes += other.compressedBytes;
+	sourceKeyframeCount += other.sourceKeyframeCount;
+	keptKeyframeCount += other.keptKeyframeCount;
+	maxTranslateError = std::max(maxTranslateError, other.maxTranslateError);
+	maxRotateError = std::max(maxRotateError, other.maxRotateError);
+	maxScaleError = std::max(maxScaleError, other.maxScaleError);
+}
+
+//=============================================================================
+// アニメーションの圧縮
+//=============================================================================
+AnimationCompressor::Stats AnimationCompressor::Compress(Animation& animation, const Settings& settings) {
+	Stats stats;
+	for (auto& [nodeName, nodeAnimation] : animation.nodeAnimations) {
+		stats.maxTranslateError = std::max(stats.maxTranslateError,
+			CompressCurve(nodeAnimation.translate, settings.translateTolerance, settings.isQuantize, stats));
+		stats.maxRotateError = std::max(stats.maxRotateError,
+			CompressCurve(nodeAnimation.rotate, settings.rotateTolerance, settings.isQuantize, stats));
+		stats.maxScaleError = std::max(stats.maxScaleError,
+			CompressCurve(nodeAnimation.scale, settings.scaleTolerance, settings.isQuantize, stats));
+	}
+	//キーフレームの並びが変わるため、Skeleton側の探索位置を作り直させる
+	animation.serial = AnimationManager::IssueAnimationSerial();
+	return stats;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "engine/Animation/NodeAnimation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+//============================================================================
+// AnimationCompressor class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// Animationのキーフレームを圧縮するクラスです。
+	/// 前後のキーフレームの補間で許容誤差内に再現できるキーフレームを削除し、
+	/// 残ったキーフレームの回転はsmallest-three(15bit×3)、移動・拡縮はカーブ毎の範囲に対する16bitに量子化します。
+	/// 圧縮したカーブはAnimationManager::CalculateValueがサンプリング時に展開します。
+	/// </summary>
+	class AnimationCompressor {
+	public:
+
+		/// <summary>
+		/// 圧縮の設定
+		/// </summary>
+		struct Settings {
+			float translateTolerance = 0.0005f; //移動の許容誤差(距離)
+			float rotateTolerance = 0.0005f;    //回転の許容誤差(ラジアン)
+			float scaleTolerance = 0.0005f;     //拡縮の許容誤差
+			bool isQuantize = true;             //falseならキーフレームの削除のみ行う
+		};
+
+		/// <summary>
+		/// 圧縮結果
+		/// </summary>
+		struct Stats {
+			size_t sourceBytes = 0;            //圧縮前のキーフレームのサイズ
+			size_t compressedBytes = 0;        //圧縮後のキーフレームのサイズ
+			uint32_t sourceKeyframeCount = 0;  //圧縮前のキーフレーム数
+			uint32_t keptKeyframeCount = 0;    //残したキーフレーム数
+			float maxTranslateError = 0.0f;    //圧縮前とのサンプリング結果の最大誤差
+			float maxRotateError = 0.0f;
+			float maxScaleError = 0.0f;
+
+			/// <summary>
+			/// 別の圧縮結果を合算する
+			/// </summary>
+			void Accumulate(const Stats& other);
+		};
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// アニメーションの全カーブを圧縮する(serialも新しい値にする)
+		/// </summary>
+		/// <param name="animation">圧縮するアニメーション</param>
+		/// <param name="settings">圧縮の設定</param>
+		/// <returns>圧縮結果</returns>
+		static Stats Compress(Animation& animation, const Settings& settings);
+
+		/// <summary>
+		/// 圧縮したVector3のキーフレームの値を展開する
+		/// </summary>
+		static Vector3 DecodeVector3(const AnimationCurve<Vector3>& curve, size_t index) {
+			const uint16_t* packed = &curve.packedValues[index * kPackedStride_];
+			return {
+				curve.rangeMin.x + curve.rangeExtent.x * (packed[0] * kInvVector3Max_),
+				curve.rangeMin.y + curve.rangeExtent.y * (packed[1] * kInvVector3Max_),
+				curve.rangeMin.z + curve.rangeExtent.z * (packed[2] * kInvVector3Max_),
+			};
+		}
+
+		/// <summary>
+		/// 圧縮したQuaternionのキーフレームの値を展開する
+		/// </summary>
+		static Quaternion DecodeQuaternion(const AnimationCurve<Quaternion>& curve, size_t index) {
+			const uint16_t* packed = &curve.packedValues[index * kPackedStride_];
+			// 省略した(絶対値が最大の)成分の位置は先頭2要素の最上位bitに入っている
+			const uint32_t largestIndex = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+			const float a = ((packed[0] & kQuaternionMax_) * kInvQuaternionMax_ * 2.0f - 1.0f) * kQuaternionRange_;
+			const float b = ((packed[1] & kQuaternionMax_) * kInvQuaternionMax_ * 2.0f - 1.0f) * kQuaternionRange_;
+			const float c = (packed[2] * kInvQuaternionMax_ * 2.0f - 1.0f) * kQuaternionRange_;
+			const float largest = std::sqrt(std::max(0.0f, 1.0f - a * a - b * b - c * c));
+			switch (largestIndex) {
+			case 0: return { largest, a, b, c };
+			case 1: return { a, largest, b, c };
+			case 2: return { a, b, largest, c };
+			default: return { a, b, c, largest };
+			}
+		}
+
+		/// <summary>
+		/// カーブのキーフレームのサイズの取得
+		/// </summary>
+		template <typename T>
+		static size_t GetCurveBytes(const AnimationCurve<T>& curve) {
+			return curve.keyframes.size() * sizeof(Keyframe<T>) +
+				curve.times.size() * sizeof(float) + curve.packedValues.size() * sizeof(uint16_t);
+		}
+
+	public:
+
+		//キーフレーム毎の量子化した値の要素数
+		static constexpr size_t kPackedStride_ = 3;
+		//Vector3の量子化の最大値
+		static constexpr float kVector3Max_ = 65535.0f;
+		static constexpr float kInvVector3Max_ = 1.0f / kVector3Max_;
+		//Quaternionの各成分の量子化の最大値(15bit)
+		static constexpr uint16_t kQuaternionMax_ = 0x7FFF;
+		static constexpr float kInvQuaternionMax_ = 1.0f / kQuaternionMax_;
+		//絶対値が最大でない成分の範囲(±1/√2)
+		static constexpr float kQuaternionRange_ = 0.70710678f;
+	};
+}
+
+using TakeC::AnimationCompressor;
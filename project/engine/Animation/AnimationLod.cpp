@@ -0,0 +1,98 @@
+#include "AnimationLod.h"
+#include "engine/base/ImGuiManager.h"
+#include <algorithm>
+
+using namespace TakeC;
+
+AnimationLod& AnimationLod::GetInstance() {
+	static AnimationLod instance;
+	return instance;
+}
+
+//=============================================================================
+// フレームの開始
+//=============================================================================
+void AnimationLod::BeginFrame() {
+	++frameIndex_;
+	lastStats_ = currentStats_;
+	currentStats_ = {};
+}
+
+//=============================================================================
+// 更新間隔の選択
+//=============================================================================
+uint32_t AnimationLod::SelectInterval(float distance) const {
+	if (distance >= settings_.quarterRateDistance) {
+		return 4;
+	}
+	if (distance >= settings_.halfRateDistance) {
+		return 2;
+	}
+	return 1;
+}
+
+//=============================================================================
+// 今フレームの更新方法の判定
+//=============================================================================
+AnimationLodDecision AnimationLod::Decide(AnimationLodState& state, float distance) {
+
+	// 評価フレームのずらし量は登録順に割り当てる(同じ間隔のキャラクターが均等に分かれる)
+	if (!state.isPhaseAssigned) {
+		state.phase = nextPhase_++ % kMaxInterval_;
+		state.isPhaseAssigned = true;
+	}
+
+	state.interval = settings_.isEnabled ? SelectInterval(distance) : 1;
+
+	AnimationLodDecision decision;
+
+	// 補間中は、間隔が変わっても前回評価した姿勢に届くまで補間を続ける
+	// (アニメーションは前回の評価で先に進めてあるため、途中で評価すると時間がずれる)
+	const bool wasInterpolating = state.span > 0;
+	if (wasInterpolating && state.step + 1 < state.span) {
+		++state.step;
+		decision.mode = AnimationLodDecision::Mode::Interpolate;
+		decision.blend = static_cast<float>(state.step) / static_cast<float>(state.span);
+		decision.advanceFrames = 0;
+		++currentStats_.interpolateCount;
+		return decision;
+	}
+
+	// ここに来るのは補間していないか、前回評価した姿勢の時刻に達したフレーム
+	state.span = 0;
+	state.step = 0;
+	++currentStats_.evaluateCount;
+
+	if (state.interval == 1) {
+		// 毎フレーム評価(前回評価した姿勢に達したフレームは、アニメーションを進めずに評価する)
+		decision.advanceFrames = wasInterpolating ? 0 : 1;
+		return decision;
+	}
+
+	// 次の評価フレームの姿勢を評価する
+	// (毎フレーム評価からの切り替えでは、アニメーションは前フレームの時刻にあるので1フレーム多く進める)
+	const uint32_t offset = (frameIndex_ + state.phase) % state.interval;
+	const uint32_t lookahead = state.interval - offset;
+	decision.mode = AnimationLodDecision::Mode::Evaluate;
+	decision.lookaheadFrames = lookahead;
+	decision.advanceFrames = wasInterpolating ? lookahead : lookahead + 1;
+	decision.blend = wasInterpolating ? 1.0f : 0.0f;
+	state.span = lookahead;
+	return decision;
+}
+
+//=============================================================================
+// ImGui更新処理
+//=============================================================================
+void AnimationLod::UpdateImGui() {
+#if defined(_DEBUG) || defined(_DEVELOP)
+	if (ImGui::TreeNode("AnimationLod")) {
+		ImGui::Checkbox("Enable", &settings_.isEnabled);
+		ImGui::DragFloat("Half Rate Distance", &settings_.halfRateDistance, 0.5f, 0.0f, 1000.0f);
+		ImGui::DragFloat("Quarter Rate Distance", &settings_.quarterRateDistance, 0.5f, 0.0f, 1000.0f);
+		ImGui::Text("Evaluate : %u", lastStats_.evaluateCount);
+		ImGui::Text("Interpolate : %u", lastStats_.interpolateCount);
+		ImGui::TreePop();
+	}
+#endif // _DEBUG
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+
+//============================================================================
+// AnimationLod class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// アニメーションLODのオブジェクト毎の状態
+	/// </summary>
+	struct AnimationLodState {
+		uint32_t phase = 0;          //更新フレームをずらす量(AnimationLodが割り当てる)
+		uint32_t interval = 1;       //現在の更新間隔
+		uint32_t span = 0;           //前回の評価から次の評価までのフレーム数(0なら補間中でない)
+		uint32_t step = 0;           //前回の評価からの経過フレーム数
+		bool isPhaseAssigned = false;
+	};
+
+	/// <summary>
+	/// アニメーションLODの1フレーム分の判定結果
+	/// </summary>
+	struct AnimationLodDecision {
+		enum class Mode {
+			Full,        //毎フレーム評価(通常の更新)
+			Evaluate,    //lookaheadFrames先の姿勢を評価し、パレットの補間を始める
+			Interpolate, //評価せず、前回の評価結果のパレットを補間する
+		};
+		Mode mode = Mode::Full;
+		uint32_t lookaheadFrames = 0; //Evaluate: 何フレーム先の姿勢を評価するか
+		uint32_t advanceFrames = 1;   //アニメーションを何フレーム分進めるか(前回の評価で先に進めた分を差し引いた値)
+		float blend = 0.0f;           //Evaluate: 直前に表示していた補間率 / Interpolate: 今回の補間率
+	};
+
+	/// <summary>
+	/// カメラからの距離に応じてスキンメッシュのアニメーションの評価頻度を下げるクラスです。
+	/// 遠いキャラクターは2フレーム・4フレームに1回だけ姿勢を評価し、間のフレームはパレットを補間します。
+	/// 評価時は次の評価フレームの姿勢を先に計算しておき、前回の結果からそこへ補間することで、遅れなく滑らかに繋ぎます。
+	/// 同じ間隔のキャラクターは登録順に評価フレームをずらし、1フレームに評価が集中しないようにします。
+	/// 描画に依存しないため、Decideの呼び出しと評価回数の集計だけで動作を確認できます。
+	/// </summary>
+	class AnimationLod {
+	public:
+
+		/// <summary>
+		/// LODの設定
+		/// </summary>
+		struct Settings {
+			bool isEnabled = true;
+			float halfRateDistance = 30.0f;    //この距離以上は2フレームに1回評価する
+			float quarterRateDistance = 60.0f; //この距離以上は4フレームに1回評価する
+		};
+
+		/// <summary>
+		/// 1フレーム分の集計
+		/// </summary>
+		struct FrameStats {
+			uint32_t evaluateCount = 0;    //姿勢を評価した数(Full + Evaluate)
+			uint32_t interpolateCount = 0; //パレットの補間のみの数
+		};
+
+		//最大の更新間隔(評価フレームをずらす量はこの範囲で割り当てる)
+		static constexpr uint32_t kMaxInterval_ = 4;
+
+	private:
+
+		//コピーコンストラクタ・代入演算子禁止
+		AnimationLod() = default;
+		~AnimationLod() = default;
+		AnimationLod(const AnimationLod&) = delete;
+		AnimationLod& operator=(const AnimationLod&) = delete;
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// シングルトンインスタンス取得
+		/// </summary>
+		static AnimationLod& GetInstance();
+
+		/// <summary>
+		/// フレームの開始(シーンの更新前に呼ぶ)
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// 今フレームの更新方法の判定
+		/// </summary>
+		/// <param name="state">オブジェクト毎の状態</param>
+		/// <param name="distance">カメラからの距離(オブジェクトの大きさで割った値)</param>
+		/// <returns>判定結果</returns>
+		AnimationLodDecision Decide(AnimationLodState& state, float distance);
+
+		/// <summary>
+		/// 距離から更新間隔を選ぶ
+		/// </summary>
+		/// <param name="distance"></param>
+		/// <returns>1, 2, 4のいずれか</returns>
+		uint32_t SelectInterval(float distance) const;
+
+		/// <summary>
+		/// ImGui更新処理
+		/// </summary>
+		void UpdateImGui();
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//設定
+		void SetSettings(const Settings& settings) { settings_ = settings; }
+		const Settings& GetSettings() const { return settings_; }
+		//現在のフレーム番号の取得
+		uint32_t GetFrameIndex() const { return frameIndex_; }
+		//今フレームの集計の取得
+		const FrameStats& GetFrameStats() const { return currentStats_; }
+		//前フレームの集計の取得
+		const FrameStats& GetLastFrameStats() const { return lastStats_; }
+
+	private:
+
+		Settings settings_;
+		uint32_t frameIndex_ = 0;
+		//次に割り当てる評価フレームのずらし量
+		uint32_t nextPhase_ = 0;
+		FrameStats currentStats_;
+		FrameStats lastStats_;
+	};
+}
+
+using TakeC::AnimationLod;
+using TakeC::AnimationLodState;
+using TakeC::AnimationLodDecision;
@@ -1,24 +1,38 @@
 #pragma once
 #include "engine/Animation/NodeAnimation.h"
+#include "engine/Animation/BlendTree.h"
+#include <algorithm>
 #include <cmath>
 
 //============================================================================
 
 // AnimationState
 // アニメーションの再生状態（アニメポインタ + 再生時間）を保持する軽量構造体
+// blendTreeを設定した場合はブレンドツリーを再生し、timeは正規化した再生位置（0〜1）になる
 //============================================================================
 /// <summary>
 /// AnimationStateに関するデータを保持する構造体です。
 /// </summary>
 struct AnimationState {
 	Animation* animation = nullptr; // 対象アニメーション（非所有）
-	float time = 0.0f;              // 現在の再生時間（秒）
+	BlendTree* blendTree = nullptr; // 対象ブレンドツリー（非所有。animationより優先）
+	Vector2 blendParameter = {};    // ブレンドツリーのパラメータ
+	float time = 0.0f;              // 現在の再生時間（秒）。ブレンドツリーは正規化した再生位置
 	bool isLoop = true;             // ループするかどうか（デフォルト: ループする）
 
 	/// <summary>
 	/// 再生時間を進める
 	/// </summary>
 	void Advance(float dt) {
+		if (blendTree) {
+			// 現在のパラメータでの周期の長さで正規化して進める
+			float duration = blendTree->GetDuration(blendParameter);
+			if (duration > 0.0f) {
+				time += dt / duration;
+				time = isLoop ? time - std::floor(time) : std::min(time, 1.0f);
+			}
+			return;
+		}
 		if (!animation) {
 			return;
 		}
@@ -37,7 +51,7 @@ struct AnimationState {
 	/// <summary>
 	/// アニメーションが有効かどうか
 	/// </summary>
-	bool IsValid() const { return animation != nullptr; }
+	bool IsValid() const { return animation != nullptr || blendTree != nullptr; }
 
 	/// <summary>
 	/// リセット
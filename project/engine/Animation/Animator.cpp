@@ -1,16 +1,91 @@
 #include "Animator.h"
 #include "Easing.h"
+#include "engine/Animation/AnimationClipFile.h"
+#include "engine/Animation/AnimationCompressor.h"
 #include "engine/Utility/ResourcePath.h"
+#include "engine/base/ImGuiManager.h"
 //assimp
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <functional>
 #include "Animator.h"
 
 using namespace TakeC;
 
+namespace {
+
+	//Assimpでアニメーションを読み込み、秒・左手系に変換する
+	std::map<std::string, Animation*> ImportAnimationFile(const std::filesystem::path& fullPath) {
+
+		std::map<std::string, Animation*> animations = {};
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(fullPath.string().c_str(), 0);
+		//アニメーションがない場合
+		if (!scene || scene->mNumAnimations == 0) {
+			return animations = {};
+		}
+
+		//複数のアニメーションの情報を取得
+		for (uint32_t animationIndex = 0; animationIndex < scene->mNumAnimations; ++animationIndex) {
+			aiAnimation* animationAssimp = scene->mAnimations[animationIndex];
+			//animationインスタンスの生成
+			Animation* animation = new Animation();
+			animation->serial = AnimationManager::IssueAnimationSerial();
+			//時間の単位を秒に変換
+			animation->duration = float(animationAssimp->mDuration / animationAssimp->mTicksPerSecond);
+
+			//assimpでは個々のNodeのAnimationをchannelと呼んでいるのでchannelを回してNodeAnimationの情報を取得する
+			for (uint32_t channelIndex = 0; channelIndex < animationAssimp->mNumChannels; ++channelIndex) {
+				aiNodeAnim* NodeAnimationAssimp = animationAssimp->mChannels[channelIndex];
+				NodeAnimation& nodeAnimation = animation->nodeAnimations[NodeAnimationAssimp->mNodeName.C_Str()];
+
+				//position, rotation, scale keyframeを取得
+				//position
+				nodeAnimation.translate.keyframes.reserve(NodeAnimationAssimp->mNumPositionKeys);
+				for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumPositionKeys; ++keyIndex) {
+					aiVectorKey& keyAssimp = NodeAnimationAssimp->mPositionKeys[keyIndex];
+					KeyframeVector3 keyframe;
+					keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
+					keyframe.value = { -keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z }; //右手->左手に変換するので手動で対処する
+					nodeAnimation.translate.keyframes.push_back(keyframe);
+				}
+				//rotation
+				nodeAnimation.rotate.keyframes.reserve(NodeAnimationAssimp->mNumRotationKeys);
+				for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumRotationKeys; ++keyIndex) {
+					aiQuatKey& keyAssimp = NodeAnimationAssimp->mRotationKeys[keyIndex];
+					KeyframeQuaternion keyframe;
+					keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
+					keyframe.value = { keyAssimp.mValue.x, -keyAssimp.mValue.y, -keyAssimp.mValue.z, keyAssimp.mValue.w };
+					nodeAnimation.rotate.keyframes.push_back(keyframe);
+				}
+				//scale
+				nodeAnimation.scale.keyframes.reserve(NodeAnimationAssimp->mNumScalingKeys);
+				for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumScalingKeys; ++keyIndex) {
+					aiVectorKey& keyAssimp = NodeAnimationAssimp->mScalingKeys[keyIndex];
+					KeyframeVector3 keyframe;
+					keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
+					keyframe.value = { keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z };
+					nodeAnimation.scale.keyframes.push_back(keyframe);
+				}
+			}
+
+			//アニメーション名を取得
+			std::string animationName = animationAssimp->mName.C_Str();
+			animation->name = animationName;
+			//アニメーションをmapに追加
+			animations.insert(std::make_pair(animationName, animation));
+		}
+
+		//読み込んだアニメーションを返す
+		return animations;
+	}
+}
+
 //=============================================================================
 //	終了・開放処理
 //=============================================================================
@@ -31,10 +106,84 @@ void AnimationManager::LoadAnimation(const std::string& filePath) {
 
 	//アニメーションの生成とファイル読み込み、初期化
 	std::map<std::string, Animation*> animation = LoadAnimationFile(filePath);
+	CompressAnimations(animation);
 	//アニメーションをコンテナに追加
 	animations_.insert(std::make_pair(filePath, animation));
 }
 
+//=============================================================================
+//	アニメーションの再読み込み
+//=============================================================================
+
+void AnimationManager::ReloadAnimation(const std::string& filePath) {
+
+	auto fileIt = animations_.find(filePath);
+	if (fileIt == animations_.end()) {
+		//未読み込みなら通常の読み込み
+		LoadAnimation(filePath);
+		return;
+	}
+
+	//元ファイルを編集中に呼ばれるため、焼き込み済みのファイルは使わずに読み込み直す
+	std::map<std::string, Animation*> reloaded = LoadAnimationFile(filePath, false);
+	CompressAnimations(reloaded);
+	for (auto& [animationName, animation] : reloaded) {
+		auto it = fileIt->second.find(animationName);
+		if (it != fileIt->second.end()) {
+			//既存のポインタを保持している側がそのまま使えるよう中身を差し替える
+			//serialも新しい値になるため、Skeleton側の対応表は次の適用時に作り直される
+			*it->second = std::move(*animation);
+			delete animation;
+		} else {
+			fileIt->second.emplace(animationName, animation);
+		}
+	}
+}
+
+//=============================================================================
+//	読み込んだアニメーションの圧縮
+//=============================================================================
+
+void AnimationManager::CompressAnimations(std::map<std::string, Animation*>& animations) {
+	if (!isCompressionEnabled_) {
+		return;
+	}
+	for (auto& [animationName, animation] : animations) {
+		compressionStats_.Accumulate(AnimationCompressor::Compress(*animation, compressionSettings_));
+	}
+}
+
+//=============================================================================
+//	ImGui更新
+//=============================================================================
+
+void AnimationManager::UpdateImGui() {
+#if defined(_DEBUG) || defined(_DEVELOP)
+	if (ImGui::TreeNode("Animation")) {
+		ImGui::Checkbox("Compress On Load", &isCompressionEnabled_);
+		ImGui::DragFloat("Translate Tolerance", &compressionSettings_.translateTolerance, 0.0001f, 0.0f, 1.0f, "%.4f");
+		ImGui::DragFloat("Rotate Tolerance", &compressionSettings_.rotateTolerance, 0.0001f, 0.0f, 1.0f, "%.4f");
+		ImGui::DragFloat("Scale Tolerance", &compressionSettings_.scaleTolerance, 0.0001f, 0.0f, 1.0f, "%.4f");
+		ImGui::Checkbox("Quantize", &compressionSettings_.isQuantize);
+
+		const AnimationCompressor::Stats& stats = compressionStats_;
+		ImGui::Text("Keyframes : %u -> %u", stats.sourceKeyframeCount, stats.keptKeyframeCount);
+		ImGui::Text("Memory : %.1f KB -> %.1f KB", stats.sourceBytes / 1024.0f, stats.compressedBytes / 1024.0f);
+		ImGui::Text("Max Error : T %.5f / R %.5f rad / S %.5f", stats.maxTranslateError, stats.maxRotateError, stats.maxScaleError);
+		ImGui::TreePop();
+	}
+#endif // _DEBUG
+}
+
+//=============================================================================
+//	アニメーションの識別番号の発行
+//=============================================================================
+
+uint64_t AnimationManager::IssueAnimationSerial() {
+	static std::atomic<uint64_t> nextSerial = 1;
+	return nextSerial++;
+}
+
 //=============================================================================
 //	アニメーションの検索
 //=============================================================================
@@ -57,7 +206,7 @@ Animation* AnimationManager::FindAnimation(const std::string& filePath, const st
 //=============================================================================
 //	アニメーションファイルの読み込み
 //=============================================================================
-std::map<std::string, Animation*> AnimationManager::LoadAnimationFile(const std::string& filename) {
+std::map<std::string, Animation*> AnimationManager::LoadAnimationFile(const std::string& filename, bool useBakedClip) {
 
 	namespace fs = std::filesystem;
 
@@ -84,105 +233,163 @@ std::map<std::string, Animation*> AnimationManager::LoadAnimationFile(const std:
 		fullPath = modelDir / filename;
 	}
 
+	// 焼き込み済みで元ファイルから変わっていなければ、Assimpを使わずに読み込む
+	const fs::path bakedPath = GetBakedClipPath(filename);
+	const AnimationClipFile::SourceStamp stamp = AnimationClipFile::MakeSourceStamp(fullPath);
 	std::map<std::string, Animation*> animations = {};
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(fullPath.string().c_str(), 0);
-    //アニメーションがない場合
-	if(scene->mNumAnimations == 0) {
-		return animations = {};
-	}
-
-	//複数のアニメーションの情報を取得
-	for (uint32_t animationIndex = 0; animationIndex < scene->mNumAnimations; ++animationIndex) {
-		aiAnimation* animationAssimp = scene->mAnimations[animationIndex];
-		//animationインスタンスの生成
-		Animation* animation = new Animation();
-		//時間の単位を秒に変換
-		animation->duration = float(animationAssimp->mDuration / animationAssimp->mTicksPerSecond);
-
-		//assimpでは個々のNodeのAnimationをchannelと呼んでいるのでchannelを回してNodeAnimationの情報を取得する
-		for (uint32_t channelIndex = 0; channelIndex < animationAssimp->mNumChannels; ++channelIndex) {
-			aiNodeAnim* NodeAnimationAssimp = animationAssimp->mChannels[channelIndex];
-			NodeAnimation& nodeAnimation = animation->nodeAnimations[NodeAnimationAssimp->mNodeName.C_Str()];
-
-			//position, rotation, scale keyframeを取得
-			//position
-			for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumPositionKeys; ++keyIndex) {
-				aiVectorKey& keyAssimp = NodeAnimationAssimp->mPositionKeys[keyIndex];
-				KeyframeVector3 keyframe;
-				keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
-				keyframe.value = { -keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z }; //右手->左手に変換するので手動で対処する
-				nodeAnimation.translate.keyframes.push_back(keyframe);
-			}
-			//rotation
-			for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumRotationKeys; ++keyIndex) {
-				aiQuatKey& keyAssimp = NodeAnimationAssimp->mRotationKeys[keyIndex];
-				KeyframeQuaternion keyframe;
-				keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
-				keyframe.value = { keyAssimp.mValue.x, -keyAssimp.mValue.y, -keyAssimp.mValue.z, keyAssimp.mValue.w };
-				nodeAnimation.rotate.keyframes.push_back(keyframe);
-			}
-			//scale
-			for (uint32_t keyIndex = 0; keyIndex < NodeAnimationAssimp->mNumScalingKeys; ++keyIndex) {
-				aiVectorKey& keyAssimp = NodeAnimationAssimp->mScalingKeys[keyIndex];
-				KeyframeVector3 keyframe;
-				keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond); //時間の単位を秒に変換
-				keyframe.value = { keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z };
-				nodeAnimation.scale.keyframes.push_back(keyframe);
-			}
-		}
+	if (useBakedClip && AnimationClipFile::Load(bakedPath, stamp, animations)) {
+		return animations;
+	}
 
-		//アニメーション名を取得
-		std::string animationName = animationAssimp->mName.C_Str();
-		animation->name = animationName;
-		//アニメーションをmapに追加
-		animations.insert(std::make_pair(animationName, animation));
+	// Assimpで読み込み、次回以降のために焼き込む
+	animations = ImportAnimationFile(fullPath);
+	if (!animations.empty()) {
+		AnimationClipFile::Save(bakedPath, stamp, animations);
 	}
 
 	//読み込んだアニメーションを返す
 	return animations;
 }
 
+//=============================================================================
+//	焼き込んだアニメーションファイルのパスの取得
+//=============================================================================
+std::filesystem::path AnimationManager::GetBakedClipPath(const std::string& filename) {
+	std::filesystem::path bakedPath = ResourcePath::Game("Models/Baked") / filename;
+	bakedPath += AnimationClipFile::kExtension_;
+	return bakedPath;
+}
+
+//=============================================================================
+//	補間区間の探索
+//=============================================================================
+namespace {
+
+	//time を含む補間区間 [index, index + 1] の先頭インデックスを返す
+	//最後のキーフレームより後ろの場合は最後のインデックスを返す
+	//要素は2つ以上、timeは先頭の時刻より後ろであること
+	//projectionで要素から時刻を取り出す(Keyframeの配列と圧縮済みカーブの時刻の配列の両方に使う)
+	template <typename T, typename Projection>
+	size_t FindKeyframeSegment(const std::vector<T>& keyframes, float time, size_t hint, Projection projection) {
+		const size_t lastIndex = keyframes.size() - 1;
+
+		//前回の区間か、その次の区間に収まっていれば探索しない
+		for (size_t index = hint; index < lastIndex && index <= hint + 1; ++index) {
+			if (std::invoke(projection, keyframes[index]) < time && time <= std::invoke(projection, keyframes[index + 1])) {
+				return index;
+			}
+		}
+
+		//time以上の時刻を持つ最初のキーフレームを二分探索し、その直前を区間の先頭とする
+		auto it = std::ranges::lower_bound(keyframes.begin() + 1, keyframes.end(), time, {}, projection);
+		if (it == keyframes.end()) {
+			return lastIndex;
+		}
+		return static_cast<size_t>(it - keyframes.begin()) - 1;
+	}
+
+	//圧縮済みカーブの補間値を計算する
+	template <typename T, typename Decode, typename Interpolate>
+	T CalculateCompressedValue(const AnimationCurve<T>& curve, float time, KeyframeCursor& cursor, Decode decode, Interpolate interpolate) {
+		const std::vector<float>& times = curve.times;
+		if (times.size() == 1 || time <= times[0]) {
+			cursor.index = 0;
+			return decode(curve, 0);
+		}
+
+		size_t index = FindKeyframeSegment(times, time, cursor.index, std::identity{});
+		cursor.index = index;
+		if (index + 1 >= times.size()) {
+			//最後のキーフレームを返す
+			return decode(curve, times.size() - 1);
+		}
+
+		//範囲内を補間する
+		size_t nextIndex = index + 1;
+		float t = (time - times[index]) / (times[nextIndex] - times[index]);
+		return interpolate(decode(curve, index), decode(curve, nextIndex), t);
+	}
+}
+
 //=============================================================================
 //	補間値の計算(Vector3用)
 //=============================================================================
 
 Vector3 AnimationManager::CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time) {
+	KeyframeCursor cursor;
+	return CalculateValue(keyframes, time, cursor);
+}
+
+Vector3 AnimationManager::CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time, KeyframeCursor& cursor) {
 	assert(!keyframes.empty()); //keyframesが空の場合はエラー
 	if(keyframes.size() == 1 || time <= keyframes[0].time) {
+		cursor.index = 0;
 		return keyframes[0].value;
 	}
 
-	for(size_t index = 0; index < keyframes.size() - 1; ++index) {
-		size_t nextIndex = index + 1;
-		if(time >= keyframes[index].time && time <= keyframes[nextIndex].time) {
-			//範囲内を補間する
-			float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
-			return Easing::Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
-		}
+	size_t index = FindKeyframeSegment(keyframes, time, cursor.index, &KeyframeVector3::time);
+	cursor.index = index;
+	if(index + 1 >= keyframes.size()) {
+		//最後のキーフレームを返す
+		return keyframes.back().value;
 	}
 
-	//最後のキーフレームを返す
-	return (*keyframes.rbegin()).value;
+	//範囲内を補間する
+	size_t nextIndex = index + 1;
+	float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+	return Easing::Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
+}
+
+Vector3 AnimationManager::CalculateValue(const AnimationCurve<Vector3>& curve, float time) {
+	KeyframeCursor cursor;
+	return CalculateValue(curve, time, cursor);
+}
+
+Vector3 AnimationManager::CalculateValue(const AnimationCurve<Vector3>& curve, float time, KeyframeCursor& cursor) {
+	if (!curve.IsCompressed()) {
+		return CalculateValue(curve.keyframes, time, cursor);
+	}
+	return CalculateCompressedValue(curve, time, cursor, &AnimationCompressor::DecodeVector3,
+		[](const Vector3& v0, const Vector3& v1, float t) { return Easing::Lerp(v0, v1, t); });
 }
 
 //=============================================================================
 //	補間値の計算(Quaternion用)
 //=============================================================================
 Quaternion AnimationManager::CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time) {
+	KeyframeCursor cursor;
+	return CalculateValue(keyframes, time, cursor);
+}
+
+Quaternion AnimationManager::CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time, KeyframeCursor& cursor) {
 	assert(!keyframes.empty()); //keyframesが空の場合はエラー
 	if(keyframes.size() == 1 || time <= keyframes[0].time) {
+		cursor.index = 0;
 		return keyframes[0].value;
 	}
 
-	for(size_t index = 0; index < keyframes.size() - 1; ++index) {
-		size_t nextIndex = index + 1;
-		if(time >= keyframes[index].time && time <= keyframes[nextIndex].time) {
-			//範囲内を補間する
-			float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
-			return Easing::Slerp(keyframes[index].value, keyframes[nextIndex].value, t);
-		}
+	size_t index = FindKeyframeSegment(keyframes, time, cursor.index, &KeyframeQuaternion::time);
+	cursor.index = index;
+	if(index + 1 >= keyframes.size()) {
+		//最後のキーフレームを返す
+		return keyframes.back().value;
+	}
+
+	//範囲内を補間する
+	size_t nextIndex = index + 1;
+	float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+	return Easing::Slerp(keyframes[index].value, keyframes[nextIndex].value, t);
+}
+
+Quaternion AnimationManager::CalculateValue(const AnimationCurve<Quaternion>& curve, float time) {
+	KeyframeCursor cursor;
+	return CalculateValue(curve, time, cursor);
+}
+
+Quaternion AnimationManager::CalculateValue(const AnimationCurve<Quaternion>& curve, float time, KeyframeCursor& cursor) {
+	if (!curve.IsCompressed()) {
+		return CalculateValue(curve.keyframes, time, cursor);
 	}
-	//最後のキーフレームを返す
-	return (*keyframes.rbegin()).value;
+	return CalculateCompressedValue(curve, time, cursor, &AnimationCompressor::DecodeQuaternion,
+		[](const Quaternion& q0, const Quaternion& q1, float t) { return Easing::Slerp(q0, q1, t); });
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Animation/NodeAnimation.h"
+#include "Animation/AnimationCompressor.h"
 #include "Matrix4x4.h"
+#include <filesystem>
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -36,6 +39,18 @@ namespace TakeC {
 		/// <param name="filePath"></param>
 		void LoadAnimation(const std::string& filePath);
 
+		/// <summary>
+		/// アニメーションの再読み込み
+		/// 読み込み済みのAnimationは同じポインタのまま中身を差し替える
+		/// </summary>
+		/// <param name="filePath"></param>
+		void ReloadAnimation(const std::string& filePath);
+
+		/// <summary>
+		/// ImGui更新(圧縮の設定と結果の表示)
+		/// </summary>
+		void UpdateImGui();
+
 		/// <summary>
 		/// アニメーション検索
 		/// </summary>
@@ -46,17 +61,42 @@ namespace TakeC {
 
 		/// <summary>
 		/// アニメーションファイル読み込み
+		/// 焼き込み済みのファイルがあり元ファイルから変わっていなければそちらを読み込み、
+		/// なければAssimpで読み込んで焼き込む
 		/// </summary>
-		/// <param name="directoryPath"></param>
 		/// <param name="filename"></param>
+		/// <param name="useBakedClip">falseならAssimpで読み込み直して焼き直す</param>
 		/// <returns></returns>
-		static std::map<std::string, Animation*> LoadAnimationFile(const std::string& filename);
+		static std::map<std::string, Animation*> LoadAnimationFile(const std::string& filename, bool useBakedClip = true);
+
+		/// <summary>
+		/// 焼き込んだアニメーションファイルのパスの取得
+		/// </summary>
+		/// <param name="filename"></param>
+		/// <returns></returns>
+		static std::filesystem::path GetBakedClipPath(const std::string& filename);
+
+		/// <summary>
+		/// Animation::serialに設定する一意な番号の発行
+		/// (Animationをコピー・編集した場合も新しい番号を設定する)
+		/// </summary>
+		/// <returns></returns>
+		static uint64_t IssueAnimationSerial();
 
 		/// <summary>
 		/// ベクトルの補間値を計算
 		/// </summary>
 		static Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time);
 
+		/// <summary>
+		/// ベクトルの補間値を計算(前回の探索位置から再開する)
+		/// </summary>
+		/// <param name="keyframes"></param>
+		/// <param name="time"></param>
+		/// <param name="cursor">前回の探索位置。計算後に今回の区間で更新される</param>
+		/// <returns></returns>
+		static Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time, KeyframeCursor& cursor);
+
 		/// <summary>
 		/// クォータニオンの補間値を計算
 		/// </summary>
@@ -65,6 +105,47 @@ namespace TakeC {
 		/// <returns></returns>
 		static Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time);
 
+		/// <summary>
+		/// クォータニオンの補間値を計算(前回の探索位置から再開する)
+		/// </summary>
+		/// <param name="keyframes"></param>
+		/// <param name="time"></param>
+		/// <param name="cursor">前回の探索位置。計算後に今回の区間で更新される</param>
+		/// <returns></returns>
+		static Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time, KeyframeCursor& cursor);
+
+		/// <summary>
+		/// カーブの補間値を計算(圧縮済みのカーブはサンプリング時に展開する)
+		/// </summary>
+		/// <param name="curve"></param>
+		/// <param name="time"></param>
+		/// <returns></returns>
+		static Vector3 CalculateValue(const AnimationCurve<Vector3>& curve, float time);
+		static Vector3 CalculateValue(const AnimationCurve<Vector3>& curve, float time, KeyframeCursor& cursor);
+		static Quaternion CalculateValue(const AnimationCurve<Quaternion>& curve, float time);
+		static Quaternion CalculateValue(const AnimationCurve<Quaternion>& curve, float time, KeyframeCursor& cursor);
+
+	public:
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//読み込み時に圧縮するかどうかの設定(設定後に読み込むアニメーションから適用)
+		void SetCompressionEnabled(bool isEnabled) { isCompressionEnabled_ = isEnabled; }
+		//圧縮の設定
+		void SetCompressionSettings(const AnimationCompressor::Settings& settings) { compressionSettings_ = settings; }
+		//読み込んだアニメーション全体の圧縮結果の取得
+		const AnimationCompressor::Stats& GetCompressionStats() const { return compressionStats_; }
+
+	private:
+
+		/// <summary>
+		/// 読み込んだアニメーションの圧縮
+		/// </summary>
+		/// <param name="animations"></param>
+		void CompressAnimations(std::map<std::string, Animation*>& animations);
+
 	private:
 
 		/// <summary>
@@ -72,5 +153,12 @@ namespace TakeC {
 		/// (ファイル名, (アニメーション名,アニメーション))
 		/// </summary>
 		std::map<std::string, std::map<std::string, Animation*>> animations_;
+
+		//読み込み時に圧縮するかどうか
+		bool isCompressionEnabled_ = true;
+		//圧縮の設定
+		AnimationCompressor::Settings compressionSettings_;
+		//読み込んだアニメーション全体の圧縮結果
+		AnimationCompressor::Stats compressionStats_;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "AnimatorController.h"
 #include <algorithm>
+#include <bit>
 
 //====================================================================
 // 初期化
@@ -47,17 +48,43 @@ void AnimatorController::TransitionTo(Animation* animation, float blendDuration,
 void AnimatorController::TransitionTo(const std::string& layerName, Animation* animation, float blendDuration, bool isLoop) {
 	if (!animation) return;
 
+	AnimationState state;
+	state.animation = animation;
+	state.isLoop = isLoop;
+	TransitionTo(layerName, state, blendDuration);
+}
+
+//====================================================================
+// ブレンドツリーへの遷移の開始（デフォルト）
+//====================================================================
+void AnimatorController::TransitionTo(BlendTree* blendTree, float blendDuration, bool isLoop) {
+	TransitionTo("Base", blendTree, blendDuration, isLoop);
+}
+
+//====================================================================
+// 指定レイヤーのブレンドツリーへの遷移
+//====================================================================
+void AnimatorController::TransitionTo(const std::string& layerName, BlendTree* blendTree, float blendDuration, bool isLoop) {
+	if (!blendTree) return;
+
+	AnimationState state;
+	state.blendTree = blendTree;
+	state.isLoop = isLoop;
+	TransitionTo(layerName, state, blendDuration);
+}
+
+void AnimatorController::TransitionTo(const std::string& layerName, const AnimationState& state, float blendDuration) {
 	for (auto& layer : layers_) {
 		if (layer.name == layerName) {
 			if (!layer.currentState.IsValid()) {
-				layer.currentState.animation = animation;
-				layer.currentState.isLoop = isLoop;
+				layer.currentState = state;
 				layer.currentState.Reset();
 				layer.isBlending = false;
 			} else {
-				layer.nextState.animation = animation;
-				layer.nextState.isLoop = isLoop;
+				layer.nextState = state;
 				layer.nextState.Reset();
+				// 設定済みのパラメータを引き継ぐ
+				layer.nextState.blendParameter = layer.currentState.blendParameter;
 				layer.blendDuration = std::max(blendDuration, 0.0001f);
 				layer.blendTimer = 0.0f;
 				layer.isBlending = true;
@@ -67,16 +94,35 @@ void AnimatorController::TransitionTo(const std::string& layerName, Animation* a
 	}
 }
 
+//====================================================================
+// ブレンドツリーのパラメータ設定
+//====================================================================
+void AnimatorController::SetBlendParameter(const std::string& layerName, const Vector2& parameter) {
+	for (auto& layer : layers_) {
+		if (layer.name == layerName) {
+			layer.currentState.blendParameter = parameter;
+			layer.nextState.blendParameter = parameter;
+			return;
+		}
+	}
+}
+
+void AnimatorController::SetBlendParameter(const std::string& layerName, float parameter) {
+	SetBlendParameter(layerName, Vector2{ parameter, 0.0f });
+}
+
 //====================================================================
 // 更新
 //====================================================================
 void AnimatorController::Update(float dt) {
-	if (!skeleton_) return;
-
-	// スケルトンの状態をリセット
-	skeleton_->ClearTransform();
+	Advance(dt);
+	Evaluate();
+}
 
-	// 全レイヤーを順番に適用
+//====================================================================
+// 再生時間と遷移の更新
+//====================================================================
+void AnimatorController::Advance(float dt) {
 	for (auto& layer : layers_) {
 		if (!layer.currentState.IsValid()) continue;
 
@@ -85,25 +131,117 @@ void AnimatorController::Update(float dt) {
 		if (layer.isBlending) {
 			layer.nextState.Advance(dt);
 			layer.blendTimer += dt;
-			float t = std::clamp(layer.blendTimer / layer.blendDuration, 0.0f, 1.0f);
-
-			// レイヤー内部でのクロスフェード
-			// 現在の状態を反映（weightを考慮）
-			skeleton_->ApplyLayeredAnimation(layer.currentState.animation, layer.currentState.time, layer.weight * (1.0f - t), layer.blendMode);
-			// 次の状態を反映
-			skeleton_->ApplyLayeredAnimation(layer.nextState.animation, layer.nextState.time, layer.weight * t, layer.blendMode);
 
-			if (t >= 1.0f) {
+			// 遷移が終わったフレームは遷移先のみを適用するのと同じ結果になるので、ここで切り替える
+			if (layer.blendTimer >= layer.blendDuration) {
 				layer.currentState = layer.nextState;
 				layer.nextState = {};
 				layer.isBlending = false;
 			}
-		} else {
-			// 単一アニメーションの適用
-			skeleton_->ApplyLayeredAnimation(layer.currentState.animation, layer.currentState.time, layer.weight, layer.blendMode);
 		}
 	}
+}
+
+//====================================================================
+// スケルトンへの適用
+//====================================================================
+void AnimatorController::Evaluate() {
+	if (!skeleton_) return;
+
+	// スケルトンの状態をリセット
+	skeleton_->ClearTransform();
+
+	// 全レイヤーを順番に適用（遷移中のクロスフェードやブレンドツリーはレイヤー内で混ぜてから適用する）
+	lastContributionCount_ = 0;
+	LayerContributions contributions;
+	for (const auto& layer : layers_) {
+		if (!CollectContributions(layer, contributions)) continue;
+
+		skeleton_->ApplyLayer({ contributions.items.data(), contributions.count }, layer.weight, layer.blendMode);
+		lastContributionCount_ += contributions.count;
+	}
 
 	// スケルトンの行列計算を更新
 	skeleton_->Update();
 }
+
+//====================================================================
+// レイヤーで合成するアニメーションの収集
+//====================================================================
+bool AnimatorController::CollectContributions(const Layer& layer, LayerContributions& contributions) {
+	contributions.count = 0;
+	if (!layer.currentState.IsValid() || layer.weight <= kMinWeight_) {
+		return false;
+	}
+
+	// 遷移の始まり・終わり際で片側のウェイトが無視できる場合は、もう片側のみサンプリングする
+	float t = layer.isBlending ? std::clamp(layer.blendTimer / layer.blendDuration, 0.0f, 1.0f) : 0.0f;
+	if (t < 1.0f - kMinWeight_) {
+		AddStateContributions(layer.currentState, 1.0f - t, contributions);
+	}
+	if (layer.isBlending && t > kMinWeight_) {
+		AddStateContributions(layer.nextState, t, contributions);
+	}
+	return contributions.count > 0;
+}
+
+void AnimatorController::AddStateContributions(const AnimationState& state, float weight, LayerContributions& contributions) {
+	if (!state.blendTree) {
+		if (state.animation) {
+			contributions.items[contributions.count++] = { state.animation, state.time, weight };
+		}
+		return;
+	}
+
+	// ブレンドツリーは正規化した再生位置を各アニメーションの長さに合わせる
+	BlendTree::Result result = state.blendTree->Evaluate(state.blendParameter);
+	for (uint32_t i = 0; i < result.count; ++i) {
+		const BlendTree::Contribution& contribution = result.contributions[i];
+		float contributionWeight = contribution.weight * weight;
+		if (contributionWeight <= kMinWeight_) continue;
+		contributions.items[contributions.count++] = {
+			contribution.animation, state.time * contribution.animation->duration, contributionWeight };
+	}
+}
+
+//====================================================================
+// 姿勢のキーの作成
+//====================================================================
+void AnimatorController::BuildPoseKey(float timeQuantum, std::vector<uint64_t>& key) const {
+	key.clear();
+	if (!skeleton_) return;
+
+	// 同じNodeから作成したスケルトンのみ姿勢を共有できる
+	key.push_back(reinterpret_cast<uintptr_t>(skeleton_->GetSourceNode()));
+
+	auto floatBits = [](float value) { return static_cast<uint64_t>(std::bit_cast<uint32_t>(value)); };
+	auto timeIndex = [timeQuantum](float time) { return static_cast<uint64_t>(QuantizeTime(time, timeQuantum)); };
+
+	// 実際にサンプリングするアニメーションのみで作るため、ウェイトが無視できる違いは区別しない
+	LayerContributions contributions;
+	for (size_t index = 0; index < layers_.size(); ++index) {
+		const Layer& layer = layers_[index];
+		if (!CollectContributions(layer, contributions)) continue;
+
+		// レイヤー番号・アニメーション数・合成モード・ウェイト
+		key.push_back((static_cast<uint64_t>(index) << 48) | (static_cast<uint64_t>(contributions.count) << 40) |
+			(static_cast<uint64_t>(layer.blendMode) << 32) | floatBits(layer.weight));
+		// アニメーション毎に、アニメーションと丸めた再生時間・ウェイト
+		for (uint32_t i = 0; i < contributions.count; ++i) {
+			const AnimationContribution& contribution = contributions.items[i];
+			key.push_back(reinterpret_cast<uintptr_t>(contribution.animation));
+			key.push_back((timeIndex(contribution.time) << 32) | floatBits(contribution.weight));
+		}
+	}
+}
+
+//====================================================================
+// 再生時間の丸め
+//====================================================================
+uint32_t AnimatorController::QuantizeTime(float time, float timeQuantum) {
+	if (timeQuantum <= 0.0f) {
+		// 丸めない場合は値そのものを区別する
+		return std::bit_cast<uint32_t>(time);
+	}
+	return static_cast<uint32_t>(std::max(time, 0.0f) / timeQuantum);
+}
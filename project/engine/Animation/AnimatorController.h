@@ -1,6 +1,8 @@
 #pragma once
 #include "engine/Animation/AnimationState.h"
 #include "engine/Animation/Skeleton.h"
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -9,6 +11,8 @@
 //============================================================================
 /// <summary>
 /// Animatorの状態遷移と制御を担当するクラスです。
+/// 各レイヤーは遷移元・遷移先(それぞれアニメーションかブレンドツリー)の寄与をまとめて1回で適用し、
+/// ウェイトが無視できるほど小さいアニメーションやレイヤーはサンプリングしません。
 /// </summary>
 class AnimatorController {
 public:
@@ -59,14 +63,99 @@ public:
 	void TransitionTo(const std::string& layerName, Animation* animation, float blendDuration, bool isLoop = true);
 
 	/// <summary>
-	/// 更新（スケルトンに全レイヤーを順次適用）
+	/// ブレンドツリーへの遷移の開始（デフォルトで "Base" レイヤーを対象）
+	/// </summary>
+	void TransitionTo(BlendTree* blendTree, float blendDuration, bool isLoop = true);
+
+	/// <summary>
+	/// 指定レイヤーのブレンドツリーへの遷移
+	/// </summary>
+	void TransitionTo(const std::string& layerName, BlendTree* blendTree, float blendDuration, bool isLoop = true);
+
+	/// <summary>
+	/// 指定レイヤーのブレンドツリーのパラメータ設定（遷移元・遷移先の両方に設定する）
+	/// </summary>
+	/// <param name="layerName">レイヤー名</param>
+	/// <param name="parameter">パラメータ(1Dはxのみ使用)</param>
+	void SetBlendParameter(const std::string& layerName, const Vector2& parameter);
+	void SetBlendParameter(const std::string& layerName, float parameter);
+
+	/// <summary>
+	/// 更新（Advanceの後にEvaluateを行う）
 	/// </summary>
 	/// <param name="dt">デルタタイム</param>
 	void Update(float dt);
 
+	/// <summary>
+	/// 再生時間と遷移のみを進める（スケルトンは変更しない）
+	/// </summary>
+	/// <param name="dt">デルタタイム</param>
+	void Advance(float dt);
+
+	/// <summary>
+	/// 現在の再生状態をスケルトンに全レイヤー順次適用する
+	/// </summary>
+	void Evaluate();
+
+	/// <summary>
+	/// 現在の再生状態で決まる姿勢のキーを作成する
+	/// 同じキーのコントローラー同士は、再生時間の差がtimeQuantum未満のほぼ同じ姿勢になる
+	/// </summary>
+	/// <param name="timeQuantum">再生時間を丸める単位(秒)</param>
+	/// <param name="key">キーの出力先(上書きする)</param>
+	void BuildPoseKey(float timeQuantum, std::vector<uint64_t>& key) const;
+
+	//========================================================================
+	// accessors
+	//========================================================================
+
+	//操作するスケルトンの取得
+	Skeleton* GetSkeleton() const { return skeleton_; }
+	//前回のEvaluateでサンプリングしたアニメーションの数の取得
+	uint32_t GetLastContributionCount() const { return lastContributionCount_; }
+
+public:
+
+	//これ以下のウェイトのアニメーション・レイヤーはサンプリングしない
+	static constexpr float kMinWeight_ = 0.001f;
+
+private:
+
+	/// <summary>
+	/// 1レイヤー分の合成するアニメーション
+	/// </summary>
+	struct LayerContributions {
+		std::array<AnimationContribution, Skeleton::kMaxLayerContributions_> items = {};
+		uint32_t count = 0;
+	};
+	//遷移元・遷移先の両方がブレンドツリーでも収まること
+	static_assert(BlendTree::kMaxContributions_ * 2 <= Skeleton::kMaxLayerContributions_);
+
+	/// <summary>
+	/// 遷移の開始(遷移先の再生状態を設定する)
+	/// </summary>
+	void TransitionTo(const std::string& layerName, const AnimationState& state, float blendDuration);
+
+	/// <summary>
+	/// レイヤーで合成するアニメーションを集める(ウェイトが無視できるものは除く)
+	/// </summary>
+	/// <returns>合成するアニメーションがある場合true</returns>
+	static bool CollectContributions(const Layer& layer, LayerContributions& contributions);
+
+	/// <summary>
+	/// 再生状態の寄与を追加する(ブレンドツリーは合成する各アニメーションに分ける)
+	/// </summary>
+	static void AddStateContributions(const AnimationState& state, float weight, LayerContributions& contributions);
+
+	/// <summary>
+	/// 再生時間をtimeQuantum毎の区間の番号に丸める
+	/// </summary>
+	static uint32_t QuantizeTime(float time, float timeQuantum);
+
 private:
 
 	Skeleton* skeleton_ = nullptr;     //スケルトンへの非所有ポインタ
 	std::vector<Layer> layers_;        //アニメーションレイヤーのリスト
+	uint32_t lastContributionCount_ = 0;
 
 };
@@ -0,0 +1,180 @@
+#include "BlendTree.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace TakeC;
+
+namespace {
+
+	//値を挟む軸上の2点と、その間の割合を求める(範囲外は端の1点)
+	void LocateOnAxis(const std::vector<float>& axis, float value, uint32_t& index0, uint32_t& index1, float& t) {
+		if (axis.size() == 1 || value <= axis.front()) {
+			index0 = index1 = 0;
+			t = 0.0f;
+			return;
+		}
+		if (value >= axis.back()) {
+			index0 = index1 = static_cast<uint32_t>(axis.size() - 1);
+			t = 0.0f;
+			return;
+		}
+		index1 = static_cast<uint32_t>(std::upper_bound(axis.begin(), axis.end(), value) - axis.begin());
+		index0 = index1 - 1;
+		t = (value - axis[index0]) / (axis[index1] - axis[index0]);
+	}
+}
+
+//=============================================================================
+// 初期化
+//=============================================================================
+void BlendTree::Initialize(Type type) {
+	type_ = type;
+	motions_.clear();
+	gridX_.clear();
+	gridY_.clear();
+	gridCells_.clear();
+}
+
+//=============================================================================
+// アニメーションの追加
+//=============================================================================
+void BlendTree::AddMotion(Animation* animation, float threshold) {
+	assert(type_ == Type::Blend1D);
+	if (!animation) return;
+
+	// 閾値の昇順に挿入する
+	auto it = std::upper_bound(motions_.begin(), motions_.end(), threshold, [](float value, const Motion& motion) {
+		return value < motion.position.x;
+	});
+	motions_.insert(it, Motion{ animation, { threshold, 0.0f } });
+}
+
+void BlendTree::AddMotion(Animation* animation, const Vector2& position) {
+	assert(type_ == Type::Blend2D);
+	if (!animation) return;
+
+	motions_.push_back({ animation, position });
+	RebuildGrid();
+}
+
+//=============================================================================
+// 2Dの格子の作り直し
+//=============================================================================
+void BlendTree::RebuildGrid() {
+	gridX_.clear();
+	gridY_.clear();
+	for (const Motion& motion : motions_) {
+		gridX_.push_back(motion.position.x);
+		gridY_.push_back(motion.position.y);
+	}
+	std::sort(gridX_.begin(), gridX_.end());
+	gridX_.erase(std::unique(gridX_.begin(), gridX_.end()), gridX_.end());
+	std::sort(gridY_.begin(), gridY_.end());
+	gridY_.erase(std::unique(gridY_.begin(), gridY_.end()), gridY_.end());
+
+	// 同じ位置に複数ある場合は後から追加したものを使う
+	gridCells_.assign(gridX_.size() * gridY_.size(), -1);
+	for (size_t index = 0; index < motions_.size(); ++index) {
+		size_t x = std::lower_bound(gridX_.begin(), gridX_.end(), motions_[index].position.x) - gridX_.begin();
+		size_t y = std::lower_bound(gridY_.begin(), gridY_.end(), motions_[index].position.y) - gridY_.begin();
+		gridCells_[y * gridX_.size() + x] = static_cast<int32_t>(index);
+	}
+}
+
+//=============================================================================
+// 評価
+//=============================================================================
+BlendTree::Result BlendTree::Evaluate(const Vector2& parameter) const {
+	if (motions_.empty()) {
+		return {};
+	}
+	return type_ == Type::Blend1D ? Evaluate1D(parameter.x) : Evaluate2D(parameter);
+}
+
+BlendTree::Result BlendTree::Evaluate1D(float parameter) const {
+	Result result;
+
+	// 範囲外は端のアニメーションのみ
+	if (motions_.size() == 1 || parameter <= motions_.front().position.x) {
+		result.contributions[result.count++] = { motions_.front().animation, 1.0f };
+		return result;
+	}
+	if (parameter >= motions_.back().position.x) {
+		result.contributions[result.count++] = { motions_.back().animation, 1.0f };
+		return result;
+	}
+
+	// 挟む2つを線形に混ぜる
+	auto it = std::upper_bound(motions_.begin(), motions_.end(), parameter, [](float value, const Motion& motion) {
+		return value < motion.position.x;
+	});
+	const Motion& motion1 = *it;
+	const Motion& motion0 = *(it - 1);
+	float t = (parameter - motion0.position.x) / (motion1.position.x - motion0.position.x);
+	if (t < 1.0f) {
+		result.contributions[result.count++] = { motion0.animation, 1.0f - t };
+	}
+	if (t > 0.0f) {
+		result.contributions[result.count++] = { motion1.animation, t };
+	}
+	return result;
+}
+
+BlendTree::Result BlendTree::Evaluate2D(const Vector2& parameter) const {
+	Result result;
+
+	uint32_t x0, x1, y0, y1;
+	float tx, ty;
+	LocateOnAxis(gridX_, parameter.x, x0, x1, tx);
+	LocateOnAxis(gridY_, parameter.y, y0, y1, ty);
+
+	// 囲む4隅を双線形に混ぜる(欠けた隅は除いて正規化する)
+	const uint32_t cornerX[kMaxContributions_] = { x0, x1, x0, x1 };
+	const uint32_t cornerY[kMaxContributions_] = { y0, y0, y1, y1 };
+	const float cornerWeight[kMaxContributions_] = {
+		(1.0f - tx) * (1.0f - ty), tx * (1.0f - ty), (1.0f - tx) * ty, tx * ty,
+	};
+	float totalWeight = 0.0f;
+	for (uint32_t corner = 0; corner < kMaxContributions_; ++corner) {
+		int32_t cell = gridCells_[cornerY[corner] * gridX_.size() + cornerX[corner]];
+		if (cornerWeight[corner] <= 0.0f || cell < 0) {
+			continue;
+		}
+		result.contributions[result.count++] = { motions_[cell].animation, cornerWeight[corner] };
+		totalWeight += cornerWeight[corner];
+	}
+
+	if (totalWeight > 0.0f) {
+		for (uint32_t i = 0; i < result.count; ++i) {
+			result.contributions[i].weight /= totalWeight;
+		}
+		return result;
+	}
+
+	// 囲む隅が全て欠けている場合は最も近いアニメーションのみ
+	const Motion* nearest = &motions_.front();
+	float nearestDistance = std::numeric_limits<float>::max();
+	for (const Motion& motion : motions_) {
+		float distance = (motion.position - parameter).Length();
+		if (distance < nearestDistance) {
+			nearestDistance = distance;
+			nearest = &motion;
+		}
+	}
+	result.count = 0;
+	result.contributions[result.count++] = { nearest->animation, 1.0f };
+	return result;
+}
+
+//=============================================================================
+// 周期の長さ
+//=============================================================================
+float BlendTree::GetDuration(const Vector2& parameter) const {
+	Result result = Evaluate(parameter);
+	float duration = 0.0f;
+	for (uint32_t i = 0; i < result.count; ++i) {
+		duration += result.contributions[i].animation->duration * result.contributions[i].weight;
+	}
+	return duration;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "engine/Animation/NodeAnimation.h"
+#include "engine/math/Vector2.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+//============================================================================
+// BlendTree class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// パラメータに応じて複数のアニメーションを混ぜるブレンドツリーです。
+	/// 1Dは閾値の並びの隣り合う2つ、2Dは格子状に置いたアニメーションの囲む4つだけを合成するため、
+	/// 登録したアニメーションの数に関わらずサンプリングするのは最大kMaxContributions_個です。
+	/// 再生位置は全アニメーションで正規化した値(0〜1)を共有し、歩きと走りなど長さの違う動きの周期を揃えます。
+	/// 複数のキャラクターで共有できるよう、パラメータはツリーではなく呼び出し側(AnimationState)が持ちます。
+	/// </summary>
+	class BlendTree {
+	public:
+
+		/// <summary>
+		/// ブレンドツリーの種類
+		/// </summary>
+		enum class Type {
+			Blend1D, //閾値(parameter.x)で並べたアニメーションを線形に混ぜる
+			Blend2D, //格子状に置いたアニメーションをparameterで双線形に混ぜる
+		};
+
+		/// <summary>
+		/// 登録したアニメーション
+		/// </summary>
+		struct Motion {
+			Animation* animation = nullptr; //非所有
+			Vector2 position = {};          //1Dはxのみ使用
+		};
+
+		/// <summary>
+		/// 合成するアニメーション1つ分
+		/// </summary>
+		struct Contribution {
+			Animation* animation = nullptr;
+			float weight = 0.0f;
+		};
+
+		//1回の評価で合成するアニメーションの最大数(2Dの格子の4隅)
+		static constexpr uint32_t kMaxContributions_ = 4;
+
+		/// <summary>
+		/// 評価結果(weightの合計は1)
+		/// </summary>
+		struct Result {
+			std::array<Contribution, kMaxContributions_> contributions = {};
+			uint32_t count = 0;
+		};
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// 初期化(登録済みのアニメーションは破棄する)
+		/// </summary>
+		/// <param name="type">ブレンドツリーの種類</param>
+		void Initialize(Type type);
+
+		/// <summary>
+		/// 1Dのアニメーションの追加
+		/// </summary>
+		/// <param name="animation">アニメーション</param>
+		/// <param name="threshold">このアニメーションのみになるパラメータの値</param>
+		void AddMotion(Animation* animation, float threshold);
+
+		/// <summary>
+		/// 2Dのアニメーションの追加(x・yそれぞれの値の組み合わせで格子状に置くこと。欠けた格子点は残りで補う)
+		/// </summary>
+		/// <param name="animation">アニメーション</param>
+		/// <param name="position">このアニメーションのみになるパラメータの値</param>
+		void AddMotion(Animation* animation, const Vector2& position);
+
+		/// <summary>
+		/// パラメータから合成するアニメーションとウェイトを求める
+		/// </summary>
+		/// <param name="parameter">パラメータ(1Dはxのみ使用)</param>
+		/// <returns>ウェイトが0でないアニメーション(最大kMaxContributions_個)</returns>
+		Result Evaluate(const Vector2& parameter) const;
+
+		/// <summary>
+		/// パラメータでの周期の長さ(合成するアニメーションの長さのウェイト付き平均)
+		/// </summary>
+		/// <param name="parameter">パラメータ(1Dはxのみ使用)</param>
+		/// <returns>秒(アニメーションがない場合は0)</returns>
+		float GetDuration(const Vector2& parameter) const;
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//種類の取得
+		Type GetType() const { return type_; }
+		//登録したアニメーションの取得
+		const std::vector<Motion>& GetMotions() const { return motions_; }
+
+	private:
+
+		/// <summary>
+		/// 1Dの評価
+		/// </summary>
+		Result Evaluate1D(float parameter) const;
+
+		/// <summary>
+		/// 2Dの評価
+		/// </summary>
+		Result Evaluate2D(const Vector2& parameter) const;
+
+		/// <summary>
+		/// 2Dの格子の作り直し
+		/// </summary>
+		void RebuildGrid();
+
+	private:
+
+		Type type_ = Type::Blend1D;
+		std::vector<Motion> motions_;    //1Dはposition.xの昇順
+		std::vector<float> gridX_;       //2Dの格子のxの値(昇順)
+		std::vector<float> gridY_;       //2Dの格子のyの値(昇順)
+		std::vector<int32_t> gridCells_; //格子点 → motions_のインデックス(ない場合は-1)
+	};
+}
+
+using TakeC::BlendTree;
@@ -1,6 +1,7 @@
 #pragma once
 #include "Vector3.h"
 #include "Quaternion.h"
+#include <cstddef>
 
 //============================================================================
 // Keyframe struct
@@ -18,4 +19,14 @@ struct Keyframe {
 };
 
 using KeyframeVector3 = Keyframe<Vector3>;
-using KeyframeQuaternion = Keyframe<Quaternion>;
\ No newline at end of file
+using KeyframeQuaternion = Keyframe<Quaternion>;
+
+// キーフレーム探索位置のキャッシュ
+/// <summary>
+/// 前回サンプリングした補間区間の先頭インデックスを保持し、
+/// 時間が進む方向のサンプリングで探索を省略するための構造体です。
+/// 別のカーブに使い回しても結果は変わらず、探索がやり直しになるだけです。
+/// </summary>
+struct KeyframeCursor {
+	size_t index = 0;
+};
\ No newline at end of file
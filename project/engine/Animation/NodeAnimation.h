@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
 
 //============================================================================
 // NodeAnimation.h
@@ -14,7 +15,18 @@
 /// </summary>
 template <typename T>
 struct AnimationCurve {
-	std::vector<Keyframe<T>> keyframes; //キーフレームの配列
+	std::vector<Keyframe<T>> keyframes; //キーフレームの配列(圧縮後は空)
+
+	//----- AnimationCompressorで圧縮した場合のみ使用 -----
+	std::vector<float> times;           //キーフレームの時刻
+	std::vector<uint16_t> packedValues; //量子化した値(キーフレーム毎に3要素)
+	Vector3 rangeMin = {};              //Vector3の量子化範囲の最小値
+	Vector3 rangeExtent = {};           //Vector3の量子化範囲の幅
+
+	//圧縮済みかどうか
+	bool IsCompressed() const { return !times.empty(); }
+	//キーフレーム数の取得
+	size_t GetKeyframeCount() const { return IsCompressed() ? times.size() : keyframes.size(); }
 };
 
 //ノードアニメーション構造体
@@ -27,6 +39,16 @@ struct NodeAnimation {
 	AnimationCurve<Vector3> scale;     //拡縮
 };
 
+//ノードアニメーションのキーフレーム探索位置
+/// <summary>
+/// NodeAnimationの各チャンネルのKeyframeCursorをまとめて保持する構造体です。
+/// </summary>
+struct NodeAnimationCursor {
+	KeyframeCursor translate;
+	KeyframeCursor rotate;
+	KeyframeCursor scale;
+};
+
 //アニメーション構造体
 /// <summary>
 /// Animationに必要な値をまとめて保持する構造体です。
@@ -35,4 +57,5 @@ struct Animation {
 	std::string name; //アニメーション名
 	float duration; //アニメーションの全体の尺(秒単位)
 	std::map<std::string, NodeAnimation> nodeAnimations; //ノードアニメーションのマップ
+	uint64_t serial = 0; //読み込み毎に一意な番号(nodeAnimationsを差し替えたら更新し、Skeleton側の対応表を作り直させる)
 };
\ No newline at end of file
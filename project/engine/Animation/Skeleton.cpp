@@ -2,6 +2,8 @@
 #include "engine/math/MatrixMath.h"
 #include "engine/math/Easing.h"
 #include "engine/base/TakeCFrameWork.h"
+#include <array>
+#include <cassert>
 
 using namespace TakeC;
 
@@ -10,52 +12,57 @@ using namespace TakeC;
 //====================================================================
 void Skeleton::Create(const Node& rootNode) {
 
-	root = CreateJoint(rootNode, {});
+	pose = {};
+	localMatrices.clear();
+	skeletonSpaceMatrices.clear();
+	parents.clear();
+	hierarchy = {};
+
+	root = CreateJoint(rootNode, -1);
+	sourceNode = &rootNode;
 
 	//名前とindexのマッピングを行いアクセスしやすくする
-	for (const Joint& joint : joints) {
-		jointMap.emplace(joint.name, joint.index);
+	for (size_t index = 0; index < hierarchy.names.size(); ++index) {
+		hierarchy.jointMap.emplace(hierarchy.names[index], static_cast<int32_t>(index));
 	}
 
+	//行列の領域を確保
+	localMatrices.resize(parents.size());
+	skeletonSpaceMatrices.resize(parents.size());
+
 	//バインドポーズを保存
-	bindPose.clear();
-	for (const Joint& joint : joints) {
-		bindPose.push_back(joint.transform);
-	}
+	bindPose = pose;
 
-	for (Joint& joint : joints) {
+	//Jointの構成が変わるので対応表を作り直させる
+	animationBindings.clear();
 
-		//ローカル行列を更新
-		joint.localMatrix = MatrixMath::MakeAffineMatrix(
-			joint.transform.scale,
-			joint.transform.rotate,
-			joint.transform.translate);
-
-		if (joint.parent) { //親がいる場合親の行列を掛ける
-			joint.skeletonSpaceMatrix = joint.localMatrix * joints[*joint.parent].skeletonSpaceMatrix;
-		} else { //親がいない場合は自身の行列をそのまま使う
-			joint.skeletonSpaceMatrix = joint.localMatrix;
-		}
-	}
+	Update();
 }
 
 //====================================================================
 // スケルトン更新
 //====================================================================
 void Skeleton::Update() {
-	//全てのJointを更新
-	for (Joint& joint : joints) {
+
+	const size_t jointCount = parents.size();
+	const Vector3* translates = pose.translates.data();
+	const Quaternion* rotates = pose.rotates.data();
+	const Vector3* scales = pose.scales.data();
+	const int32_t* parentIndices = parents.data();
+	Matrix4x4* locals = localMatrices.data();
+	Matrix4x4* skeletonSpace = skeletonSpaceMatrices.data();
+
+	//親は子より前に並んでいるので、先頭から1回走査すれば親の行列は計算済みになっている
+	for (size_t index = 0; index < jointCount; ++index) {
 
 		//ローカル行列を更新
-		joint.localMatrix = MatrixMath::MakeAffineMatrix(
-			joint.transform.scale,
-			joint.transform.rotate,
-			joint.transform.translate);
+		locals[index] = MatrixMath::MakeAffineMatrix(scales[index], rotates[index], translates[index]);
 
-		if (joint.parent) { //親がいる場合親の行列を掛ける
-			joint.skeletonSpaceMatrix = joint.localMatrix * joints[*joint.parent].skeletonSpaceMatrix;
+		const int32_t parent = parentIndices[index];
+		if (parent >= 0) { //親がいる場合親の行列を掛ける
+			skeletonSpace[index] = locals[index] * skeletonSpace[parent];
 		} else { //親がいない場合は自身の行列をそのまま使う
-			joint.skeletonSpaceMatrix = joint.localMatrix;
+			skeletonSpace[index] = locals[index];
 		}
 	}
 }
@@ -65,11 +72,13 @@ void Skeleton::Update() {
 //====================================================================
 void Skeleton::UpdateImGui() {
 #if defined(_DEBUG) || defined(_DEVELOP)
-	for (Joint& joint : joints) {
-		ImGui::SeparatorText(joint.name.c_str());
-		ImGui::DragFloat3("Scale", &joint.transform.scale.x, 0.01f);
-		ImGui::DragFloat4("Rotate", &joint.transform.rotate.x, 0.01f);
-		ImGui::DragFloat3("Translate", &joint.transform.translate.x, 0.01f);
+	for (size_t index = 0; index < parents.size(); ++index) {
+		ImGui::PushID(static_cast<int>(index));
+		ImGui::SeparatorText(hierarchy.names[index].c_str());
+		ImGui::DragFloat3("Scale", &pose.scales[index].x, 0.01f);
+		ImGui::DragFloat4("Rotate", &pose.rotates[index].x, 0.01f);
+		ImGui::DragFloat3("Translate", &pose.translates[index].x, 0.01f);
+		ImGui::PopID();
 	}
 #endif
 }
@@ -80,26 +89,25 @@ void Skeleton::UpdateImGui() {
 void Skeleton::Draw(const Matrix4x4& worldMatrix) {
 
 	//jointの描画
-	for (const Joint& joint : joints) {
+	for (size_t index = 0; index < parents.size(); ++index) {
 
 		// ボーンのワールド行列を計算
-		Matrix4x4 jointWorldMatrix = joint.skeletonSpaceMatrix * worldMatrix;
+		Matrix4x4 jointWorldMatrix = skeletonSpaceMatrices[index] * worldMatrix;
 
 		// jointWorldMatrix からボーンの位置を取得して描画
 		// 例: Jointの原点（0,0,0）をjointWorldMatrixで変換してボーンのワールド位置に
 		Vector3 jointWorldPos = MatrixMath::Transform(
 			Vector3(0, 0, 0), jointWorldMatrix);
 		//親がいない場合はルートJointなので球で描画
-		if (!joint.parent) {
+		const int32_t parent = parents[index];
+		if (parent < 0) {
 			TakeC::TakeCFrameWork::GetWireFrame()->DrawSphere(
 				jointWorldPos,
 				0.1f, { 1.0f,1.0f,0.1f,1.0f });
 		} else {
 			//親がいる場合は親との線を描画
-			if (joint.parent.has_value()) {
-				Vector3 parentWorldPos = MatrixMath::Transform(Vector3(0, 0, 0), joints[joint.parent.value()].skeletonSpaceMatrix * worldMatrix);
-				TakeC::TakeCFrameWork::GetWireFrame()->DrawLine(jointWorldPos, parentWorldPos, { 1.0f,1.0f,1.0f,1.0f }); // 仮想関数
-			}
+			Vector3 parentWorldPos = MatrixMath::Transform(Vector3(0, 0, 0), skeletonSpaceMatrices[parent] * worldMatrix);
+			TakeC::TakeCFrameWork::GetWireFrame()->DrawLine(jointWorldPos, parentWorldPos, { 1.0f,1.0f,1.0f,1.0f }); // 仮想関数
 
 			//Jointを球で描画
 			TakeC::TakeCFrameWork::GetWireFrame()->DrawSphere(
@@ -114,14 +122,16 @@ void Skeleton::Draw(const Matrix4x4& worldMatrix) {
 // アニメーションの適用
 //====================================================================
 void Skeleton::ApplyAnimation(Animation* animation, float animationTime) {
-	for (Joint& joint : joints) {
+	AnimationBinding& binding = GetAnimationBinding(animation);
+	for (size_t index = 0; index < parents.size(); ++index) {
 		//対象のJointのAnimationがあれば、値の適用を行う。
-		if (auto it = animation->nodeAnimations.find(joint.name); it != animation->nodeAnimations.end()) {
-			const NodeAnimation& rootNodeAnimation = (*it).second;
-			joint.transform.scale = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.scale.keyframes, animationTime);
-			joint.transform.rotate = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.rotate.keyframes, animationTime);
-			joint.transform.translate = TakeC::AnimationManager::CalculateValue(rootNodeAnimation.translate.keyframes, animationTime);
-		}
+		const NodeAnimation* nodeAnimation = binding.channels[index];
+		if (!nodeAnimation) continue;
+
+		NodeAnimationCursor& cursor = binding.cursors[index];
+		pose.scales[index] = TakeC::AnimationManager::CalculateValue(nodeAnimation->scale, animationTime, cursor.scale);
+		pose.rotates[index] = TakeC::AnimationManager::CalculateValue(nodeAnimation->rotate, animationTime, cursor.rotate);
+		pose.translates[index] = TakeC::AnimationManager::CalculateValue(nodeAnimation->translate, animationTime, cursor.translate);
 	}
 }
 
@@ -129,46 +139,47 @@ void Skeleton::ApplyAnimation(Animation* animation, float animationTime) {
 // ブレンドアニメーションの適用（クロスフェード）
 //====================================================================
 void Skeleton::ApplyBlendedAnimation(Animation* from, float tFrom, Animation* to, float tTo, float blend) {
-	for (Joint& joint : joints) {
-		QuaternionTransform fromTransform = joint.transform;
+	AnimationBinding* fromBinding = (from && from->duration > 0.0f) ? &GetAnimationBinding(from) : nullptr;
+	AnimationBinding* toBinding = (to && to->duration > 0.0f && blend > 0.0f) ? &GetAnimationBinding(to) : nullptr;
+
+	for (size_t index = 0; index < parents.size(); ++index) {
+		QuaternionTransform fromTransform = pose.Get(index);
 
 		// 遷移元アニメーションのサンプリング
-		if (from && from->duration > 0.0f) {
-			auto it = from->nodeAnimations.find(joint.name);
-			if (it != from->nodeAnimations.end()) {
-				const NodeAnimation& nodeAnim = it->second;
-				fromTransform.scale = TakeC::AnimationManager::CalculateValue(nodeAnim.scale.keyframes, tFrom);
-				fromTransform.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim.rotate.keyframes, tFrom);
-				fromTransform.translate = TakeC::AnimationManager::CalculateValue(nodeAnim.translate.keyframes, tFrom);
+		if (fromBinding) {
+			if (const NodeAnimation* nodeAnim = fromBinding->channels[index]) {
+				NodeAnimationCursor& cursor = fromBinding->cursors[index];
+				fromTransform.scale = TakeC::AnimationManager::CalculateValue(nodeAnim->scale, tFrom, cursor.scale);
+				fromTransform.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim->rotate, tFrom, cursor.rotate);
+				fromTransform.translate = TakeC::AnimationManager::CalculateValue(nodeAnim->translate, tFrom, cursor.translate);
 			}
 		}
 
 		// ブレンド比率が0ならfromのみ適用
-		if (!to || to->duration <= 0.0f || blend <= 0.0f) {
-			joint.transform = fromTransform;
+		if (!toBinding) {
+			pose.Set(index, fromTransform);
 			continue;
 		}
 
 		// 遷移先アニメーションのサンプリング
 		QuaternionTransform toTransform = fromTransform;
-		auto it = to->nodeAnimations.find(joint.name);
-		if (it != to->nodeAnimations.end()) {
-			const NodeAnimation& nodeAnim = it->second;
-			toTransform.scale = TakeC::AnimationManager::CalculateValue(nodeAnim.scale.keyframes, tTo);
-			toTransform.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim.rotate.keyframes, tTo);
-			toTransform.translate = TakeC::AnimationManager::CalculateValue(nodeAnim.translate.keyframes, tTo);
+		if (const NodeAnimation* nodeAnim = toBinding->channels[index]) {
+			NodeAnimationCursor& cursor = toBinding->cursors[index];
+			toTransform.scale = TakeC::AnimationManager::CalculateValue(nodeAnim->scale, tTo, cursor.scale);
+			toTransform.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim->rotate, tTo, cursor.rotate);
+			toTransform.translate = TakeC::AnimationManager::CalculateValue(nodeAnim->translate, tTo, cursor.translate);
 		}
 
 		// ブレンド比率が1ならtoのみ適用
 		if (blend >= 1.0f) {
-			joint.transform = toTransform;
+			pose.Set(index, toTransform);
 			continue;
 		}
 
 		// Lerp/Slerpによるブレンド
-		joint.transform.scale = Easing::Lerp(fromTransform.scale, toTransform.scale, blend);
-		joint.transform.rotate = Easing::Slerp(fromTransform.rotate, toTransform.rotate, blend);
-		joint.transform.translate = Easing::Lerp(fromTransform.translate, toTransform.translate, blend);
+		pose.scales[index] = Easing::Lerp(fromTransform.scale, toTransform.scale, blend);
+		pose.rotates[index] = Easing::Slerp(fromTransform.rotate, toTransform.rotate, blend);
+		pose.translates[index] = Easing::Lerp(fromTransform.translate, toTransform.translate, blend);
 	}
 }
 
@@ -178,41 +189,100 @@ void Skeleton::ApplyBlendedAnimation(Animation* from, float tFrom, Animation* to
 void Skeleton::ApplyLayeredAnimation(Animation* animation, float time, float weight, AnimationBlendMode blendMode) {
 	if (!animation || weight <= 0.0f) return;
 
-	for (Joint& joint : joints) {
-		auto it = animation->nodeAnimations.find(joint.name);
-		if (it == animation->nodeAnimations.end()) continue;
+	const AnimationContribution contribution = { animation, time, 1.0f };
+	ApplyLayer({ &contribution, 1 }, weight, blendMode);
+}
+
+//====================================================================
+// 複数のアニメーションを混ぜたレイヤーの適用
+//====================================================================
+void Skeleton::ApplyLayer(std::span<const AnimationContribution> contributions, float weight, AnimationBlendMode blendMode) {
+	if (contributions.empty() || weight <= 0.0f) return;
+	assert(contributions.size() <= kMaxLayerContributions_);
+
+	// アニメーション毎の対応表を先に引いておく(アニメーションがない・ウェイトが0以下のものは除く)
+	std::array<const AnimationContribution*, kMaxLayerContributions_> actives = {};
+	std::array<AnimationBinding*, kMaxLayerContributions_> bindings = {};
+	size_t activeCount = 0;
+	for (const AnimationContribution& contribution : contributions) {
+		if (!contribution.animation || contribution.weight <= 0.0f) continue;
+		actives[activeCount] = &contribution;
+		bindings[activeCount] = &GetAnimationBinding(contribution.animation);
+		activeCount++;
+	}
+	if (activeCount == 0) return;
 
-		const NodeAnimation& nodeAnim = it->second;
+	for (size_t index = 0; index < parents.size(); ++index) {
+		Vector3& scale = pose.scales[index];
+		Quaternion& rotate = pose.rotates[index];
+		Vector3& translate = pose.translates[index];
 
-		// アニメーションから現在の値をサンプリング
+		// アニメーションから現在の値をサンプリングし、ウェイトの比率で順に混ぜる
+		// (i番目までの合計に対するi番目の割合で補間すると、全体をウェイトで正規化した平均になる)
 		QuaternionTransform sampled;
-		sampled.scale = TakeC::AnimationManager::CalculateValue(nodeAnim.scale.keyframes, time);
-		sampled.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim.rotate.keyframes, time);
-		sampled.translate = TakeC::AnimationManager::CalculateValue(nodeAnim.translate.keyframes, time);
+		float totalWeight = 0.0f;
+		bool hasChannel = false;
+		for (size_t i = 0; i < activeCount; ++i) {
+			const NodeAnimation* nodeAnim = bindings[i]->channels[index];
+			QuaternionTransform value;
+			if (nodeAnim) {
+				NodeAnimationCursor& cursor = bindings[i]->cursors[index];
+				const float time = actives[i]->time;
+				value.scale = TakeC::AnimationManager::CalculateValue(nodeAnim->scale, time, cursor.scale);
+				value.rotate = TakeC::AnimationManager::CalculateValue(nodeAnim->rotate, time, cursor.rotate);
+				value.translate = TakeC::AnimationManager::CalculateValue(nodeAnim->translate, time, cursor.translate);
+				hasChannel = true;
+			} else if (blendMode == AnimationBlendMode::Additive) {
+				// 加算は差分がないものとして扱う
+				value = { bindPose.scales[index], bindPose.rotates[index], bindPose.translates[index] };
+			} else {
+				value = { scale, rotate, translate };
+			}
+
+			totalWeight += actives[i]->weight;
+			if (i == 0) {
+				sampled = value;
+			} else {
+				float ratio = actives[i]->weight / totalWeight;
+				sampled.scale = Easing::Lerp(sampled.scale, value.scale, ratio);
+				sampled.rotate = Easing::Slerp(sampled.rotate, value.rotate, ratio);
+				sampled.translate = Easing::Lerp(sampled.translate, value.translate, ratio);
+			}
+		}
+		if (!hasChannel) continue;
 
 		if (blendMode == AnimationBlendMode::Override) {
-			// 上書き（現在の値と線形補間）
-			joint.transform.scale = Easing::Lerp(joint.transform.scale, sampled.scale, weight);
-			joint.transform.rotate = Easing::Slerp(joint.transform.rotate, sampled.rotate, weight);
-			joint.transform.translate = Easing::Lerp(joint.transform.translate, sampled.translate, weight);
+			if (weight >= 1.0f) {
+				// 上書き（ウェイトが1なら補間せずにそのまま使う）
+				scale = sampled.scale;
+				rotate = sampled.rotate;
+				translate = sampled.translate;
+			} else {
+				// 上書き（現在の値と線形補間）
+				scale = Easing::Lerp(scale, sampled.scale, weight);
+				rotate = Easing::Slerp(rotate, sampled.rotate, weight);
+				translate = Easing::Lerp(translate, sampled.translate, weight);
+			}
 		} else if (blendMode == AnimationBlendMode::Additive) {
 			// 加算（バインドポーズを基準とする）
-			const QuaternionTransform& ref = bindPose[joint.index];
+			const Vector3& refScale = bindPose.scales[index];
+			const Quaternion& refRotate = bindPose.rotates[index];
+			const Vector3& refTranslate = bindPose.translates[index];
 
 			// 差分を計算してウェイトを掛けて加算
 			// Scale: 1.0からの差分を加算
-			joint.transform.scale.x += (sampled.scale.x - ref.scale.x) * weight;
-			joint.transform.scale.y += (sampled.scale.y - ref.scale.y) * weight;
-			joint.transform.scale.z += (sampled.scale.z - ref.scale.z) * weight;
+			scale.x += (sampled.scale.x - refScale.x) * weight;
+			scale.y += (sampled.scale.y - refScale.y) * weight;
+			scale.z += (sampled.scale.z - refScale.z) * weight;
 
 			// Translate: 差分を加算
-			joint.transform.translate += (sampled.translate - ref.translate) * weight;
+			translate += (sampled.translate - refTranslate) * weight;
 
 			// Rotate: 差分クォータニオンを計算して適用
-			Quaternion q_diff = sampled.rotate * QuaternionMath::Inverse(ref.rotate);
+			Quaternion q_diff = sampled.rotate * QuaternionMath::Inverse(refRotate);
 			// 差分をウェイト分だけ適用（Identityとの補間）
 			Quaternion q_weighted = Easing::Slerp(QuaternionMath::IdentityQuaternion(), q_diff, weight);
-			joint.transform.rotate = q_weighted * joint.transform.rotate;
+			rotate = q_weighted * rotate;
 		}
 	}
 }
@@ -221,18 +291,64 @@ void Skeleton::ApplyLayeredAnimation(Animation* animation, float time, float wei
 // トランスフォームのリセット
 //====================================================================
 void Skeleton::ClearTransform() {
-	for (size_t i = 0; i < joints.size(); ++i) {
-		joints[i].transform = bindPose[i];
+	//要素数が同じなので確保は発生せずコピーのみになる
+	pose.translates.assign(bindPose.translates.begin(), bindPose.translates.end());
+	pose.rotates.assign(bindPose.rotates.begin(), bindPose.rotates.end());
+	pose.scales.assign(bindPose.scales.begin(), bindPose.scales.end());
+}
+
+//====================================================================
+// 姿勢と行列のコピー
+//====================================================================
+void Skeleton::CopyPoseFrom(const Skeleton& source) {
+	assert(source.sourceNode == sourceNode && source.parents.size() == parents.size());
+	//要素数が同じなので確保は発生せずコピーのみになる
+	pose.translates.assign(source.pose.translates.begin(), source.pose.translates.end());
+	pose.rotates.assign(source.pose.rotates.begin(), source.pose.rotates.end());
+	pose.scales.assign(source.pose.scales.begin(), source.pose.scales.end());
+	localMatrices.assign(source.localMatrices.begin(), source.localMatrices.end());
+	skeletonSpaceMatrices.assign(source.skeletonSpaceMatrices.begin(), source.skeletonSpaceMatrices.end());
+}
+
+//====================================================================
+// アニメーションとJointの対応表の破棄
+//====================================================================
+void Skeleton::ClearAnimationBindings() {
+	animationBindings.clear();
+}
+
+//====================================================================
+// アニメーションとJointの対応表の取得
+//====================================================================
+AnimationBinding& Skeleton::GetAnimationBinding(const Animation* animation) {
+	auto [it, inserted] = animationBindings.try_emplace(animation);
+	AnimationBinding& binding = it->second;
+	if (!inserted && binding.serial == animation->serial && binding.channels.size() == parents.size()) {
+		return binding;
+	}
+
+	//serialが異なる場合は同じアドレスに別のAnimationが作られたので、古い対応表は追加せず置き換える
+	binding = AnimationBinding{};
+
+	//Joint名でNodeAnimationを引いて対応表を作成する
+	binding.serial = animation->serial;
+	binding.channels.assign(parents.size(), nullptr);
+	binding.cursors.assign(parents.size(), NodeAnimationCursor{});
+	for (size_t index = 0; index < parents.size(); ++index) {
+		if (auto node = animation->nodeAnimations.find(hierarchy.names[index]); node != animation->nodeAnimations.end()) {
+			binding.channels[index] = &node->second;
+		}
 	}
+	return binding;
 }
 
 //====================================================================
 // ジョイント名から値を取得
 //====================================================================
 std::optional<Joint> Skeleton::GetJointByName(const std::string& name) const {
-	auto it = jointMap.find(name);
-	if (it != jointMap.end()) {
-		return joints[it->second];
+	auto it = hierarchy.jointMap.find(name);
+	if (it != hierarchy.jointMap.end()) {
+		return MakeJoint(it->second);
 	}
 	return std::nullopt; //見つからなかった場合はstd::nulloptを返す
 }
@@ -241,9 +357,9 @@ std::optional<Joint> Skeleton::GetJointByName(const std::string& name) const {
 // ジョイント名からワールド行列を取得
 //====================================================================
 std::optional<Matrix4x4> Skeleton::GetJointWorldMatrix(const std::string& jointName, const Matrix4x4& characterWorldMatrix) const {
-	auto it = jointMap.find(jointName);
-	if (it != jointMap.end()) {
-		return joints[it->second].skeletonSpaceMatrix * characterWorldMatrix;
+	auto it = hierarchy.jointMap.find(jointName);
+	if (it != hierarchy.jointMap.end()) {
+		return skeletonSpaceMatrices[it->second] * characterWorldMatrix;
 	}
 	return std::nullopt; //見つからなかった場合はstd::nulloptを返す
 }
@@ -252,10 +368,10 @@ std::optional<Matrix4x4> Skeleton::GetJointWorldMatrix(const std::string& jointN
 // ジョイント名からワールド位置を取得
 //====================================================================
 std::optional<Vector3> Skeleton::GetJointPosition(const std::string& jointName, const Matrix4x4& modelWorldMatrix) const {
-	auto it = jointMap.find(jointName);
-	if (it != jointMap.end()) {
+	auto it = hierarchy.jointMap.find(jointName);
+	if (it != hierarchy.jointMap.end()) {
 		int32_t index = it->second;
-		Matrix4x4 jointWorldMatrix = joints[index].skeletonSpaceMatrix * modelWorldMatrix;
+		Matrix4x4 jointWorldMatrix = skeletonSpaceMatrices[index] * modelWorldMatrix;
 		Vector3 worldPos = { jointWorldMatrix.m[3][0], jointWorldMatrix.m[3][1], jointWorldMatrix.m[3][2] };
 		return worldPos; // Jointのワールド位置を返す
 	}
@@ -264,23 +380,42 @@ std::optional<Vector3> Skeleton::GetJointPosition(const std::string& jointName,
 }
 
 //====================================================================
-// NodeからJointを作成
+// Jointの値をまとめて取り出す
 //====================================================================
-int32_t Skeleton::CreateJoint(const Node& node, const std::optional<int32_t>& parent) {
+Joint Skeleton::MakeJoint(int32_t index) const {
 	Joint joint;
-	joint.name = node.name;
-	joint.localMatrix = node.localMatrix;
-	joint.skeletonSpaceMatrix = MatrixMath::MakeIdentity4x4();
-	joint.transform = node.transform;
-	joint.index = static_cast<int32_t>(joints.size());
-	joint.parent = parent;
-	joints.push_back(joint); //SkeletonのJoint列に追加
+	joint.transform = pose.Get(index);
+	joint.localMatrix = localMatrices[index];
+	joint.skeletonSpaceMatrix = skeletonSpaceMatrices[index];
+	joint.name = hierarchy.names[index];
+	joint.children = hierarchy.children[index];
+	joint.index = index;
+	if (parents[index] >= 0) {
+		joint.parent = static_cast<uint32_t>(parents[index]);
+	}
+	return joint;
+}
+
+//====================================================================
+// NodeからJointを作成
+//====================================================================
+int32_t Skeleton::CreateJoint(const Node& node, int32_t parent) {
+	const int32_t index = static_cast<int32_t>(parents.size());
+
+	//SkeletonのJoint列に追加
+	pose.translates.push_back(node.transform.translate);
+	pose.rotates.push_back(node.transform.rotate);
+	pose.scales.push_back(node.transform.scale);
+	parents.push_back(parent);
+	hierarchy.names.push_back(node.name);
+	hierarchy.children.emplace_back();
+
 	for (const Node& child : node.children) {
-		//子Jointを作成して、そのIndexを登録
-		int32_t childIndex = CreateJoint(child, joint.index);
-		joints[joint.index].children.push_back(childIndex);
+		//子Jointを作成して、そのIndexを登録(子は自身より後ろに追加される)
+		int32_t childIndex = CreateJoint(child, index);
+		hierarchy.children[index].push_back(childIndex);
 	}
 
 	//自身のIndexを返す
-	return joint.index;
+	return index;
 }
@@ -7,11 +7,14 @@
 #include <vector>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <map>
+#include <unordered_map>
 
 //jointの構造体
 /// <summary>
-/// Jointに必要な値をまとめて保持する構造体です。
+/// Jointの値をまとめた構造体です。
+/// Skeleton内部では要素毎の配列で持つため、GetJointByNameで取り出す際のコピー用として使います。
 /// </summary>
 struct Joint {
 	QuaternionTransform transform; 
@@ -23,19 +26,82 @@ struct Joint {
 	std::optional<uint32_t> parent;   //親Jointのインデックス
 };
 
+//ジョイントのローカル姿勢
+/// <summary>
+/// 全JointのローカルなTRSを要素毎に連続した配列で持つ構造体です(インデックスはJointのインデックス)。
+/// </summary>
+struct SkeletonPose {
+	std::vector<Vector3> translates;
+	std::vector<Quaternion> rotates;
+	std::vector<Vector3> scales;
+
+	//Joint数の取得
+	size_t Size() const { return translates.size(); }
+	//Joint数の変更
+	void Resize(size_t count) {
+		translates.resize(count);
+		rotates.resize(count);
+		scales.resize(count);
+	}
+	//Jointの姿勢の取得・設定
+	QuaternionTransform Get(size_t index) const { return { scales[index], rotates[index], translates[index] }; }
+	void Set(size_t index, const QuaternionTransform& transform) {
+		scales[index] = transform.scale;
+		rotates[index] = transform.rotate;
+		translates[index] = transform.translate;
+	}
+};
+
+//ジョイントの階層情報
+/// <summary>
+/// 更新時には参照しないJointの名前と子の情報をまとめた構造体です。
+/// </summary>
+struct SkeletonHierarchy {
+	std::vector<std::string> names;              //Joint名
+	std::vector<std::vector<int32_t>> children;  //子Jointのインデックス
+	std::map<std::string, int32_t> jointMap;     //Joint名からindexとのマップ
+};
+
+//アニメーションとJointの対応表
+/// <summary>
+/// Joint毎に対応するNodeAnimationを事前に引いておき、適用時の名前検索を省くための構造体です。
+/// </summary>
+struct AnimationBinding {
+	uint64_t serial = 0;                        //作成時のAnimation::serial
+	std::vector<const NodeAnimation*> channels; //Joint毎のNodeAnimation(対応するものがなければnullptr)
+	std::vector<NodeAnimationCursor> cursors;   //Joint毎のキーフレーム探索位置
+};
+
 // ブレンドモード
 enum class AnimationBlendMode {
 	Override, // 上書き（線形補間）
 	Additive  // 加算
 };
 
+//レイヤーに合成するアニメーション1つ分
+/// <summary>
+/// ApplyLayerで1つのレイヤーとして混ぜるアニメーションと、その再生時間・ウェイトをまとめた構造体です。
+/// </summary>
+struct AnimationContribution {
+	Animation* animation = nullptr;
+	float time = 0.0f;   //再生時間（秒）
+	float weight = 0.0f; //レイヤー内での相対的なウェイト（合計が1でなくてもよい）
+};
+
 //==============================================================
 // Skeletonクラス
 //==============================================================
 /// <summary>
 /// モデルのジョイント階層と姿勢行列を保持・更新するクラスです。
+/// 更新で使う姿勢・行列・親のインデックスは要素毎の配列で持ち、親が子より前に並ぶ順序にしているため、
+/// Updateは先頭から1回走査するだけで全Jointのスケルトン空間行列が求まります。
 /// </summary>
 class Skeleton {
+public:
+
+	//ApplyLayerで1度に混ぜるアニメーションの最大数
+	static constexpr size_t kMaxLayerContributions_ = 8;
+
 public:
 
 	//==========================================================
@@ -83,11 +149,33 @@ public:
 	/// </summary>
 	void ApplyLayeredAnimation(Animation* animation, float time, float weight, AnimationBlendMode blendMode);
 
+	/// <summary>
+	/// 複数のアニメーションを混ぜた姿勢を1つのレイヤーとして適用する
+	/// Joint毎にcontributionsをウェイトで正規化して混ぜてから、weightで現在の姿勢に合成する
+	/// (対応するNodeAnimationのないアニメーションは、そのJointでは現在の姿勢(加算ではバインドポーズ)を使う)
+	/// </summary>
+	/// <param name="contributions">混ぜるアニメーション(最大kMaxLayerContributions_個。animationがnullptr・weightが0以下のものは無視する)</param>
+	/// <param name="weight">レイヤーのウェイト</param>
+	/// <param name="blendMode">合成モード</param>
+	void ApplyLayer(std::span<const AnimationContribution> contributions, float weight, AnimationBlendMode blendMode);
+
 	/// <summary>
 	/// トランスフォームのリセット（バインドポーズに戻す）
 	/// </summary>
 	void ClearTransform();
 
+	/// <summary>
+	/// アニメーションとJointの対応表を破棄する
+	/// (適用したAnimationを破棄した場合に呼ぶ。再読み込みはserialで自動的に検出される)
+	/// </summary>
+	void ClearAnimationBindings();
+
+	/// <summary>
+	/// 同じNodeから作成したスケルトンの姿勢と行列をコピーする(姿勢の共有で評価を省く場合に使用)
+	/// </summary>
+	/// <param name="source">コピー元(Update済みであること)</param>
+	void CopyPoseFrom(const Skeleton& source);
+
 
 	//=====================================================
 	// accessors
@@ -97,10 +185,25 @@ public:
 
 	//スケルトンのRootJointのインデックスを取得
 	const int32_t GetRoot() const { return root; }
-	//ジョイントのリストを取得
-	const std::vector<Joint>& GetJoints() { return joints; }
+	//ジョイント数を取得
+	size_t GetJointCount() const { return parents.size(); }
+	//作成元のNodeの取得(同じNodeから作成したスケルトンはJointの構成が同じ)
+	const TakeC::Node* GetSourceNode() const { return sourceNode; }
 	//ジョイント名からインデックスのマップを取得
-	const std::map<std::string, int32_t>& GetJointMap() { return jointMap; }
+	const std::map<std::string, int32_t>& GetJointMap() const { return hierarchy.jointMap; }
+	//ジョイント名の取得
+	const std::string& GetJointName(size_t index) const { return hierarchy.names[index]; }
+	//親ジョイントのインデックスの取得(ルートは-1)
+	const std::vector<int32_t>& GetParentIndices() const { return parents; }
+	//子ジョイントのインデックスの取得
+	const std::vector<int32_t>& GetChildren(size_t index) const { return hierarchy.children[index]; }
+	//ローカル姿勢の取得
+	const SkeletonPose& GetLocalPose() const { return pose; }
+	SkeletonPose& GetLocalPose() { return pose; }
+	//ローカル行列の取得
+	const std::vector<Matrix4x4>& GetLocalMatrices() const { return localMatrices; }
+	//スケルトン空間行列の取得
+	const std::vector<Matrix4x4>& GetSkeletonSpaceMatrices() const { return skeletonSpaceMatrices; }
 
 	// ジョイント名から値を取得
 	std::optional<Joint> GetJointByName(const std::string& name) const;
@@ -112,17 +215,37 @@ public:
 private:
 
 	/// <summary>
-	/// NodeからJointを作成
+	/// NodeからJointを作成(深さ優先で追加するため、親は子より前に並ぶ)
 	/// </summary>
 	/// <param name="node"></param>
-	/// <param name="parent"></param>
-	/// <param name="joints"></param>
+	/// <param name="parent">親Jointのインデックス(ルートは-1)</param>
 	/// <returns></returns>
-	int32_t CreateJoint(const TakeC::Node& node, const std::optional<int32_t>& parent);
+	int32_t CreateJoint(const TakeC::Node& node, int32_t parent);
+
+	/// <summary>
+	/// アニメーションとJointの対応表の取得(未作成・再読み込み済みなら作成する)
+	/// </summary>
+	/// <param name="animation"></param>
+	/// <returns></returns>
+	AnimationBinding& GetAnimationBinding(const Animation* animation);
+
+
+	/// <summary>
+	/// Jointの値をまとめて取り出す
+	/// </summary>
+	Joint MakeJoint(int32_t index) const;
+
+	int32_t root = 0; //RootJointのインデックス
+	const TakeC::Node* sourceNode = nullptr; //作成元のNode(非所有)
 
+	// 更新で使うデータ(インデックスはJointのインデックスで、親は必ず子より前にある)
+	SkeletonPose pose;                          //ローカル姿勢
+	std::vector<Matrix4x4> localMatrices;       //ローカル行列
+	std::vector<Matrix4x4> skeletonSpaceMatrices; //SkeletonSpaceでの変換行列
+	std::vector<int32_t> parents;               //親Jointのインデックス(ルートは-1)
 
-	int32_t root; //RootJointのインデックス
-	std::map<std::string, int32_t> jointMap; //Joint名からindexとのマップ
-	std::vector<Joint> joints; //Jointのリスト
-	std::vector<QuaternionTransform> bindPose; //リセット用のバインドポーズ
+	// 更新では使わないデータ
+	SkeletonHierarchy hierarchy;  //Joint名・子の情報
+	SkeletonPose bindPose;        //リセット用のバインドポーズ
+	std::unordered_map<const Animation*, AnimationBinding> animationBindings; //アニメーション毎のJointとの対応表
 };
\ No newline at end of file
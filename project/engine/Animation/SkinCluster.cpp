@@ -13,9 +13,12 @@ void SkinCluster::Create(
 	const ComPtr<ID3D12Device>& device,TakeC::SrvManager* srvManager,
 	Skeleton* skeleton, const ModelData* modelData) {
 
+	//作り直す場合は補間中のパレットを破棄する
+	EndInterpolation();
+
 	//palette用のResource確保
 	//MEMO:sizeInBytesはWellForGPUのサイズ×ジョイント数
-	paletteResource = TakeC::DirectXCommon::CreateBufferResource(device.Get(), sizeof(WellForGPU) * skeleton->GetJoints().size());
+	paletteResource = TakeC::DirectXCommon::CreateBufferResource(device.Get(), sizeof(WellForGPU) * skeleton->GetJointCount());
 	paletteResource->SetName(L"SkinCluster::paletteResource");
 	
 	//paletteのSRVのIndexを取得
@@ -24,11 +27,11 @@ void SkinCluster::Create(
 	paletteSrvHandle.second = srvManager->GetSrvDescriptorHandleGPU(paletteIndex);
 	//paletteのsrv作成
 	srvManager->CreateSRVforStructuredBuffer(
-		UINT(skeleton->GetJoints().size()),sizeof(WellForGPU),paletteResource.Get(), paletteIndex);
+		UINT(skeleton->GetJointCount()),sizeof(WellForGPU),paletteResource.Get(), paletteIndex);
 
 	WellForGPU* mappedPaletteData = nullptr;
 	paletteResource->Map(0, nullptr, reinterpret_cast<void**>(&mappedPaletteData));
-	mappedPalette = { mappedPaletteData, skeleton->GetJoints().size() };
+	mappedPalette = { mappedPaletteData, skeleton->GetJointCount() };
 
 	//influence用のResource確保
 	//VertexInfluence * std::vector<VertexData>
@@ -51,7 +54,7 @@ void SkinCluster::Create(
 	*skinningInfoData = modelData->skinningInfoData;
 
 	//InverseBindPoseMatricesの保存領域の作成
-	inverseBindPoseMatrices.resize(skeleton->GetJoints().size());
+	inverseBindPoseMatrices.resize(skeleton->GetJointCount());
 	std::generate(inverseBindPoseMatrices.begin(), inverseBindPoseMatrices.end(), []() {
 		return MatrixMath::MakeIdentity4x4(); });
 
@@ -84,12 +87,84 @@ void SkinCluster::Create(
 // SkinCluster更新
 //====================================================================
 void SkinCluster::Update(Skeleton* skeleton) {
-	for (size_t jointIndex = 0; jointIndex < skeleton->GetJoints().size(); ++jointIndex) {
-		assert(jointIndex < inverseBindPoseMatrices.size());
+	if (!isInterpolating) {
+		ComputePalette(skeleton, mappedPalette);
+		return;
+	}
+
+	//補間中は評価結果を補間先にし、このフレームは補間元を表示する
+	ComputePalette(skeleton, interpolationTo);
+	std::copy(interpolationFrom.begin(), interpolationFrom.end(), mappedPalette.begin());
+}
+
+void SkinCluster::WritePalette(std::span<const WellForGPU> palette) {
+	assert(palette.size() <= mappedPalette.size());
+	if (!isInterpolating) {
+		std::copy(palette.begin(), palette.end(), mappedPalette.begin());
+		return;
+	}
+
+	std::copy(palette.begin(), palette.end(), interpolationTo.begin());
+	std::copy(interpolationFrom.begin(), interpolationFrom.end(), mappedPalette.begin());
+}
+
+void SkinCluster::ComputePalette(Skeleton* skeleton, std::span<WellForGPU> palette) const {
+	const std::vector<Matrix4x4>& skeletonSpaceMatrices = skeleton->GetSkeletonSpaceMatrices();
+	assert(skeletonSpaceMatrices.size() <= inverseBindPoseMatrices.size());
+	assert(skeletonSpaceMatrices.size() <= palette.size());
+
+	for (size_t jointIndex = 0; jointIndex < skeletonSpaceMatrices.size(); ++jointIndex) {
+		palette[jointIndex].skeletonSpaceMatrix =
+			inverseBindPoseMatrices[jointIndex] * skeletonSpaceMatrices[jointIndex];
+		//パレットはアフィン行列同士の積なのでアフィン専用の逆転置行列で求める
+		palette[jointIndex].skeletonSpaceInvTransposeMatrix =
+			MatrixMath::InverseTransposeAffine(palette[jointIndex].skeletonSpaceMatrix);
+	}
+}
+
+//====================================================================
+// パレットの補間
+//====================================================================
+namespace {
+
+	//パレットの各行列の要素を線形補間する(評価の間隔は数フレームなので行列の補間で十分近い)
+	void LerpPalette(const std::vector<WellForGPU>& from, const std::vector<WellForGPU>& to, float blend, std::span<WellForGPU> out) {
+		constexpr size_t kFloatCount = sizeof(WellForGPU) / sizeof(float);
+		for (size_t jointIndex = 0; jointIndex < from.size(); ++jointIndex) {
+			const float* f = reinterpret_cast<const float*>(&from[jointIndex]);
+			const float* t = reinterpret_cast<const float*>(&to[jointIndex]);
+			float* o = reinterpret_cast<float*>(&out[jointIndex]);
+			for (size_t i = 0; i < kFloatCount; ++i) {
+				o[i] = f[i] + (t[i] - f[i]) * blend;
+			}
+		}
+	}
+}
+
+void SkinCluster::BeginInterpolation(Skeleton* skeleton, float currentBlend) {
+	if (!isInterpolating) {
+		interpolationFrom.resize(mappedPalette.size());
+		interpolationTo.resize(mappedPalette.size());
+		ComputePalette(skeleton, interpolationFrom);
+		isInterpolating = true;
+		return;
+	}
 
-		mappedPalette[jointIndex].skeletonSpaceMatrix =
-			inverseBindPoseMatrices[jointIndex] * skeleton->GetJoints()[jointIndex].skeletonSpaceMatrix;
-		mappedPalette[jointIndex].skeletonSpaceInvTransposeMatrix =
-			MatrixMath::Transpose(MatrixMath::Inverse(mappedPalette[jointIndex].skeletonSpaceMatrix));
+	if (currentBlend >= 1.0f) {
+		interpolationFrom.swap(interpolationTo);
+	} else {
+		LerpPalette(interpolationFrom, interpolationTo, currentBlend, interpolationFrom);
 	}
-}
\ No newline at end of file
+}
+
+void SkinCluster::EndInterpolation() {
+	isInterpolating = false;
+}
+
+void SkinCluster::WriteInterpolated(float blend) {
+	if (!isInterpolating) {
+		return;
+	}
+	//アップロードヒープは書き込みのみ行う
+	LerpPalette(interpolationFrom, interpolationTo, blend, mappedPalette);
+}
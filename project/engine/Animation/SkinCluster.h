@@ -51,6 +51,11 @@ struct SkinCluster {
 	ComPtr<ID3D12Resource> skinningInfoResource;
 	TakeC::SkinningInfo* skinningInfoData;
 
+	//アニメーションLODで評価を間引く場合のパレット(補間元と補間先をCPU側に保持する)
+	std::vector<WellForGPU> interpolationFrom;
+	std::vector<WellForGPU> interpolationTo;
+	bool isInterpolating = false;
+
 	//SRVハンドル
 	std::pair<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_GPU_DESCRIPTOR_HANDLE> paletteSrvHandle;
 	uint32_t paletteIndex;
@@ -64,7 +69,39 @@ struct SkinCluster {
 
 	/// <summary>
 	/// SkinCluster更新
+	/// 補間中はスケルトンのパレットを補間先として保持し、補間元をGPUに書き込む
 	/// </summary>
 	void Update(Skeleton* skeleton);
+
+	/// <summary>
+	/// パレットの補間の開始(スケルトンを次の評価フレームの姿勢に進める前に呼ぶ)
+	/// 補間中でなければ現在のスケルトンから、補間中なら直前に表示していた補間結果から補間元を作る
+	/// </summary>
+	/// <param name="skeleton"></param>
+	/// <param name="currentBlend">直前に表示していた補間率</param>
+	void BeginInterpolation(Skeleton* skeleton, float currentBlend);
+
+	/// <summary>
+	/// パレットの補間の終了(以降のUpdateは直接GPUに書き込む)
+	/// </summary>
+	void EndInterpolation();
+
+	/// <summary>
+	/// 補間したパレットをGPUに書き込む
+	/// </summary>
+	/// <param name="blend">補間率(0で補間元、1で補間先)</param>
+	void WriteInterpolated(float blend);
+
+	/// <summary>
+	/// 計算済みのパレットを書き込む(同じ姿勢のモデルとパレットを共有する場合に使用)
+	/// 補間中はUpdateと同様に補間先として保持し、補間元をGPUに書き込む
+	/// </summary>
+	/// <param name="palette">同じModelDataのスケルトンから計算したパレット</param>
+	void WritePalette(std::span<const WellForGPU> palette);
+
+	/// <summary>
+	/// スケルトンからパレットを計算する
+	/// </summary>
+	void ComputePalette(Skeleton* skeleton, std::span<WellForGPU> palette) const;
 };
 
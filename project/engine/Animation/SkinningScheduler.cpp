@@ -0,0 +1,248 @@
+#include "SkinningScheduler.h"
+#include "engine/3d/Model.h"
+#include "engine/Animation/AnimatorController.h"
+#include "engine/Utility/JobSystem.h"
+#include "engine/base/ImGuiManager.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace TakeC;
+
+SkinningScheduler& SkinningScheduler::GetInstance() {
+	static SkinningScheduler instance;
+	return instance;
+}
+
+//=============================================================================
+// 更新の登録
+//=============================================================================
+void SkinningScheduler::Enqueue(Model* model, Animation* animation, float animationTime, const AnimationLodDecision& lod) {
+	Push({ model, nullptr, animation, animationTime, lod });
+}
+
+void SkinningScheduler::Enqueue(Model* model, AnimatorController* controller, float deltaTime, const AnimationLodDecision& lod) {
+	Push({ model, controller, nullptr, deltaTime, lod });
+}
+
+void SkinningScheduler::Push(const Task& task) {
+
+	// 無効ならその場で処理する
+	if (!isEnabled_) {
+		Execute(task);
+		return;
+	}
+
+	// 登録済みなら上書き(同じモデルを複数スレッドで更新しないため)
+	uint32_t index = task.model->GetSkinningTaskIndex();
+	if (index < tasks_.size() && tasks_[index].model == task.model) {
+		tasks_[index] = task;
+		return;
+	}
+	task.model->SetSkinningTaskIndex(static_cast<uint32_t>(tasks_.size()));
+	tasks_.push_back(task);
+}
+
+//=============================================================================
+// 登録の取り消し
+//=============================================================================
+void SkinningScheduler::Cancel(Model* model) {
+	uint32_t index = model->GetSkinningTaskIndex();
+	if (index < tasks_.size() && tasks_[index].model == model) {
+		tasks_[index].model = nullptr;
+	}
+	model->SetSkinningTaskIndex(Model::kNoSkinningTask);
+}
+
+//=============================================================================
+// 登録済みの更新を並列に処理
+//=============================================================================
+void SkinningScheduler::Flush() {
+
+	auto start = std::chrono::steady_clock::now();
+
+	// 同じ姿勢になるAnimatorControllerの更新をまとめる
+	AssignSharedPoses();
+
+	// モデル毎にスケルトン・パレットが別なので、モデル単位の分担なら書き込みは重ならない
+	// 他のモデルの姿勢をコピーする更新は、代表の評価が全て終わってから行う
+	JobSystem::GetInstance().ParallelFor(static_cast<uint32_t>(tasks_.size()), kGrainSize_, [this](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			if (tasks_[i].model && !tasks_[i].IsPoseFollower()) {
+				Execute(tasks_[i]);
+			}
+		}
+	});
+	if (lastPoseStats_.hitCount > 0) {
+		JobSystem::GetInstance().ParallelFor(static_cast<uint32_t>(tasks_.size()), kGrainSize_, [this](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				if (tasks_[i].model && tasks_[i].IsPoseFollower()) {
+					Execute(tasks_[i]);
+				}
+			}
+		});
+	}
+
+	for (const Task& task : tasks_) {
+		if (task.model) {
+			task.model->SetSkinningTaskIndex(Model::kNoSkinningTask);
+		}
+	}
+
+	lastTaskCount_ = static_cast<uint32_t>(tasks_.size());
+	lastFlushMilliseconds_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	tasks_.clear();
+}
+
+//=============================================================================
+// 同じ姿勢になる更新への姿勢の割り当て
+//=============================================================================
+void SkinningScheduler::AssignSharedPoses() {
+
+	poseLookup_.clear();
+	poseKeys_.clear();
+	poseCount_ = 0;
+	lastPoseStats_ = {};
+
+	if (!isPoseSharingEnabled_) {
+		return;
+	}
+
+	for (uint32_t taskIndex = 0; taskIndex < tasks_.size(); ++taskIndex) {
+		Task& task = tasks_[taskIndex];
+		// パレットの補間のみの更新は評価しないので対象外
+		if (!task.model || !task.controller || task.lod.mode == AnimationLodDecision::Mode::Interpolate) {
+			continue;
+		}
+
+		// 再生時間はここで進め、Executeでは適用のみ行う
+		task.controller->Advance(task.time);
+		task.controller->BuildPoseKey(poseTimeQuantum_, poseKeyScratch_);
+		lastPoseStats_.lookupCount++;
+
+		// 同じキーの姿勢があれば、その代表の結果をコピーする
+		uint64_t hash = poseKeyHasher_(poseKeyScratch_);
+		auto [it, isInserted] = poseLookup_.try_emplace(hash, poseCount_);
+		if (!isInserted) {
+			SharedPose& pose = poses_[it->second];
+			const uint64_t* storedKey = poseKeys_.data() + pose.keyOffset;
+			if (pose.keySize == poseKeyScratch_.size() && std::equal(poseKeyScratch_.begin(), poseKeyScratch_.end(), storedKey)) {
+				task.poseIndex = it->second;
+				task.isPoseOwner = false;
+				pose.followerCount++;
+				lastPoseStats_.hitCount++;
+				continue;
+			}
+			// ハッシュが衝突した場合は共有せずに別の姿勢として評価する
+		}
+
+		// 新しい姿勢の代表にする(palette は前フレームの領域を使い回す)
+		if (poseCount_ == poses_.size()) {
+			poses_.emplace_back();
+		}
+		SharedPose& pose = poses_[poseCount_];
+		pose.ownerTask = taskIndex;
+		pose.followerCount = 0;
+		pose.keyOffset = static_cast<uint32_t>(poseKeys_.size());
+		pose.keySize = static_cast<uint32_t>(poseKeyScratch_.size());
+		poseKeys_.insert(poseKeys_.end(), poseKeyScratch_.begin(), poseKeyScratch_.end());
+		task.poseIndex = poseCount_;
+		task.isPoseOwner = true;
+		poseCount_++;
+	}
+
+	lastPoseStats_.uniqueCount = poseCount_;
+	totalPoseLookupCount_ += lastPoseStats_.lookupCount;
+	totalPoseHitCount_ += lastPoseStats_.hitCount;
+}
+
+//=============================================================================
+// 姿勢のキーのハッシュ
+//=============================================================================
+uint64_t SkinningScheduler::HashPoseKey(const std::vector<uint64_t>& key) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (uint64_t word : key) {
+		hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+	}
+	return hash;
+}
+
+//=============================================================================
+// 1モデル分の更新
+//=============================================================================
+void SkinningScheduler::Execute(const Task& task) {
+	// アニメーションLOD: 評価を間引くフレームはパレットの補間のみ行う
+	switch (task.lod.mode) {
+	case AnimationLodDecision::Mode::Interpolate:
+		task.model->WriteInterpolatedPalette(task.lod.blend);
+		return;
+	case AnimationLodDecision::Mode::Evaluate:
+		task.model->BeginPaletteInterpolation(task.lod.blend);
+		break;
+	default:
+		task.model->EndPaletteInterpolation();
+		break;
+	}
+
+	if (task.poseIndex != kNoPose_) {
+		ExecuteSharedPose(task);
+	} else if (task.controller) {
+		task.controller->Update(task.time);
+		task.model->UpdateSkinningFromSkeleton();
+	} else {
+		task.model->Update(task.animation, task.time);
+	}
+}
+
+//=============================================================================
+// 姿勢を共有する更新
+//=============================================================================
+void SkinningScheduler::ExecuteSharedPose(const Task& task) {
+	SharedPose& pose = poses_[task.poseIndex];
+
+	if (task.isPoseOwner) {
+		// 再生時間はAssignSharedPosesで進めてあるので適用のみ行う
+		task.controller->Evaluate();
+		if (pose.followerCount == 0) {
+			task.model->UpdateSkinningFromSkeleton();
+			return;
+		}
+		// 同じ姿勢のモデルが使えるようにCPU側にパレットを残す(アップロードヒープからは読み出さない)
+		task.model->BuildSkinPalette(pose.palette);
+		task.model->WriteSkinPalette(pose.palette);
+		return;
+	}
+
+	// 代表の評価結果をコピーする(ジョイントの位置の参照に使えるよう、スケルトンもコピーする)
+	const Task& owner = tasks_[pose.ownerTask];
+	task.controller->GetSkeleton()->CopyPoseFrom(*owner.controller->GetSkeleton());
+	task.model->WriteSkinPalette(pose.palette);
+}
+
+//=============================================================================
+// ImGui更新処理
+//=============================================================================
+void SkinningScheduler::UpdateImGui() {
+#if defined(_DEBUG) || defined(_DEVELOP)
+	if (ImGui::TreeNode("Skinning")) {
+		ImGui::Checkbox("Parallel", &isEnabled_);
+		ImGui::Text("Models : %u", lastTaskCount_);
+		ImGui::Text("Flush : %.3f ms", lastFlushMilliseconds_);
+
+		// 姿勢の共有
+		ImGui::SeparatorText("Pose Sharing");
+		ImGui::Checkbox("Enabled", &isPoseSharingEnabled_);
+		ImGui::DragFloat("Time Quantum", &poseTimeQuantum_, 0.001f, 0.0f, 0.1f, "%.4f s");
+		const float hitRate = lastPoseStats_.lookupCount > 0 ?
+			100.0f * lastPoseStats_.hitCount / lastPoseStats_.lookupCount : 0.0f;
+		const float totalHitRate = totalPoseLookupCount_ > 0 ?
+			100.0f * static_cast<float>(totalPoseHitCount_) / static_cast<float>(totalPoseLookupCount_) : 0.0f;
+		ImGui::Text("Unique Poses : %u / %u", lastPoseStats_.uniqueCount, lastPoseStats_.lookupCount);
+		ImGui::Text("Hit Rate : %.1f %% (total %.1f %%)", hitRate, totalHitRate);
+		if (ImGui::Button("Reset Total")) {
+			totalPoseLookupCount_ = 0;
+			totalPoseHitCount_ = 0;
+		}
+		ImGui::TreePop();
+	}
+#endif // _DEBUG
+}
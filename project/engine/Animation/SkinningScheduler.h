@@ -0,0 +1,202 @@
+#pragma once
+#include "engine/Animation/AnimationLod.h"
+#include "engine/Animation/SkinCluster.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct Animation;
+class AnimatorController;
+namespace TakeC {
+	class Model;
+}
+
+//============================================================================
+// SkinningScheduler class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// スキンメッシュのアニメーション更新(ポーズのサンプリング・スケルトン行列の計算・パレットの書き込み)を
+	/// フレーム中に溜めておき、Flushで全モデル分をJobSystemで並列に処理するクラスです。
+	/// モデル毎にスケルトンとパレットのバッファを持つため、モデル単位で分担すれば書き込みは競合しません。
+	/// 同じモデルを1フレームに複数回登録した場合は最後の登録で上書きし、1回だけ処理します。
+	/// AnimatorControllerによる更新は、スケルトンの構成・アニメーション・丸めた再生時間・遷移の状態が同じものを
+	/// 1フレームの間だけまとめ、代表の1体だけが姿勢とパレットを計算して残りはそのコピーで済ませます。
+	/// </summary>
+	class SkinningScheduler {
+	public:
+
+		/// <summary>
+		/// 姿勢の共有の1フレーム分の集計
+		/// </summary>
+		struct PoseShareStats {
+			uint32_t lookupCount = 0; //共有の対象になった更新の数
+			uint32_t hitCount = 0;    //他のモデルの姿勢をコピーで済ませた数
+			uint32_t uniqueCount = 0; //実際に評価した姿勢の数
+		};
+
+		//姿勢のキーのハッシュ関数
+		using PoseKeyHasher = uint64_t(*)(const std::vector<uint64_t>& key);
+
+		//姿勢を共有しない更新を表すインデックス
+		static constexpr uint32_t kNoPose_ = UINT32_MAX;
+
+	private:
+
+		//コピーコンストラクタ・代入演算子禁止
+		SkinningScheduler() = default;
+		~SkinningScheduler() = default;
+		SkinningScheduler(const SkinningScheduler&) = delete;
+		SkinningScheduler& operator=(const SkinningScheduler&) = delete;
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// シングルトンインスタンス取得
+		/// </summary>
+		static SkinningScheduler& GetInstance();
+
+		/// <summary>
+		/// アニメーションを再生時間で適用する更新の登録(Model::Updateと同じ処理)
+		/// </summary>
+		/// <param name="model">更新するモデル</param>
+		/// <param name="animation">アニメーション</param>
+		/// <param name="animationTime">再生時間</param>
+		/// <param name="lod">アニメーションLODの判定結果(Interpolateなら評価せずパレットの補間のみ行う)</param>
+		void Enqueue(Model* model, Animation* animation, float animationTime, const AnimationLodDecision& lod = {});
+
+		/// <summary>
+		/// AnimatorControllerによる更新の登録(AnimatorController::Update後にパレットを書き込む)
+		/// </summary>
+		/// <param name="model">更新するモデル</param>
+		/// <param name="controller">モデルのスケルトンを操作するコントローラー</param>
+		/// <param name="deltaTime">デルタタイム</param>
+		/// <param name="lod">アニメーションLODの判定結果(Interpolateなら評価せずパレットの補間のみ行う)</param>
+		void Enqueue(Model* model, AnimatorController* controller, float deltaTime, const AnimationLodDecision& lod = {});
+
+		/// <summary>
+		/// 登録済みの更新を取り消す(モデルを破棄する前に呼ぶ)
+		/// </summary>
+		/// <param name="model">取り消すモデル</param>
+		void Cancel(Model* model);
+
+		/// <summary>
+		/// 登録済みの更新を全て並列に処理する(シーンの更新後・描画前に呼ぶ)
+		/// 同じフレームでジョイントの姿勢を参照したい場合は、参照する前に呼んでもよい
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		/// ImGui更新処理
+		/// </summary>
+		void UpdateImGui();
+
+		/// <summary>
+		/// 既定の姿勢のキーのハッシュ
+		/// </summary>
+		/// <param name="key">AnimatorController::BuildPoseKeyで作ったキー</param>
+		/// <returns>ハッシュ値</returns>
+		static uint64_t HashPoseKey(const std::vector<uint64_t>& key);
+
+		//========================================================================
+		// accessors
+		//========================================================================
+
+		//並列処理の有効・無効の設定(無効なら登録時にその場で処理する)
+		void SetEnabled(bool isEnabled) { isEnabled_ = isEnabled; }
+		bool IsEnabled() const { return isEnabled_; }
+		//前回のFlushで処理したモデル数の取得
+		uint32_t GetLastTaskCount() const { return lastTaskCount_; }
+		//姿勢の共有の有効・無効の設定
+		void SetPoseSharingEnabled(bool isEnabled) { isPoseSharingEnabled_ = isEnabled; }
+		bool IsPoseSharingEnabled() const { return isPoseSharingEnabled_; }
+		//姿勢を共有するかの判定で再生時間を丸める単位(秒)の設定
+		void SetPoseTimeQuantum(float timeQuantum) { poseTimeQuantum_ = timeQuantum; }
+		float GetPoseTimeQuantum() const { return poseTimeQuantum_; }
+		//前回のFlushでの姿勢の共有の集計の取得
+		const PoseShareStats& GetLastPoseShareStats() const { return lastPoseStats_; }
+		//姿勢のキーのハッシュ関数の差し替え(nullptrなら既定に戻す。ハッシュが衝突した場合の確認用)
+		void SetPoseKeyHasher(PoseKeyHasher hasher) { poseKeyHasher_ = hasher ? hasher : &HashPoseKey; }
+
+	public:
+
+		//並列処理で1度に処理するモデル数
+		static constexpr uint32_t kGrainSize_ = 4;
+
+	private:
+
+		/// <summary>
+		/// 1モデル分の更新
+		/// </summary>
+		struct Task {
+			Model* model = nullptr;                 //更新するモデル(取り消し済みならnullptr)
+			AnimatorController* controller = nullptr; //コントローラー(nullptrならanimationを再生時間で適用)
+			Animation* animation = nullptr;
+			float time = 0.0f;                      //再生時間またはデルタタイム
+			AnimationLodDecision lod;               //評価するか、パレットの補間のみか
+			uint32_t poseIndex = kNoPose_;          //共有する姿勢(kNoPose_なら共有しない)
+			bool isPoseOwner = false;               //共有する姿勢を評価する代表か
+
+			//他のモデルが評価した姿勢をコピーする更新か
+			bool IsPoseFollower() const { return poseIndex != kNoPose_ && !isPoseOwner; }
+		};
+
+		/// <summary>
+		/// 1フレームの間だけ共有する姿勢
+		/// </summary>
+		struct SharedPose {
+			uint32_t ownerTask = 0;           //評価する代表の更新のインデックス
+			uint32_t followerCount = 0;       //コピーで済ませる更新の数
+			uint32_t keyOffset = 0;           //poseKeys_内のキーの位置
+			uint32_t keySize = 0;
+			std::vector<WellForGPU> palette;  //代表が計算したパレット(フレームをまたいで領域を使い回す)
+		};
+
+		/// <summary>
+		/// 更新の登録(登録済みのモデルは上書きする)
+		/// </summary>
+		void Push(const Task& task);
+
+		/// <summary>
+		/// AnimatorControllerの再生時間を進め、同じ姿勢になる更新に同じ姿勢を割り当てる
+		/// </summary>
+		void AssignSharedPoses();
+
+		/// <summary>
+		/// 1モデル分の更新を実行する
+		/// </summary>
+		void Execute(const Task& task);
+
+		/// <summary>
+		/// 姿勢を共有する更新を実行する(代表は評価し、それ以外は代表の結果をコピーする)
+		/// </summary>
+		void ExecuteSharedPose(const Task& task);
+
+	private:
+
+		std::vector<Task> tasks_;
+		bool isEnabled_ = true;
+		uint32_t lastTaskCount_ = 0;
+		float lastFlushMilliseconds_ = 0.0f;
+
+		//姿勢の共有
+		bool isPoseSharingEnabled_ = true;
+		float poseTimeQuantum_ = 1.0f / 60.0f;
+		PoseKeyHasher poseKeyHasher_ = &HashPoseKey;
+		std::unordered_map<uint64_t, uint32_t> poseLookup_; //キーのハッシュ → poses_のインデックス
+		std::vector<SharedPose> poses_;
+		uint32_t poseCount_ = 0;                            //今フレームで使っているposes_の数
+		std::vector<uint64_t> poseKeys_;                    //今フレームの全キーを連結したもの
+		std::vector<uint64_t> poseKeyScratch_;
+		PoseShareStats lastPoseStats_;
+		uint64_t totalPoseLookupCount_ = 0;
+		uint64_t totalPoseHitCount_ = 0;
+	};
+}
+
+using TakeC::SkinningScheduler;
@@ -799,9 +799,9 @@ void BehaviorTreeEditor::UpdateBlackboardKeys() {
 	} else {
 		// キー名を収集（実行のたびに作り直す。量が少ないので許容範囲）
 		blackboardKeys_.clear();
-		for (const auto& pair : blackboard_->Entries()) {
-			blackboardKeys_.push_back(pair.first);
-		}
+		blackboard_->ForEach([this](const std::string& key, const BlackboardValue&) {
+			blackboardKeys_.push_back(key);
+		});
 		// 毎回順番が変わらないようにソートしておく
 		std::sort(blackboardKeys_.begin(), blackboardKeys_.end());
 	}
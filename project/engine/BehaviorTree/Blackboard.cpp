@@ -1,15 +1,94 @@
 #include "Blackboard.h"
 
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 namespace TakeC {
+namespace {
+
+/// <summary>
+/// キー名とIDの対応表です。キー名はdequeに保持し、mapのキーはその文字列を参照します。
+/// </summary>
+struct BlackboardKeyTable {
+	std::mutex mutex;
+	std::deque<std::string> names;
+	std::unordered_map<std::string_view, BlackboardKeyId> ids;
+};
+
+BlackboardKeyTable& GetKeyTable() {
+	static BlackboardKeyTable table;
+	return table;
+}
+
+} // namespace
+
+//=============================================================================
+// BlackboardKeyRegistry
+//=============================================================================
+
+BlackboardKeyId BlackboardKeyRegistry::Intern(std::string_view name) {
+	if (name.empty()) {
+		return BlackboardKeyId::Invalid;
+	}
+
+	BlackboardKeyTable& table = GetKeyTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	auto it = table.ids.find(name);
+	if (it != table.ids.end()) {
+		return it->second;
+	}
+
+	const BlackboardKeyId id = static_cast<BlackboardKeyId>(table.names.size());
+	const std::string& stored = table.names.emplace_back(name);
+	table.ids.emplace(std::string_view(stored), id);
+	return id;
+}
+
+BlackboardKeyId BlackboardKeyRegistry::Find(std::string_view name) {
+	BlackboardKeyTable& table = GetKeyTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	auto it = table.ids.find(name);
+	return it == table.ids.end() ? BlackboardKeyId::Invalid : it->second;
+}
+
+const std::string& BlackboardKeyRegistry::GetName(BlackboardKeyId id) {
+	static const std::string kEmpty;
+
+	BlackboardKeyTable& table = GetKeyTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	const std::size_t index = static_cast<std::size_t>(id);
+	return index < table.names.size() ? table.names[index] : kEmpty;
+}
+
+//=============================================================================
+// Blackboard
+//=============================================================================
 
 bool Blackboard::Contains(std::string_view key) const {
-	return data_.contains(std::string(key));
+	return Contains(BlackboardKeyRegistry::Find(key));
+}
+
+bool Blackboard::Contains(BlackboardKeyId key) const {
+	const Slot* slot = FindSlot(key);
+	return slot != nullptr && slot->has_value();
 }
 
 bool Blackboard::Remove(std::string_view key) {
-	if (data_.erase(std::string(key)) == 0) {
+	return Remove(BlackboardKeyRegistry::Find(key));
+}
+
+bool Blackboard::Remove(BlackboardKeyId key) {
+	Slot* slot = FindSlot(key);
+	if (slot == nullptr || !slot->has_value()) {
 		return false;
 	}
+	slot->reset();
+	--size_;
 	++revision_;
 	return true;
 }
@@ -19,22 +98,27 @@ bool Blackboard::Rename(std::string_view oldKey, std::string_view newKey) {
 		return false;
 	}
 
-	auto node = data_.extract(std::string(oldKey));
-	if (node.empty()) {
+	Slot* oldSlot = FindSlot(BlackboardKeyRegistry::Find(oldKey));
+	if (oldSlot == nullptr || !oldSlot->has_value()) {
 		return false;
 	}
 
-	node.key() = std::string(newKey);
-	data_.insert(std::move(node));
+	BlackboardValue value = std::move(**oldSlot);
+	oldSlot->reset();
+	// EnsureSlotでslots_が再確保される可能性があるため、oldSlotはここ以降使わない
+	EnsureSlot(BlackboardKeyRegistry::Intern(newKey)).emplace(std::move(value));
 	++revision_;
 	return true;
 }
 
 void Blackboard::Clear() {
-	if (data_.empty()) {
+	if (size_ == 0) {
 		return;
 	}
-	data_.clear();
+	for (Slot& slot : slots_) {
+		slot.reset();
+	}
+	size_ = 0;
 	++revision_;
 }
 
@@ -43,22 +127,28 @@ bool Blackboard::SetOrReplace(std::string_view key, BlackboardValue value) {
 		return false;
 	}
 
-	auto [it, inserted] = data_.try_emplace(std::string(key), std::move(value));
-	if (inserted) {
+	Slot& slot = EnsureSlot(BlackboardKeyRegistry::Intern(key));
+	if (!slot.has_value()) {
+		slot.emplace(std::move(value));
+		++size_;
 		++revision_;
 		return true;
 	}
 
-	if (it->second != value) {
-		it->second = std::move(value);
+	if (*slot != value) {
+		*slot = std::move(value);
 		++revision_;
 	}
 	return true;
 }
 
 std::optional<float> Blackboard::TryGetNumberAsFloat(std::string_view key) const {
-	auto it = data_.find(std::string(key));
-	if (it == data_.end()) {
+	return TryGetNumberAsFloat(BlackboardKeyRegistry::Find(key));
+}
+
+std::optional<float> Blackboard::TryGetNumberAsFloat(BlackboardKeyId key) const {
+	const BlackboardValue* entry = TryGetValue(key);
+	if (entry == nullptr) {
 		return std::nullopt;
 	}
 
@@ -71,7 +161,26 @@ std::optional<float> Blackboard::TryGetNumberAsFloat(std::string_view key) const
 		} else {
 			return std::nullopt;
 		}
-	}, it->second);
+	}, *entry);
+}
+
+const BlackboardValue* Blackboard::TryGetValue(std::string_view key) const {
+	return TryGetValue(BlackboardKeyRegistry::Find(key));
+}
+
+const BlackboardValue* Blackboard::TryGetValue(BlackboardKeyId key) const {
+	const Slot* slot = FindSlot(key);
+	return (slot == nullptr || !slot->has_value()) ? nullptr : &**slot;
+}
+
+Blackboard::Slot& Blackboard::EnsureSlot(BlackboardKeyId key) {
+	assert(key != BlackboardKeyId::Invalid);
+
+	const std::size_t index = static_cast<std::size_t>(key);
+	if (index >= slots_.size()) {
+		slots_.resize(index + 1);
+	}
+	return slots_[index];
 }
 
 } // namespace TakeC
@@ -5,9 +5,9 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace TakeC {
 
@@ -27,23 +27,65 @@ inline constexpr bool IsBlackboardValue =
 
 } // namespace Detail
 
+/// <summary>
+/// 文字列キーを一度だけ登録して得る、Blackboardのスロット番号です。
+/// </summary>
+enum class BlackboardKeyId : std::uint32_t {
+	Invalid = 0xFFFFFFFFu,
+};
+
+/// <summary>
+/// Blackboardのキー名を整数IDへ変換(intern)するプロセス共通の登録表です。
+/// ツリー構築・アセット読み込み時にInternしておけば、実行時はIDだけで値にアクセスできます。
+/// </summary>
+class BlackboardKeyRegistry final {
+public:
+	BlackboardKeyRegistry() = delete;
+
+	/// <summary>
+	/// キー名を登録してIDを返します。登録済みなら既存のIDを返し、空文字ならInvalidを返します。
+	/// </summary>
+	static BlackboardKeyId Intern(std::string_view name);
+
+	/// <summary>
+	/// 登録済みのキー名からIDを検索します。未登録ならInvalidを返します(登録もメモリ確保もしません)。
+	/// </summary>
+	[[nodiscard]] static BlackboardKeyId Find(std::string_view name);
+
+	/// <summary>
+	/// IDに対応するキー名を取得します。Invalidや未登録のIDなら空文字を返します。
+	/// </summary>
+	[[nodiscard]] static const std::string& GetName(BlackboardKeyId id);
+};
+
 /// <summary>
 /// キー名と値型を組にして、Blackboardアクセス時の型を保証するキーです。
+/// 構築時にキー名をInternするため、アクセス時に文字列の検索は行いません。
 /// </summary>
 template<class T>
 struct BlackboardKey final {
 	static_assert(Detail::IsBlackboardValue<T>, "T is not supported by BlackboardValue");
 
-	std::string_view name;
+	BlackboardKey() = default;
+	BlackboardKey(std::string_view name) : id(BlackboardKeyRegistry::Intern(name)) {}
+	explicit BlackboardKey(BlackboardKeyId keyId) : id(keyId) {}
+
+	/// <summary>
+	/// キー名を取得します。
+	/// </summary>
+	[[nodiscard]] const std::string& Name() const { return BlackboardKeyRegistry::GetName(id); }
+
+	BlackboardKeyId id = BlackboardKeyId::Invalid;
 };
 
 /// <summary>
 /// ビヘイビアツリーのノード間で共有する型付きデータを保持するクラスです。
 /// Runtime機能だけを担当し、表示・編集処理には依存しません。
+/// 値はBlackboardKeyIdで添字付けしたスロットに保持し、ID指定のアクセスはメモリ確保を行いません。
 /// </summary>
 class Blackboard final {
 public:
-	using Storage = std::unordered_map<std::string, BlackboardValue>;
+	using Slot = std::optional<BlackboardValue>;
 
 	Blackboard() = default;
 	~Blackboard() = default;
@@ -57,11 +99,13 @@ public:
 	/// キーが存在するかを調べます。
 	/// </summary>
 	[[nodiscard]] bool Contains(std::string_view key) const;
+	[[nodiscard]] bool Contains(BlackboardKeyId key) const;
 
 	/// <summary>
 	/// キーを削除します。削除した場合はtrueを返します。
 	/// </summary>
 	bool Remove(std::string_view key);
+	bool Remove(BlackboardKeyId key);
 
 	/// <summary>
 	/// キー名を変更します。元キーがない場合や変更先が使用済みの場合はfalseを返します。
@@ -79,6 +123,9 @@ public:
 	template<class T>
 	bool Set(std::string_view key, T&& value);
 
+	template<class T>
+	bool Set(BlackboardKeyId key, T&& value);
+
 	/// <summary>
 	/// 型付きキーを使って値を設定します。
 	/// </summary>
@@ -99,6 +146,12 @@ public:
 	template<class T>
 	[[nodiscard]] const T* TryGet(std::string_view key) const;
 
+	template<class T>
+	[[nodiscard]] T* TryGet(BlackboardKeyId key);
+
+	template<class T>
+	[[nodiscard]] const T* TryGet(BlackboardKeyId key) const;
+
 	/// <summary>
 	/// 型付きキーを使って値を取得します。
 	/// </summary>
@@ -114,6 +167,9 @@ public:
 	template<class T>
 	[[nodiscard]] T GetOr(std::string_view key, T defaultValue) const;
 
+	template<class T>
+	[[nodiscard]] T GetOr(BlackboardKeyId key, T defaultValue) const;
+
 	template<class T>
 	[[nodiscard]] T GetOr(const BlackboardKey<T>& key, T defaultValue) const;
 
@@ -121,11 +177,24 @@ public:
 	/// 数値型の値をfloatへ変換して取得します。非数値型または未登録ならnulloptを返します。
 	/// </summary>
 	[[nodiscard]] std::optional<float> TryGetNumberAsFloat(std::string_view key) const;
+	[[nodiscard]] std::optional<float> TryGetNumberAsFloat(BlackboardKeyId key) const;
+
+	/// <summary>
+	/// 型を問わず値を取得します。キーがない場合はnullptrを返します。
+	/// </summary>
+	[[nodiscard]] const BlackboardValue* TryGetValue(std::string_view key) const;
+	[[nodiscard]] const BlackboardValue* TryGetValue(BlackboardKeyId key) const;
+
+	/// <summary>
+	/// 全エントリーを(キー名, 値)で列挙します。
+	/// </summary>
+	template<class Func>
+	void ForEach(Func&& func) const;
 
 	/// <summary>
-	/// 読み取り専用の全エントリーを取得します。
+	/// 登録されている値の数を取得します。
 	/// </summary>
-	[[nodiscard]] const Storage& Entries() const noexcept { return data_; }
+	[[nodiscard]] std::size_t Size() const noexcept { return size_; }
 
 	/// <summary>
 	/// 最後に値が変化した世代を取得します。
@@ -133,27 +202,59 @@ public:
 	[[nodiscard]] std::uint64_t Revision() const noexcept { return revision_; }
 
 private:
-	Storage data_;
+
+	/// <summary>
+	/// IDに対応するスロットを取得します。範囲外ならnullptrを返します。
+	/// </summary>
+	[[nodiscard]] Slot* FindSlot(BlackboardKeyId key);
+	[[nodiscard]] const Slot* FindSlot(BlackboardKeyId key) const;
+
+	/// <summary>
+	/// IDに対応するスロットを取得します。範囲外なら配列を拡張します。
+	/// </summary>
+	Slot& EnsureSlot(BlackboardKeyId key);
+
+	std::vector<Slot> slots_;  // BlackboardKeyIdで添字付けした値
+	std::size_t size_ = 0;     // 値が入っているスロットの数
 	std::uint64_t revision_ = 0;
 };
 
+inline Blackboard::Slot* Blackboard::FindSlot(BlackboardKeyId key) {
+	const std::size_t index = static_cast<std::size_t>(key);
+	return index < slots_.size() ? &slots_[index] : nullptr;
+}
+
+inline const Blackboard::Slot* Blackboard::FindSlot(BlackboardKeyId key) const {
+	const std::size_t index = static_cast<std::size_t>(key);
+	return index < slots_.size() ? &slots_[index] : nullptr;
+}
+
 template<class T>
 bool Blackboard::Set(std::string_view key, T&& value) {
+	if (key.empty()) {
+		return false;
+	}
+	return Set(BlackboardKeyRegistry::Intern(key), std::forward<T>(value));
+}
+
+template<class T>
+bool Blackboard::Set(BlackboardKeyId key, T&& value) {
 	using ValueType = std::remove_cvref_t<T>;
 	static_assert(Detail::IsBlackboardValue<ValueType>, "T is not supported by BlackboardValue");
 
-	if (key.empty()) {
+	if (key == BlackboardKeyId::Invalid) {
 		return false;
 	}
 
-	auto it = data_.find(std::string(key));
-	if (it == data_.end()) {
-		data_.emplace(std::string(key), BlackboardValue{std::forward<T>(value)});
+	Slot& slot = EnsureSlot(key);
+	if (!slot.has_value()) {
+		slot.emplace(std::in_place_type<ValueType>, std::forward<T>(value));
+		++size_;
 		++revision_;
 		return true;
 	}
 
-	auto* current = std::get_if<ValueType>(&it->second);
+	auto* current = std::get_if<ValueType>(&*slot);
 	if (current == nullptr) {
 		return false;
 	}
@@ -167,37 +268,52 @@ bool Blackboard::Set(std::string_view key, T&& value) {
 
 template<class T>
 bool Blackboard::Set(const BlackboardKey<T>& key, T value) {
-	return Set<T>(key.name, std::move(value));
+	return Set<T>(key.id, std::move(value));
 }
 
 template<class T>
 T* Blackboard::TryGet(std::string_view key) {
+	return TryGet<T>(BlackboardKeyRegistry::Find(key));
+}
+
+template<class T>
+const T* Blackboard::TryGet(std::string_view key) const {
+	return TryGet<T>(BlackboardKeyRegistry::Find(key));
+}
+
+template<class T>
+T* Blackboard::TryGet(BlackboardKeyId key) {
 	static_assert(Detail::IsBlackboardValue<T>, "T is not supported by BlackboardValue");
 
-	auto it = data_.find(std::string(key));
-	return it == data_.end() ? nullptr : std::get_if<T>(&it->second);
+	Slot* slot = FindSlot(key);
+	return (slot == nullptr || !slot->has_value()) ? nullptr : std::get_if<T>(&**slot);
 }
 
 template<class T>
-const T* Blackboard::TryGet(std::string_view key) const {
+const T* Blackboard::TryGet(BlackboardKeyId key) const {
 	static_assert(Detail::IsBlackboardValue<T>, "T is not supported by BlackboardValue");
 
-	auto it = data_.find(std::string(key));
-	return it == data_.end() ? nullptr : std::get_if<T>(&it->second);
+	const Slot* slot = FindSlot(key);
+	return (slot == nullptr || !slot->has_value()) ? nullptr : std::get_if<T>(&**slot);
 }
 
 template<class T>
 T* Blackboard::TryGet(const BlackboardKey<T>& key) {
-	return TryGet<T>(key.name);
+	return TryGet<T>(key.id);
 }
 
 template<class T>
 const T* Blackboard::TryGet(const BlackboardKey<T>& key) const {
-	return TryGet<T>(key.name);
+	return TryGet<T>(key.id);
 }
 
 template<class T>
 T Blackboard::GetOr(std::string_view key, T defaultValue) const {
+	return GetOr<T>(BlackboardKeyRegistry::Find(key), std::move(defaultValue));
+}
+
+template<class T>
+T Blackboard::GetOr(BlackboardKeyId key, T defaultValue) const {
 	if (const T* value = TryGet<T>(key)) {
 		return *value;
 	}
@@ -206,7 +322,16 @@ T Blackboard::GetOr(std::string_view key, T defaultValue) const {
 
 template<class T>
 T Blackboard::GetOr(const BlackboardKey<T>& key, T defaultValue) const {
-	return GetOr<T>(key.name, std::move(defaultValue));
+	return GetOr<T>(key.id, std::move(defaultValue));
+}
+
+template<class Func>
+void Blackboard::ForEach(Func&& func) const {
+	for (std::size_t index = 0; index < slots_.size(); ++index) {
+		if (slots_[index].has_value()) {
+			func(BlackboardKeyRegistry::GetName(static_cast<BlackboardKeyId>(index)), *slots_[index]);
+		}
+	}
 }
 
 } // namespace TakeC
@@ -214,4 +339,6 @@ T Blackboard::GetOr(const BlackboardKey<T>& key, T defaultValue) const {
 // 既存のBehaviorTreeコードを段階的にTakeC名前空間へ移行するための互換用宣言。
 using TakeC::Blackboard;
 using TakeC::BlackboardKey;
+using TakeC::BlackboardKeyId;
+using TakeC::BlackboardKeyRegistry;
 using TakeC::BlackboardValue;
@@ -6,7 +6,7 @@
 ConditionNode::ConditionNode(const std::string& field, const std::string& op, float threshold, const std::string& name) {
 
 	name_ = name;
-	field_ = field;
+	SetField(field);
 	threshold_ = threshold;
 
 	if (op == ">=")      compare_ = [](float a, float b) { return a >= b; };
@@ -24,7 +24,7 @@ ConditionNode::ConditionNode(const std::string& field, const std::string& op, fl
 // ノードの実行
 //====================================================================================
 BehaviorStatus ConditionNode::Execute(Blackboard& blackboard) {
-	const std::optional<float> current = blackboard.TryGetNumberAsFloat(field_);
+	const std::optional<float> current = blackboard.TryGetNumberAsFloat(fieldId_);
 	if (!current.has_value()) {
 		currentStatus_ = BehaviorStatus::Failure;
 		return currentStatus_;
@@ -49,7 +49,7 @@ void ConditionNode::DrawInspector() {
 	strncpy_s(fieldBuf, field_.c_str(), sizeof(fieldBuf) - 1);
 	ImGui::SetNextItemWidth(kWidgetWidth);
 	if (ImGui::InputText("Field", fieldBuf, sizeof(fieldBuf))) {
-		field_ = fieldBuf;
+		SetField(fieldBuf);
 	}
 
 	// 比較演算子
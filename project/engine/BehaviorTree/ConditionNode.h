@@ -69,12 +69,16 @@ public:
 	/// 比較対象のフィールドの設定
 	/// </summary>
 	/// <param name="field"></param>
-	void SetField(const std::string& field) { field_ = field; }
+	void SetField(const std::string& field) {
+		field_ = field;
+		fieldId_ = BlackboardKeyRegistry::Intern(field_);
+	}
 
 
 private:
 
 	std::string field_;
+	BlackboardKeyId fieldId_ = BlackboardKeyId::Invalid; // field_をInternしたID
 	std::string op_;
 	float threshold_;
 	std::function<bool(float, float)> compare_;
@@ -5,7 +5,7 @@
 // コンストラクタ
 //====================================================================
 SetBlackboardBoolNode::SetBlackboardBoolNode(const std::string& key, bool value, const std::string& name)
-	: key_(key), value_(value) {
+	: key_(key), keyId_(BlackboardKeyRegistry::Intern(key)), value_(value) {
 	SetName(name);
 }
 
@@ -14,7 +14,7 @@ SetBlackboardBoolNode::SetBlackboardBoolNode(const std::string& key, bool value,
 //====================================================================
 BehaviorStatus SetBlackboardBoolNode::Execute(Blackboard& blackboard) {
 	// 指定されたキーにbool値をセットする
-	blackboard.Set(key_, value_);
+	blackboard.Set(keyId_, value_);
 	return BehaviorStatus::Success; // 実行は即座に成功する
 }
 
@@ -27,12 +27,16 @@ public:
 	// accessors
 	//=============================================================================
 	const std::string& GetKey() const { return key_; }
-	void SetKey(const std::string& key) { key_ = key; }
+	void SetKey(const std::string& key) {
+		key_ = key;
+		keyId_ = BlackboardKeyRegistry::Intern(key_);
+	}
 
 	bool GetValue() const { return value_; }
 	void SetValue(bool value) { value_ = value; }
 
 private:
 	std::string key_;
+	BlackboardKeyId keyId_ = BlackboardKeyId::Invalid; // key_をInternしたID
 	bool value_;
 };
@@ -5,7 +5,7 @@
 // コンストラクタ
 //====================================================================
 SetBlackboardStringNode::SetBlackboardStringNode(const std::string& key, const std::string& value, const std::string& name)
-	: key_(key), value_(value) {
+	: key_(key), keyId_(BlackboardKeyRegistry::Intern(key)), value_(value) {
 	SetName(name);
 }
 
@@ -13,7 +13,7 @@ SetBlackboardStringNode::SetBlackboardStringNode(const std::string& key, const s
 // 実行：指定キーに文字列をセットして即 Success を返す
 //====================================================================
 BehaviorStatus SetBlackboardStringNode::Execute(Blackboard& blackboard) {
-	blackboard.Set(key_, value_);
+	blackboard.Set(keyId_, value_);
 	return BehaviorStatus::Success;
 }
 
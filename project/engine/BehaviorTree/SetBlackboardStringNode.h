@@ -33,7 +33,10 @@ public:
 	// accessors
 	//=============================================================================
 	const std::string& GetKey() const { return key_; }
-	void SetKey(const std::string& key) { key_ = key; }
+	void SetKey(const std::string& key) {
+		key_ = key;
+		keyId_ = BlackboardKeyRegistry::Intern(key_);
+	}
 
 	const std::string& GetStringValue() const { return value_; }
 	void SetStringValue(const std::string& value) { value_ = value; }
@@ -41,6 +44,8 @@ public:
 private:
 	// 書き込み先のBlackboardキー
 	std::string key_;
+	// key_をInternしたID
+	BlackboardKeyId keyId_ = BlackboardKeyId::Invalid;
 	// セットする文字列値
 	std::string value_;
 };
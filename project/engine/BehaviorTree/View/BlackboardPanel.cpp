@@ -66,23 +66,22 @@ void BlackboardPanel::Draw(Blackboard& blackboard) {
 	ImGui::Separator();
 
 	std::vector<std::string> sortedKeys;
-	sortedKeys.reserve(blackboard.Entries().size());
-	for (const auto& [key, value] : blackboard.Entries()) {
-		(void)value;
+	sortedKeys.reserve(blackboard.Size());
+	blackboard.ForEach([&sortedKeys](const std::string& key, const BlackboardValue&) {
 		sortedKeys.push_back(key);
-	}
+	});
 	std::sort(sortedKeys.begin(), sortedKeys.end());
 
 	std::string keyToRemove;
 	std::pair<std::string, std::string> renameRequest;
 
 	for (const std::string& key : sortedKeys) {
-		auto valueIt = blackboard.Entries().find(key);
-		if (valueIt == blackboard.Entries().end()) {
+		const BlackboardValue* entry = blackboard.TryGetValue(key);
+		if (entry == nullptr) {
 			continue;
 		}
 
-		const BlackboardValue currentValue = valueIt->second;
+		const BlackboardValue currentValue = *entry;
 		ImGui::PushID(key.c_str());
 
 		if (ImGui::Button("X")) {
@@ -7,7 +7,7 @@
 // コンストラクタ
 //==================================================================================
 WaitBlackboardTimeNode::WaitBlackboardTimeNode(const std::string& bbKey, const std::string& name)
-	: bbKey_(bbKey) {
+	: bbKey_(bbKey), bbKeyId_(BlackboardKeyRegistry::Intern(bbKey)) {
 	name_ = name;
 }
 
@@ -17,7 +17,7 @@ WaitBlackboardTimeNode::WaitBlackboardTimeNode(const std::string& bbKey, const s
 BehaviorStatus WaitBlackboardTimeNode::Execute(Blackboard& blackboard) {
 	// 初回 Execute 時に待機時間をキャッシュ
 	if (!isCached_) {
-		cachedWaitTime_ = blackboard.GetOr<float>(bbKey_, 0.0f);
+		cachedWaitTime_ = blackboard.GetOr<float>(bbKeyId_, 0.0f);
 		isCached_ = true;
 	}
 
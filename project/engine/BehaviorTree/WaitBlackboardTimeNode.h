@@ -42,11 +42,15 @@ public:
 	//========================================================================
 
 	const std::string& GetBBKey() const { return bbKey_; }
-	void SetBBKey(const std::string& key) { bbKey_ = key; }
+	void SetBBKey(const std::string& key) {
+		bbKey_ = key;
+		bbKeyId_ = BlackboardKeyRegistry::Intern(bbKey_);
+	}
 
 private:
 
 	std::string bbKey_;             // Blackboard から待機秒数を読むキー名
+	BlackboardKeyId bbKeyId_ = BlackboardKeyId::Invalid; // bbKey_をInternしたID
 	float elapsedTime_    = 0.0f;  // 累積経過時間 [s]
 	float cachedWaitTime_ = 0.0f;  // 初回 Execute 時にキャッシュした待機時間
 	bool  isCached_       = false; // キャッシュ済みフラグ
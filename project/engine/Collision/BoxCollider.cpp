@@ -3,6 +3,7 @@
 #include "3d/Model.h"
 #include "engine/math/MatrixMath.h"
 #include "engine/math/Vector3Math.h"
+#include "engine/math/physics/RayIntersection.h"
 #include "Collision/SphereCollider.h"
 #include "Base/ModelManager.h"
 #include "Base/DirectXCommon.h"
@@ -112,55 +113,28 @@ void BoxCollider::UpdateImGui([[maybe_unused]]const std::string& name) {
 #endif // _DEBUG
 }
 //=============================================================================
-// 衝突判定
+// OBB同士の衝突判定(衝突面の種類も更新する)
 //=============================================================================
 
-bool BoxCollider::CheckCollision(Collider* other) {
+bool BoxCollider::CheckCollisionBox(BoxCollider* otherBox) {
 
-	bool result = false;
-
-	if (BoxCollider* box = dynamic_cast<BoxCollider*>(other)) {
-		result = CheckCollisionOBB(box);
-		if (result == true) {
-			surfaceType_ = CheckSurfaceType(obb_.axis, minAxis_);
-		}
-		return result;
+	bool result = CheckCollisionOBB(otherBox);
+	if (result == true) {
+		surfaceType_ = CheckSurfaceType(obb_.axis, minAxis_);
 	}
-	if (SphereCollider* sphere = dynamic_cast<SphereCollider*>(other)) {
-		result = sphere->CheckCollisionOBB(this);
-		return result;
-	}
-	return false;
+	return result;
 }
 
 //=============================================================================
 // レイとの衝突判定
 //=============================================================================
 bool BoxCollider::Intersects(const Ray& ray, RayCastHit& outHit) {
-	// OBBとレイの衝突判定
-	Vector3 invDir = { 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
-	Vector3 tMin = (obb_.center - obb_.halfSize) - ray.origin;
-	Vector3 tMax = (obb_.center + obb_.halfSize) - ray.origin;
-	float t1 = tMin.x * invDir.x;
-	float t2 = tMax.x * invDir.x;
-	float t3 = tMin.y * invDir.y;
-	float t4 = tMax.y * invDir.y;
-	float t5 = tMin.z * invDir.z;
-	float t6 = tMax.z * invDir.z;
-	float tMinX = std::min(t1, t2);
-	float tMaxX = std::max(t1, t2);
-	float tMinY = std::min(t3, t4);
-	float tMaxY = std::max(t3, t4);
-	float tMinZ = std::min(t5, t6);
-	float tMaxZ = std::max(t5, t6);
-	if (tMinX > tMaxY || tMinY > tMaxX || tMinX > tMaxZ || tMinZ > tMaxX) {
-		return false; // レイとOBBは交差しない
-	}
-	float tNear = std::max(tMinX, std::max(tMinY, tMinZ));
-	float tFar = std::min(tMaxX, std::min(tMaxY, tMaxZ));
-	if (tNear > tFar || tFar < 0) {
+	// レイをOBBのローカル座標系に変換してスラブ法で判定する
+	float tNear = 0.0f;
+	if (!RayIntersection::IntersectOBB(ray, obb_, tNear)) {
 		return false; // レイとOBBは交差しない
 	}
+	outHit.isHit = true;
 	outHit.distance = tNear;
 	outHit.position = ray.origin + ray.direction * tNear;
 	outHit.normal = (outHit.position - obb_.center).Normalize(); // 衝突点からOBBの中心への法線ベクトル
@@ -497,6 +471,24 @@ Vector3 BoxCollider::GetWorldPos() {
 	return obb_.center;
 }
 
+//=============================================================================
+// ワールド空間AABBの取得
+//=============================================================================
+AABB BoxCollider::GetWorldAABB() {
+	const float halfSize[3] = { obb_.halfSize.x, obb_.halfSize.y, obb_.halfSize.z };
+	Vector3 extent = { 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 3; i++) {
+		// 球-OBB判定は halfSize・axis を軸方向の範囲として扱うため、そちらも包含する
+		float axisExtent = std::max(halfSize[i], std::fabs(obb_.halfSize.Dot(obb_.axis[i])));
+		extent.x += std::fabs(obb_.axis[i].x) * axisExtent;
+		extent.y += std::fabs(obb_.axis[i].y) * axisExtent;
+		extent.z += std::fabs(obb_.axis[i].z) * axisExtent;
+	}
+
+	return { obb_.center - extent, obb_.center + extent };
+}
+
 //半径の取得
 void BoxCollider::SetHalfSize(const Vector3& halfSize) {
 	halfSize_ = halfSize;
@@ -18,6 +18,11 @@ public:
 	// functions
 	//=========================================================================
 
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	BoxCollider() : Collider(ColliderShape::Box) {}
+
 	/// <summary>
 	/// 初期化
 	/// </summary>
@@ -38,12 +43,12 @@ public:
 	void UpdateImGui([[maybe_unused]]const std::string& name) override;
 
 	/// <summary>
-	/// 衝突判定
+	/// OBB同士の衝突判定(衝突時は衝突面の種類も更新する)
 	/// </summary>
-	/// <param name="other"></param>
+	/// <param name="otherBox"></param>
 	/// <returns></returns>
-	bool CheckCollision(Collider* other) override;
-	
+	bool CheckCollisionBox(BoxCollider* otherBox);
+
 	/// <summary>
 	/// レイとの当たり判定
 	/// </summary>
@@ -99,6 +104,8 @@ public:
 
 	//ワールド座標の取得
 	Vector3 GetWorldPos() override;
+	//ワールド空間AABBの取得
+	AABB GetWorldAABB() override;
 	//半径の取得
 	void SetHalfSize(const Vector3& halfSize) override;
 	//OBBの取得
@@ -117,8 +124,8 @@ private:
 
 private: // privateメンバ変数
 	//衝突OBB
-	OBB obb_;
+	OBB obb_{};
 	Matrix4x4 rotateMatrix_;
-	Vector3 minAxis_;    // 最小分離軸（衝突面の法線）
-	float minPenetration_; // penetration depth
+	Vector3 minAxis_{};  // 最小分離軸（衝突面の法線）
+	float minPenetration_ = 0.0f; // penetration depth
 };
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include "Collider.h"
+#include "engine/Collision/CollisionDispatcher.h"
 
 namespace TakeC {
 
+// 衝突判定(形状タグによるテーブル振り分け)
+bool Collider::CheckCollision(Collider* other) {
+	return CollisionDispatcher::Dispatch(this, other);
+}
+
 // コライダーの色を取得
 Vector4 Collider::GetColor() const {
 	return color_;
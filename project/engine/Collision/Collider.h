@@ -3,6 +3,7 @@
 #include "engine/math/physics/Ray.h"
 #include "engine/Collision/SurfaceType.h"
 #include "engine/Collision/Capsule.h"
+#include "engine/math/AABB.h"
 #include "engine/base/ComPtrAliasTemplates.h"
 #include <cstdint>
 #include <memory>
@@ -26,6 +27,13 @@ enum class CollisionLayer {
 	Ignoe = Player | Bullet | Enemy | Missile| Sensor, 
 };
 
+// コライダー形状の列挙型(ナローフェーズの振り分けに使用)
+enum class ColliderShape : uint8_t {
+	Box,
+	Sphere,
+	Count, // 未登録の形状
+};
+
 class DirectXCommon;
 
 //=================================================================================
@@ -46,6 +54,12 @@ public:
 	/// </summary>
 	Collider() = default;
 
+	/// <summary>
+	/// 形状タグを指定するコンストラクタ
+	/// </summary>
+	/// <param name="shape"></param>
+	explicit Collider(ColliderShape shape) : shape_(shape) {}
+
 	/// <summary>
 	/// デストラクタ(仮想デストラクタ)
 	/// </summary>
@@ -77,10 +91,11 @@ public:
 
 	/// <summary>
 	/// 衝突判定
+	/// 形状タグの組み合わせからCollisionDispatcherに登録された判定関数を呼ぶ
 	/// </summary>
 	/// <param name="other"></param>
 	/// <returns></returns>
-	virtual bool CheckCollision(Collider* other) = 0;
+	virtual bool CheckCollision(Collider* other);
 
 	/// <summary>
 	/// レイとの交差判定
@@ -107,6 +122,8 @@ public:
 	
 	// ワールド座標の取得
 	virtual Vector3 GetWorldPos() = 0;
+	// ワールド空間AABBの取得(ブロードフェーズ用)
+	virtual AABB GetWorldAABB() = 0;
 	// ワールド行列の取得
 	const Vector3& GetHalfSize() const { return halfSize_; }
 	// オフセットの取得
@@ -121,6 +138,8 @@ public:
 	SurfaceType GetSurfaceType() const;
 	/// 持ち主の取得
 	GameCharacter* GetOwner() const { return owner_; }
+	/// 形状タグの取得
+	ColliderShape GetShape() const { return shape_; }
 
 	//----- setter ---------------
 
@@ -159,7 +178,7 @@ protected:
 	Vector4 color_ = { 1.0f,1.0f,1.0f,1.0f };
 
 	//衝突時の情報
-	SurfaceType surfaceType_;
+	SurfaceType surfaceType_{};
 
 	//オフセット
 	Vector3 offset_ = { 0.0f,0.0f,0.0f };
@@ -169,6 +188,8 @@ protected:
 	Vector3 halfSize_ = { 1.0f,1.0f,1.0f };
 	//種別ID
 	CollisionLayer layerID_ = CollisionLayer::None;
+	//形状タグ
+	ColliderShape shape_ = ColliderShape::Count;
 };
 
 }
@@ -176,3 +197,4 @@ protected:
 // 既存コードを段階的にTakeC名前空間へ移行するための互換用宣言。
 using TakeC::Collider;
 using TakeC::CollisionLayer;
+using TakeC::ColliderShape;
@@ -0,0 +1,74 @@
+#include "CollisionDispatcher.h"
+#include "engine/Collision/BoxCollider.h"
+#include "engine/Collision/SphereCollider.h"
+#include <cassert>
+
+using namespace TakeC;
+
+namespace {
+
+	//OBB同士
+	bool CollideBoxBox(Collider* a, Collider* b) {
+		return static_cast<BoxCollider*>(a)->CheckCollisionBox(static_cast<BoxCollider*>(b));
+	}
+
+	//OBBと球
+	bool CollideBoxSphere(Collider* a, Collider* b) {
+		return static_cast<SphereCollider*>(b)->CheckCollisionOBB(static_cast<BoxCollider*>(a));
+	}
+
+	//球同士
+	bool CollideSphereSphere(Collider* a, Collider* b) {
+		return static_cast<SphereCollider*>(a)->CheckCollisionSphere(static_cast<SphereCollider*>(b));
+	}
+}
+
+//=============================================================================
+// 判定関数の登録
+//=============================================================================
+void CollisionDispatcher::Register(ColliderShape shapeA, ColliderShape shapeB, PairFunction function) {
+	SetEntry(GetTable(), shapeA, shapeB, function);
+}
+
+//=============================================================================
+// 形状タグに応じた判定関数の呼び出し
+//=============================================================================
+bool CollisionDispatcher::Dispatch(Collider* a, Collider* b) {
+	size_t indexA = static_cast<size_t>(a->GetShape());
+	size_t indexB = static_cast<size_t>(b->GetShape());
+	//形状タグが未設定のコライダーは判定しない
+	if (indexA >= kShapeCount_ || indexB >= kShapeCount_) return false;
+
+	const Entry& entry = GetTable()[indexA][indexB];
+	if (!entry.function) return false;
+
+	return entry.swapArguments ? entry.function(b, a) : entry.function(a, b);
+}
+
+//=============================================================================
+// テーブルの取得
+//=============================================================================
+CollisionDispatcher::Table& CollisionDispatcher::GetTable() {
+	static Table table = [] {
+		Table initialTable{};
+		SetEntry(initialTable, ColliderShape::Box, ColliderShape::Box, &CollideBoxBox);
+		SetEntry(initialTable, ColliderShape::Box, ColliderShape::Sphere, &CollideBoxSphere);
+		SetEntry(initialTable, ColliderShape::Sphere, ColliderShape::Sphere, &CollideSphereSphere);
+		return initialTable;
+	}();
+	return table;
+}
+
+//=============================================================================
+// テーブル要素の設定(逆の並びにも引数入れ替えで設定する)
+//=============================================================================
+void CollisionDispatcher::SetEntry(Table& table, ColliderShape shapeA, ColliderShape shapeB, PairFunction function) {
+	size_t indexA = static_cast<size_t>(shapeA);
+	size_t indexB = static_cast<size_t>(shapeB);
+	assert(indexA < kShapeCount_ && indexB < kShapeCount_);
+
+	table[indexA][indexB] = { function, false };
+	if (indexA != indexB) {
+		table[indexB][indexA] = { function, true };
+	}
+}
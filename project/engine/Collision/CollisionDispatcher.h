@@ -0,0 +1,64 @@
+#pragma once
+#include "engine/Collision/Collider.h"
+#include <array>
+#include <cstdint>
+
+namespace TakeC {
+
+//============================================================================
+// CollisionDispatcher class
+//============================================================================
+/// <summary>
+/// 形状タグの組み合わせごとにナローフェーズの判定関数を引く2次元テーブルです。
+/// 形状を追加する場合は ColliderShape に値を足し、判定関数を Register します。
+/// </summary>
+class CollisionDispatcher {
+public:
+
+	// 判定関数(引数は登録時の形状の並びで渡される)
+	using PairFunction = bool (*)(Collider* a, Collider* b);
+
+public:
+
+	//=========================================================================
+	// functions
+	//=========================================================================
+
+	/// <summary>
+	/// 判定関数の登録。(shapeB, shapeA) の並びにも引数を入れ替えて登録される
+	/// </summary>
+	/// <param name="shapeA"></param>
+	/// <param name="shapeB"></param>
+	/// <param name="function"></param>
+	static void Register(ColliderShape shapeA, ColliderShape shapeB, PairFunction function);
+
+	/// <summary>
+	/// 形状タグに応じた判定関数の呼び出し。未登録の組み合わせはfalse
+	/// </summary>
+	/// <param name="a"></param>
+	/// <param name="b"></param>
+	/// <returns></returns>
+	static bool Dispatch(Collider* a, Collider* b);
+
+private:
+
+	/// <summary>
+	/// テーブルの要素
+	/// </summary>
+	struct Entry {
+		PairFunction function = nullptr;
+		bool swapArguments = false; // 登録時と逆の並びで引かれた場合true
+	};
+
+	static constexpr size_t kShapeCount_ = static_cast<size_t>(ColliderShape::Count);
+	using Table = std::array<std::array<Entry, kShapeCount_>, kShapeCount_>;
+
+	//組み込み形状の判定関数を登録したテーブルの取得
+	static Table& GetTable();
+	//テーブル要素の設定
+	static void SetEntry(Table& table, ColliderShape shapeA, ColliderShape shapeB, PairFunction function);
+};
+
+}
+
+using TakeC::CollisionDispatcher;
@@ -4,6 +4,9 @@
 #include "DirectXCommon.h"
 #include "Collision/BoxCollider.h"
 #include "Collision/SphereCollider.h"
+#include "math/physics/RayIntersection.h"
+#include <algorithm>
+#include <cassert>
 
 CollisionManager& CollisionManager::GetInstance() {
 	static CollisionManager instance;
@@ -52,8 +55,17 @@ void CollisionManager::Finalize() {
 // ゲームキャラクターの登録・解放・衝突判定
 //=============================================================================
 void CollisionManager::RegisterGameCharacter(GameCharacter* gameCharacter) {
-	colliders_.push_back(gameCharacter->GetCollider());
+	Collider* collider = gameCharacter->GetCollider();
+	colliders_.push_back(collider);
 	gameCharacters_.push_back(gameCharacter);
+
+	//BVHへの登録
+	int32_t proxyId = TakeC::DynamicAABBTree::kNullNode;
+	if (collider) {
+		proxyId = colliderTree_.CreateProxy(
+			collider->GetWorldAABB(), static_cast<uint32_t>(collider->GetCollisionLayerID()), collider);
+	}
+	colliderProxies_.push_back(proxyId);
 }
 
 //=============================================================================
@@ -61,6 +73,8 @@ void CollisionManager::RegisterGameCharacter(GameCharacter* gameCharacter) {
 //=============================================================================
 void CollisionManager::ClearGameCharacter() {
 	colliders_.clear();
+	colliderProxies_.clear();
+	colliderTree_.Clear();
 	gameCharacters_.clear();
 }
 
@@ -69,20 +83,27 @@ void CollisionManager::ClearGameCharacter() {
 //=============================================================================
 void CollisionManager::CheckAllCollisionsForGameCharacter() {
 
-	//リスト内のペアを総当たり
-	std::list<GameCharacter*>::iterator itrA = gameCharacters_.begin();
-	for (; itrA != gameCharacters_.end(); ++itrA) {
-		//イテレータAからコライダーAを取得する
-		GameCharacter* gameCharacterA = *itrA;
-		//イテレータA+1からコライダーBを取得する(重複判定の回避)
-		std::list<GameCharacter*>::iterator itrB = itrA;
-		itrB++;
-		for (; itrB != gameCharacters_.end(); ++itrB) {
-			//イテレータBからコライダーBを取得する
-			GameCharacter* gameCharacterB = *itrB;
-			//コライダーAとBの衝突判定
-			CheckCollisionPairForGameCharacter(gameCharacterA, gameCharacterB);
-		}
+	//キャスト判定用BVHの更新
+	UpdateColliderTree();
+
+	//ブロードフェーズ: 各コライダーのワールドAABBを登録
+	broadPhase_.Clear();
+	for (uint32_t index = 0; index < gameCharacters_.size(); ++index) {
+		GameCharacter* gameCharacter = gameCharacters_[index];
+		Collider* collider = gameCharacter->GetCollider();
+		//コライダーがnullptrなら判定対象外
+		if (!collider) continue;
+
+		//同じキャラクタータイプ同士はペアにしない
+		broadPhase_.AddProxy(
+			collider->GetWorldAABB(), index,
+			static_cast<uint32_t>(gameCharacter->GetCharacterType()));
+	}
+
+	//ナローフェーズ: AABBが重なったペアのみ登録順に判定
+	//(衝突処理中に登録が増えても参照が壊れないようインデックスで引く)
+	for (const TakeC::SweepAndPrune::Pair& pair : broadPhase_.ComputePairs()) {
+		CheckCollisionPairForGameCharacter(gameCharacters_[pair.first], gameCharacters_[pair.second]);
 	}
 }
 
@@ -113,18 +134,56 @@ void CollisionManager::CheckCollisionPairForGameCharacter(GameCharacter* gameCha
 	}
 }
 
+//=============================================================================
+// フレーム開始処理
+//=============================================================================
+void CollisionManager::BeginFrame() {
+	//コライダーはシーン更新中に動くため、次のキャストで更新させる
+	isColliderTreeDirty_ = true;
+}
+
+//=============================================================================
+// このフレームで未更新ならキャスト判定用BVHを更新
+//=============================================================================
+void CollisionManager::RefreshColliderTree() {
+	if (isColliderTreeDirty_) {
+		UpdateColliderTree();
+	}
+}
+
+//=============================================================================
+// キャスト判定用BVHの更新
+//=============================================================================
+void CollisionManager::UpdateColliderTree() {
+	isColliderTreeDirty_ = false;
+	for (size_t index = 0; index < colliders_.size(); ++index) {
+		Collider* collider = colliders_[index];
+		if (!collider) continue;
+
+		//fat AABBからはみ出したコライダーだけが挿し直される
+		colliderTree_.MoveProxy(
+			colliderProxies_[index], collider->GetWorldAABB(),
+			static_cast<uint32_t>(collider->GetCollisionLayerID()));
+	}
+}
+
 //=============================================================================
 // レイキャスト処理
 //=============================================================================
 bool CollisionManager::RayCast(const Ray& ray, RayCastHit& outHit,uint32_t layerMask) {
 
+	//フレーム内の最初のキャストでBVHを現在位置に合わせる
+	RefreshColliderTree();
+
 	bool result = false;
 	float closestDistance = ray.distance;
 	RayCastHit tempHit;
-	for (auto* collider : colliders_) {
+
+	//BVHを辿り、レイが通るノードのコライダーだけを判定する
+	colliderTree_.RayCast(ray.origin, ray.direction, ray.distance, 0.0f, layerMask, [&](Collider* collider) {
 		// レイヤーマスクによる絞り込み
 		// もしコライダーのレイヤーIDがlayerMaskに含まれていなければスキップ
-		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) continue;
+		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) return std::max(closestDistance, 0.0f);
 
 		// レイとコライダーの交差判定
 		if (collider->Intersects(ray, tempHit)) {
@@ -135,21 +194,89 @@ bool CollisionManager::RayCast(const Ray& ray, RayCastHit& outHit,uint32_t layer
 				result = true;
 			}
 		}
-	}
+		// 始点がボックス内部だと負の距離になり得るため、走査範囲は0未満にしない
+		return std::max(closestDistance, 0.0f);
+	});
 	return result;
 }
 
+//=============================================================================
+// 複数レイのレイキャスト処理
+//=============================================================================
+uint32_t CollisionManager::RayCastBatch(std::span<const Ray> rays, uint32_t layerMask, std::span<RayCastHit> outHits) {
+	assert(outHits.size() >= rays.size());
+
+	//フレーム内の最初のキャストでBVHを現在位置に合わせる
+	RefreshColliderTree();
+
+	uint32_t hitCount = 0;
+	RayCastHit laneHits[RayPacket::kLaneCount];
+	RayPacket packet;
+
+	for (size_t first = 0; first < rays.size(); first += RayPacket::kLaneCount) {
+		std::span<const Ray> packetRays = rays.subspan(first, std::min<size_t>(RayPacket::kLaneCount, rays.size() - first));
+		packet.Load(packetRays);
+
+		// レーンごとの最近ヒット距離(RayCastのclosestDistanceに相当)
+		float closestDistance[RayPacket::kLaneCount];
+		for (size_t lane = 0; lane < packetRays.size(); ++lane) {
+			closestDistance[lane] = packetRays[lane].distance;
+			outHits[first + lane] = {};
+		}
+
+		colliderTree_.RayCastPacket(packet, layerMask, [&](Collider* collider, int laneMask) {
+			// レイヤーマスクによる絞り込み
+			if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) return;
+
+			// 形状ごとのSIMD判定で、交差し得るレーンをさらに絞り込む
+			switch (collider->GetShape()) {
+			case ColliderShape::Box:
+				laneMask &= packet.OverlapOBB(static_cast<BoxCollider*>(collider)->GetOBB());
+				break;
+			case ColliderShape::Sphere: {
+				SphereCollider* sphere = static_cast<SphereCollider*>(collider);
+				laneMask &= packet.OverlapSphere(sphere->GetWorldPos(), sphere->GetRadius());
+				break;
+			}
+			default:
+				break;
+			}
+
+			// 残ったレーンだけスカラー版と同じ判定でヒット情報を作る
+			int updatedMask = RayIntersection::UpdateClosestHits(packet, packetRays, laneMask, closestDistance, [&](size_t lane, float& outDistance) {
+				if (!collider->Intersects(packetRays[lane], laneHits[lane])) return false;
+				outDistance = laneHits[lane].distance;
+				return true;
+			});
+			for (size_t lane = 0; lane < packetRays.size(); ++lane) {
+				if (!(updatedMask & (1 << lane))) continue;
+				outHits[first + lane] = laneHits[lane];
+				outHits[first + lane].isHit = true;
+			}
+		});
+
+		for (size_t lane = 0; lane < packetRays.size(); ++lane) {
+			if (outHits[first + lane].isHit) ++hitCount;
+		}
+	}
+	return hitCount;
+}
+
 //=============================================================================
 // 球キャスト処理
 //=============================================================================
 bool CollisionManager::SphereCast(const Ray& ray, float radius, RayCastHit& outHit, uint32_t layerMask) {
+	//フレーム内の最初のキャストでBVHを現在位置に合わせる
+	RefreshColliderTree();
+
 	bool result = false;
 	float closestDistance = ray.distance;
 	RayCastHit tempHit;
 
-	for (auto* collider : colliders_) {
+	//ノードのAABBを半径分膨らませて辿る
+	colliderTree_.RayCast(ray.origin, ray.direction, ray.distance, radius, layerMask, [&](Collider* collider) {
 		// レイヤーマスクによる絞り込み
-		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) continue;
+		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) return std::max(closestDistance, 0.0f);
 
 		// スフィアキャスト判定
 		// IntersectsSphere を呼び出す
@@ -161,7 +288,9 @@ bool CollisionManager::SphereCast(const Ray& ray, float radius, RayCastHit& outH
 				result = true;
 			}
 		}
-	}
+		// 始点が形状内部だと負の距離になり得るため、走査範囲は0未満にしない
+		return std::max(closestDistance, 0.0f);
+	});
 	return result;
 }
 
@@ -169,13 +298,19 @@ bool CollisionManager::SphereCast(const Ray& ray, float radius, RayCastHit& outH
 // カプセルキャスト処理
 //=============================================================================
 bool CollisionManager::CapsuleCast(const Capsule& capsule, RayCastHit& outHit, uint32_t layerMask){
+	//フレーム内の最初のキャストでBVHを現在位置に合わせる
+	RefreshColliderTree();
+
 	bool result = false;
-	float closestDistance = Vector3Math::Length(capsule.end - capsule.start);
+	Vector3 axis = capsule.end - capsule.start;
+	float closestDistance = Vector3Math::Length(axis);
 	RayCastHit tempHit;
 
-	for (auto* collider : colliders_) {
+	//カプセル軸の線分に沿って、ノードのAABBを半径分膨らませて辿る
+	Vector3 direction = (closestDistance > 0.0f) ? axis / closestDistance : Vector3{ 0.0f, 0.0f, 0.0f };
+	colliderTree_.RayCast(capsule.start, direction, closestDistance, capsule.radius, layerMask, [&](Collider* collider) {
 		// レイヤーマスクによる絞り込み
-		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) continue;
+		if (!(static_cast<uint32_t>(collider->GetCollisionLayerID()) & layerMask)) return std::max(closestDistance, 0.0f);
 
 		// カプセル判定
 		if (collider->IntersectsCapsule(capsule, tempHit)) {
@@ -186,6 +321,8 @@ bool CollisionManager::CapsuleCast(const Capsule& capsule, RayCastHit& outHit, u
 				result = true;
 			}
 		}
-	}
+		// 始点が形状内部だと負の距離になり得るため、走査範囲は0未満にしない
+		return std::max(closestDistance, 0.0f);
+	});
 	return result;
 }
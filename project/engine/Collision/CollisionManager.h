@@ -4,8 +4,11 @@
 #include "engine/Entity/GameCharacter.h"
 #include "engine/math/physics/Ray.h"
 #include "engine/Collision/Capsule.h"
-#include <list>
+#include "engine/Collision/SweepAndPrune.h"
+#include "engine/Collision/DynamicAABBTree.h"
+#include <vector>
 #include <memory>
+#include <span>
 
 //前方宣言
 class DirectXCommon;
@@ -70,6 +73,7 @@ public:
 
 	/// <summary>
 	/// 全てのゲームキャラクターの衝突判定を行う関数
+	/// (Sweep and PruneでAABBが重なるペアだけを絞り込んでから判定する)
 	/// </summary>
 	void CheckAllCollisionsForGameCharacter();
 
@@ -80,6 +84,19 @@ public:
 	/// <param name="gameCharacterB"></param>
 	void CheckCollisionPairForGameCharacter(GameCharacter* gameCharacterA, GameCharacter* gameCharacterB);
 
+	/// <summary>
+	/// フレーム開始処理(キャスト判定用BVHを更新が必要な状態にする)
+	/// 各キャストはフレーム内の最初の呼び出しでBVHを更新するため、
+	/// CheckAllCollisionsForGameCharacterより前に呼んでも前フレームの位置で判定されない
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// レイキャスト用BVHを各コライダーの現在位置に合わせて更新する
+	/// (CheckAllCollisionsForGameCharacter内でも呼ばれる)
+	/// </summary>
+	void UpdateColliderTree();
+
 	/// <summary>
 	/// レイキャスト処理
 	/// </summary>
@@ -89,6 +106,16 @@ public:
 	/// <returns></returns>
 	bool RayCast(const Ray& ray, RayCastHit& outHit,uint32_t layerMask);
 
+	/// <summary>
+	/// 複数レイのレイキャスト処理
+	/// 4本ずつSSEのパケットにまとめてBVHとコライダーを絞り込み、結果はRayCastと同一になる
+	/// </summary>
+	/// <param name="rays">レイの配列</param>
+	/// <param name="layerMask">レイヤーマスク</param>
+	/// <param name="outHits">rays と同じ長さのヒット情報(ヒットしなければ isHit = false)</param>
+	/// <returns>ヒットしたレイの本数</returns>
+	uint32_t RayCastBatch(std::span<const Ray> rays, uint32_t layerMask, std::span<RayCastHit> outHits);
+
 	/// <summary>
 	/// 球キャスト処理
 	/// </summary>
@@ -99,8 +126,22 @@ public:
 	/// <returns></returns>
 	bool SphereCast(const Ray& ray, float radius, RayCastHit& outHit, uint32_t layerMask);
 
+	/// <summary>
+	/// カプセルキャスト処理
+	/// </summary>
+	/// <param name="capsule"></param>
+	/// <param name="outHit"></param>
+	/// <param name="layerMask"></param>
+	/// <returns></returns>
 	bool CapsuleCast(const Capsule& capsule, RayCastHit& outHit, uint32_t layerMask);
 
+private:
+
+	/// <summary>
+	/// このフレームでまだBVHを更新していなければ更新する
+	/// </summary>
+	void RefreshColliderTree();
+
 private:
 
 	////////////////////////////////////////////////////////////////////////////////////////
@@ -112,8 +153,16 @@ private:
 
 	//コライダーリスト
 	std::vector<Collider*> colliders_;
+	//コライダーごとのBVHプロキシID(colliders_と同じ並び)
+	std::vector<int32_t> colliderProxies_;
+	//キャスト判定用BVH
+	TakeC::DynamicAABBTree colliderTree_;
+	//キャスト判定用BVHがこのフレームで未更新か
+	bool isColliderTreeDirty_ = true;
 	//ゲームキャラクターリスト
-	std::list<GameCharacter*> gameCharacters_;
+	std::vector<GameCharacter*> gameCharacters_;
+	//ブロードフェーズ
+	TakeC::SweepAndPrune broadPhase_;
 	//パイプラインステートオブジェクト
 	std::unique_ptr<TakeC::PSO> pso_ = nullptr;
 	//ルートシグネチャ
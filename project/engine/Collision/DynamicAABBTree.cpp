@@ -0,0 +1,360 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace TakeC;
+
+namespace {
+
+	//2つのAABBの合成
+	AABB Combine(const AABB& a, const AABB& b) {
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+		};
+	}
+
+	//outerがinnerを完全に包含しているか
+	bool Contains(const AABB& outer, const AABB& inner) {
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+
+	//表面積(挿入位置のコスト評価に使用)
+	float SurfaceArea(const AABB& bounds) {
+		Vector3 size = bounds.GetSize();
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+}
+
+//=============================================================================
+// プロキシの生成
+//=============================================================================
+int32_t DynamicAABBTree::CreateProxy(const AABB& bounds, uint32_t layerMask, Collider* collider) {
+	int32_t proxyId = AllocateNode();
+
+	Vector3 margin = { kAABBMargin_, kAABBMargin_, kAABBMargin_ };
+	Node& node = nodes_[proxyId];
+	node.bounds = { bounds.min - margin, bounds.max + margin };
+	node.collider = collider;
+	node.height = 0;
+	node.layerMask = layerMask;
+
+	InsertLeaf(proxyId);
+	++proxyCount_;
+	return proxyId;
+}
+
+//=============================================================================
+// プロキシの破棄
+//=============================================================================
+void DynamicAABBTree::DestroyProxy(int32_t proxyId) {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--proxyCount_;
+}
+
+//=============================================================================
+// プロキシの更新
+//=============================================================================
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& bounds, uint32_t layerMask) {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+
+	Node& node = nodes_[proxyId];
+
+	//fat AABBに収まっていればレイヤーの反映のみ
+	if (Contains(node.bounds, bounds)) {
+		if (node.layerMask != layerMask) {
+			node.layerMask = layerMask;
+			RefitAncestors(node.parent);
+		}
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+
+	Vector3 margin = { kAABBMargin_, kAABBMargin_, kAABBMargin_ };
+	node.bounds = { bounds.min - margin, bounds.max + margin };
+	node.layerMask = layerMask;
+
+	InsertLeaf(proxyId);
+	return true;
+}
+
+//=============================================================================
+// 全ノードの削除
+//=============================================================================
+void DynamicAABBTree::Clear() {
+	nodes_.clear();
+	root_ = kNullNode;
+	freeList_ = kNullNode;
+	proxyCount_ = 0;
+}
+
+//=============================================================================
+// ノードの確保
+//=============================================================================
+int32_t DynamicAABBTree::AllocateNode() {
+	int32_t nodeId;
+	if (freeList_ != kNullNode) {
+		nodeId = freeList_;
+		freeList_ = nodes_[nodeId].parent;
+	} else {
+		nodeId = static_cast<int32_t>(nodes_.size());
+		nodes_.emplace_back();
+	}
+
+	nodes_[nodeId] = Node{};
+	return nodeId;
+}
+
+//=============================================================================
+// ノードの解放
+//=============================================================================
+void DynamicAABBTree::FreeNode(int32_t nodeId) {
+	nodes_[nodeId] = Node{};
+	nodes_[nodeId].parent = freeList_;
+	freeList_ = nodeId;
+}
+
+//=============================================================================
+// 葉の挿入
+//=============================================================================
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+
+	if (root_ == kNullNode) {
+		root_ = leaf;
+		nodes_[root_].parent = kNullNode;
+		return;
+	}
+
+	//表面積の増加が最小になる兄弟ノードを探す
+	const AABB leafBounds = nodes_[leaf].bounds;
+	int32_t index = root_;
+	while (!nodes_[index].IsLeaf()) {
+		const Node& node = nodes_[index];
+		int32_t child1 = node.child1;
+		int32_t child2 = node.child2;
+
+		float area = SurfaceArea(node.bounds);
+		float combinedArea = SurfaceArea(Combine(node.bounds, leafBounds));
+
+		//このノードを兄弟にして新しい親を作るコスト
+		float cost = 2.0f * combinedArea;
+		//さらに下へ降りる場合に祖先側で増える最小コスト
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			const Node& childNode = nodes_[child];
+			float newArea = SurfaceArea(Combine(leafBounds, childNode.bounds));
+			if (childNode.IsLeaf()) {
+				return newArea + inheritanceCost;
+			}
+			return (newArea - SurfaceArea(childNode.bounds)) + inheritanceCost;
+		};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2) break;
+
+		index = (cost1 < cost2) ? child1 : child2;
+	}
+
+	//兄弟ノードと葉をまとめる親ノードを作る
+	int32_t sibling = index;
+	int32_t oldParent = nodes_[sibling].parent;
+	int32_t newParent = AllocateNode();
+
+	Node& parentNode = nodes_[newParent];
+	parentNode.parent = oldParent;
+	parentNode.bounds = Combine(leafBounds, nodes_[sibling].bounds);
+	parentNode.height = nodes_[sibling].height + 1;
+	parentNode.layerMask = nodes_[sibling].layerMask | nodes_[leaf].layerMask;
+	parentNode.child1 = sibling;
+	parentNode.child2 = leaf;
+
+	if (oldParent != kNullNode) {
+		if (nodes_[oldParent].child1 == sibling) {
+			nodes_[oldParent].child1 = newParent;
+		} else {
+			nodes_[oldParent].child2 = newParent;
+		}
+	} else {
+		root_ = newParent;
+	}
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+
+	//祖先のAABB・高さ・レイヤーを更新しつつ平衡化
+	RefitAncestors(nodes_[leaf].parent);
+}
+
+//=============================================================================
+// 葉の削除
+//=============================================================================
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+
+	if (leaf == root_) {
+		root_ = kNullNode;
+		return;
+	}
+
+	int32_t parent = nodes_[leaf].parent;
+	int32_t grandParent = nodes_[parent].parent;
+	int32_t sibling = (nodes_[parent].child1 == leaf) ? nodes_[parent].child2 : nodes_[parent].child1;
+
+	if (grandParent != kNullNode) {
+		//親を取り除き、兄弟を祖父に繋ぎ直す
+		if (nodes_[grandParent].child1 == parent) {
+			nodes_[grandParent].child1 = sibling;
+		} else {
+			nodes_[grandParent].child2 = sibling;
+		}
+		nodes_[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		RefitAncestors(grandParent);
+	} else {
+		root_ = sibling;
+		nodes_[sibling].parent = kNullNode;
+		FreeNode(parent);
+	}
+
+	nodes_[leaf].parent = kNullNode;
+}
+
+//=============================================================================
+// 祖先の再計算
+//=============================================================================
+void DynamicAABBTree::RefitAncestors(int32_t nodeId) {
+	int32_t index = nodeId;
+	while (index != kNullNode) {
+		index = Balance(index);
+
+		Node& node = nodes_[index];
+		const Node& child1 = nodes_[node.child1];
+		const Node& child2 = nodes_[node.child2];
+
+		node.bounds = Combine(child1.bounds, child2.bounds);
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.layerMask = child1.layerMask | child2.layerMask;
+
+		index = node.parent;
+	}
+}
+
+//=============================================================================
+// 平衡化(左右の高さの差が2以上なら回転する)
+//=============================================================================
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+
+	Node* A = &nodes_[iA];
+	if (A->IsLeaf() || A->height < 2) {
+		return iA;
+	}
+
+	int32_t iB = A->child1;
+	int32_t iC = A->child2;
+	Node* B = &nodes_[iB];
+	Node* C = &nodes_[iC];
+
+	int32_t balance = C->height - B->height;
+
+	//Cを持ち上げる / Bを持ち上げる処理は対称なので共通化
+	auto rotate = [&](int32_t iLow, int32_t iHigh, bool highIsChild2) {
+		Node* low = &nodes_[iLow];
+		Node* high = &nodes_[iHigh];
+		int32_t iF = high->child1;
+		int32_t iG = high->child2;
+		Node* F = &nodes_[iF];
+		Node* G = &nodes_[iG];
+
+		//highをAの位置へ
+		high->child1 = iA;
+		high->parent = A->parent;
+		A->parent = iHigh;
+
+		if (high->parent != kNullNode) {
+			if (nodes_[high->parent].child1 == iA) {
+				nodes_[high->parent].child1 = iHigh;
+			} else {
+				nodes_[high->parent].child2 = iHigh;
+			}
+		} else {
+			root_ = iHigh;
+		}
+
+		//高い方の孫をhighに残し、低い方の孫をAへ移す
+		int32_t iKeep = (F->height > G->height) ? iF : iG;
+		int32_t iMove = (F->height > G->height) ? iG : iF;
+		Node* keep = &nodes_[iKeep];
+		Node* move = &nodes_[iMove];
+
+		high->child2 = iKeep;
+		if (highIsChild2) {
+			A->child2 = iMove;
+		} else {
+			A->child1 = iMove;
+		}
+		move->parent = iA;
+
+		A->bounds = Combine(low->bounds, move->bounds);
+		A->height = 1 + std::max(low->height, move->height);
+		A->layerMask = low->layerMask | move->layerMask;
+
+		high->bounds = Combine(A->bounds, keep->bounds);
+		high->height = 1 + std::max(A->height, keep->height);
+		high->layerMask = A->layerMask | keep->layerMask;
+	};
+
+	if (balance > 1) {
+		rotate(iB, iC, true);
+		return iC;
+	}
+	if (balance < -1) {
+		rotate(iC, iB, false);
+		return iB;
+	}
+
+	return iA;
+}
+
+//=============================================================================
+// 線分と膨張AABBの判定
+//=============================================================================
+bool DynamicAABBTree::SegmentOverlaps(const AABB& bounds, float expand, const Vector3& origin,
+	const Vector3& direction, float maxDistance, float& outEnter) {
+
+	const float boxMin[3] = { bounds.min.x - expand, bounds.min.y - expand, bounds.min.z - expand };
+	const float boxMax[3] = { bounds.max.x + expand, bounds.max.y + expand, bounds.max.z + expand };
+	const float rayOrigin[3] = { origin.x, origin.y, origin.z };
+	const float rayDirection[3] = { direction.x, direction.y, direction.z };
+
+	float tMin = 0.0f;
+	float tMax = maxDistance;
+
+	for (int i = 0; i < 3; ++i) {
+		if (std::abs(rayDirection[i]) < 1e-6f) {
+			//軸に平行な場合は始点がスラブ内にあるか
+			if (rayOrigin[i] < boxMin[i] || rayOrigin[i] > boxMax[i]) return false;
+			continue;
+		}
+
+		float invDirection = 1.0f / rayDirection[i];
+		float t1 = (boxMin[i] - rayOrigin[i]) * invDirection;
+		float t2 = (boxMax[i] - rayOrigin[i]) * invDirection;
+		if (t1 > t2) std::swap(t1, t2);
+
+		tMin = std::max(tMin, t1);
+		tMax = std::min(tMax, t2);
+		if (tMin > tMax) return false;
+	}
+
+	outEnter = tMin;
+	return true;
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "engine/math/AABB.h"
+#include "engine/math/physics/RayPacket.h"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// 前方宣言
+namespace TakeC {
+	class Collider;
+}
+
+namespace TakeC {
+
+//============================================================================
+// DynamicAABBTree class
+//============================================================================
+/// <summary>
+/// 余白付きAABB(fat AABB)で構成する動的BVHです。
+/// RayCast/SphereCast/CapsuleCastの候補絞り込みに使用します。
+/// </summary>
+class DynamicAABBTree {
+public:
+
+	//無効ノード
+	static constexpr int32_t kNullNode = -1;
+
+public:
+
+	//=========================================================================
+	// functions
+	//=========================================================================
+
+	DynamicAABBTree() = default;
+	~DynamicAABBTree() = default;
+
+	/// <summary>
+	/// プロキシ(葉)の生成
+	/// </summary>
+	/// <param name="bounds">コライダーのワールドAABB</param>
+	/// <param name="layerMask">コライダーのレイヤー</param>
+	/// <param name="collider">コライダー</param>
+	/// <returns>プロキシID</returns>
+	int32_t CreateProxy(const AABB& bounds, uint32_t layerMask, Collider* collider);
+
+	/// <summary>
+	/// プロキシの破棄
+	/// </summary>
+	/// <param name="proxyId"></param>
+	void DestroyProxy(int32_t proxyId);
+
+	/// <summary>
+	/// プロキシの更新。fat AABBからはみ出した場合のみ挿し直す
+	/// </summary>
+	/// <param name="proxyId">プロキシID</param>
+	/// <param name="bounds">コライダーの最新のワールドAABB</param>
+	/// <param name="layerMask">コライダーの最新のレイヤー</param>
+	/// <returns>挿し直した場合true</returns>
+	bool MoveProxy(int32_t proxyId, const AABB& bounds, uint32_t layerMask);
+
+	/// <summary>
+	/// 全ノードの削除(確保済みの容量は維持する)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 線分に沿ったツリー走査
+	/// ノードのAABBを expand 分だけ膨らませて origin + direction * t (0 <= t <= maxDistance) と判定し、
+	/// 重なった葉で callback(Collider*) を呼ぶ。callbackは以降の走査で使う最大距離を返す
+	/// </summary>
+	template<typename Callback>
+	void RayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+		float expand, uint32_t layerMask, Callback&& callback) const;
+
+	/// <summary>
+	/// レイパケットによるツリー走査
+	/// ノードのAABBと重なったレーンが1本でもあれば降り、葉で callback(Collider*, laneMask) を呼ぶ。
+	/// callbackは packet.maxDistance を最近ヒットに合わせて縮めてよい
+	/// </summary>
+	template<typename Callback>
+	void RayCastPacket(RayPacket& packet, uint32_t layerMask, Callback&& callback) const;
+
+	//----- getter ---------------
+
+	// ツリーの高さ
+	int32_t GetHeight() const { return (root_ == kNullNode) ? 0 : nodes_[root_].height; }
+	// プロキシ数
+	uint32_t GetProxyCount() const { return proxyCount_; }
+
+private:
+
+	/// <summary>
+	/// ツリーのノード
+	/// </summary>
+	struct Node {
+		AABB bounds;                 // 葉: fat AABB / 内部: 子の合成AABB
+		Collider* collider = nullptr;
+		int32_t parent = kNullNode;  // 空きノードでは次の空きノード
+		int32_t child1 = kNullNode;
+		int32_t child2 = kNullNode;
+		int32_t height = -1;         // 葉: 0 / 空き: -1
+		uint32_t layerMask = 0;      // 部分木に含まれるレイヤーの論理和
+
+		bool IsLeaf() const { return child1 == kNullNode; }
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t nodeId);
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	int32_t Balance(int32_t nodeId);
+	//葉から根まで、AABB・高さ・レイヤーを再計算する
+	void RefitAncestors(int32_t nodeId);
+
+	//線分と膨張AABBの判定(当たれば進入距離を返す)
+	static bool SegmentOverlaps(const AABB& bounds, float expand, const Vector3& origin,
+		const Vector3& direction, float maxDistance, float& outEnter);
+
+private:
+
+	//fat AABBの余白
+	static constexpr float kAABBMargin_ = 0.5f;
+	//走査スタックの最大深さ(平衡化により高さは要素数の対数程度に収まる)
+	static constexpr int32_t kMaxStackSize_ = 256;
+
+	std::vector<Node> nodes_;
+	int32_t root_ = kNullNode;
+	int32_t freeList_ = kNullNode;
+	uint32_t proxyCount_ = 0;
+};
+
+//---------------------------------------------------------------------------------
+// 線分に沿ったツリー走査
+//---------------------------------------------------------------------------------
+template<typename Callback>
+inline void DynamicAABBTree::RayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+	float expand, uint32_t layerMask, Callback&& callback) const {
+
+	if (root_ == kNullNode) return;
+
+	int32_t stack[kMaxStackSize_];
+	int32_t stackSize = 0;
+	stack[stackSize++] = root_;
+
+	while (stackSize > 0) {
+		int32_t nodeId = stack[--stackSize];
+
+		const Node& node = nodes_[nodeId];
+		// 部分木に対象レイヤーが一つも無ければスキップ
+		if ((node.layerMask & layerMask) == 0) continue;
+
+		float enter = 0.0f;
+		if (!SegmentOverlaps(node.bounds, expand, origin, direction, maxDistance, enter)) continue;
+
+		if (node.IsLeaf()) {
+			// 現在の最近ヒットより手前の可能性があるものだけ判定
+			maxDistance = callback(node.collider);
+		} else {
+			assert(stackSize + 2 <= kMaxStackSize_);
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------------
+// レイパケットによるツリー走査
+//---------------------------------------------------------------------------------
+template<typename Callback>
+inline void DynamicAABBTree::RayCastPacket(RayPacket& packet, uint32_t layerMask, Callback&& callback) const {
+
+	if (root_ == kNullNode) return;
+
+	int32_t stack[kMaxStackSize_];
+	int32_t stackSize = 0;
+	stack[stackSize++] = root_;
+
+	while (stackSize > 0) {
+		int32_t nodeId = stack[--stackSize];
+
+		const Node& node = nodes_[nodeId];
+		// 部分木に対象レイヤーが一つも無ければスキップ
+		if ((node.layerMask & layerMask) == 0) continue;
+
+		int laneMask = packet.OverlapAABB(node.bounds);
+		if (laneMask == 0) continue;
+
+		if (node.IsLeaf()) {
+			callback(node.collider, laneMask);
+		} else {
+			assert(stackSize + 2 <= kMaxStackSize_);
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+}
+
+}
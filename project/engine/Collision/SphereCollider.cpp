@@ -7,6 +7,7 @@
 #include "engine/Camera/CameraManager.h"
 #include "engine/math/MatrixMath.h"
 #include "engine/math/Vector3Math.h"
+#include "engine/math/physics/RayIntersection.h"
 #include <algorithm>
 
 using namespace TakeC;
@@ -65,24 +66,6 @@ void SphereCollider::UpdateImGui([[maybe_unused]]const std::string& name) {
 #endif // _DEBUG
 }
 
-//=============================================================================
-// 衝突判定
-//=============================================================================
-
-bool SphereCollider::CheckCollision(Collider* other) {
-
-	// OBBとの衝突処理
-	if (BoxCollider* box = dynamic_cast<BoxCollider*>(other)) {
-		return CheckCollisionOBB(box);
-	}
-	// Sphereとの衝突処理
-	if (SphereCollider* sphere = dynamic_cast<SphereCollider*>(other)) {
-		return CheckCollisionSphere(sphere);
-	}
-
-	return false;
-}
-
 //=============================================================================
 // 当たり判定範囲の描画
 //=============================================================================
@@ -98,21 +81,8 @@ void SphereCollider::DrawCollider() {
 //=============================================================================
 
 bool SphereCollider::Intersects(const Ray& ray, RayCastHit& outHit) {
-	Vector3 oc = ray.origin - transform_.translate; // 球の中心からレイの始点までのベクトル
-	float a = ray.direction.Dot(ray.direction);
-	float b = 2.0f * oc.Dot(ray.direction);
-	float c = oc.Dot(oc) - radius_ * radius_;
-	float discriminant = b * b - 4 * a * c;
-
-	if (discriminant < 0) return false; // レイと球は交差しない
-
-	float sqrtDiscriminant = std::sqrt(discriminant);
-	float t1 = (-b - sqrtDiscriminant) / (2.0f * a);
-	float t2 = (-b + sqrtDiscriminant) / (2.0f * a);
-
-	float t = t1;
-	if (t <0 || t > ray.distance) t = t2; // t1が負またはrayの距離より大きい場合、t2を使用
-	if (t < 0 || t > ray.distance) return false; // レイの範囲外
+	float t = 0.0f;
+	if (!RayIntersection::IntersectSphere(ray, transform_.translate, radius_, t)) return false; // レイと球は交差しない
 
 	//衝突情報設定
 	outHit.isHit = true;
@@ -133,21 +103,8 @@ bool SphereCollider::IntersectsSphere(const Ray& ray, float radius, RayCastHit&
 	// 相手の半径分だけ、自分の当たり判定を大きくしてRayCastするのと同じ計算
 	float totalRadius = radius_ + radius;
 
-	Vector3 oc = ray.origin - transform_.translate;
-	float a = ray.direction.Dot(ray.direction);
-	float b = 2.0f * oc.Dot(ray.direction);
-	float c = oc.Dot(oc) - totalRadius * totalRadius; // ここで半径を合成
-	float discriminant = b * b - 4 * a * c;
-
-	if (discriminant < 0) return false;
-
-	float sqrtDiscriminant = std::sqrt(discriminant);
-	float t1 = (-b - sqrtDiscriminant) / (2.0f * a);
-	float t2 = (-b + sqrtDiscriminant) / (2.0f * a);
-
-	float t = t1;
-	if (t < 0 || t > ray.distance) t = t2;
-	if (t < 0 || t > ray.distance) return false;
+	float t = 0.0f;
+	if (!RayIntersection::IntersectSphere(ray, transform_.translate, totalRadius, t)) return false;
 
 	outHit.isHit = true;
 	outHit.distance = t;
@@ -285,3 +242,11 @@ Vector3 SphereCollider::GetWorldPos() {
 	// ワールド座標の取得	
 	return transform_.translate;
 }
+
+//=============================================================================
+// ワールド空間AABBの取得
+//=============================================================================
+AABB SphereCollider::GetWorldAABB() {
+	Vector3 extent = { radius_, radius_, radius_ };
+	return { transform_.translate - extent, transform_.translate + extent };
+}
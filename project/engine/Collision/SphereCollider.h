@@ -18,6 +18,11 @@ public:
 	// functions
 	//=========================================================================
 
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	SphereCollider() : Collider(ColliderShape::Sphere) {}
+
 	/// <summary>
 	/// 初期化
 	/// </summary>
@@ -36,13 +41,6 @@ public:
 	/// </summary>
 	/// <param name="name"></param>
 	void UpdateImGui([[maybe_unused]]const std::string& name) override;
-	
-	/// <summary>
-	/// 衝突判定
-	/// </summary>
-	/// <param name="other"></param>
-	/// <returns></returns>
-	bool CheckCollision(Collider* other) override;
 
 	/// <summary>
 	/// コライダーの描画
@@ -102,6 +100,8 @@ public:
 
 	//ワールド座標の取得
 	Vector3 GetWorldPos() override;
+	//ワールド空間AABBの取得
+	AABB GetWorldAABB() override;
 	//半径の取得
 	float GetRadius() const { return radius_; }
 
@@ -113,5 +113,5 @@ public:
 private:
 
 	//球の半径
-	float radius_;
+	float radius_ = 0.0f;
 };
\ No newline at end of file
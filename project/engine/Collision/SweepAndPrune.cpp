@@ -0,0 +1,112 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+using namespace TakeC;
+
+namespace {
+
+	//軸番号からベクトル成分を取得
+	float GetAxisValue(const Vector3& v, int axis) {
+		return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z;
+	}
+
+	//指定軸でAABB同士が重なっているか
+	bool OverlapOnAxis(const AABB& a, const AABB& b, int axis) {
+		return GetAxisValue(a.min, axis) <= GetAxisValue(b.max, axis) &&
+			GetAxisValue(b.min, axis) <= GetAxisValue(a.max, axis);
+	}
+}
+
+//=============================================================================
+// プロキシの全削除
+//=============================================================================
+void SweepAndPrune::Clear() {
+	proxies_.clear();
+	pairs_.clear();
+}
+
+//=============================================================================
+// プロキシの追加
+//=============================================================================
+void SweepAndPrune::AddProxy(const AABB& bounds, uint32_t index, uint32_t group) {
+	Vector3 margin = { kBoundsMargin_, kBoundsMargin_, kBoundsMargin_ };
+	proxies_.push_back({ { bounds.min - margin, bounds.max + margin }, index, group });
+}
+
+//=============================================================================
+// AABBが重なっているペアの列挙
+//=============================================================================
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::ComputePairs() {
+
+	pairs_.clear();
+	if (proxies_.size() < 2) {
+		return pairs_;
+	}
+
+	//スイープ軸の決定と、その軸の最小値でのソート
+	const int axis = SelectSweepAxis();
+	const int otherAxis0 = (axis + 1) % 3;
+	const int otherAxis1 = (axis + 2) % 3;
+	std::sort(proxies_.begin(), proxies_.end(), [axis](const Proxy& a, const Proxy& b) {
+		return GetAxisValue(a.bounds.min, axis) < GetAxisValue(b.bounds.min, axis);
+	});
+
+	//スイープ: 区間が重なる間だけ後続を調べる
+	for (size_t i = 0; i < proxies_.size(); ++i) {
+		const Proxy& proxyA = proxies_[i];
+		const float maxA = GetAxisValue(proxyA.bounds.max, axis);
+
+		for (size_t j = i + 1; j < proxies_.size(); ++j) {
+			const Proxy& proxyB = proxies_[j];
+			if (GetAxisValue(proxyB.bounds.min, axis) > maxA) break;
+
+			//同じグループ同士は判定しない
+			if (proxyA.group == proxyB.group) continue;
+
+			//残りの2軸で重なりを確認
+			if (!OverlapOnAxis(proxyA.bounds, proxyB.bounds, otherAxis0)) continue;
+			if (!OverlapOnAxis(proxyA.bounds, proxyB.bounds, otherAxis1)) continue;
+
+			pairs_.push_back({
+				std::min(proxyA.index, proxyB.index),
+				std::max(proxyA.index, proxyB.index)
+			});
+		}
+	}
+
+	//総当たりと同じ順序で衝突処理が呼ばれるよう、登録インデックス順に並べる
+	std::sort(pairs_.begin(), pairs_.end(), [](const Pair& a, const Pair& b) {
+		return (a.first != b.first) ? (a.first < b.first) : (a.second < b.second);
+	});
+
+	return pairs_;
+}
+
+//=============================================================================
+// 中心座標の分散が最大の軸を選ぶ
+//=============================================================================
+int SweepAndPrune::SelectSweepAxis() const {
+
+	float sum[3] = { 0.0f, 0.0f, 0.0f };
+	float sumSq[3] = { 0.0f, 0.0f, 0.0f };
+	for (const Proxy& proxy : proxies_) {
+		Vector3 center = proxy.bounds.GetCenter();
+		for (int axis = 0; axis < 3; ++axis) {
+			float value = GetAxisValue(center, axis);
+			sum[axis] += value;
+			sumSq[axis] += value * value;
+		}
+	}
+
+	const float count = static_cast<float>(proxies_.size());
+	int bestAxis = 0;
+	float bestVariance = -1.0f;
+	for (int axis = 0; axis < 3; ++axis) {
+		float variance = sumSq[axis] - (sum[axis] * sum[axis]) / count;
+		if (variance > bestVariance) {
+			bestVariance = variance;
+			bestAxis = axis;
+		}
+	}
+	return bestAxis;
+}
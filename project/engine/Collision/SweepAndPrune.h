@@ -0,0 +1,78 @@
+#pragma once
+#include "engine/math/AABB.h"
+#include <cstdint>
+#include <vector>
+
+namespace TakeC {
+
+//============================================================================
+// SweepAndPrune class
+//============================================================================
+/// <summary>
+/// ワールド空間AABBをソート&スイープし、重なり得るペアだけを列挙するブロードフェーズです。
+/// </summary>
+class SweepAndPrune {
+public:
+
+	/// <summary>
+	/// 判定対象のプロキシ
+	/// </summary>
+	struct Proxy {
+		AABB bounds;     // ワールド空間AABB
+		uint32_t index;  // 呼び出し側の登録インデックス
+		uint32_t group;  // 同じグループ同士のペアは列挙しない
+	};
+
+	/// <summary>
+	/// 候補ペア(常に first < second)
+	/// </summary>
+	struct Pair {
+		uint32_t first;
+		uint32_t second;
+	};
+
+public:
+
+	//=========================================================================
+	// functions
+	//=========================================================================
+
+	SweepAndPrune() = default;
+	~SweepAndPrune() = default;
+
+	/// <summary>
+	/// プロキシの全削除(確保済みの容量は維持する)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// プロキシの追加
+	/// </summary>
+	/// <param name="bounds">ワールド空間AABB</param>
+	/// <param name="index">登録インデックス</param>
+	/// <param name="group">グループID</param>
+	void AddProxy(const AABB& bounds, uint32_t index, uint32_t group);
+
+	/// <summary>
+	/// AABBが重なっているペアの列挙
+	/// </summary>
+	/// <returns>登録インデックス順(first, second)に並んだ候補ペア</returns>
+	const std::vector<Pair>& ComputePairs();
+
+private:
+
+	//中心座標の分散が最大の軸を選ぶ
+	int SelectSweepAxis() const;
+
+private:
+
+	//境界判定の誤差吸収用マージン
+	static constexpr float kBoundsMargin_ = 1.0e-3f;
+
+	//プロキシリスト
+	std::vector<Proxy> proxies_;
+	//候補ペアリスト
+	std::vector<Pair> pairs_;
+};
+
+}
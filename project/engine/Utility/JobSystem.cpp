@@ -0,0 +1,141 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+using namespace TakeC;
+
+namespace {
+	//ワーカースレッド上、またはチャンクの処理中かどうか(入れ子のParallelForを直列実行するため)
+	thread_local bool tIsInsideJob = false;
+}
+
+JobSystem& JobSystem::GetInstance() {
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem::~JobSystem() {
+	Finalize();
+}
+
+//=============================================================================
+// 初期化
+//=============================================================================
+void JobSystem::Initialize(uint32_t workerCount) {
+	Finalize();
+
+	if (workerCount == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	running_ = true;
+	workers_.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i) {
+		workers_.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+}
+
+//=============================================================================
+// 終了処理
+//=============================================================================
+void JobSystem::Finalize() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		running_ = false;
+	}
+	wakeCondition_.notify_all();
+
+	for (auto& worker : workers_) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+	workers_.clear();
+}
+
+//=============================================================================
+// バッチの配布と完了待ち
+//=============================================================================
+void JobSystem::Dispatch(uint32_t count, uint32_t grainSize, ChunkFunc func, void* context) {
+
+	Batch batch;
+	batch.func = func;
+	batch.context = context;
+	batch.count = count;
+	batch.grainSize = grainSize;
+	batch.chunkCount = GetChunkCount(count, grainSize);
+
+	//ワーカーがいない・1チャンクしかない・チャンクの処理中からの呼び出しの場合はその場で処理する
+	if (workers_.empty() || batch.chunkCount <= 1 || tIsInsideJob) {
+		RunBatch(batch);
+		return;
+	}
+
+	std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		currentBatch_ = &batch;
+		++generation_;
+	}
+	wakeCondition_.notify_all();
+
+	//呼び出し元スレッドも処理に参加する(チャンク内からのParallelForでdispatchMutex_を再度取らないよう、処理中は印を付ける)
+	tIsInsideJob = true;
+	RunBatch(batch);
+	tIsInsideJob = false;
+
+	//全チャンクが終わり、参加中のワーカーがいなくなるまで待つ(batchはこの関数のスタック上にあるため)
+	std::unique_lock<std::mutex> lock(mutex_);
+	doneCondition_.wait(lock, [&batch]() {
+		return batch.finishedChunks.load(std::memory_order_acquire) == batch.chunkCount && batch.activeWorkers == 0;
+	});
+	currentBatch_ = nullptr;
+}
+
+//=============================================================================
+// チャンクの処理
+//=============================================================================
+void JobSystem::RunBatch(Batch& batch) {
+	for (;;) {
+		uint32_t chunk = batch.nextChunk.fetch_add(1, std::memory_order_relaxed);
+		if (chunk >= batch.chunkCount) {
+			return;
+		}
+		uint32_t begin = chunk * batch.grainSize;
+		uint32_t end = (std::min)(batch.count, begin + batch.grainSize);
+		batch.func(batch.context, begin, end);
+		batch.finishedChunks.fetch_add(1, std::memory_order_release);
+	}
+}
+
+//=============================================================================
+// ワーカースレッドの処理
+//=============================================================================
+void JobSystem::WorkerLoop() {
+	tIsInsideJob = true;
+	uint64_t seenGeneration = 0;
+
+	for (;;) {
+		Batch* batch = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wakeCondition_.wait(lock, [this, &seenGeneration]() {
+				return !running_ || (currentBatch_ != nullptr && generation_ != seenGeneration);
+			});
+			if (!running_) {
+				return;
+			}
+			seenGeneration = generation_;
+			batch = currentBatch_;
+			++batch->activeWorkers;
+		}
+
+		RunBatch(*batch);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--batch->activeWorkers;
+		}
+		doneCondition_.notify_one();
+	}
+}
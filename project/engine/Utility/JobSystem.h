@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//============================================================================
+// JobSystem class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// ワーカースレッドを常駐させ、範囲を分割して並列に処理するクラスです。
+	/// ParallelForは呼び出し元スレッドも処理に参加し、全チャンクの完了まで戻りません。
+	/// </summary>
+	class JobSystem {
+	private:
+
+		//コピーコンストラクタ・代入演算子禁止
+		JobSystem() = default;
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+	public:
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// シングルトンインスタンス取得
+		/// </summary>
+		static JobSystem& GetInstance();
+
+		/// <summary>
+		/// 初期化
+		/// </summary>
+		/// <param name="workerCount">ワーカースレッド数(0ならハードウェアスレッド数-1)</param>
+		void Initialize(uint32_t workerCount = 0);
+
+		/// <summary>
+		/// 終了処理(ワーカースレッドの停止)
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// [0, count) を grainSize 毎のチャンクに分けて並列に処理する
+		/// func(begin, end) はチャンク毎に1回呼ばれ、チャンクの境界は grainSize の倍数になる
+		/// ワーカーがいない場合やチャンクの処理中(入れ子)に呼ばれた場合は呼び出し元スレッドで順に処理する
+		/// </summary>
+		/// <param name="count">要素数</param>
+		/// <param name="grainSize">1チャンクの要素数</param>
+		/// <param name="func">void(uint32_t begin, uint32_t end)</param>
+		template<typename Func>
+		void ParallelFor(uint32_t count, uint32_t grainSize, Func&& func);
+
+		/// <summary>
+		/// ParallelForで分割されるチャンク数の取得
+		/// </summary>
+		static uint32_t GetChunkCount(uint32_t count, uint32_t grainSize) {
+			return grainSize == 0 ? 0 : (count + grainSize - 1) / grainSize;
+		}
+
+		//ワーカースレッド数の取得
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+	private:
+
+		using ChunkFunc = void(*)(void* context, uint32_t begin, uint32_t end);
+
+		/// <summary>
+		/// 1回のParallelForで処理する範囲(呼び出し元のスタック上に置く)
+		/// </summary>
+		struct Batch {
+			ChunkFunc func = nullptr;
+			void* context = nullptr;
+			uint32_t count = 0;
+			uint32_t grainSize = 0;
+			uint32_t chunkCount = 0;
+			std::atomic<uint32_t> nextChunk = 0;     //次に処理するチャンク
+			std::atomic<uint32_t> finishedChunks = 0; //処理済みのチャンク数
+			uint32_t activeWorkers = 0;               //参加中のワーカー数(mutex_で保護)
+		};
+
+		/// <summary>
+		/// バッチをワーカーに配り、呼び出し元も参加して完了を待つ
+		/// </summary>
+		void Dispatch(uint32_t count, uint32_t grainSize, ChunkFunc func, void* context);
+
+		/// <summary>
+		/// バッチのチャンクを取れなくなるまで処理する
+		/// </summary>
+		static void RunBatch(Batch& batch);
+
+		/// <summary>
+		/// ワーカースレッドの処理
+		/// </summary>
+		void WorkerLoop();
+
+	private:
+
+		std::vector<std::thread> workers_;
+		std::mutex dispatchMutex_;               //ParallelForの同時呼び出しを直列化する
+		std::mutex mutex_;                       //currentBatch_・generation_・running_用
+		std::condition_variable wakeCondition_;  //ワーカー起床用
+		std::condition_variable doneCondition_;  //バッチ完了通知用
+		Batch* currentBatch_ = nullptr;
+		uint64_t generation_ = 0;
+		bool running_ = false;
+	};
+
+	//---------------------------------------------------------------------------------
+	// 範囲の並列処理
+	//---------------------------------------------------------------------------------
+	template<typename Func>
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, Func&& func) {
+		if (count == 0) {
+			return;
+		}
+		if (grainSize == 0) {
+			grainSize = 1;
+		}
+
+		using FuncType = std::remove_reference_t<Func>;
+		Dispatch(count, grainSize,
+			[](void* context, uint32_t begin, uint32_t end) {
+				(*static_cast<FuncType*>(context))(begin, end);
+			},
+			const_cast<void*>(static_cast<const void*>(&func)));
+	}
+}
@@ -0,0 +1,68 @@
+#include "RadixSort.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+using namespace TakeC;
+
+//=============================================================================
+// 並べ替え
+//=============================================================================
+void RadixSort::Sort(const uint16_t* keys, std::vector<uint32_t>& indices) {
+
+	if (indices.size() <= 1) {
+		return;
+	}
+	buffer_.resize(indices.size());
+
+	// 下位8bit → 上位8bit の順に分配する(各回が安定なので全体も安定になる)
+	for (uint32_t shift = 0; shift < 16; shift += 8) {
+		if (Scatter(keys, indices, buffer_, shift)) {
+			indices.swap(buffer_);
+		}
+	}
+}
+
+//=============================================================================
+// 8bit分の分配
+//=============================================================================
+bool RadixSort::Scatter(const uint16_t* keys, const std::vector<uint32_t>& src, std::vector<uint32_t>& dst, uint32_t shift) {
+
+	JobSystem& jobSystem = JobSystem::GetInstance();
+	const uint32_t count = static_cast<uint32_t>(src.size());
+	const uint32_t chunkCount = JobSystem::GetChunkCount(count, kGrainSize_);
+	histograms_.resize(static_cast<size_t>(chunkCount) * kRadix_);
+
+	// チャンク毎のヒストグラム
+	jobSystem.ParallelFor(count, kGrainSize_, [&](uint32_t begin, uint32_t end) {
+		uint32_t* histogram = &histograms_[static_cast<size_t>(begin / kGrainSize_) * kRadix_];
+		std::fill(histogram, histogram + kRadix_, 0u);
+		for (uint32_t i = begin; i < end; ++i) {
+			++histogram[(keys[src[i]] >> shift) & (kRadix_ - 1)];
+		}
+	});
+
+	// 値の順 → チャンクの順 に累積して各チャンクの書き込み開始位置にする
+	uint32_t offset = 0;
+	for (uint32_t digit = 0; digit < kRadix_; ++digit) {
+		const uint32_t digitBegin = offset;
+		for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+			uint32_t& slot = histograms_[static_cast<size_t>(chunk) * kRadix_ + digit];
+			uint32_t digitCount = slot;
+			slot = offset;
+			offset += digitCount;
+		}
+		// 全要素が同じ値なら並びは変わらない
+		if (offset - digitBegin == count) {
+			return false;
+		}
+	}
+
+	// チャンク内の順序を保ったまま分配
+	jobSystem.ParallelFor(count, kGrainSize_, [&](uint32_t begin, uint32_t end) {
+		uint32_t* writeOffset = &histograms_[static_cast<size_t>(begin / kGrainSize_) * kRadix_];
+		for (uint32_t i = begin; i < end; ++i) {
+			dst[writeOffset[(keys[src[i]] >> shift) & (kRadix_ - 1)]++] = src[i];
+		}
+	});
+	return true;
+}
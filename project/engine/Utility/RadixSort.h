@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//============================================================================
+// RadixSort class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// 16bitのキーでインデックスを並べ替える安定な基数ソートです。
+	/// 8bitずつ2回の分配を行い、各回のヒストグラム作成と分配をJobSystemで並列に処理します。
+	/// 作業用の配列は保持して再利用するため、定常状態ではメモリ確保が発生しません。
+	/// </summary>
+	class RadixSort {
+	public:
+
+		RadixSort() = default;
+		~RadixSort() = default;
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// indices を keys[index] の昇順に並べ替える(キーが等しい要素は元の順序を保つ)
+		/// </summary>
+		/// <param name="keys">インデックスで参照するキー</param>
+		/// <param name="indices">並べ替えるインデックス(keysの範囲内であること)</param>
+		void Sort(const uint16_t* keys, std::vector<uint32_t>& indices);
+
+	public:
+
+		//並列処理で1度に処理する要素数
+		static constexpr uint32_t kGrainSize_ = 4096;
+
+	private:
+
+		/// <summary>
+		/// 8bit分の分配
+		/// </summary>
+		/// <param name="keys">キー</param>
+		/// <param name="src">分配元</param>
+		/// <param name="dst">分配先</param>
+		/// <param name="shift">キーのシフト量</param>
+		/// <returns>全要素が同じ値で分配を省略した場合false</returns>
+		bool Scatter(const uint16_t* keys, const std::vector<uint32_t>& src, std::vector<uint32_t>& dst, uint32_t shift);
+
+	private:
+
+		static constexpr uint32_t kRadix_ = 256;
+
+		std::vector<uint32_t> buffer_;     //分配先の作業領域
+		std::vector<uint32_t> histograms_; //チャンク毎のヒストグラム(分配時は書き込み位置)
+	};
+}
+
+using TakeC::RadixSort;
@@ -2,6 +2,9 @@
 #include "base/ImGuiManager.h"
 #include "engine/3d/Particle/ParticleCommon.h"
 #include "engine/Base/TakeCFrameWork.h"
+#include "engine/Utility/JobSystem.h"
+#include "engine/camera/CameraManager.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace TakeC;
@@ -14,6 +17,7 @@ void TakeC::ParticleManager::Initialize(ParticleCommon* particleCommon,Primitive
 	emitterAllocator_ = std::make_unique<ParticleEmitterAllocator>();
 	particleCommon_ = particleCommon;
 	primitiveDrawer_ = primitiveDrawer;
+	budget_.Initialize();
 }
 
 //================================================================================================
@@ -21,8 +25,56 @@ void TakeC::ParticleManager::Initialize(ParticleCommon* particleCommon,Primitive
 //================================================================================================
 
 void TakeC::ParticleManager::Update() {
+
+	JobSystem& jobSystem = JobSystem::GetInstance();
+
+	// エミッターの姿勢をスロットへ書き写す(並列更新中はスナップショットのみを読む)
+	emitterAllocator_->SyncTransforms();
+
+	// 各グループを範囲に分割し、グループ・範囲をまとめて並列に移動更新する
+	updateJobs_.clear();
+	for (auto& [name, particleGroup] : particleGroups_) {
+		AppendUpdateJobs(particleGroup.get(), particleGroup->BeginUpdate());
+	}
+	jobSystem.ParallelFor(static_cast<uint32_t>(updateJobs_.size()), 1, [this](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			updateJobs_[i].group->UpdateRange(updateJobs_[i].begin, updateJobs_[i].end);
+		}
+	});
+
+	// 同期点: 寿命の尽きたパーティクルの削除とトレイルの描画数の集計はグループ毎に直列で行う
+	updateJobs_.clear();
+	uint32_t liveCount = 0;
 	for (auto& [name, particleGroup] : particleGroups_) {
-		particleGroup->Update();
+		AppendUpdateJobs(particleGroup.get(), particleGroup->MergeUpdate());
+		liveCount += particleGroup->GetParticleCount();
+	}
+
+	// 次の更新までに発生させる分の予算と、間引き・画面外判定に使うカメラの設定
+	budget_.BeginFrame(liveCount);
+	if (Camera* camera = CameraManager::GetInstance().GetActiveCamera()) {
+		const Matrix4x4& cameraWorld = camera->GetWorldMatrix();
+		budget_.SetView(camera->GetViewProjectionMatrix(), { cameraWorld.m[3][0], cameraWorld.m[3][1], cameraWorld.m[3][2] });
+	} else {
+		budget_.ClearView();
+	}
+
+	// GPU用データへの書き込み(各インデックスへの書き込みは1つの範囲だけが行う)
+	jobSystem.ParallelFor(static_cast<uint32_t>(updateJobs_.size()), 1, [this](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			updateJobs_[i].group->WriteRange(updateJobs_[i].begin, updateJobs_[i].end);
+		}
+	});
+}
+
+//================================================================================================
+// 並列更新用の範囲の追加
+//================================================================================================
+
+void TakeC::ParticleManager::AppendUpdateJobs(PrimitiveParticle* particleGroup, uint32_t particleCount) {
+	for (uint32_t begin = 0; begin < particleCount; begin += PrimitiveParticle::kUpdateChunkSize_) {
+		uint32_t end = (std::min)(particleCount, begin + PrimitiveParticle::kUpdateChunkSize_);
+		updateJobs_.push_back({ particleGroup, begin, end });
 	}
 }
 
@@ -35,6 +87,7 @@ void TakeC::ParticleManager::UpdateImGui() {
 #if defined(_DEBUG) || defined(_DEVELOP)
 	ImGui::Begin("ParticleManager");
 	ImGui::Text("ParticleGroup Count : %d", particleGroups_.size());
+	budget_.UpdateImGui();
 	ImGui::Separator();
 	for (const auto& [name, particleGroup] : particleGroups_) {
 
@@ -128,8 +181,15 @@ void TakeC::ParticleManager::Emit(const std::string& name, const Vector3& emitPo
 		return;
 	}
 
-	//particleGroupsに発生させたパーティクルを登録させる
-	particleGroups_.at(name)->SpliceParticles(particleGroups_.at(name)->Emit(emitPosition,direction, count));
+	//発生予算の範囲に収める
+	PrimitiveParticle* particleGroup = particleGroups_.at(name).get();
+	count = budget_.RequestEmit(particleGroup->GetPreset().attribute, emitPosition, count);
+	if (count == 0) {
+		return;
+	}
+
+	//particleGroupに直接パーティクルを発生させる
+	particleGroup->Emit(emitPosition,direction, count);
 }
 
 void TakeC::ParticleManager::EmitWithEmitter(uint32_t emitterID, const std::string& name, const Vector3& emitPosition, const Vector3& direction, uint32_t count) {
@@ -138,10 +198,15 @@ void TakeC::ParticleManager::EmitWithEmitter(uint32_t emitterID, const std::stri
 		return;
 	}
 
+	// 発生予算の範囲に収める
+	PrimitiveParticle* particleGroup = particleGroups_.at(name).get();
+	count = budget_.RequestEmit(particleGroup->GetPreset().attribute, emitPosition, count);
+	if (count == 0) {
+		return;
+	}
+
 	// エミッターIDを含めてパーティクルを発生
-	particleGroups_.at(name)->SpliceParticles(
-		particleGroups_.at(name)->EmitWithEmitter(emitterID, emitPosition, direction, count)
-	);
+	particleGroup->EmitWithEmitter(emitterID, emitPosition, direction, count);
 }
 
 //================================================================================================
@@ -2,6 +2,7 @@
 #include "engine/3d/Particle/Particle3d.h"
 #include "engine/3d/Particle/PrimitiveParticle.h"
 #include "engine/3d/Particle/ParticleEmitterAllocater.h"
+#include "engine/3d/Particle/ParticleBudget.h"
 #include "engine/3d/Primitive/PrimitiveDrawer.h"
 #include "engine/Base/BlendModeStateEnum.h"
 
@@ -101,6 +102,12 @@ namespace TakeC {
 		/// <returns>エミッターのスケール（存在しない場合はnullopt）</returns>
 		std::optional<Vector3> GetEmitterScale(uint32_t emitterID) const;
 
+		//エミッターの割り当て管理の取得(パーティクル更新中の姿勢参照用)
+		const ParticleEmitterAllocator* GetEmitterAllocator() const { return emitterAllocator_.get(); }
+		//発生予算の取得(上限・間引き距離の設定用)
+		ParticleBudget& GetBudget() { return budget_; }
+		const ParticleBudget& GetBudget() const { return budget_; }
+
 		//パーティクルグループの取得
 		BaseParticleGroup* GetParticleGroup(const std::string& name);
 		//groupnameからプリミティブハンドルの取得
@@ -109,16 +116,38 @@ namespace TakeC {
 		//プリセットの設定
 		void SetPreset(const std::string& name, const ParticlePreset& preset);
 
+	private:
+
+		/// <summary>
+		/// 並列更新で1度に処理する範囲
+		/// </summary>
+		struct UpdateJob {
+			PrimitiveParticle* group = nullptr;
+			uint32_t begin = 0;
+			uint32_t end = 0;
+		};
+
+		/// <summary>
+		/// グループのパーティクルを範囲に分割して更新ジョブに追加
+		/// </summary>
+		/// <param name="particleGroup"></param>
+		/// <param name="particleCount"></param>
+		void AppendUpdateJobs(PrimitiveParticle* particleGroup, uint32_t particleCount);
+
 	private:
 
 		//エミッターアロケータ
 		std::unique_ptr<ParticleEmitterAllocator> emitterAllocator_;
+		//発生予算
+		ParticleBudget budget_;
 		//パーティクルグループ
 		std::unordered_map<std::string, std::unique_ptr<PrimitiveParticle>> particleGroups_;
 		//パーティクル共通情報
 		ParticleCommon* particleCommon_ = nullptr;
 		//プリミティブドロワー
 		PrimitiveDrawer* primitiveDrawer_ = nullptr;
+		//並列更新用の範囲(確保済みの領域は毎フレーム再利用する)
+		std::vector<UpdateJob> updateJobs_;
 	};
 
 
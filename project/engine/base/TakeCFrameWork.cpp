@@ -1,4 +1,5 @@
 #include "TakeCFrameWork.h"
+#include "Collision/CollisionManager.h"
 #include <cassert>
 
 //Clockの宣言
@@ -10,6 +11,7 @@ std::unique_ptr<TakeC::AnimationManager> TakeCFrameWork::animationManager_ = nul
 std::unique_ptr<TakeC::JsonLoader> TakeCFrameWork::jsonLoader_ = nullptr;
 std::unique_ptr<TakeC::LightManager> TakeCFrameWork::lightManager_ = nullptr;
 std::unique_ptr<TakeC::ParticleManager> TakeCFrameWork::particleManager_ = nullptr;
+std::unique_ptr<TakeC::EffectGroupPool> TakeCFrameWork::effectGroupPool_ = nullptr;
 std::unique_ptr<TakeC::PrimitiveDrawer> TakeCFrameWork::primitiveDrawer_ = nullptr;
 std::unique_ptr<TakeC::PostEffectManager> TakeCFrameWork::postEffectManager_= nullptr;
 std::unique_ptr<TakeC::WireFrame> TakeCFrameWork::wireFrame_ = nullptr;
@@ -54,6 +56,9 @@ void TakeCFrameWork::Initialize(const std::wstring& titleName) {
 	//AnimationManager
 	animationManager_ = std::make_unique<AnimationManager>();
 
+	//JobSystem(ワーカースレッドの起動)
+	TakeC::JobSystem::GetInstance().Initialize();
+
 	//CameraManager
 	TakeC::CameraManager::GetInstance().Initialize(directXCommon_.get());
 
@@ -108,6 +113,8 @@ void TakeCFrameWork::Initialize(const std::wstring& titleName) {
 	//ParticleManager
 	particleManager_ = std::make_unique<ParticleManager>();
 	particleManager_->Initialize(particleCommon_,primitiveDrawer_.get());
+	//EffectGroupPool
+	effectGroupPool_ = std::make_unique<EffectGroupPool>();
 
 	//RenderTexture
 	renderTexture_ = std::make_unique<RenderTexture>();
@@ -166,7 +173,10 @@ void TakeCFrameWork::Finalize() {
 	CameraManager::GetInstance().Finalize();
 	postEffectManager_->Finalize();
 	renderTexture_.reset();
+	//エミッターの解放にParticleManagerを使うため先に破棄する
+	effectGroupPool_.reset();
 	particleManager_->Finalize();
+	TakeC::JobSystem::GetInstance().Finalize();
 	primitiveDrawer_->Finalize();
 	particleCommon_->Finalize();
 	object3dCommon_->Finalize();
@@ -228,6 +238,10 @@ void TakeCFrameWork::Update() {
 	directXCommon_->DrawFrameTimeInfo();
 	ImGui::Text("DeltaTime: %.4f", deltaTime);
 	ImGui::DragFloat("TimeScale", &timeScale_, 0.01f, 0.0f, 5.0f);
+	effectGroupPool_->UpdateImGui();
+	SkinningScheduler::GetInstance().UpdateImGui();
+	AnimationLod::GetInstance().UpdateImGui();
+	animationManager_->UpdateImGui();
 	ImGui::End();
 #endif
 	
@@ -237,7 +251,15 @@ void TakeCFrameWork::Update() {
 
 	//シーンの更新
 	if (!isPaused_) {
+		//PlayOneShotで再生したエフェクトの更新(シーン内のParticleManager::Updateで発生させる)
+		effectGroupPool_->Update();
+		//アニメーションLODのフレーム番号を進める(評価フレームの判定に使う)
+		AnimationLod::GetInstance().BeginFrame();
+		//キャスト判定用BVHを次のキャストで更新させる
+		CollisionManager::GetInstance().BeginFrame();
 		sceneManager_->Update();
+		//シーン中に登録されたスキンメッシュのアニメーション更新をまとめて並列に処理
+		SkinningScheduler::GetInstance().Flush();
 	}
 
 #if defined(_DEBUG) || defined(_DEVELOP)
@@ -303,6 +325,15 @@ TakeC::ParticleManager* TakeCFrameWork::GetParticleManager() {
 	return particleManager_.get();
 }
 
+//====================================================================
+//			EffectGroupPoolの取得
+//====================================================================
+
+TakeC::EffectGroupPool* TakeCFrameWork::GetEffectGroupPool() {
+	assert(effectGroupPool_ && "EffectGroupPoolが生成されていません");
+	return effectGroupPool_.get();
+}
+
 //====================================================================
 //			AnimationManagerの取得
 //====================================================================
@@ -21,9 +21,12 @@
 #include "3d/Particle/ParticleCommon.h"
 #include "3d/Light/LightManager.h"
 #include "3d/Particle/ParticleEditor.h"
+#include "3d/Particle/EffectGroupPool.h"
 #include "2d/SpriteCommon.h"
 #include "2d/WireFrame.h"
 #include "Animation/Animator.h"
+#include "Animation/SkinningScheduler.h"
+#include "Animation/AnimationLod.h"
 #include "audio/Audio.h"
 #include "camera/CameraManager.h"
 #include "CameraCapture/CameraCapture.h"
@@ -38,6 +41,7 @@
 #include "Utility/ResourceBarrier.h"
 #include "Utility/ResourcePath.h"
 #include "Utility/JsonLoader.h"
+#include "Utility/JobSystem.h"
 #include "Utility/Timer.h"
 #include "engine/math/Easing.h"
 
@@ -89,6 +93,8 @@ public:
 
 	//ParticleManagerの取得
 	static TakeC::ParticleManager* GetParticleManager();
+	//EffectGroupPoolの取得
+	static TakeC::EffectGroupPool* GetEffectGroupPool();
 	//PostEffectManagerの取得
 	static TakeC::AnimationManager* GetAnimationManager();
 	//JsonLoaderの取得
@@ -165,6 +171,8 @@ protected:
 	static std::unique_ptr<TakeC::JsonLoader> jsonLoader_;
 	//パーティクルマネージャー
 	static std::unique_ptr<TakeC::ParticleManager> particleManager_;
+	//エフェクトのプール
+	static std::unique_ptr<TakeC::EffectGroupPool> effectGroupPool_;
 	//プリミティブ描画クラス
 	static std::unique_ptr<TakeC::PrimitiveDrawer> primitiveDrawer_;
 	//ポストエフェクトマネージャー
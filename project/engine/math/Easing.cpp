@@ -1,5 +1,7 @@
 #include "Easing.h"
 #include "engine/Utility/StringUtility.h"
+#include <array>
+#include <utility>
 
 //=============================================================================
 // 線形補間(float)
@@ -116,6 +118,30 @@ float Easing::EaseOutQuad(float x) {
 	return x * (2.0f - x);
 }
 
+//=============================================================================
+// イージングの一括評価
+//=============================================================================
+namespace {
+	template<size_t kType>
+	void EaseBatch(const float* t, float* out, uint32_t count) {
+		for (uint32_t i = 0; i < count; ++i) {
+			out[i] = Easing::Ease[kType](t[i]);
+		}
+	}
+
+	template<size_t... kTypes>
+	constexpr auto MakeEaseBatchTable(std::index_sequence<kTypes...>) {
+		return std::array<Easing::EasingBatchFunction, sizeof...(kTypes)>{ &EaseBatch<kTypes>... };
+	}
+
+	constexpr auto kEaseBatchTable = MakeEaseBatchTable(std::make_index_sequence<std::size(Easing::Ease)>{});
+}
+
+Easing::EasingBatchFunction Easing::GetEaseBatch(EasingType type) {
+	size_t index = static_cast<size_t>(type);
+	return index < kEaseBatchTable.size() ? kEaseBatchTable[index] : kEaseBatchTable[LINEAR];
+}
+
 //=============================================================================
 // EasingType -> JSON
 //=============================================================================
@@ -3,6 +3,7 @@
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
 #include <cmath>
+#include <cstdint>
 #include <numbers>
 #include <json.hpp>
 
@@ -88,8 +89,8 @@ namespace Easing {
 	};
 
 	// イージング関数配列(float)
-	using EasingFunction = std::function<float(float)>;
-	inline EasingFunction Ease[] = {[](float t){ return t; },
+	using EasingFunction = float(*)(float);
+	inline constexpr EasingFunction Ease[] = {[](float t){ return t; },
 		EaseInSine,
 		EaseOutSine,
 		EaseInOutSine,
@@ -105,6 +106,17 @@ namespace Easing {
 		GentleRise
 	};
 
+	// まとめて評価するイージング関数(out[i] = Ease[type](t[i]))
+	using EasingBatchFunction = void(*)(const float* t, float* out, uint32_t count);
+
+	/// <summary>
+	/// イージングの種類に対応する一括評価関数の取得
+	/// 種類の分岐と関数の解決は取得時に1回だけ行い、ループ内は直接呼び出しになる
+	/// </summary>
+	/// <param name="type">イージングの種類</param>
+	/// <returns></returns>
+	EasingBatchFunction GetEaseBatch(EasingType type);
+
 };
 
 void to_json(nlohmann::json& j, const Easing::EasingType& type);
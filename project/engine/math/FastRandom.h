@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <random>
+
+//============================================================================
+// FastRandom class
+//============================================================================
+namespace TakeC {
+
+	/// <summary>
+	/// xoshiro128+ による軽量な疑似乱数生成器です。
+	/// 状態は16バイトで分布オブジェクトも不要なため、大量のパーティクル発生でも負荷が小さく、
+	/// 同じシードからは同じ乱数列を返すので発生処理の再現にも使えます。
+	/// </summary>
+	class FastRandom {
+	public:
+
+		/// <summary>
+		/// コンストラクタ(random_deviceのシードで初期化)
+		/// </summary>
+		FastRandom() : FastRandom((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {}
+
+		/// <summary>
+		/// コンストラクタ(指定したシードで初期化)
+		/// </summary>
+		/// <param name="seed">シード</param>
+		explicit FastRandom(uint64_t seed) { SetSeed(seed); }
+
+		//========================================================================
+		// functions
+		//========================================================================
+
+		/// <summary>
+		/// シードの設定(splitmix64で4つの状態を初期化する)
+		/// </summary>
+		/// <param name="seed">シード</param>
+		void SetSeed(uint64_t seed) {
+			for (uint32_t i = 0; i < 2; ++i) {
+				seed += 0x9E3779B97F4A7C15ull;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				z = z ^ (z >> 31);
+				state_[i * 2 + 0] = static_cast<uint32_t>(z);
+				state_[i * 2 + 1] = static_cast<uint32_t>(z >> 32);
+			}
+		}
+
+		/// <summary>
+		/// 32bitの乱数の取得
+		/// </summary>
+		uint32_t NextUInt() {
+			const uint32_t result = state_[0] + state_[3];
+			const uint32_t t = state_[1] << 9;
+
+			state_[2] ^= state_[0];
+			state_[3] ^= state_[1];
+			state_[1] ^= state_[2];
+			state_[0] ^= state_[3];
+			state_[2] ^= t;
+			state_[3] = (state_[3] << 11) | (state_[3] >> 21);
+			return result;
+		}
+
+		/// <summary>
+		/// [0, 1) の乱数の取得
+		/// </summary>
+		float NextFloat() {
+			// 上位24bitを仮数として使う
+			return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f);
+		}
+
+		/// <summary>
+		/// [min, max) の乱数の取得
+		/// </summary>
+		/// <param name="min">最小値</param>
+		/// <param name="max">最大値</param>
+		float NextFloat(float min, float max) {
+			return min + (max - min) * NextFloat();
+		}
+
+	private:
+
+		uint32_t state_[4] = {};
+	};
+}
+
+using TakeC::FastRandom;
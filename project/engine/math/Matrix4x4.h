@@ -1,13 +1,15 @@
 #pragma once
 #include <json.hpp>
+#include <xmmintrin.h>
 
 /// <summary>
 /// 4x4行列
 /// </summary>
+/// 各行を__m128で読み書きする演算はヘッダ内でインライン展開される。
+/// GPUへ転送する構造体に埋め込まれるため、アラインメントは float と同じまま(非整列ロードを使用)。
 struct Matrix4x4 final {
 
 	Matrix4x4() = default;
-	Matrix4x4(const Matrix4x4& other);
 	float m[4][4] = {};
 
 	Matrix4x4 operator+() const;
@@ -18,7 +20,57 @@ struct Matrix4x4 final {
 	Matrix4x4& operator*=(const Matrix4x4& matrix);
 };
 
-Matrix4x4 operator+(const Matrix4x4& m1, const Matrix4x4& m2);
-Matrix4x4 operator-(const Matrix4x4& m1, const Matrix4x4& m2);
-Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2);
-Matrix4x4 operator*(const Matrix4x4& m, float scalar);
\ No newline at end of file
+//---------------------------------------------------------------------------------
+// 行列の加法
+//---------------------------------------------------------------------------------
+inline Matrix4x4 operator+(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result;
+	for (int row = 0; row < 4; row++) {
+		_mm_storeu_ps(result.m[row], _mm_add_ps(_mm_loadu_ps(m1.m[row]), _mm_loadu_ps(m2.m[row])));
+	}
+	return result;
+}
+
+//---------------------------------------------------------------------------------
+// 行列の減法
+//---------------------------------------------------------------------------------
+inline Matrix4x4 operator-(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result;
+	for (int row = 0; row < 4; row++) {
+		_mm_storeu_ps(result.m[row], _mm_sub_ps(_mm_loadu_ps(m1.m[row]), _mm_loadu_ps(m2.m[row])));
+	}
+	return result;
+}
+
+//---------------------------------------------------------------------------------
+// 行列の積
+// 結果の各行 = m1の行の各要素でブロードキャストした m2 の行の線形結合
+//---------------------------------------------------------------------------------
+inline Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2) {
+	const __m128 row0 = _mm_loadu_ps(m2.m[0]);
+	const __m128 row1 = _mm_loadu_ps(m2.m[1]);
+	const __m128 row2 = _mm_loadu_ps(m2.m[2]);
+	const __m128 row3 = _mm_loadu_ps(m2.m[3]);
+
+	Matrix4x4 result;
+	for (int row = 0; row < 4; row++) {
+		__m128 r = _mm_mul_ps(_mm_set1_ps(m1.m[row][0]), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][1]), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][2]), row2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][3]), row3));
+		_mm_storeu_ps(result.m[row], r);
+	}
+	return result;
+}
+
+//---------------------------------------------------------------------------------
+// 行列のスカラー倍
+//---------------------------------------------------------------------------------
+inline Matrix4x4 operator*(const Matrix4x4& m, float scalar) {
+	const __m128 s = _mm_set1_ps(scalar);
+	Matrix4x4 result;
+	for (int row = 0; row < 4; row++) {
+		_mm_storeu_ps(result.m[row], _mm_mul_ps(_mm_loadu_ps(m.m[row]), s));
+	}
+	return result;
+}
@@ -2,160 +2,168 @@
 #include "Vector3Math.h"
 #include <assert.h>
 #include <cmath>
-#include <xmmintrin.h>
+#include <emmintrin.h>
 
-//============================================================================
-//行列の加法
-//============================================================================
-Matrix4x4 MatrixMath::Add(const Matrix4x4& m1, const Matrix4x4& m2) {
-	Matrix4x4 result = m1 + m2;
-	return result;
-}
-
-//============================================================================
-//行列の減法
-//============================================================================
-Matrix4x4 MatrixMath::Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
-	Matrix4x4 result = m1 - m2;
-	return result;
-}
+namespace {
 
-//============================================================================
-//行列の積
-//============================================================================
-Matrix4x4 MatrixMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
-	Matrix4x4 result; for (int row = 0; row < 4; row++) { // m1 の1行を4要素同時ロード
-		__m128 r = _mm_set_ps(m1.m[row][3], m1.m[row][2], m1.m[row][1], m1.m[row][0]);
-		for (int col = 0; col < 4; col++) { 
-			// m2 の1列を4要素同時ロード
-			__m128 c = _mm_set_ps(m2.m[3][col], m2.m[2][col], m2.m[1][col], m2.m[0][col]);
-			// 4要素の積を同時計算し、水平加算
-			__m128 mul = _mm_mul_ps(r, c); 
-			// 水平加算: (a+b) + (c+d)
-			__m128 hadd = _mm_add_ps(mul, _mm_movehl_ps(mul, mul)); 
-			hadd = _mm_add_ss(hadd, _mm_shuffle_ps(hadd, hadd, 1));
-			result.m[row][col] = _mm_cvtss_f32(hadd);
-		}
+	//_mm_shuffle_ps の選択マスク(x, y は1つ目、z, w は2つ目のベクトルから取る)
+	constexpr int ShuffleMask(int x, int y, int z, int w) {
+		return x | (y << 2) | (z << 4) | (w << 6);
 	}
-	return result;
-}
 
-//============================================================================
-//逆行列
-//============================================================================
-Matrix4x4 MatrixMath::Inverse(const Matrix4x4& m) {
-	float determinant =
-		(m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3])
-		+ (m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1])
-		+ (m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2])
-		- (m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1])
-		- (m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3])
-		- (m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2])
-		- (m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3])
-		- (m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1])
-		- (m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2])
-		+ (m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1])
-		+ (m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3])
-		+ (m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2])
-		+ (m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3])
-		+ (m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1])
-		+ (m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2])
-		- (m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1])
-		- (m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3])
-		- (m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2])
-		- (m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0])
-		- (m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0])
-		- (m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0])
-		+ (m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0])
-		+ (m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0])
-		+ (m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0]);
-
-	Matrix4x4 result;
-	result.m[0][0] = 1.0f / determinant *
-		(m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[1][3] * m.m[2][1] * m.m[3][2]
-			- m.m[1][3] * m.m[2][2] * m.m[3][1] - m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[1][1] * m.m[2][3] * m.m[3][2]);
-
-	result.m[0][1] = 1.0f / determinant *
-		(-m.m[0][1] * m.m[2][2] * m.m[3][3] - m.m[0][2] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[2][1] * m.m[3][2]
-			+ m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] + m.m[0][1] * m.m[2][3] * m.m[3][2]);
-
-	result.m[0][2] = 1.0f / determinant *
-		(m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] + m.m[0][3] * m.m[1][1] * m.m[3][2]
-			- m.m[0][3] * m.m[1][2] * m.m[3][1] - m.m[0][2] * m.m[1][1] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[3][2]);
-
-	result.m[0][3] = 1.0f / determinant *
-		(-m.m[0][1] * m.m[1][2] * m.m[2][3] - m.m[0][2] * m.m[1][3] * m.m[2][1] - m.m[0][3] * m.m[1][1] * m.m[2][2]
-			+ m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] + m.m[0][1] * m.m[1][3] * m.m[2][2]);
-
-	result.m[1][0] = 1.0f / determinant *
-		(-m.m[1][0] * m.m[2][2] * m.m[3][3] - m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[1][3] * m.m[2][0] * m.m[3][2]
-			+ m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] + m.m[1][0] * m.m[2][3] * m.m[3][2]);
-
-	result.m[1][1] = 1.0f / determinant *
-		(m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] + m.m[0][3] * m.m[2][0] * m.m[3][2]
-			- m.m[0][3] * m.m[2][2] * m.m[3][0] - m.m[0][2] * m.m[2][0] * m.m[3][3] - m.m[0][0] * m.m[2][3] * m.m[3][2]);
-
-	result.m[1][2] = 1.0f / determinant *
-		(-m.m[0][0] * m.m[1][2] * m.m[3][3] - m.m[0][2] * m.m[1][3] * m.m[3][0] - m.m[0][3] * m.m[1][0] * m.m[3][2]
-			+ m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] + m.m[0][0] * m.m[1][3] * m.m[3][2]);
-
-	result.m[1][3] = 1.0f / determinant *
-		(m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] + m.m[0][3] * m.m[1][0] * m.m[2][2]
-			- m.m[0][3] * m.m[1][2] * m.m[2][0] - m.m[0][2] * m.m[1][0] * m.m[2][3] - m.m[0][0] * m.m[1][3] * m.m[2][2]);
-
-	result.m[2][0] = 1.0f / determinant *
-		(m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] + m.m[1][3] * m.m[2][0] * m.m[3][1]
-			- m.m[1][3] * m.m[2][1] * m.m[3][0] - m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[1][0] * m.m[2][3] * m.m[3][1]);
+	//1つのベクトル内での並べ替え
+	template <int x, int y, int z, int w>
+	inline __m128 Swizzle(__m128 v) {
+		return _mm_shuffle_ps(v, v, ShuffleMask(x, y, z, w));
+	}
 
-	result.m[2][1] = 1.0f / determinant *
-		(-m.m[0][0] * m.m[2][1] * m.m[3][3] - m.m[0][1] * m.m[2][3] * m.m[3][0] - m.m[0][3] * m.m[2][0] * m.m[3][1]
-			+ m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] + m.m[0][0] * m.m[2][3] * m.m[3][1]);
+	//2つのベクトルからの並べ替え
+	template <int x, int y, int z, int w>
+	inline __m128 Shuffle(__m128 a, __m128 b) {
+		return _mm_shuffle_ps(a, b, ShuffleMask(x, y, z, w));
+	}
 
-	result.m[2][2] = 1.0f / determinant *
-		(m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] + m.m[0][3] * m.m[1][0] * m.m[3][1]
-			- m.m[0][3] * m.m[1][1] * m.m[3][0] - m.m[0][1] * m.m[1][0] * m.m[3][3] - m.m[0][0] * m.m[1][3] * m.m[3][1]);
+	//2x2行列(行優先で1本の__m128に格納)の積 A * B
+	inline __m128 Mat2Mul(__m128 a, __m128 b) {
+		return _mm_add_ps(
+			_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)),
+			_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+	}
 
-	result.m[2][3] = 1.0f / determinant *
-		(-m.m[0][0] * m.m[1][1] * m.m[2][3] - m.m[0][1] * m.m[1][3] * m.m[2][0] - m.m[0][3] * m.m[1][0] * m.m[2][1]
-			+ m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] + m.m[0][0] * m.m[1][3] * m.m[2][1]);
+	//2x2行列の余因子行列との積 adj(A) * B
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b),
+			_mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+	}
 
-	result.m[3][0] = 1.0f / determinant *
-		(-m.m[1][0] * m.m[2][1] * m.m[3][2] - m.m[1][1] * m.m[2][2] * m.m[3][0] - m.m[1][2] * m.m[2][0] * m.m[3][1]
-			+ m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] + m.m[1][0] * m.m[2][2] * m.m[3][1]);
+	//2x2行列と余因子行列の積 A * adj(B)
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)),
+			_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+	}
 
-	result.m[3][1] = 1.0f / determinant *
-		(m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] + m.m[0][2] * m.m[2][0] * m.m[3][1]
-			- m.m[0][2] * m.m[2][1] * m.m[3][0] - m.m[0][1] * m.m[2][0] * m.m[3][2] - m.m[0][0] * m.m[2][2] * m.m[3][1]);
+	//3要素の外積(4要素目は0になる)
+	inline __m128 Cross3(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(Swizzle<1, 2, 0, 3>(a), Swizzle<2, 0, 1, 3>(b)),
+			_mm_mul_ps(Swizzle<2, 0, 1, 3>(a), Swizzle<1, 2, 0, 3>(b)));
+	}
 
-	result.m[3][2] = 1.0f / determinant *
-		(-m.m[0][0] * m.m[1][1] * m.m[3][2] - m.m[0][1] * m.m[1][2] * m.m[3][0] - m.m[0][2] * m.m[1][0] * m.m[3][1]
-			+ m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] + m.m[0][0] * m.m[1][2] * m.m[3][1]);
+	//3要素の内積を全要素に複製したもの
+	inline __m128 Dot3(__m128 a, __m128 b) {
+		__m128 product = _mm_mul_ps(a, b);
+		__m128 sum = _mm_add_ss(product, Swizzle<1, 1, 1, 1>(product));
+		sum = _mm_add_ss(sum, Swizzle<2, 2, 2, 2>(product));
+		return Swizzle<0, 0, 0, 0>(sum);
+	}
 
-	result.m[3][3] = 1.0f / determinant *
-		(m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] + m.m[0][2] * m.m[1][0] * m.m[2][1]
-			- m.m[0][2] * m.m[1][1] * m.m[2][0] - m.m[0][1] * m.m[1][0] * m.m[2][2] - m.m[0][0] * m.m[1][2] * m.m[2][1]);
+	//アフィン行列(4列目が(0,0,0,1))の逆行列
+	//uniformScale が true の場合、上3x3が回転と一様スケールのみである前提で 転置 / スケール² として求める
+	Matrix4x4 InverseAffineImpl(const Matrix4x4& m, bool uniformScale) {
+		assert(std::abs(m.m[0][3]) < 1.0e-4f && std::abs(m.m[1][3]) < 1.0e-4f && std::abs(m.m[2][3]) < 1.0e-4f);
+		assert(std::abs(m.m[3][3] - 1.0f) < 1.0e-4f);
+
+		//4要素目を0にした各行
+		const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		const __m128 row0 = _mm_and_ps(_mm_loadu_ps(m.m[0]), xyzMask);
+		const __m128 row1 = _mm_and_ps(_mm_loadu_ps(m.m[1]), xyzMask);
+		const __m128 row2 = _mm_and_ps(_mm_loadu_ps(m.m[2]), xyzMask);
+		const __m128 translate = _mm_and_ps(_mm_loadu_ps(m.m[3]), xyzMask);
+
+		//上3x3の逆行列を転置したもの(各行が逆行列の列)
+		__m128 column0, column1, column2;
+		if (uniformScale) {
+			__m128 inverseScaleSq = _mm_div_ps(_mm_set1_ps(1.0f), Dot3(row0, row0));
+			column0 = _mm_mul_ps(row0, inverseScaleSq);
+			column1 = _mm_mul_ps(row1, inverseScaleSq);
+			column2 = _mm_mul_ps(row2, inverseScaleSq);
+		} else {
+			//余因子(行同士の外積)を行列式で割る
+			column0 = Cross3(row1, row2);
+			column1 = Cross3(row2, row0);
+			column2 = Cross3(row0, row1);
+			__m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), Dot3(row0, column0));
+			column0 = _mm_mul_ps(column0, inverseDeterminant);
+			column1 = _mm_mul_ps(column1, inverseDeterminant);
+			column2 = _mm_mul_ps(column2, inverseDeterminant);
+		}
 
-	return result;
+		//転置して上3x3の逆行列にする
+		__m128 column3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+		//平行移動成分 = -t * (上3x3の逆行列)
+		__m128 inverseTranslate = _mm_mul_ps(Swizzle<0, 0, 0, 0>(translate), column0);
+		inverseTranslate = _mm_add_ps(inverseTranslate, _mm_mul_ps(Swizzle<1, 1, 1, 1>(translate), column1));
+		inverseTranslate = _mm_add_ps(inverseTranslate, _mm_mul_ps(Swizzle<2, 2, 2, 2>(translate), column2));
+		inverseTranslate = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), inverseTranslate);
+
+		Matrix4x4 result;
+		_mm_storeu_ps(result.m[0], column0);
+		_mm_storeu_ps(result.m[1], column1);
+		_mm_storeu_ps(result.m[2], column2);
+		_mm_storeu_ps(result.m[3], inverseTranslate);
+		return result;
+	}
 }
 
 //============================================================================
-//転置行列
+//逆行列
+// 4x4行列を2x2の小行列 | A B | に分けたブロック行列の公式で求める
+//                      | C D |
 //============================================================================
-Matrix4x4 MatrixMath::Transpose(const Matrix4x4& m) {
+Matrix4x4 MatrixMath::Inverse(const Matrix4x4& m) {
+	const __m128 row0 = _mm_loadu_ps(m.m[0]);
+	const __m128 row1 = _mm_loadu_ps(m.m[1]);
+	const __m128 row2 = _mm_loadu_ps(m.m[2]);
+	const __m128 row3 = _mm_loadu_ps(m.m[3]);
+
+	//小行列
+	__m128 a = _mm_movelh_ps(row0, row1);
+	__m128 b = _mm_movehl_ps(row1, row0);
+	__m128 c = _mm_movelh_ps(row2, row3);
+	__m128 d = _mm_movehl_ps(row3, row2);
+
+	//小行列の行列式 (|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)),
+		_mm_mul_ps(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3)));
+	__m128 detA = Swizzle<0, 0, 0, 0>(detSub);
+	__m128 detB = Swizzle<1, 1, 1, 1>(detSub);
+	__m128 detC = Swizzle<2, 2, 2, 2>(detSub);
+	__m128 detD = Swizzle<3, 3, 3, 3>(detSub);
+
+	//逆行列を 1/|M| * | X Y | としたときの各小行列の余因子行列
+	//                 | Z W |
+	__m128 adjDC = Mat2AdjMul(d, c);
+	__m128 adjAB = Mat2AdjMul(a, b);
+	__m128 adjX = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, adjDC));
+	__m128 adjW = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, adjAB));
+	__m128 adjY = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, adjAB));
+	__m128 adjZ = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, adjDC));
+
+	//|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 trace = _mm_mul_ps(adjAB, Swizzle<0, 2, 1, 3>(adjDC));
+	trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+	trace = _mm_add_ps(trace, Swizzle<1, 1, 1, 1>(trace));
+	trace = Swizzle<0, 0, 0, 0>(trace);
+	__m128 determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+	//余因子行列の符号と 1/|M| をまとめて掛ける
+	__m128 reciprocal = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+	adjX = _mm_mul_ps(adjX, reciprocal);
+	adjY = _mm_mul_ps(adjY, reciprocal);
+	adjZ = _mm_mul_ps(adjZ, reciprocal);
+	adjW = _mm_mul_ps(adjW, reciprocal);
+
+	//余因子行列への並べ替えと行への格納を同時に行う
 	Matrix4x4 result;
-
-	__m128 row0 = _mm_loadu_ps(m.m[0]);
-	__m128 row1 = _mm_loadu_ps(m.m[1]);
-	__m128 row2 = _mm_loadu_ps(m.m[2]);
-	__m128 row3 = _mm_loadu_ps(m.m[3]);
-
-	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
-
-	_mm_storeu_ps(result.m[0], row0);
-	_mm_storeu_ps(result.m[1], row1);
-	_mm_storeu_ps(result.m[2], row2);
-	_mm_storeu_ps(result.m[3], row3);
-
+	_mm_storeu_ps(result.m[0], Shuffle<3, 1, 3, 1>(adjX, adjY));
+	_mm_storeu_ps(result.m[1], Shuffle<2, 0, 2, 0>(adjX, adjY));
+	_mm_storeu_ps(result.m[2], Shuffle<3, 1, 3, 1>(adjZ, adjW));
+	_mm_storeu_ps(result.m[3], Shuffle<2, 0, 2, 0>(adjZ, adjW));
 	return result;
 }
 
@@ -444,41 +452,41 @@ Matrix4x4 MatrixMath::MakeViewportMatrix(float left, float top, float width, flo
 }
 
 //============================================================================
-//Matrix4x4からVector3に座標変換
+//逆転置行列
 //============================================================================
-Vector3 MatrixMath::Transform(const Vector3& vector, const Matrix4x4& matrix) {
-	Vector3 result;
-	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
-	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
-	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
-	float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
-	assert(w != 0.0f);
-	result.x /= w;
-	result.y /= w;
-	result.z /= w;
+Matrix4x4 MatrixMath::InverseTranspose(const Matrix4x4& m) {
+
+	Matrix4x4 result = Inverse(m);
+	result = Transpose(result);
 	return result;
 }
 
 //============================================================================
-//Matrix4x4からVector3に法線変換
+//アフィン行列の逆行列
 //============================================================================
-Vector3 MatrixMath::TransformNormal(const Vector3& v, const Matrix4x4& matrix) {
-	Vector3 result;
-	result.x = v.x * matrix.m[0][0] + v.y * matrix.m[1][0] + v.z * matrix.m[2][0];
-	result.y = v.x * matrix.m[0][1] + v.y * matrix.m[1][1] + v.z * matrix.m[2][1];
-	result.z = v.x * matrix.m[0][2] + v.y * matrix.m[1][2] + v.z * matrix.m[2][2];
+Matrix4x4 MatrixMath::InverseAffine(const Matrix4x4& m) {
+	return InverseAffineImpl(m, false);
+}
 
-	return result;
+//============================================================================
+//回転・一様スケール・平行移動のみのアフィン行列の逆行列
+//============================================================================
+Matrix4x4 MatrixMath::InverseAffineUniformScale(const Matrix4x4& m) {
+	return InverseAffineImpl(m, true);
 }
 
 //============================================================================
-//逆転置行列
+//アフィン行列の逆転置行列
 //============================================================================
-Matrix4x4 MatrixMath::InverseTranspose(const Matrix4x4& m) {
+Matrix4x4 MatrixMath::InverseTransposeAffine(const Matrix4x4& m) {
+	return Transpose(InverseAffineImpl(m, false));
+}
 
-	Matrix4x4 result = Inverse(m);
-	result = Transpose(result);
-	return result;
+//============================================================================
+//回転・一様スケール・平行移動のみのアフィン行列の逆転置行列
+//============================================================================
+Matrix4x4 MatrixMath::InverseTransposeAffineUniformScale(const Matrix4x4& m) {
+	return Transpose(InverseAffineImpl(m, true));
 }
 
 //============================================================================
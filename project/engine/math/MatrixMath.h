@@ -1,7 +1,10 @@
+#pragma once
 #include "engine/math/Vector3.h"
 #include "engine/math/Matrix4x4.h"
 #include "engine/math/Quaternion.h"
 #include "engine/math/Transform.h"
+#include <cassert>
+#include <xmmintrin.h>
 
 //============================================================================
 // MatrixMath namespace
@@ -75,6 +78,13 @@ namespace MatrixMath {
 	//InverseTranspose
 	Matrix4x4 InverseTranspose(const Matrix4x4& m);
 
+	//アフィン行列(4列目が(0,0,0,1))専用の逆行列・逆転置行列
+	Matrix4x4 InverseAffine(const Matrix4x4& m);
+	Matrix4x4 InverseTransposeAffine(const Matrix4x4& m);
+	//回転・一様スケール・平行移動のみで構成されたアフィン行列専用(転置/スケール²で求める)
+	Matrix4x4 InverseAffineUniformScale(const Matrix4x4& m);
+	Matrix4x4 InverseTransposeAffineUniformScale(const Matrix4x4& m);
+
 	//ある方向からある方向へ向ける回転行列
 	Matrix4x4 DirectionToDirection(const Vector3& from, const Vector3& to);
 	//ある位置からある位置へ向ける回転行列
@@ -82,4 +92,62 @@ namespace MatrixMath {
 
 	//行列からスケール成分を除去する
 	Matrix4x4 RemoveScale(const Matrix4x4& m);
-};
\ No newline at end of file
+};
+
+//============================================================================
+// 毎フレーム大量に呼ばれる演算はヘッダ内で定義してインライン展開させる
+//============================================================================
+
+//行列の加法
+inline Matrix4x4 MatrixMath::Add(const Matrix4x4& m1, const Matrix4x4& m2) {
+	return m1 + m2;
+}
+
+//行列の減法
+inline Matrix4x4 MatrixMath::Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
+	return m1 - m2;
+}
+
+//行列の積
+inline Matrix4x4 MatrixMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	return m1 * m2;
+}
+
+//転置行列
+inline Matrix4x4 MatrixMath::Transpose(const Matrix4x4& m) {
+	__m128 row0 = _mm_loadu_ps(m.m[0]);
+	__m128 row1 = _mm_loadu_ps(m.m[1]);
+	__m128 row2 = _mm_loadu_ps(m.m[2]);
+	__m128 row3 = _mm_loadu_ps(m.m[3]);
+
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+	Matrix4x4 result;
+	_mm_storeu_ps(result.m[0], row0);
+	_mm_storeu_ps(result.m[1], row1);
+	_mm_storeu_ps(result.m[2], row2);
+	_mm_storeu_ps(result.m[3], row3);
+	return result;
+}
+
+//Matrix4x4からVector3に座標変換
+inline Vector3 MatrixMath::Transform(const Vector3& vector, const Matrix4x4& matrix) {
+	__m128 r = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+	r = _mm_add_ps(r, _mm_loadu_ps(matrix.m[3]));
+
+	alignas(16) float xyzw[4];
+	_mm_store_ps(xyzw, r);
+	assert(xyzw[3] != 0.0f);
+	return { xyzw[0] / xyzw[3], xyzw[1] / xyzw[3], xyzw[2] / xyzw[3] };
+}
+
+//Matrix4x4からVector3に回転とスケーリングのみ反映
+inline Vector3 MatrixMath::TransformNormal(const Vector3& v, const Matrix4x4& matrix) {
+	return {
+		v.x * matrix.m[0][0] + v.y * matrix.m[1][0] + v.z * matrix.m[2][0],
+		v.x * matrix.m[0][1] + v.y * matrix.m[1][1] + v.z * matrix.m[2][1],
+		v.x * matrix.m[0][2] + v.y * matrix.m[1][2] + v.z * matrix.m[2][2]
+	};
+}
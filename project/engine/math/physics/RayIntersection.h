@@ -0,0 +1,105 @@
+#pragma once
+#include "engine/math/physics/Ray.h"
+#include "engine/math/physics/RayPacket.h"
+#include "engine/math/OBB.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+//=============================================================================
+// RayIntersection.h
+//=============================================================================
+
+/// <summary>
+/// レイと形状のスカラーの交差判定と、パケットのレーンごとの最近ヒットの更新です。
+/// BoxCollider/SphereCollider のレイ判定と CollisionManager::RayCastBatch が共通で使います。
+/// </summary>
+namespace RayIntersection {
+
+	/// <summary>
+	/// レイとOBBの交差判定(スラブ法)
+	/// </summary>
+	/// <param name="ray">判定するレイ(距離は見ない)</param>
+	/// <param name="obb">判定するOBB</param>
+	/// <param name="outDistance">突入距離(始点がOBBの内部なら負の値)</param>
+	/// <returns>交差するか</returns>
+	inline bool IntersectOBB(const Ray& ray, const OBB& obb, float& outDistance) {
+		// レイをOBBのローカル座標系に変換する
+		Vector3 diff = ray.origin - obb.center;
+		Vector3 localOrigin = { diff.Dot(obb.axis[0]), diff.Dot(obb.axis[1]), diff.Dot(obb.axis[2]) };
+		Vector3 localDirection = {
+			ray.direction.Dot(obb.axis[0]),
+			ray.direction.Dot(obb.axis[1]),
+			ray.direction.Dot(obb.axis[2])
+		};
+
+		// ゼロ除算対策を含めた逆数計算
+		Vector3 invDir;
+		invDir.x = (std::abs(localDirection.x) < 1e-6f) ? 1e20f : 1.0f / localDirection.x;
+		invDir.y = (std::abs(localDirection.y) < 1e-6f) ? 1e20f : 1.0f / localDirection.y;
+		invDir.z = (std::abs(localDirection.z) < 1e-6f) ? 1e20f : 1.0f / localDirection.z;
+
+		Vector3 tMin = (-obb.halfSize - localOrigin) * invDir;
+		Vector3 tMax = (obb.halfSize - localOrigin) * invDir;
+
+		// 最も遅い突入時間と、最も早い脱出時間を求める
+		float tNear = (std::max)((std::max)((std::min)(tMin.x, tMax.x), (std::min)(tMin.y, tMax.y)), (std::min)(tMin.z, tMax.z));
+		float tFar = (std::min)((std::min)((std::max)(tMin.x, tMax.x), (std::max)(tMin.y, tMax.y)), (std::max)(tMin.z, tMax.z));
+		if (tNear > tFar || tFar < 0) {
+			return false;
+		}
+		outDistance = tNear;
+		return true;
+	}
+
+	/// <summary>
+	/// レイと球の交差判定
+	/// </summary>
+	/// <param name="ray">判定するレイ</param>
+	/// <param name="center">球の中心</param>
+	/// <param name="radius">球の半径</param>
+	/// <param name="outDistance">0～ray.distance の範囲の解のうち近い方</param>
+	/// <returns>交差するか</returns>
+	inline bool IntersectSphere(const Ray& ray, const Vector3& center, float radius, float& outDistance) {
+		Vector3 oc = ray.origin - center; // 球の中心からレイの始点までのベクトル
+		float a = ray.direction.Dot(ray.direction);
+		float b = 2.0f * oc.Dot(ray.direction);
+		float c = oc.Dot(oc) - radius * radius;
+		float discriminant = b * b - 4 * a * c;
+		if (discriminant < 0) return false;
+
+		float sqrtDiscriminant = std::sqrt(discriminant);
+		float t = (-b - sqrtDiscriminant) / (2.0f * a);
+		if (t < 0 || t > ray.distance) t = (-b + sqrtDiscriminant) / (2.0f * a); // 手前の解が範囲外なら奥の解を使う
+		if (t < 0 || t > ray.distance) return false;
+		outDistance = t;
+		return true;
+	}
+
+	/// <summary>
+	/// BVHの候補1つに対する、パケットのレーンごとの最近ヒットの更新
+	/// laneMask のレーンだけスカラーの判定を行い、最近ヒットより近ければ距離を更新してパケットの判定距離を縮める
+	/// </summary>
+	/// <param name="packet">判定中のパケット</param>
+	/// <param name="rays">パケットに読み込んだレイ</param>
+	/// <param name="laneMask">BVHと形状ごとのSIMD判定で残ったレーン</param>
+	/// <param name="closestDistance">レーンごとの最近ヒット距離</param>
+	/// <param name="intersect">bool(size_t lane, float& outDistance) のスカラーの判定</param>
+	/// <returns>最近ヒットを更新したレーン</returns>
+	template<typename IntersectFunc>
+	inline int UpdateClosestHits(RayPacket& packet, std::span<const Ray> rays, int laneMask, float* closestDistance, IntersectFunc&& intersect) {
+		int updatedMask = 0;
+		for (size_t lane = 0; lane < rays.size(); ++lane) {
+			if (!(laneMask & (1 << lane))) continue;
+
+			float distance = 0.0f;
+			if (intersect(lane, distance) && distance < closestDistance[lane]) {
+				closestDistance[lane] = distance;
+				// 始点がボックス内部だと負の距離になり得るため、走査範囲は0未満にしない
+				packet.maxDistance[lane] = (std::max)(distance, 0.0f);
+				updatedMask |= 1 << lane;
+			}
+		}
+		return updatedMask;
+	}
+}
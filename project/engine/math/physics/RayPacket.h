@@ -0,0 +1,197 @@
+#pragma once
+#include "engine/math/physics/Ray.h"
+#include "engine/math/AABB.h"
+#include "engine/math/OBB.h"
+#include <xmmintrin.h>
+#include <cstdint>
+#include <span>
+
+//=============================================================================
+// RayPacket.h
+//=============================================================================
+
+/// <summary>
+/// 4本のレイをSSEのレーンにまとめたパケットです。
+/// 各判定はレーンごとのヒット有無をビットマスク(bit i = i本目のレイ)で返します。
+/// ここでの判定は候補の絞り込み用で、境界付近は ε 分だけ広めに判定します。
+/// </summary>
+struct RayPacket {
+
+	static constexpr int kLaneCount = 4;
+	static constexpr int kAllLanes = (1 << kLaneCount) - 1;
+
+	__m128 originX, originY, originZ;
+	__m128 directionX, directionY, directionZ;
+	alignas(16) float maxDistance[kLaneCount]; // レーンごとの判定距離(無効レーンは負値)
+	int activeMask = 0;                        // 有効なレーン
+
+	/// <summary>
+	/// 最大4本のレイの読み込み。足りないレーンは無効レーンになる
+	/// </summary>
+	void Load(std::span<const Ray> rays);
+
+	/// <summary>
+	/// AABBとの判定
+	/// </summary>
+	int OverlapAABB(const AABB& bounds) const;
+
+	/// <summary>
+	/// OBBとの判定
+	/// </summary>
+	int OverlapOBB(const OBB& obb) const;
+
+	/// <summary>
+	/// 球との判定
+	/// </summary>
+	int OverlapSphere(const Vector3& center, float radius) const;
+
+private:
+
+	//境界判定の許容誤差
+	static constexpr float kEpsilon_ = 1.0e-3f;
+
+	//ほぼ0の成分を大きな値に置き換えた逆数
+	static __m128 SafeReciprocal(__m128 v);
+	//スラブ判定の共通部分
+	int SlabTest(__m128 localOriginX, __m128 localOriginY, __m128 localOriginZ,
+		__m128 localDirectionX, __m128 localDirectionY, __m128 localDirectionZ,
+		const float boxMin[3], const float boxMax[3]) const;
+};
+
+//---------------------------------------------------------------------------------
+// レイの読み込み
+//---------------------------------------------------------------------------------
+inline void RayPacket::Load(std::span<const Ray> rays) {
+	alignas(16) float ox[kLaneCount] = {}, oy[kLaneCount] = {}, oz[kLaneCount] = {};
+	alignas(16) float dx[kLaneCount] = {}, dy[kLaneCount] = {}, dz[kLaneCount] = {};
+
+	activeMask = 0;
+	for (int lane = 0; lane < kLaneCount; ++lane) {
+		if (lane < static_cast<int>(rays.size())) {
+			const Ray& ray = rays[lane];
+			ox[lane] = ray.origin.x;
+			oy[lane] = ray.origin.y;
+			oz[lane] = ray.origin.z;
+			dx[lane] = ray.direction.x;
+			dy[lane] = ray.direction.y;
+			dz[lane] = ray.direction.z;
+			maxDistance[lane] = ray.distance;
+			activeMask |= 1 << lane;
+		} else {
+			maxDistance[lane] = -1.0f;
+		}
+	}
+
+	originX = _mm_load_ps(ox);
+	originY = _mm_load_ps(oy);
+	originZ = _mm_load_ps(oz);
+	directionX = _mm_load_ps(dx);
+	directionY = _mm_load_ps(dy);
+	directionZ = _mm_load_ps(dz);
+}
+
+//---------------------------------------------------------------------------------
+// ほぼ0の成分を大きな値に置き換えた逆数(スカラー版のスラブ判定と同じ扱い)
+//---------------------------------------------------------------------------------
+inline __m128 RayPacket::SafeReciprocal(__m128 v) {
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	__m128 absV = _mm_andnot_ps(signMask, v);
+	__m128 nearZero = _mm_cmplt_ps(absV, _mm_set1_ps(1e-6f));
+	__m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.0f), v);
+	return _mm_or_ps(_mm_and_ps(nearZero, _mm_set1_ps(1e20f)), _mm_andnot_ps(nearZero, reciprocal));
+}
+
+//---------------------------------------------------------------------------------
+// スラブ判定の共通部分
+//---------------------------------------------------------------------------------
+inline int RayPacket::SlabTest(__m128 localOriginX, __m128 localOriginY, __m128 localOriginZ,
+	__m128 localDirectionX, __m128 localDirectionY, __m128 localDirectionZ,
+	const float boxMin[3], const float boxMax[3]) const {
+
+	__m128 invX = SafeReciprocal(localDirectionX);
+	__m128 invY = SafeReciprocal(localDirectionY);
+	__m128 invZ = SafeReciprocal(localDirectionZ);
+
+	__m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[0]), localOriginX), invX);
+	__m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[0]), localOriginX), invX);
+	__m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[1]), localOriginY), invY);
+	__m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[1]), localOriginY), invY);
+	__m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin[2]), localOriginZ), invZ);
+	__m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax[2]), localOriginZ), invZ);
+
+	__m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_min_ps(t1z, t2z));
+	__m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_max_ps(t1z, t2z));
+
+	// 始点より後ろで交差し、かつ判定距離より手前から入っている
+	__m128 maxT = _mm_load_ps(maxDistance);
+	__m128 hit = _mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmpge_ps(tFar, _mm_setzero_ps()));
+	hit = _mm_and_ps(hit, _mm_cmple_ps(tNear, maxT));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(maxT, _mm_setzero_ps()));
+
+	return _mm_movemask_ps(hit) & activeMask;
+}
+
+//---------------------------------------------------------------------------------
+// AABBとの判定
+//---------------------------------------------------------------------------------
+inline int RayPacket::OverlapAABB(const AABB& bounds) const {
+	const float boxMin[3] = { bounds.min.x - kEpsilon_, bounds.min.y - kEpsilon_, bounds.min.z - kEpsilon_ };
+	const float boxMax[3] = { bounds.max.x + kEpsilon_, bounds.max.y + kEpsilon_, bounds.max.z + kEpsilon_ };
+	return SlabTest(originX, originY, originZ, directionX, directionY, directionZ, boxMin, boxMax);
+}
+
+//---------------------------------------------------------------------------------
+// OBBとの判定(レイをOBBのローカル座標系へ変換してスラブ判定)
+//---------------------------------------------------------------------------------
+inline int RayPacket::OverlapOBB(const OBB& obb) const {
+	__m128 diffX = _mm_sub_ps(originX, _mm_set1_ps(obb.center.x));
+	__m128 diffY = _mm_sub_ps(originY, _mm_set1_ps(obb.center.y));
+	__m128 diffZ = _mm_sub_ps(originZ, _mm_set1_ps(obb.center.z));
+
+	__m128 localOrigin[3];
+	__m128 localDirection[3];
+	for (int i = 0; i < 3; ++i) {
+		__m128 axisX = _mm_set1_ps(obb.axis[i].x);
+		__m128 axisY = _mm_set1_ps(obb.axis[i].y);
+		__m128 axisZ = _mm_set1_ps(obb.axis[i].z);
+		localOrigin[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(diffX, axisX), _mm_mul_ps(diffY, axisY)), _mm_mul_ps(diffZ, axisZ));
+		localDirection[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, axisX), _mm_mul_ps(directionY, axisY)), _mm_mul_ps(directionZ, axisZ));
+	}
+
+	const float boxMax[3] = { obb.halfSize.x + kEpsilon_, obb.halfSize.y + kEpsilon_, obb.halfSize.z + kEpsilon_ };
+	const float boxMin[3] = { -boxMax[0], -boxMax[1], -boxMax[2] };
+	return SlabTest(localOrigin[0], localOrigin[1], localOrigin[2],
+		localDirection[0], localDirection[1], localDirection[2], boxMin, boxMax);
+}
+
+//---------------------------------------------------------------------------------
+// 球との判定
+//---------------------------------------------------------------------------------
+inline int RayPacket::OverlapSphere(const Vector3& center, float radius) const {
+	__m128 ocX = _mm_sub_ps(originX, _mm_set1_ps(center.x));
+	__m128 ocY = _mm_sub_ps(originY, _mm_set1_ps(center.y));
+	__m128 ocZ = _mm_sub_ps(originZ, _mm_set1_ps(center.z));
+
+	float expandedRadius = radius + kEpsilon_;
+	__m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, directionX), _mm_mul_ps(directionY, directionY)), _mm_mul_ps(directionZ, directionZ));
+	__m128 halfB = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocX, directionX), _mm_mul_ps(ocY, directionY)), _mm_mul_ps(ocZ, directionZ));
+	__m128 c = _mm_sub_ps(
+		_mm_add_ps(_mm_add_ps(_mm_mul_ps(ocX, ocX), _mm_mul_ps(ocY, ocY)), _mm_mul_ps(ocZ, ocZ)),
+		_mm_set1_ps(expandedRadius * expandedRadius));
+
+	// 判別式(b/2形式)
+	__m128 discriminant = _mm_sub_ps(_mm_mul_ps(halfB, halfB), _mm_mul_ps(a, c));
+	__m128 hit = _mm_cmpge_ps(discriminant, _mm_setzero_ps());
+
+	// 遠い方の解が始点より後ろ、近い方の解が判定距離より手前
+	__m128 sqrtDiscriminant = _mm_sqrt_ps(_mm_max_ps(discriminant, _mm_setzero_ps()));
+	__m128 negHalfB = _mm_sub_ps(_mm_setzero_ps(), halfB);
+	__m128 tFarScaled = _mm_add_ps(negHalfB, sqrtDiscriminant);  // t2 * a
+	__m128 tNearScaled = _mm_sub_ps(negHalfB, sqrtDiscriminant); // t1 * a
+	__m128 maxT = _mm_load_ps(maxDistance);
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(tFarScaled, _mm_setzero_ps()));
+	hit = _mm_and_ps(hit, _mm_cmple_ps(tNearScaled, _mm_mul_ps(maxT, a)));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(maxT, _mm_setzero_ps()));
+
+	return _mm_movemask_ps(hit) & activeMask;
+}
@@ -0,0 +1,297 @@
+#include "TestFramework.h"
+#include "engine/Animation/AnimationClipFile.h"
+#include "engine/Animation/Animator.h"
+#include "engine/Utility/ResourcePath.h"
+#include "engine/math/FastRandom.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// AnimationClipFile のテスト
+//============================================================================
+// 焼き込んだクリップは Assimp の読み込み結果(秒・左手系に変換済み)をそのまま保存したものなので、
+// 読み戻した結果は Assimp で読み込んだ結果とビット単位で一致しなければならない。
+// テスト用のglTFを一時ディレクトリに書き出し、AnimationManager::LoadAnimationFile の
+// Assimp経由の読み込みと焼き込み済みファイルからの読み込みを比較する。
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	using AnimationMap = std::map<std::string, Animation*>;
+
+	//テスト用のファイルを置くディレクトリ
+	fs::path GetTestDirectory() {
+		return fs::temp_directory_path() / "TakeCEngineTests" / "AnimationClipFile";
+	}
+
+	/// <summary>
+	/// テスト中だけゲームリソースのルートを差し替える
+	/// </summary>
+	struct ScopedGameRoot {
+		explicit ScopedGameRoot(const fs::path& root) : previous(ResourcePath::GetGameRoot()) {
+			ResourcePath::SetGameRoot(root);
+		}
+		~ScopedGameRoot() { ResourcePath::SetGameRoot(previous); }
+		fs::path previous;
+	};
+
+	//読み込んだアニメーションの解放
+	void DeleteAnimations(AnimationMap& animations) {
+		for (auto& [name, animation] : animations) {
+			delete animation;
+		}
+		animations.clear();
+	}
+
+	//キーフレーム配列がビット単位で一致するか
+	template<typename T>
+	bool IsSameKeyframes(const std::vector<Keyframe<T>>& a, const std::vector<Keyframe<T>>& b) {
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), sizeof(Keyframe<T>) * a.size()) == 0);
+	}
+
+	//2つの読み込み結果の比較(serialは読み込み毎に異なるので比較しない)
+	void CheckSameAnimations(const AnimationMap& actual, const AnimationMap& expected) {
+		TAKEC_CHECK_EQ(actual.size(), expected.size());
+		for (const auto& [name, expectedAnimation] : expected) {
+			auto it = actual.find(name);
+			TAKEC_CHECK(it != actual.end());
+			if (it == actual.end()) continue;
+
+			const Animation& a = *it->second;
+			const Animation& e = *expectedAnimation;
+			TAKEC_CHECK_EQ(a.name, e.name);
+			TAKEC_CHECK_EQ(a.duration, e.duration);
+			TAKEC_CHECK_EQ(a.nodeAnimations.size(), e.nodeAnimations.size());
+			for (const auto& [nodeName, expectedNode] : e.nodeAnimations) {
+				auto nodeIt = a.nodeAnimations.find(nodeName);
+				TAKEC_CHECK(nodeIt != a.nodeAnimations.end());
+				if (nodeIt == a.nodeAnimations.end()) continue;
+
+				TAKEC_CHECK(IsSameKeyframes(nodeIt->second.translate.keyframes, expectedNode.translate.keyframes));
+				TAKEC_CHECK(IsSameKeyframes(nodeIt->second.rotate.keyframes, expectedNode.rotate.keyframes));
+				TAKEC_CHECK(IsSameKeyframes(nodeIt->second.scale.keyframes, expectedNode.scale.keyframes));
+			}
+		}
+	}
+
+	//Base64への変換(glTFのdata URI用)
+	std::string EncodeBase64(const std::vector<uint8_t>& data) {
+		static const char* kTable = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string encoded;
+		for (size_t i = 0; i < data.size(); i += 3) {
+			uint32_t value = static_cast<uint32_t>(data[i]) << 16;
+			if (i + 1 < data.size()) value |= static_cast<uint32_t>(data[i + 1]) << 8;
+			if (i + 2 < data.size()) value |= static_cast<uint32_t>(data[i + 2]);
+			encoded += kTable[(value >> 18) & 63];
+			encoded += kTable[(value >> 12) & 63];
+			encoded += (i + 1 < data.size()) ? kTable[(value >> 6) & 63] : '=';
+			encoded += (i + 2 < data.size()) ? kTable[value & 63] : '=';
+		}
+		return encoded;
+	}
+
+	/// <summary>
+	/// テスト用glTFのキーフレーム(glTFの右手系の値)
+	/// </summary>
+	struct SourceClip {
+		std::array<float, 3> walkTimes = { 0.0f, 0.5f, 1.0f };
+		std::array<float, 2> waveTimes = { 0.0f, 0.25f };
+		std::array<float, 9> rootTranslations = { 0.0f, 0.0f, 0.0f, 1.0f, 0.5f, -2.0f, 3.0f, 1.0f, -4.0f };
+		std::array<float, 12> armRotations = {
+			0.0f, 0.0f, 0.0f, 1.0f,
+			0.0f, 0.6f, 0.0f, 0.8f,
+			0.48f, 0.0f, 0.6f, 0.64f };
+		std::array<float, 6> armScales = { 1.0f, 1.0f, 1.0f, 2.0f, 0.5f, 1.5f };
+	};
+
+	//アニメーション2つ(移動・回転のWalk、拡縮のWave)を持つglTFの書き出し
+	void WriteSourceGltf(const fs::path& path, const SourceClip& clip) {
+		std::vector<uint8_t> buffer;
+		auto append = [&buffer](const float* data, size_t count) {
+			size_t offset = buffer.size();
+			buffer.resize(offset + sizeof(float) * count);
+			std::memcpy(buffer.data() + offset, data, sizeof(float) * count);
+			return std::to_string(offset);
+		};
+		const std::string walkTimesOffset = append(clip.walkTimes.data(), clip.walkTimes.size());
+		const std::string waveTimesOffset = append(clip.waveTimes.data(), clip.waveTimes.size());
+		const std::string translationOffset = append(clip.rootTranslations.data(), clip.rootTranslations.size());
+		const std::string rotationOffset = append(clip.armRotations.data(), clip.armRotations.size());
+		const std::string scaleOffset = append(clip.armScales.data(), clip.armScales.size());
+
+		std::string json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],)";
+		json += R"("nodes":[{"name":"Root","children":[1]},{"name":"Arm","translation":[0,1,0]}],)";
+		json += R"("buffers":[{"byteLength":)" + std::to_string(buffer.size()) +
+			R"(,"uri":"data:application/octet-stream;base64,)" + EncodeBase64(buffer) + R"("}],)";
+		json += R"("bufferViews":[)";
+		json += R"({"buffer":0,"byteOffset":)" + walkTimesOffset + R"(,"byteLength":12},)";
+		json += R"({"buffer":0,"byteOffset":)" + waveTimesOffset + R"(,"byteLength":8},)";
+		json += R"({"buffer":0,"byteOffset":)" + translationOffset + R"(,"byteLength":36},)";
+		json += R"({"buffer":0,"byteOffset":)" + rotationOffset + R"(,"byteLength":48},)";
+		json += R"({"buffer":0,"byteOffset":)" + scaleOffset + R"(,"byteLength":24}],)";
+		json += R"("accessors":[)";
+		json += R"({"bufferView":0,"componentType":5126,"count":3,"type":"SCALAR","min":[0],"max":[1]},)";
+		json += R"({"bufferView":1,"componentType":5126,"count":2,"type":"SCALAR","min":[0],"max":[0.25]},)";
+		json += R"({"bufferView":2,"componentType":5126,"count":3,"type":"VEC3"},)";
+		json += R"({"bufferView":3,"componentType":5126,"count":3,"type":"VEC4"},)";
+		json += R"({"bufferView":4,"componentType":5126,"count":2,"type":"VEC3"}],)";
+		json += R"("animations":[)";
+		json += R"({"name":"Walk","samplers":[{"input":0,"output":2,"interpolation":"LINEAR"},{"input":0,"output":3,"interpolation":"LINEAR"}],)";
+		json += R"("channels":[{"sampler":0,"target":{"node":0,"path":"translation"}},{"sampler":1,"target":{"node":1,"path":"rotation"}}]},)";
+		json += R"({"name":"Wave","samplers":[{"input":1,"output":4,"interpolation":"LINEAR"}],)";
+		json += R"("channels":[{"sampler":0,"target":{"node":1,"path":"scale"}}]}]})";
+
+		fs::create_directories(path.parent_path());
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << json;
+	}
+
+	//ランダムなキーフレームを持つアニメーションの生成
+	Animation* MakeRandomAnimation(FastRandom& random, const std::string& name, uint32_t nodeCount) {
+		Animation* animation = new Animation();
+		animation->name = name;
+		animation->duration = random.NextFloat(0.5f, 5.0f);
+		for (uint32_t node = 0; node < nodeCount; ++node) {
+			NodeAnimation& nodeAnimation = animation->nodeAnimations["Node" + std::to_string(node)];
+			//チャンネル毎にキーフレーム数を変える(0個のチャンネルも含める)
+			const uint32_t translateCount = random.NextUInt() % 40;
+			const uint32_t rotateCount = random.NextUInt() % 40;
+			const uint32_t scaleCount = random.NextUInt() % 3;
+			for (uint32_t i = 0; i < translateCount; ++i) {
+				nodeAnimation.translate.keyframes.push_back({ float(i) / 30.0f, { random.NextFloat(-5.0f, 5.0f), random.NextFloat(-5.0f, 5.0f), random.NextFloat(-5.0f, 5.0f) } });
+			}
+			for (uint32_t i = 0; i < rotateCount; ++i) {
+				nodeAnimation.rotate.keyframes.push_back({ float(i) / 30.0f, { random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f) } });
+			}
+			for (uint32_t i = 0; i < scaleCount; ++i) {
+				nodeAnimation.scale.keyframes.push_back({ float(i), { random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f) } });
+			}
+		}
+		return animation;
+	}
+}
+
+//============================================================================
+// Save → Load で全てのアニメーションがビット単位で戻る
+//============================================================================
+TAKEC_TEST(AnimationClipFile_SaveLoadRoundTrip) {
+	const fs::path path = GetTestDirectory() / "RoundTrip.anim";
+	const AnimationClipFile::SourceStamp stamp = { 1234, 5678 };
+
+	FastRandom random(31);
+	AnimationMap source;
+	source["Idle"] = MakeRandomAnimation(random, "Idle", 1);
+	source["Run"] = MakeRandomAnimation(random, "Run", 40);
+	source["Empty"] = MakeRandomAnimation(random, "Empty", 0);
+
+	TAKEC_CHECK(AnimationClipFile::Save(path, stamp, source));
+	AnimationMap loaded;
+	TAKEC_CHECK(AnimationClipFile::Load(path, stamp, loaded));
+	CheckSameAnimations(loaded, source);
+
+	DeleteAnimations(loaded);
+	DeleteAnimations(source);
+	fs::remove_all(GetTestDirectory());
+}
+
+//============================================================================
+// 元ファイルが変わった・壊れたファイルは読み込まず、追加先も変更しない
+//============================================================================
+TAKEC_TEST(AnimationClipFile_RejectsStaleOrBrokenFile) {
+	const fs::path path = GetTestDirectory() / "Stale.anim";
+	const AnimationClipFile::SourceStamp stamp = { 1234, 5678 };
+
+	FastRandom random(32);
+	AnimationMap source;
+	source["Run"] = MakeRandomAnimation(random, "Run", 8);
+	TAKEC_CHECK(AnimationClipFile::Save(path, stamp, source));
+
+	AnimationMap loaded;
+	TAKEC_CHECK(!AnimationClipFile::Load(path, { stamp.size + 1, stamp.writeTime }, loaded));
+	TAKEC_CHECK(!AnimationClipFile::Load(path, { stamp.size, stamp.writeTime + 1 }, loaded));
+	TAKEC_CHECK(!AnimationClipFile::Load(GetTestDirectory() / "Missing.anim", stamp, loaded));
+	TAKEC_CHECK(loaded.empty());
+
+	//末尾を切り詰めたファイル
+	fs::resize_file(path, fs::file_size(path) - 4);
+	TAKEC_CHECK(!AnimationClipFile::Load(path, stamp, loaded));
+	TAKEC_CHECK(loaded.empty());
+
+	DeleteAnimations(source);
+	fs::remove_all(GetTestDirectory());
+}
+
+//============================================================================
+// 焼き込んだクリップの読み込み結果が Assimp での読み込み結果と一致する
+//============================================================================
+TAKEC_TEST(AnimationClipFile_MatchesAssimpImport) {
+	const fs::path root = GetTestDirectory();
+	fs::remove_all(root);
+	ScopedGameRoot gameRoot(root);
+
+	const std::string fileName = "ClipTest.gltf";
+	const SourceClip clip;
+	WriteSourceGltf(ResourcePath::Game("Models") / fileName, clip);
+
+	//Assimpで読み込む(読み込みと同時に焼き込まれる)
+	AnimationMap imported = AnimationManager::LoadAnimationFile(fileName, false);
+	const fs::path bakedPath = AnimationManager::GetBakedClipPath(fileName);
+	TAKEC_CHECK_EQ(imported.size(), size_t{ 2 });
+	TAKEC_CHECK(fs::exists(bakedPath));
+
+	//左手系への変換(移動はxを、回転はy,zを反転)が済んでいること
+	const bool hasWalkChannels = imported.contains("Walk") &&
+		imported["Walk"]->nodeAnimations.contains("Root") && imported["Walk"]->nodeAnimations.contains("Arm");
+	TAKEC_CHECK(hasWalkChannels);
+	if (hasWalkChannels) {
+		const Animation& walk = *imported["Walk"];
+		TAKEC_CHECK_NEAR(walk.duration, 1.0f, 1.0e-6f);
+		const auto& translateKeys = walk.nodeAnimations.at("Root").translate.keyframes;
+		const auto& rotateKeys = walk.nodeAnimations.at("Arm").rotate.keyframes;
+		TAKEC_CHECK_EQ(translateKeys.size(), size_t{ 3 });
+		TAKEC_CHECK_EQ(rotateKeys.size(), size_t{ 3 });
+		for (size_t i = 0; i < translateKeys.size() && i < 3; ++i) {
+			TAKEC_CHECK_NEAR(translateKeys[i].time, clip.walkTimes[i], 1.0e-6f);
+			TAKEC_CHECK_NEAR(translateKeys[i].value.x, -clip.rootTranslations[i * 3 + 0], 1.0e-6f);
+			TAKEC_CHECK_NEAR(translateKeys[i].value.y, clip.rootTranslations[i * 3 + 1], 1.0e-6f);
+			TAKEC_CHECK_NEAR(translateKeys[i].value.z, clip.rootTranslations[i * 3 + 2], 1.0e-6f);
+		}
+		for (size_t i = 0; i < rotateKeys.size() && i < 3; ++i) {
+			TAKEC_CHECK_NEAR(rotateKeys[i].value.x, clip.armRotations[i * 4 + 0], 1.0e-6f);
+			TAKEC_CHECK_NEAR(rotateKeys[i].value.y, -clip.armRotations[i * 4 + 1], 1.0e-6f);
+			TAKEC_CHECK_NEAR(rotateKeys[i].value.z, -clip.armRotations[i * 4 + 2], 1.0e-6f);
+			TAKEC_CHECK_NEAR(rotateKeys[i].value.w, clip.armRotations[i * 4 + 3], 1.0e-6f);
+		}
+	}
+
+	//焼き込み済みのファイルからの読み込み
+	AnimationMap baked;
+	TAKEC_CHECK(AnimationClipFile::Load(bakedPath, AnimationClipFile::MakeSourceStamp(ResourcePath::Game("Models") / fileName), baked));
+	CheckSameAnimations(baked, imported);
+	DeleteAnimations(baked);
+
+	//LoadAnimationFile も焼き込み済みのファイルを使って同じ結果を返す
+	baked = AnimationManager::LoadAnimationFile(fileName);
+	CheckSameAnimations(baked, imported);
+	DeleteAnimations(baked);
+
+	//焼き込み済みのファイルが壊れていても、Assimpで読み込み直して焼き直す
+	fs::resize_file(bakedPath, sizeof(uint32_t));
+	baked = AnimationManager::LoadAnimationFile(fileName);
+	CheckSameAnimations(baked, imported);
+	TAKEC_CHECK(fs::file_size(bakedPath) > sizeof(uint32_t));
+	DeleteAnimations(baked);
+
+	DeleteAnimations(imported);
+	fs::remove_all(root);
+}
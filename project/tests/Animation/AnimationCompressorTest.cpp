@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+#include "engine/Animation/AnimationCompressor.h"
+#include "engine/Animation/Animator.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/Quaternion.h"
+#include "engine/math/Vector3Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <string>
+
+using namespace TakeC;
+
+//============================================================================
+// AnimationCompressor のテスト
+//============================================================================
+// 圧縮したカーブを AnimationManager::CalculateValue でサンプリングした結果が、
+// 圧縮前のサンプリング結果から設定した許容誤差以上ずれないことを確認する。
+// 実際のクリップと同じ性質(30fpsで焼いた周期的な回転・一定の区間・範囲の広いルートの移動・一定の拡縮)を
+// 持つ歩行アニメーションを作り、キーフレームの間も細かくサンプリングして比較する。
+
+namespace {
+
+	//サンプリングの誤差の許容値(floatの計算誤差の分)
+	constexpr float kSampleEpsilon = 1.0e-5f;
+	//キーフレームの間を分割してサンプリングする数
+	constexpr uint32_t kSamplesPerInterval = 8;
+
+	//距離
+	float Difference(const Vector3& v0, const Vector3& v1) {
+		return Vector3Math::Length(v0 - v1);
+	}
+	//なす角(q と -q は同じ回転。角度が小さいとacos(dot)の精度が足りないため、差の長さから求める)
+	float Difference(const Quaternion& q0, const Quaternion& q1) {
+		float sign = QuaternionMath::Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+		float dx = q0.x - q1.x * sign;
+		float dy = q0.y - q1.y * sign;
+		float dz = q0.z - q1.z * sign;
+		float dw = q0.w - q1.w * sign;
+		float chord = std::sqrt(dx * dx + dy * dy + dz * dz + dw * dw);
+		return 4.0f * std::asin(std::min(chord * 0.5f, 1.0f));
+	}
+
+	//圧縮前後のサンプリング結果の最大誤差(キーフレームの間も分割してサンプリングする)
+	template <typename T>
+	float MeasureMaxError(const AnimationCurve<T>& source, const AnimationCurve<T>& compressed, float duration) {
+		float maxError = 0.0f;
+		KeyframeCursor sourceCursor;
+		KeyframeCursor compressedCursor;
+		const uint32_t sampleCount = static_cast<uint32_t>(source.keyframes.size()) * kSamplesPerInterval;
+		for (uint32_t i = 0; i <= sampleCount; ++i) {
+			float time = duration * static_cast<float>(i) / static_cast<float>(sampleCount);
+			T expected = AnimationManager::CalculateValue(source, time, sourceCursor);
+			T actual = AnimationManager::CalculateValue(compressed, time, compressedCursor);
+			maxError = std::max(maxError, Difference(expected, actual));
+		}
+		return maxError;
+	}
+
+	/// <summary>
+	/// 全カーブの最大誤差
+	/// </summary>
+	struct MaxErrors {
+		float translate = 0.0f;
+		float rotate = 0.0f;
+		float scale = 0.0f;
+	};
+
+	MaxErrors MeasureMaxErrors(const Animation& source, const Animation& compressed) {
+		MaxErrors errors;
+		for (const auto& [nodeName, sourceNode] : source.nodeAnimations) {
+			const NodeAnimation& compressedNode = compressed.nodeAnimations.at(nodeName);
+			errors.translate = std::max(errors.translate, MeasureMaxError(sourceNode.translate, compressedNode.translate, source.duration));
+			errors.rotate = std::max(errors.rotate, MeasureMaxError(sourceNode.rotate, compressedNode.rotate, source.duration));
+			errors.scale = std::max(errors.scale, MeasureMaxError(sourceNode.scale, compressedNode.scale, source.duration));
+		}
+		return errors;
+	}
+
+	//30fpsで焼いた歩行アニメーション(ボーン毎に軸・振幅・位相の異なる周期的な回転)
+	Animation MakeWalkClip(FastRandom& random, uint32_t boneCount, float duration) {
+		constexpr float kFrameRate = 30.0f;
+		const uint32_t frameCount = static_cast<uint32_t>(duration * kFrameRate) + 1;
+
+		Animation animation;
+		animation.name = "Walk";
+		animation.duration = duration;
+		for (uint32_t bone = 0; bone < boneCount; ++bone) {
+			NodeAnimation& node = animation.nodeAnimations["Bone" + std::to_string(bone)];
+
+			const Vector3 axis = Vector3Math::Normalize({ random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(0.1f, 1.0f) });
+			const float amplitude = random.NextFloat(0.05f, 1.2f);
+			const float phase = random.NextFloat(0.0f, 2.0f * std::numbers::pi_v<float>);
+			//先頭のボーンはルート(範囲の広い前進と上下の揺れ)、それ以外は親からの一定の位置
+			const bool isRoot = bone == 0;
+			const Vector3 offset = { random.NextFloat(-0.3f, 0.3f), random.NextFloat(0.1f, 0.5f), random.NextFloat(-0.1f, 0.1f) };
+			//途中で動きが止まるボーン(一定の区間)
+			const float holdStart = (bone % 4 == 3) ? duration * 0.5f : duration;
+
+			for (uint32_t frame = 0; frame < frameCount; ++frame) {
+				const float time = static_cast<float>(frame) / kFrameRate;
+				const float cycle = std::min(time, holdStart) * 2.0f * std::numbers::pi_v<float>;
+
+				Vector3 translate = offset;
+				if (isRoot) {
+					translate = { 0.0f, 0.9f + 0.05f * std::sin(cycle * 2.0f), time * 1.4f };
+				}
+				node.translate.keyframes.push_back({ time, translate });
+				node.rotate.keyframes.push_back({ time, QuaternionMath::MakeRotateAxisAngleQuaternion(axis, amplitude * std::sin(cycle + phase)) });
+				node.scale.keyframes.push_back({ time, { 1.0f, 1.0f, 1.0f } });
+			}
+		}
+		return animation;
+	}
+}
+
+//============================================================================
+// 量子化ありの圧縮で、全カーブの誤差が許容誤差に収まり、サイズが小さくなる
+//============================================================================
+TAKEC_TEST(AnimationCompressor_MaxErrorWithinTolerance) {
+	FastRandom random(41);
+	const Animation source = MakeWalkClip(random, 40, 4.0f);
+
+	const AnimationCompressor::Settings settings;
+	Animation compressed = source;
+	const AnimationCompressor::Stats stats = AnimationCompressor::Compress(compressed, settings);
+
+	const MaxErrors errors = MeasureMaxErrors(source, compressed);
+	TAKEC_CHECK(errors.translate <= settings.translateTolerance + kSampleEpsilon);
+	TAKEC_CHECK(errors.rotate <= settings.rotateTolerance + kSampleEpsilon);
+	TAKEC_CHECK(errors.scale <= settings.scaleTolerance + kSampleEpsilon);
+
+	//報告される誤差も許容誤差に収まる
+	TAKEC_CHECK(stats.maxTranslateError <= settings.translateTolerance + kSampleEpsilon);
+	TAKEC_CHECK(stats.maxRotateError <= settings.rotateTolerance + kSampleEpsilon);
+	TAKEC_CHECK(stats.maxScaleError <= settings.scaleTolerance + kSampleEpsilon);
+
+	//キーフレーム数・サイズが減り、報告されるサイズが実際のカーブのサイズと一致する
+	size_t sourceBytes = 0;
+	size_t compressedBytes = 0;
+	for (const auto& [nodeName, node] : compressed.nodeAnimations) {
+		const NodeAnimation& sourceNode = source.nodeAnimations.at(nodeName);
+		sourceBytes += AnimationCompressor::GetCurveBytes(sourceNode.translate) +
+			AnimationCompressor::GetCurveBytes(sourceNode.rotate) + AnimationCompressor::GetCurveBytes(sourceNode.scale);
+		compressedBytes += AnimationCompressor::GetCurveBytes(node.translate) +
+			AnimationCompressor::GetCurveBytes(node.rotate) + AnimationCompressor::GetCurveBytes(node.scale);
+		//一定の拡縮は1つのキーフレームにまとまる
+		TAKEC_CHECK_EQ(node.scale.GetKeyframeCount(), size_t{ 1 });
+	}
+	TAKEC_CHECK_EQ(stats.sourceBytes, sourceBytes);
+	TAKEC_CHECK_EQ(stats.compressedBytes, compressedBytes);
+	TAKEC_CHECK(stats.keptKeyframeCount < stats.sourceKeyframeCount);
+	TAKEC_CHECK(stats.compressedBytes * 2 < stats.sourceBytes);
+
+	//回転は量子化される
+	TAKEC_CHECK(compressed.nodeAnimations.at("Bone1").rotate.IsCompressed());
+	//キーフレームの並びが変わるので serial が更新される
+	TAKEC_CHECK(compressed.serial != source.serial);
+}
+
+//============================================================================
+// 許容誤差を変えても誤差が収まる(量子化なし・厳しい許容誤差・緩い許容誤差)
+//============================================================================
+TAKEC_TEST(AnimationCompressor_MaxErrorAcrossSettings) {
+	const float tolerances[] = { 0.0001f, 0.0005f, 0.005f, 0.05f };
+	for (bool isQuantize : { false, true }) {
+		for (float tolerance : tolerances) {
+			FastRandom random(42);
+			const Animation source = MakeWalkClip(random, 12, 2.0f);
+
+			AnimationCompressor::Settings settings;
+			settings.translateTolerance = tolerance;
+			settings.rotateTolerance = tolerance;
+			settings.scaleTolerance = tolerance;
+			settings.isQuantize = isQuantize;
+
+			Animation compressed = source;
+			AnimationCompressor::Compress(compressed, settings);
+			const MaxErrors errors = MeasureMaxErrors(source, compressed);
+			TAKEC_CHECK(errors.translate <= tolerance + kSampleEpsilon);
+			TAKEC_CHECK(errors.rotate <= tolerance + kSampleEpsilon);
+			TAKEC_CHECK(errors.scale <= tolerance + kSampleEpsilon);
+		}
+	}
+}
+
+//============================================================================
+// smallest-three の展開が元の回転に戻る(省略する成分の位置・符号の全パターン)
+//============================================================================
+TAKEC_TEST(AnimationCompressor_QuaternionQuantizationRoundTrip) {
+	FastRandom random(43);
+	AnimationCurve<Quaternion> source;
+	for (uint32_t i = 0; i < 2000; ++i) {
+		Quaternion q = QuaternionMath::Normalize({ random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f) });
+		source.keyframes.push_back({ static_cast<float>(i), q });
+	}
+
+	Animation animation;
+	animation.duration = static_cast<float>(source.keyframes.size() - 1);
+	animation.nodeAnimations["Node"].rotate = source;
+	//ランダムな回転は隣同士で補間できないので、全キーフレームが量子化されて残る
+	AnimationCompressor::Compress(animation, {});
+	const AnimationCurve<Quaternion>& compressed = animation.nodeAnimations["Node"].rotate;
+	TAKEC_CHECK(compressed.IsCompressed());
+	TAKEC_CHECK_EQ(compressed.GetKeyframeCount(), source.keyframes.size());
+
+	float maxError = 0.0f;
+	for (size_t i = 0; i < source.keyframes.size() && i < compressed.GetKeyframeCount(); ++i) {
+		maxError = std::max(maxError, Difference(AnimationCompressor::DecodeQuaternion(compressed, i), source.keyframes[i].value));
+	}
+	TAKEC_CHECK(maxError <= 0.0002f);
+}
@@ -0,0 +1,179 @@
+#include "TestFramework.h"
+#include "engine/Animation/AnimationLod.h"
+#include "engine/math/FastRandom.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// AnimationLod のテスト
+//============================================================================
+// AnimationLod は描画に依存しないので、Object3d の代わりに状態だけを持つキャラクターを並べ、
+// BeginFrame → Decide を繰り返して評価回数を数える。
+// 距離毎の評価頻度・同じ間隔のキャラクターの評価フレームの分散・
+// 間隔が変わってもアニメーションの時刻がずれないことを確認する。
+
+namespace {
+
+	//近距離・中距離・遠距離(既定の設定で毎フレーム・2フレーム毎・4フレーム毎になる距離)
+	constexpr float kNearDistance = 10.0f;
+	constexpr float kMiddleDistance = 40.0f;
+	constexpr float kFarDistance = 100.0f;
+
+	/// <summary>
+	/// テスト中だけ設定を差し替える(終了時に元の設定へ戻す)
+	/// </summary>
+	struct ScopedLodSettings {
+		explicit ScopedLodSettings(const AnimationLod::Settings& settings) : previous(AnimationLod::GetInstance().GetSettings()) {
+			AnimationLod::GetInstance().SetSettings(settings);
+		}
+		~ScopedLodSettings() { AnimationLod::GetInstance().SetSettings(previous); }
+		AnimationLod::Settings previous;
+	};
+
+	/// <summary>
+	/// テスト用のキャラクター(Object3dが持つLODの状態と、進めたアニメーションのフレーム数)
+	/// </summary>
+	struct TestCharacter {
+		AnimationLodState state;
+		float distance = 0.0f;
+		uint32_t animationFrame = 0; //advanceFramesの合計
+		uint32_t evaluateCount = 0;
+	};
+
+	//1フレーム分の更新(Object3d::AnimationUpdate と同じく、判定に従ってアニメーションを進める)
+	void UpdateFrame(std::vector<TestCharacter>& characters) {
+		AnimationLod::GetInstance().BeginFrame();
+		for (TestCharacter& character : characters) {
+			AnimationLodDecision decision = AnimationLod::GetInstance().Decide(character.state, character.distance);
+			character.animationFrame += decision.advanceFrames;
+			if (decision.mode != AnimationLodDecision::Mode::Interpolate) {
+				++character.evaluateCount;
+			}
+		}
+	}
+
+	std::vector<TestCharacter> MakeCharacters(uint32_t count, float distance) {
+		std::vector<TestCharacter> characters(count);
+		for (TestCharacter& character : characters) {
+			character.distance = distance;
+		}
+		return characters;
+	}
+}
+
+//============================================================================
+// 距離に応じて評価回数が 1/1・1/2・1/4 になる
+//============================================================================
+TAKEC_TEST(AnimationLod_EvaluationCountByDistance) {
+	ScopedLodSettings settings({});
+	constexpr uint32_t kFrameCount = 400;
+
+	const float distances[] = { kNearDistance, kMiddleDistance, kFarDistance };
+	const uint32_t intervals[] = { 1, 2, 4 };
+	for (uint32_t band = 0; band < 3; ++band) {
+		std::vector<TestCharacter> characters = MakeCharacters(16, distances[band]);
+		for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+			UpdateFrame(characters);
+		}
+		for (const TestCharacter& character : characters) {
+			//最初のフレームは間隔に関わらず評価するので、最大1回多い
+			const uint32_t expected = kFrameCount / intervals[band];
+			TAKEC_CHECK(character.evaluateCount >= expected && character.evaluateCount <= expected + 1);
+			TAKEC_CHECK_EQ(character.state.interval, intervals[band]);
+		}
+	}
+}
+
+//============================================================================
+// 同じ間隔のキャラクターは評価フレームがずれ、毎フレームの評価数が均等になる
+//============================================================================
+TAKEC_TEST(AnimationLod_SpreadsEvaluationsAcrossFrames) {
+	ScopedLodSettings settings({});
+	constexpr uint32_t kCharacterCount = 100;
+	std::vector<TestCharacter> characters = MakeCharacters(kCharacterCount, kFarDistance);
+
+	//最初のフレームは全員が評価する
+	UpdateFrame(characters);
+	TAKEC_CHECK_EQ(AnimationLod::GetInstance().GetFrameStats().evaluateCount, kCharacterCount);
+
+	for (uint32_t frame = 0; frame < 64; ++frame) {
+		UpdateFrame(characters);
+		const AnimationLod::FrameStats& stats = AnimationLod::GetInstance().GetFrameStats();
+		TAKEC_CHECK_EQ(stats.evaluateCount, kCharacterCount / AnimationLod::kMaxInterval_);
+		TAKEC_CHECK_EQ(stats.evaluateCount + stats.interpolateCount, kCharacterCount);
+	}
+
+	//前フレームの集計は BeginFrame で引き継がれる
+	const AnimationLod::FrameStats last = AnimationLod::GetInstance().GetFrameStats();
+	AnimationLod::GetInstance().BeginFrame();
+	TAKEC_CHECK_EQ(AnimationLod::GetInstance().GetLastFrameStats().evaluateCount, last.evaluateCount);
+	TAKEC_CHECK_EQ(AnimationLod::GetInstance().GetFrameStats().evaluateCount, 0u);
+}
+
+//============================================================================
+// 無効にすると全員が毎フレーム評価する
+//============================================================================
+TAKEC_TEST(AnimationLod_DisabledEvaluatesEveryFrame) {
+	AnimationLod::Settings disabled;
+	disabled.isEnabled = false;
+	ScopedLodSettings settings(disabled);
+
+	constexpr uint32_t kCharacterCount = 20;
+	std::vector<TestCharacter> characters = MakeCharacters(kCharacterCount, kFarDistance);
+	for (uint32_t frame = 0; frame < 10; ++frame) {
+		UpdateFrame(characters);
+		TAKEC_CHECK_EQ(AnimationLod::GetInstance().GetFrameStats().evaluateCount, kCharacterCount);
+		TAKEC_CHECK_EQ(AnimationLod::GetInstance().GetFrameStats().interpolateCount, 0u);
+	}
+	for (const TestCharacter& character : characters) {
+		TAKEC_CHECK_EQ(character.animationFrame, 10u);
+	}
+}
+
+//============================================================================
+// 距離が変わり続けても、アニメーションの時刻が実際の経過フレームからずれない
+//============================================================================
+// 評価フレームでは次の評価フレームの時刻まで先に進め、補間中は進めない。
+// そのため毎フレーム評価なら経過フレーム数と一致し、Evaluate なら lookaheadFrames 先、
+// 補間中は補間の終わり(span - step)先の時刻にある。
+TAKEC_TEST(AnimationLod_AnimationTimeStaysInSync) {
+	ScopedLodSettings settings({});
+	const float distances[] = { kNearDistance, kMiddleDistance, kFarDistance };
+
+	FastRandom random(51);
+	std::vector<TestCharacter> characters = MakeCharacters(32, kNearDistance);
+	uint32_t mismatchCount = 0;
+	uint32_t badBlendCount = 0;
+	for (uint32_t frame = 1; frame <= 2000; ++frame) {
+		AnimationLod::GetInstance().BeginFrame();
+		for (TestCharacter& character : characters) {
+			//一定の確率で距離の帯を変える
+			if (random.NextUInt() % 8 == 0) {
+				character.distance = distances[random.NextUInt() % 3];
+			}
+
+			AnimationLodDecision decision = AnimationLod::GetInstance().Decide(character.state, character.distance);
+			character.animationFrame += decision.advanceFrames;
+
+			uint32_t expected = frame;
+			switch (decision.mode) {
+			case AnimationLodDecision::Mode::Full:
+				break;
+			case AnimationLodDecision::Mode::Evaluate:
+				expected += decision.lookaheadFrames;
+				badBlendCount += (decision.blend == 0.0f || decision.blend == 1.0f) ? 0 : 1;
+				break;
+			case AnimationLodDecision::Mode::Interpolate:
+				expected += character.state.span - character.state.step;
+				badBlendCount += (decision.blend > 0.0f && decision.blend < 1.0f) ? 0 : 1;
+				break;
+			}
+			mismatchCount += (character.animationFrame == expected) ? 0 : 1;
+		}
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+	TAKEC_CHECK_EQ(badBlendCount, 0u);
+}
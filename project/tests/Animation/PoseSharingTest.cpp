@@ -0,0 +1,316 @@
+#include "TestFramework.h"
+#include "engine/3d/Model.h"
+#include "engine/Animation/AnimatorController.h"
+#include "engine/Animation/SkinningScheduler.h"
+#include "engine/math/MatrixMath.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// 姿勢の共有のテスト
+//============================================================================
+// SkinningScheduler::Flush は AnimatorController::BuildPoseKey で作ったキー(スケルトンの元のNode・レイヤー・
+// アニメーション・丸めた再生時間・ウェイト)が同じ更新をまとめ、代表の1体だけが評価して残りはコピーで済ませる。
+// キーが同じになる場合・異なる場合(クリップ・再生時間の区間・遷移のウェイト・レイヤーのウェイト)と、
+// Flush での代表・コピーの振り分け、GetLastPoseShareStats の集計、ハッシュが衝突した場合に共有しないことを確認する。
+// Model はデバイスを使わない InitializeSkinningOnly で作り、パレットはCPU側の配列に書き込む。
+
+namespace {
+
+	//ジョイント数(1本の鎖)
+	constexpr int kJointCount = 4;
+	//テストで使う再生時間を丸める単位
+	constexpr float kTimeQuantum = 0.1f;
+
+	//1本の鎖のジョイントの階層を作る
+	Node MakeChain(int jointIndex) {
+		Node node;
+		node.name = "joint" + std::to_string(jointIndex);
+		node.transform = { { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } };
+		node.localMatrix = MatrixMath::MakeIdentity4x4();
+		if (jointIndex + 1 < kJointCount) {
+			node.children.push_back(MakeChain(jointIndex + 1));
+		}
+		return node;
+	}
+
+	//全ジョイントを回す2秒のアニメーション(speed でクリップ毎に動きを変える)
+	std::unique_ptr<Animation> MakeAnimation(const std::string& name, float speed) {
+		auto animation = std::make_unique<Animation>();
+		animation->name = name;
+		animation->duration = 2.0f;
+		animation->serial = AnimationManager::IssueAnimationSerial();
+		for (int joint = 0; joint < kJointCount; ++joint) {
+			NodeAnimation nodeAnimation;
+			for (int frame = 0; frame <= 20; ++frame) {
+				const float time = static_cast<float>(frame) / 10.0f;
+				const float halfAngle = 0.05f * speed * static_cast<float>(frame);
+				nodeAnimation.translate.keyframes.push_back({ time, { 0.0f, 1.0f, 0.0f } });
+				nodeAnimation.rotate.keyframes.push_back({ time, { std::sin(halfAngle), 0.0f, 0.0f, std::cos(halfAngle) } });
+				nodeAnimation.scale.keyframes.push_back({ time, { 1.0f, 1.0f, 1.0f } });
+			}
+			animation->nodeAnimations["joint" + std::to_string(joint)] = nodeAnimation;
+		}
+		return animation;
+	}
+
+	/// <summary>
+	/// テスト用のキャラクター
+	/// </summary>
+	struct Character {
+		Model model;
+		AnimatorController controller;
+		std::vector<WellForGPU> palette; //Model がパレットを書き込むCPU側の配列
+	};
+
+	//clip を startTime まで再生したキャラクターの生成
+	std::unique_ptr<Character> MakeCharacter(const Node& root, Animation* clip, float startTime) {
+		auto character = std::make_unique<Character>();
+		character->palette.resize(kJointCount);
+		character->model.InitializeSkinningOnly(root, std::vector<Matrix4x4>(kJointCount, MatrixMath::MakeIdentity4x4()), character->palette);
+		character->controller.Initialize(character->model.GetSkeleton());
+		character->controller.TransitionTo(clip, 0.0f);
+		character->controller.Update(startTime);
+		return character;
+	}
+
+	//キーの作成(BuildPoseKey は出力先を使い回すため、比べる側ごとに作る)
+	std::vector<uint64_t> BuildKey(const AnimatorController& controller) {
+		std::vector<uint64_t> key;
+		controller.BuildPoseKey(kTimeQuantum, key);
+		return key;
+	}
+
+	bool IsSamePalette(const Character& a, const Character& b) {
+		return std::memcmp(a.palette.data(), b.palette.data(), sizeof(WellForGPU) * kJointCount) == 0;
+	}
+
+	//全てのキーを同じ値にするハッシュ(ハッシュの衝突の確認用)
+	uint64_t CollidingHash(const std::vector<uint64_t>&) { return 0; }
+
+	/// <summary>
+	/// テスト中だけ SkinningScheduler の設定を差し替える(終了時に既定の設定へ戻す)
+	/// </summary>
+	struct ScopedScheduler {
+		ScopedScheduler() {
+			SkinningScheduler& scheduler = SkinningScheduler::GetInstance();
+			previousTimeQuantum = scheduler.GetPoseTimeQuantum();
+			scheduler.SetEnabled(true);
+			scheduler.SetPoseSharingEnabled(true);
+			scheduler.SetPoseTimeQuantum(kTimeQuantum);
+		}
+		~ScopedScheduler() {
+			SkinningScheduler& scheduler = SkinningScheduler::GetInstance();
+			scheduler.SetEnabled(true);
+			scheduler.SetPoseSharingEnabled(true);
+			scheduler.SetPoseTimeQuantum(previousTimeQuantum);
+			scheduler.SetPoseKeyHasher(nullptr);
+		}
+		float previousTimeQuantum = 0.0f;
+	};
+
+	//全キャラクターを登録して Flush する
+	void FlushAll(const std::vector<std::unique_ptr<Character>>& characters, float deltaTime) {
+		for (const std::unique_ptr<Character>& character : characters) {
+			SkinningScheduler::GetInstance().Enqueue(&character->model, &character->controller, deltaTime);
+		}
+		SkinningScheduler::GetInstance().Flush();
+	}
+}
+
+//============================================================================
+// 同じクリップ・同じ再生時間の区間ならキーは同じで、クリップ・区間・元のNodeが違えば異なる
+//============================================================================
+TAKEC_TEST(AnimatorController_PoseKeyClipAndTime) {
+	const Node root = MakeChain(0);
+	const Node otherRoot = MakeChain(0);
+	auto walk = MakeAnimation("walk", 1.0f);
+	auto run = MakeAnimation("run", 2.0f);
+
+	auto base = MakeCharacter(root, walk.get(), 0.52f);
+	auto sameBucket = MakeCharacter(root, walk.get(), 0.58f);
+	auto nextBucket = MakeCharacter(root, walk.get(), 0.61f);
+	auto otherClip = MakeCharacter(root, run.get(), 0.52f);
+	auto otherSkeleton = MakeCharacter(otherRoot, walk.get(), 0.52f);
+
+	const std::vector<uint64_t> key = BuildKey(base->controller);
+	TAKEC_CHECK(!key.empty());
+	TAKEC_CHECK(BuildKey(sameBucket->controller) == key);
+	TAKEC_CHECK(BuildKey(nextBucket->controller) != key);
+	TAKEC_CHECK(BuildKey(otherClip->controller) != key);
+	TAKEC_CHECK(BuildKey(otherSkeleton->controller) != key);
+
+	//丸めない場合は同じ区間でも再生時間が違えば異なる
+	std::vector<uint64_t> exactKey;
+	std::vector<uint64_t> exactSameBucketKey;
+	base->controller.BuildPoseKey(0.0f, exactKey);
+	sameBucket->controller.BuildPoseKey(0.0f, exactSameBucketKey);
+	TAKEC_CHECK(exactKey != exactSameBucketKey);
+}
+
+//============================================================================
+// 遷移中はクロスフェードのウェイトで区別し、遷移が終われば遷移先だけのキーになる
+//============================================================================
+TAKEC_TEST(AnimatorController_PoseKeyCrossFade) {
+	const Node root = MakeChain(0);
+	auto walk = MakeAnimation("walk", 1.0f);
+	auto run = MakeAnimation("run", 2.0f);
+
+	auto a = MakeCharacter(root, walk.get(), 0.0f);
+	auto b = MakeCharacter(root, walk.get(), 0.0f);
+	a->controller.TransitionTo(run.get(), 1.0f);
+	b->controller.TransitionTo(run.get(), 1.0f);
+	TAKEC_CHECK(BuildKey(a->controller) == BuildKey(b->controller));
+
+	//遷移元・遷移先の再生時間は同じ区間でも、遷移の進み方(ウェイト)が違えば異なる
+	a->controller.Advance(0.21f);
+	b->controller.Advance(0.25f);
+	TAKEC_CHECK(BuildKey(a->controller) != BuildKey(b->controller));
+
+	//遷移中のキーは遷移先だけを再生するキャラクターとも異なる
+	auto runOnly = MakeCharacter(root, run.get(), 0.21f);
+	TAKEC_CHECK(BuildKey(a->controller) != BuildKey(runOnly->controller));
+
+	//遷移が終わると遷移先だけのキーと一致する
+	a->controller.Advance(1.0f);
+	runOnly->controller.Advance(1.0f);
+	TAKEC_CHECK(BuildKey(a->controller) == BuildKey(runOnly->controller));
+}
+
+//============================================================================
+// レイヤーのウェイトが違えば異なり、無視できるウェイトのレイヤーは区別しない
+//============================================================================
+TAKEC_TEST(AnimatorController_PoseKeyLayerWeight) {
+	const Node root = MakeChain(0);
+	auto walk = MakeAnimation("walk", 1.0f);
+	auto wave = MakeAnimation("wave", 3.0f);
+
+	auto withLayer = [&](float weight) {
+		auto character = MakeCharacter(root, walk.get(), 0.3f);
+		character->controller.AddLayer("Upper", AnimationBlendMode::Override, weight);
+		character->controller.TransitionTo("Upper", wave.get(), 0.0f);
+		return character;
+	};
+	auto half = withLayer(0.5f);
+	auto halfAgain = withLayer(0.5f);
+	auto quarter = withLayer(0.25f);
+	TAKEC_CHECK(BuildKey(half->controller) == BuildKey(halfAgain->controller));
+	TAKEC_CHECK(BuildKey(half->controller) != BuildKey(quarter->controller));
+
+	//ウェイトを変えれば同じキーになる
+	quarter->controller.SetLayerWeight("Upper", 0.5f);
+	TAKEC_CHECK(BuildKey(half->controller) == BuildKey(quarter->controller));
+
+	//ウェイトが無視できるレイヤーは、レイヤーが無いキャラクターと同じキーになる
+	auto disabled = withLayer(0.0005f);
+	auto baseOnly = MakeCharacter(root, walk.get(), 0.3f);
+	TAKEC_CHECK(BuildKey(disabled->controller) == BuildKey(baseOnly->controller));
+	TAKEC_CHECK(BuildKey(half->controller) != BuildKey(baseOnly->controller));
+}
+
+//============================================================================
+// Flush は同じキーの更新を代表1体の評価とコピーにまとめ、集計する
+//============================================================================
+TAKEC_TEST(SkinningScheduler_PoseSharingGroups) {
+	ScopedScheduler scope;
+	const Node root = MakeChain(0);
+	auto walk = MakeAnimation("walk", 1.0f);
+	auto run = MakeAnimation("run", 2.0f);
+	constexpr float kDeltaTime = 0.01f;
+
+	//0～2: 同じ再生時間、3: 同じ区間の別の再生時間、4: 別のクリップ、5: 別の区間
+	auto makeCrowd = [&]() {
+		std::vector<std::unique_ptr<Character>> characters;
+		characters.push_back(MakeCharacter(root, walk.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, walk.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, walk.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, walk.get(), 0.55f));
+		characters.push_back(MakeCharacter(root, run.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, walk.get(), 0.72f));
+		return characters;
+	};
+	std::vector<std::unique_ptr<Character>> shared = makeCrowd();
+	std::vector<std::unique_ptr<Character>> expected = makeCrowd();
+
+	FlushAll(shared, kDeltaTime);
+	const SkinningScheduler::PoseShareStats stats = SkinningScheduler::GetInstance().GetLastPoseShareStats();
+	TAKEC_CHECK_EQ(stats.lookupCount, 6u);
+	TAKEC_CHECK_EQ(stats.hitCount, 3u);
+	TAKEC_CHECK_EQ(stats.uniqueCount, 3u);
+
+	//共有しない場合の結果(各自で評価)
+	SkinningScheduler::GetInstance().SetPoseSharingEnabled(false);
+	FlushAll(expected, kDeltaTime);
+	const SkinningScheduler::PoseShareStats disabledStats = SkinningScheduler::GetInstance().GetLastPoseShareStats();
+	TAKEC_CHECK_EQ(disabledStats.lookupCount, 0u);
+	TAKEC_CHECK_EQ(disabledStats.hitCount, 0u);
+	TAKEC_CHECK_EQ(disabledStats.uniqueCount, 0u);
+
+	//代表と、同じ再生時間のコピーは各自で評価した結果と一致する
+	uint32_t mismatchCount = 0;
+	for (uint32_t i : { 0u, 1u, 2u, 4u, 5u }) {
+		mismatchCount += IsSamePalette(*shared[i], *expected[i]) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+
+	//同じ区間のものは代表の姿勢をコピーする(スケルトンもコピーされる)
+	TAKEC_CHECK(IsSamePalette(*shared[3], *shared[0]));
+	TAKEC_CHECK(!IsSamePalette(*expected[3], *expected[0]));
+	const Skeleton& owner = *shared[0]->model.GetSkeleton();
+	const Skeleton& follower = *shared[3]->model.GetSkeleton();
+	TAKEC_CHECK(std::memcmp(owner.GetSkeletonSpaceMatrices().data(), follower.GetSkeletonSpaceMatrices().data(), sizeof(Matrix4x4) * kJointCount) == 0);
+
+	//異なるキーのものは共有しない
+	TAKEC_CHECK(!IsSamePalette(*shared[4], *shared[0]));
+	TAKEC_CHECK(!IsSamePalette(*shared[5], *shared[0]));
+
+	//再生時間は共有の有無に関わらず各自で進む(次のフレームで3は0と別の区間になる)
+	SkinningScheduler::GetInstance().SetPoseSharingEnabled(true);
+	FlushAll(shared, 0.06f);
+	TAKEC_CHECK_EQ(SkinningScheduler::GetInstance().GetLastPoseShareStats().hitCount, 2u);
+	TAKEC_CHECK(!IsSamePalette(*shared[3], *shared[0]));
+}
+
+//============================================================================
+// ハッシュが衝突しても、キーが違えば共有せずに別の姿勢として評価する
+//============================================================================
+TAKEC_TEST(SkinningScheduler_PoseHashCollisionFallback) {
+	ScopedScheduler scope;
+	SkinningScheduler::GetInstance().SetPoseKeyHasher(&CollidingHash);
+	const Node root = MakeChain(0);
+	auto walk = MakeAnimation("walk", 1.0f);
+	auto run = MakeAnimation("run", 2.0f);
+	constexpr float kDeltaTime = 0.01f;
+
+	auto makeCrowd = [&]() {
+		std::vector<std::unique_ptr<Character>> characters;
+		characters.push_back(MakeCharacter(root, walk.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, run.get(), 0.52f));
+		characters.push_back(MakeCharacter(root, walk.get(), 0.52f));
+		return characters;
+	};
+	std::vector<std::unique_ptr<Character>> shared = makeCrowd();
+	std::vector<std::unique_ptr<Character>> expected = makeCrowd();
+
+	FlushAll(shared, kDeltaTime);
+	const SkinningScheduler::PoseShareStats stats = SkinningScheduler::GetInstance().GetLastPoseShareStats();
+	TAKEC_CHECK_EQ(stats.lookupCount, 3u);
+	TAKEC_CHECK_EQ(stats.hitCount, 1u);
+	TAKEC_CHECK_EQ(stats.uniqueCount, 2u);
+
+	SkinningScheduler::GetInstance().SetPoseSharingEnabled(false);
+	FlushAll(expected, kDeltaTime);
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < 3; ++i) {
+		mismatchCount += IsSamePalette(*shared[i], *expected[i]) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+	TAKEC_CHECK(!IsSamePalette(*shared[1], *shared[0]));
+}
@@ -0,0 +1,188 @@
+#include "TestFramework.h"
+#include "engine/BehaviorTree/Blackboard.h"
+#include "engine/BehaviorTree/ConditionNode.h"
+#include "engine/BehaviorTree/SelectorNode.h"
+#include "engine/BehaviorTree/SequenceNode.h"
+#include "engine/BehaviorTree/SetBlackboardBoolNode.h"
+#include "engine/BehaviorTree/WaitBlackboardTimeNode.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+//============================================================================
+// Blackboard のメモリ確保のテスト
+//============================================================================
+// キーをIDへInternしておけば、ビヘイビアツリーの1tick(ConditionNodeの評価・Blackboardへの書き込み)で
+// ヒープ確保が起きないことを確認する。このファイルでグローバルな operator new を置き換えて確保回数を数える。
+// キー名は std::string の小さい文字列の最適化(SSO)に収まらない長さにして、文字列のコピーも確保として数えられるようにする。
+
+namespace {
+
+	//確保を数えるかどうかと、数えた回数
+	std::atomic<bool> isCountingAllocations = false;
+	std::atomic<uint64_t> allocationCount = 0;
+
+	void* AllocateCounted(std::size_t size) {
+		if (isCountingAllocations.load(std::memory_order_relaxed)) {
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+
+	/// <summary>
+	/// 生存中だけヒープ確保の回数を数える
+	/// </summary>
+	struct AllocationCounter {
+		AllocationCounter() {
+			allocationCount = 0;
+			isCountingAllocations = true;
+		}
+		~AllocationCounter() { isCountingAllocations = false; }
+		uint64_t GetCount() const { return allocationCount.load(); }
+	};
+}
+
+void* operator new(std::size_t size) { return AllocateCounted(size); }
+void* operator new[](std::size_t size) { return AllocateCounted(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+	/// <summary>
+	/// 敵AIを想定したツリー
+	/// Selector
+	///  ├ Sequence: healthPercentage < 30 → isFleeing = true
+	///  ├ Sequence: distanceToTarget <= 5 → 攻撃の待機時間だけ待つ → isAttacking = true
+	///  └ isIdle = true
+	/// </summary>
+	std::unique_ptr<BehaviorNode> MakeEnemyTree() {
+		auto flee = std::make_unique<SequenceNode>();
+		flee->AddChild(std::make_unique<ConditionNode>("healthPercentage", "<", 30.0f));
+		flee->AddChild(std::make_unique<SetBlackboardBoolNode>("isFleeing", true));
+
+		auto attack = std::make_unique<SequenceNode>();
+		attack->AddChild(std::make_unique<ConditionNode>("distanceToTarget", "<=", 5.0f));
+		attack->AddChild(std::make_unique<WaitBlackboardTimeNode>("attackWaitSeconds"));
+		attack->AddChild(std::make_unique<SetBlackboardBoolNode>("isAttacking", true));
+
+		auto root = std::make_unique<SelectorNode>();
+		root->AddChild(std::move(flee));
+		root->AddChild(std::move(attack));
+		root->AddChild(std::make_unique<SetBlackboardBoolNode>("isIdle", true));
+		return root;
+	}
+}
+
+//============================================================================
+// ツリーの実行でヒープ確保が起きない
+//============================================================================
+TAKEC_TEST(Blackboard_TreeTickDoesNotAllocate) {
+	std::unique_ptr<BehaviorNode> tree = MakeEnemyTree();
+	const BlackboardKey<int32_t> healthKey("healthPercentage");
+	const BlackboardKey<float> distanceKey("distanceToTarget");
+
+	Blackboard blackboard;
+	blackboard.Set(healthKey, 100);
+	blackboard.Set(distanceKey, 20.0f);
+	blackboard.Set<float>("attackWaitSeconds", 0.05f);
+	//書き込まれるキーのスロットを用意するため、全ての分岐を1度通しておく
+	for (int32_t health : { 100, 10 }) {
+		for (float distance : { 20.0f, 1.0f }) {
+			blackboard.Set(healthKey, health);
+			blackboard.Set(distanceKey, distance);
+			for (int i = 0; i < 10; ++i) {
+				tree->Execute(blackboard);
+			}
+		}
+	}
+
+	uint32_t fleeCount = 0;
+	uint32_t attackCount = 0;
+	uint64_t count = 0;
+	{
+		AllocationCounter counter;
+		for (uint32_t tick = 0; tick < 10000; ++tick) {
+			//値を変えながら全ての分岐を通す
+			blackboard.Set(healthKey, static_cast<int32_t>(tick % 100));
+			blackboard.Set(distanceKey, static_cast<float>(tick % 13));
+			tree->Execute(blackboard);
+			fleeCount += blackboard.GetOr<bool>("isFleeing", false) ? 1 : 0;
+			attackCount += blackboard.GetOr<bool>("isAttacking", false) ? 1 : 0;
+		}
+		count = counter.GetCount();
+	}
+	TAKEC_CHECK_EQ(count, 0u);
+	//ツリーが実際に評価されていること
+	TAKEC_CHECK(fleeCount > 0);
+	TAKEC_CHECK(attackCount > 0);
+}
+
+//============================================================================
+// 登録済みキーへのアクセスでヒープ確保が起きない(ID指定・文字列指定の両方)
+//============================================================================
+TAKEC_TEST(Blackboard_AccessDoesNotAllocate) {
+	const BlackboardKey<float> speedKey("movementSpeedScale");
+	const BlackboardKey<bool> isGroundedKey("isStandingOnGround");
+	const BlackboardKeyId countId = BlackboardKeyRegistry::Intern("comboCounterValue");
+
+	Blackboard blackboard;
+	blackboard.Set(speedKey, 1.0f);
+	blackboard.Set(isGroundedKey, true);
+	blackboard.Set<int32_t>(countId, 0);
+
+	uint64_t count = 0;
+	float total = 0.0f;
+	{
+		AllocationCounter counter;
+		for (int32_t i = 0; i < 10000; ++i) {
+			blackboard.Set(speedKey, static_cast<float>(i));
+			blackboard.Set(countId, i);
+			blackboard.Set<bool>("isStandingOnGround", (i & 1) == 0);
+			total += blackboard.TryGetNumberAsFloat(countId).value_or(0.0f);
+			total += blackboard.TryGetNumberAsFloat("movementSpeedScale").value_or(0.0f);
+			total += blackboard.GetOr(speedKey, 0.0f);
+			total += blackboard.Contains("isStandingOnGround") ? 1.0f : 0.0f;
+			//未登録のキーの検索は登録もしない
+			total += blackboard.Contains("unregisteredKeyName") ? 1.0f : 0.0f;
+			total += (blackboard.TryGet<float>("unregisteredKeyName") != nullptr) ? 1.0f : 0.0f;
+		}
+		count = counter.GetCount();
+	}
+	TAKEC_CHECK_EQ(count, 0u);
+	TAKEC_CHECK(total > 0.0f);
+	TAKEC_CHECK(BlackboardKeyRegistry::Find("unregisteredKeyName") == BlackboardKeyId::Invalid);
+}
+
+//============================================================================
+// revision は値が変わった時だけ進む
+//============================================================================
+TAKEC_TEST(Blackboard_RevisionAdvancesOnChangeOnly) {
+	const BlackboardKey<float> speedKey("movementSpeedScale");
+	Blackboard blackboard;
+
+	const uint64_t initial = blackboard.Revision();
+	blackboard.Set(speedKey, 1.0f);
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 1);
+	blackboard.Set(speedKey, 1.0f);
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 1);
+	blackboard.Set(speedKey, 2.0f);
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 2);
+
+	//型の異なる書き込みは失敗し、revisionも進まない
+	TAKEC_CHECK(!blackboard.Set<int32_t>(speedKey.id, 3));
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 2);
+
+	TAKEC_CHECK(blackboard.Remove(speedKey.id));
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 3);
+	TAKEC_CHECK(!blackboard.Remove(speedKey.id));
+	TAKEC_CHECK_EQ(blackboard.Revision(), initial + 3);
+}
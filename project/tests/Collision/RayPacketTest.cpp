@@ -0,0 +1,317 @@
+#include "TestFramework.h"
+#include "engine/Collision/Collider.h"
+#include "engine/Collision/DynamicAABBTree.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+#include "engine/math/physics/RayIntersection.h"
+#include "engine/math/physics/RayPacket.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// RayPacket のテスト
+//============================================================================
+// CollisionManager::RayCastBatch はパケット(4本)でBVHとコライダーを絞り込み、
+// 残ったレーンだけ RayIntersection::UpdateClosestHits でスカラー版と同じ判定を行う。
+// 絞り込みが1本でもヒットを落とすと RayCast と結果が変わるため、ランダムなレイと形状でスカラー版との一致を確認する。
+// BoxCollider/SphereCollider の生成にはデバイスが必要なため、同じ RayIntersection の判定を呼ぶテスト用のコライダーを使う。
+
+namespace {
+
+	/// <summary>
+	/// 判定対象のコライダー(BoxColliderのOBB、またはSphereColliderの球)
+	/// レイの判定は BoxCollider/SphereCollider と同じ RayIntersection の関数で行う
+	/// </summary>
+	class TestCollider : public Collider {
+	public:
+
+		bool isBox = true;
+		OBB obb = {};
+		Vector3 center = {};
+		float radius = 0.0f;
+
+		void Initialize(TakeC::DirectXCommon*, TakeC::Object3d*) override {}
+		void Update(TakeC::Object3d*) override {}
+		void UpdateImGui(const std::string&) override {}
+		void DrawCollider() override {}
+
+		bool Intersects(const Ray& ray, RayCastHit& outHit) override {
+			float distance = 0.0f;
+			if (!Intersects(ray, distance)) return false;
+			outHit.isHit = true;
+			outHit.distance = distance;
+			outHit.hitCollider = this;
+			return true;
+		}
+		bool Intersects(const Ray& ray, float& outDistance) const {
+			return isBox ? RayIntersection::IntersectOBB(ray, obb, outDistance) : RayIntersection::IntersectSphere(ray, center, radius, outDistance);
+		}
+		bool IntersectsSphere(const Ray&, float, RayCastHit&) override { return false; }
+		bool IntersectsCapsule(const Capsule&, RayCastHit&) override { return false; }
+
+		Vector3 GetWorldPos() override { return isBox ? obb.center : center; }
+		AABB GetWorldAABB() override {
+			if (!isBox) {
+				Vector3 extent = { radius, radius, radius };
+				return { center - extent, center + extent };
+			}
+			Vector3 extent = {};
+			for (int i = 0; i < 3; ++i) {
+				const float half = (i == 0) ? obb.halfSize.x : (i == 1) ? obb.halfSize.y : obb.halfSize.z;
+				extent.x += std::abs(obb.axis[i].x) * half;
+				extent.y += std::abs(obb.axis[i].y) * half;
+				extent.z += std::abs(obb.axis[i].z) * half;
+			}
+			return { obb.center - extent, obb.center + extent };
+		}
+
+		//パケットの形状ごとのSIMD判定(CollisionManager::RayCastBatch の形状の振り分けに相当)
+		int Overlap(const RayPacket& packet) const {
+			return isBox ? packet.OverlapOBB(obb) : packet.OverlapSphere(center, radius);
+		}
+	};
+
+	//ランダムな形状のコライダーの生成
+	std::vector<std::unique_ptr<TestCollider>> MakeRandomColliders(FastRandom& random, uint32_t count, float extent) {
+		std::vector<std::unique_ptr<TestCollider>> colliders;
+		for (uint32_t i = 0; i < count; ++i) {
+			auto collider = std::make_unique<TestCollider>();
+			Vector3 center = { random.NextFloat(-extent, extent), random.NextFloat(-extent, extent), random.NextFloat(-extent, extent) };
+			collider->isBox = (random.NextUInt() & 1) != 0;
+			if (collider->isBox) {
+				Matrix4x4 rotate = MatrixMath::MakeRotateMatrix(Vector3{
+					random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) });
+				collider->obb.center = center;
+				for (int axis = 0; axis < 3; ++axis) {
+					collider->obb.axis[axis] = { rotate.m[axis][0], rotate.m[axis][1], rotate.m[axis][2] };
+				}
+				collider->obb.halfSize = { random.NextFloat(0.1f, 3.0f), random.NextFloat(0.1f, 3.0f), random.NextFloat(0.1f, 3.0f) };
+			} else {
+				collider->center = center;
+				collider->radius = random.NextFloat(0.1f, 3.0f);
+			}
+			colliders.push_back(std::move(collider));
+		}
+		return colliders;
+	}
+
+	//ランダムなレイの生成(軸に平行な方向と、形状の内部から始まるものを含める)
+	std::vector<Ray> MakeRandomRays(FastRandom& random, uint32_t count, float extent) {
+		std::vector<Ray> rays(count);
+		for (Ray& ray : rays) {
+			ray.origin = { random.NextFloat(-extent, extent), random.NextFloat(-extent, extent), random.NextFloat(-extent, extent) };
+			switch (random.NextUInt() % 4) {
+			case 0:
+				ray.direction = { 0.0f, 0.0f, (random.NextUInt() & 1) ? 1.0f : -1.0f };
+				break;
+			case 1:
+				ray.direction = { (random.NextUInt() & 1) ? 1.0f : -1.0f, 0.0f, 0.0f };
+				break;
+			default:
+				ray.direction = Vector3{ random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f) }.Normalize();
+				break;
+			}
+			ray.distance = random.NextFloat(1.0f, extent * 2.0f);
+		}
+		return rays;
+	}
+
+	/// <summary>
+	/// 最近ヒットの結果
+	/// </summary>
+	struct TestHit {
+		const Collider* collider = nullptr;
+		float distance = 0.0f;
+	};
+
+	//CollisionManager::RayCast と同じ手順のスカラー版(期待値)
+	TestHit RayCastScalar(const DynamicAABBTree& tree, const Ray& ray) {
+		TestHit hit;
+		float closestDistance = ray.distance;
+		RayCastHit tempHit = {};
+		tree.RayCast(ray.origin, ray.direction, ray.distance, 0.0f, 1u, [&](Collider* collider) {
+			if (collider->Intersects(ray, tempHit) && tempHit.distance < closestDistance) {
+				closestDistance = tempHit.distance;
+				hit = { tempHit.hitCollider, tempHit.distance };
+			}
+			return (std::max)(closestDistance, 0.0f);
+		});
+		return hit;
+	}
+
+	//CollisionManager::RayCastBatch と同じ手順のパケット版
+	void RayCastPacket(const DynamicAABBTree& tree, std::span<const Ray> rays, std::vector<TestHit>& outHits) {
+		RayPacket packet;
+		packet.Load(rays);
+
+		float closestDistance[RayPacket::kLaneCount];
+		RayCastHit laneHits[RayPacket::kLaneCount] = {};
+		for (size_t lane = 0; lane < rays.size(); ++lane) {
+			closestDistance[lane] = rays[lane].distance;
+			outHits[lane] = {};
+		}
+
+		tree.RayCastPacket(packet, 1u, [&](Collider* collider, int laneMask) {
+			//BVHにはテスト用のコライダーだけを登録している
+			laneMask &= static_cast<const TestCollider*>(collider)->Overlap(packet);
+
+			int updatedMask = RayIntersection::UpdateClosestHits(packet, rays, laneMask, closestDistance, [&](size_t lane, float& outDistance) {
+				if (!collider->Intersects(rays[lane], laneHits[lane])) return false;
+				outDistance = laneHits[lane].distance;
+				return true;
+			});
+			for (size_t lane = 0; lane < rays.size(); ++lane) {
+				if (updatedMask & (1 << lane)) {
+					outHits[lane] = { laneHits[lane].hitCollider, laneHits[lane].distance };
+				}
+			}
+		});
+	}
+}
+
+//============================================================================
+// スカラーの判定: OBBは始点が内部なら負の突入距離、球は手前の解が範囲外なら奥の解
+//============================================================================
+TAKEC_TEST(RayIntersection_ScalarDistances) {
+	const OBB obb = { { 0.0f, 0.0f, 0.0f }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 1.0f, 2.0f, 1.0f } };
+	float distance = 0.0f;
+
+	//外から: 面までの距離
+	TAKEC_CHECK(RayIntersection::IntersectOBB({ { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f }, obb, distance));
+	TAKEC_CHECK_NEAR(distance, 4.0f, 1.0e-5f);
+	//内部から: 後ろの面までの負の距離
+	TAKEC_CHECK(RayIntersection::IntersectOBB({ { 0.0f, 0.0f, 0.5f }, { 0.0f, 0.0f, 1.0f }, 10.0f }, obb, distance));
+	TAKEC_CHECK_NEAR(distance, -1.5f, 1.0e-5f);
+	//後ろ向き・外れ
+	TAKEC_CHECK(!RayIntersection::IntersectOBB({ { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, -1.0f }, 10.0f }, obb, distance));
+	TAKEC_CHECK(!RayIntersection::IntersectOBB({ { 0.0f, 2.5f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f }, obb, distance));
+
+	//球: 外からは手前の解、内部からは奥の解、距離の範囲外は外れ
+	TAKEC_CHECK(RayIntersection::IntersectSphere({ { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f }, { 0.0f, 0.0f, 0.0f }, 1.0f, distance));
+	TAKEC_CHECK_NEAR(distance, 4.0f, 1.0e-5f);
+	TAKEC_CHECK(RayIntersection::IntersectSphere({ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f }, { 0.0f, 0.0f, 0.0f }, 1.0f, distance));
+	TAKEC_CHECK_NEAR(distance, 1.0f, 1.0e-5f);
+	TAKEC_CHECK(!RayIntersection::IntersectSphere({ { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 3.0f }, { 0.0f, 0.0f, 0.0f }, 1.0f, distance));
+}
+
+//============================================================================
+// 最近ヒットの更新: マスク外のレーンは判定せず、近いヒットだけ判定距離を縮める
+//============================================================================
+TAKEC_TEST(RayIntersection_UpdateClosestHits) {
+	const Ray rays[3] = {
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f },
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f },
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f },
+	};
+	RayPacket packet;
+	packet.Load(rays);
+	float closestDistance[RayPacket::kLaneCount] = { 10.0f, 3.0f, 10.0f };
+
+	//レーン0は更新、レーン1は既存のヒットより遠い、レーン2はマスク外
+	const float candidate[3] = { 5.0f, 4.0f, 1.0f };
+	uint32_t calledMask = 0;
+	int updatedMask = RayIntersection::UpdateClosestHits(packet, rays, 0b011, closestDistance, [&](size_t lane, float& outDistance) {
+		calledMask |= 1u << lane;
+		outDistance = candidate[lane];
+		return true;
+	});
+	TAKEC_CHECK_EQ(updatedMask, 0b001);
+	TAKEC_CHECK_EQ(calledMask, 0b011u);
+	TAKEC_CHECK_EQ(closestDistance[0], 5.0f);
+	TAKEC_CHECK_EQ(closestDistance[1], 3.0f);
+	TAKEC_CHECK_EQ(packet.maxDistance[0], 5.0f);
+	TAKEC_CHECK_EQ(packet.maxDistance[1], 10.0f);
+	TAKEC_CHECK_EQ(packet.maxDistance[2], 10.0f);
+
+	//始点が内部の負の距離は最近ヒットとして記録し、判定距離は0で止める
+	updatedMask = RayIntersection::UpdateClosestHits(packet, rays, 0b100, closestDistance, [](size_t, float& outDistance) {
+		outDistance = -0.5f;
+		return true;
+	});
+	TAKEC_CHECK_EQ(updatedMask, 0b100);
+	TAKEC_CHECK_EQ(closestDistance[2], -0.5f);
+	TAKEC_CHECK_EQ(packet.maxDistance[2], 0.0f);
+}
+
+//============================================================================
+// 形状単体: スカラー版で有効なヒットのレーンはパケットの判定でも残る
+//============================================================================
+TAKEC_TEST(RayPacket_OverlapKeepsScalarHits) {
+	FastRandom random(4);
+	const std::vector<std::unique_ptr<TestCollider>> colliders = MakeRandomColliders(random, 200, 10.0f);
+	const std::vector<Ray> rays = MakeRandomRays(random, 4000, 12.0f);
+
+	uint32_t scalarHitCount = 0;
+	for (size_t first = 0; first < rays.size(); first += RayPacket::kLaneCount) {
+		std::span<const Ray> packetRays(rays.data() + first, std::min<size_t>(RayPacket::kLaneCount, rays.size() - first));
+		RayPacket packet;
+		packet.Load(packetRays);
+
+		for (const std::unique_ptr<TestCollider>& collider : colliders) {
+			int laneMask = collider->Overlap(packet);
+			int aabbMask = packet.OverlapAABB(collider->GetWorldAABB());
+			for (size_t lane = 0; lane < packetRays.size(); ++lane) {
+				float distance = 0.0f;
+				if (!collider->Intersects(packetRays[lane], distance) || distance >= packetRays[lane].distance) continue;
+
+				++scalarHitCount;
+				TAKEC_CHECK(laneMask & (1 << lane));
+				TAKEC_CHECK(aabbMask & (1 << lane));
+			}
+		}
+	}
+	// ヒットが少なすぎると確認にならない
+	TAKEC_CHECK(scalarHitCount > 1000);
+}
+
+//============================================================================
+// 無効レーン: 4本未満のパケットの空きレーンは常に0
+//============================================================================
+TAKEC_TEST(RayPacket_InactiveLanesNeverHit) {
+	Ray ray = { { 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 10.0f };
+	RayPacket packet;
+	packet.Load(std::span<const Ray>(&ray, 1));
+
+	OBB obb = { { 0.0f, 0.0f, 0.0f }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 1.0f, 1.0f, 1.0f } };
+	TAKEC_CHECK_EQ(packet.OverlapOBB(obb), 1);
+	TAKEC_CHECK_EQ(packet.OverlapSphere({ 0.0f, 0.0f, 0.0f }, 1.0f), 1);
+	TAKEC_CHECK_EQ(packet.OverlapAABB({ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }), 1);
+}
+
+//============================================================================
+// BVH経由: パケット版の最近ヒットはスカラー版と一致する
+//============================================================================
+TAKEC_TEST(RayPacket_BatchMatchesScalarRayCast) {
+	FastRandom random(5);
+	for (uint32_t trial = 0; trial < 5; ++trial) {
+		const std::vector<std::unique_ptr<TestCollider>> colliders = MakeRandomColliders(random, 500, 30.0f);
+		const std::vector<Ray> rays = MakeRandomRays(random, 2001, 35.0f);
+
+		DynamicAABBTree tree;
+		for (const std::unique_ptr<TestCollider>& collider : colliders) {
+			tree.CreateProxy(collider->GetWorldAABB(), 1u, collider.get());
+		}
+
+		uint32_t hitCount = 0;
+		std::vector<TestHit> packetHits(RayPacket::kLaneCount);
+		for (size_t first = 0; first < rays.size(); first += RayPacket::kLaneCount) {
+			std::span<const Ray> packetRays(rays.data() + first, std::min<size_t>(RayPacket::kLaneCount, rays.size() - first));
+			RayCastPacket(tree, packetRays, packetHits);
+
+			for (size_t lane = 0; lane < packetRays.size(); ++lane) {
+				TestHit expected = RayCastScalar(tree, packetRays[lane]);
+				TAKEC_CHECK(packetHits[lane].collider == expected.collider);
+				TAKEC_CHECK_EQ(packetHits[lane].distance, expected.distance);
+				if (expected.collider) ++hitCount;
+			}
+		}
+		TAKEC_CHECK(hitCount > 100);
+	}
+}
@@ -0,0 +1,155 @@
+#include "TestFramework.h"
+#include "engine/Collision/SweepAndPrune.h"
+#include "engine/math/FastRandom.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// SweepAndPrune のテスト
+//============================================================================
+// CollisionManager が SweepAndPrune を使う前は、登録順の全ペアを総当たりで判定していた。
+// 総当たりのうちAABBが重なるペアと、SweepAndPrune が列挙するペアが
+// 同じ集合・同じ順序(登録インデックス順)になることを確認する。
+
+namespace {
+
+	//SweepAndPrune と同じ境界の余白
+	constexpr float kBoundsMargin = 1.0e-3f;
+
+	struct TestProxy {
+		AABB bounds;
+		uint32_t group;
+	};
+
+	//総当たりによるペアの列挙(旧CheckAllCollisionsForGameCharacterの二重ループと同じ順序)
+	std::vector<SweepAndPrune::Pair> ComputeBruteForcePairs(const std::vector<TestProxy>& proxies) {
+		std::vector<SweepAndPrune::Pair> pairs;
+		for (uint32_t i = 0; i < proxies.size(); ++i) {
+			for (uint32_t j = i + 1; j < proxies.size(); ++j) {
+				if (proxies[i].group == proxies[j].group) continue;
+
+				const AABB& a = proxies[i].bounds;
+				const AABB& b = proxies[j].bounds;
+				const Vector3 margin = { kBoundsMargin, kBoundsMargin, kBoundsMargin };
+				const Vector3 minA = a.min - margin, maxA = a.max + margin;
+				const Vector3 minB = b.min - margin, maxB = b.max + margin;
+				if (minA.x <= maxB.x && minB.x <= maxA.x &&
+					minA.y <= maxB.y && minB.y <= maxA.y &&
+					minA.z <= maxB.z && minB.z <= maxA.z) {
+					pairs.push_back({ i, j });
+				}
+			}
+		}
+		return pairs;
+	}
+
+	//ランダムな配置の生成
+	std::vector<TestProxy> MakeRandomProxies(FastRandom& random, uint32_t count, const Vector3& extent, float maxHalfSize, uint32_t groupCount) {
+		std::vector<TestProxy> proxies(count);
+		for (TestProxy& proxy : proxies) {
+			Vector3 center = {
+				random.NextFloat(-extent.x, extent.x),
+				random.NextFloat(-extent.y, extent.y),
+				random.NextFloat(-extent.z, extent.z)
+			};
+			Vector3 halfSize = {
+				random.NextFloat(0.0f, maxHalfSize),
+				random.NextFloat(0.0f, maxHalfSize),
+				random.NextFloat(0.0f, maxHalfSize)
+			};
+			proxy.bounds = { center - halfSize, center + halfSize };
+			proxy.group = random.NextUInt() % groupCount;
+		}
+		return proxies;
+	}
+
+	//SweepAndPrune と総当たりの結果の比較
+	void CheckMatchesBruteForce(const std::vector<TestProxy>& proxies) {
+		SweepAndPrune broadPhase;
+		for (uint32_t index = 0; index < proxies.size(); ++index) {
+			broadPhase.AddProxy(proxies[index].bounds, index, proxies[index].group);
+		}
+
+		const std::vector<SweepAndPrune::Pair>& actual = broadPhase.ComputePairs();
+		const std::vector<SweepAndPrune::Pair> expected = ComputeBruteForcePairs(proxies);
+
+		TAKEC_CHECK_EQ(actual.size(), expected.size());
+		if (actual.size() != expected.size()) return;
+		for (size_t i = 0; i < actual.size(); ++i) {
+			TAKEC_CHECK_EQ(actual[i].first, expected[i].first);
+			TAKEC_CHECK_EQ(actual[i].second, expected[i].second);
+		}
+	}
+}
+
+//============================================================================
+// 散らばった配置
+//============================================================================
+TAKEC_TEST(SweepAndPrune_MatchesBruteForce_Scattered) {
+	FastRandom random(1);
+	for (uint32_t trial = 0; trial < 20; ++trial) {
+		CheckMatchesBruteForce(MakeRandomProxies(random, 300, { 100.0f, 20.0f, 100.0f }, 4.0f, 3));
+	}
+}
+
+//============================================================================
+// 密集した配置(ほとんどのペアが重なる)
+//============================================================================
+TAKEC_TEST(SweepAndPrune_MatchesBruteForce_Clustered) {
+	FastRandom random(2);
+	for (uint32_t trial = 0; trial < 20; ++trial) {
+		CheckMatchesBruteForce(MakeRandomProxies(random, 120, { 5.0f, 5.0f, 5.0f }, 3.0f, 4));
+	}
+}
+
+//============================================================================
+// 1軸に並んだ配置(スイープ軸以外の2軸で弾かれるペアが多い)
+//============================================================================
+TAKEC_TEST(SweepAndPrune_MatchesBruteForce_Flat) {
+	FastRandom random(3);
+	for (uint32_t trial = 0; trial < 20; ++trial) {
+		CheckMatchesBruteForce(MakeRandomProxies(random, 300, { 0.5f, 50.0f, 0.5f }, 1.0f, 2));
+	}
+}
+
+//============================================================================
+// 面で接している・同じグループ・大きさ0のAABB
+//============================================================================
+TAKEC_TEST(SweepAndPrune_MatchesBruteForce_EdgeCases) {
+	std::vector<TestProxy> proxies;
+	// 面で接する箱の列(交互にグループを変える)
+	for (uint32_t i = 0; i < 8; ++i) {
+		float x = static_cast<float>(i);
+		proxies.push_back({ { { x, 0.0f, 0.0f }, { x + 1.0f, 1.0f, 1.0f } }, i % 2 });
+	}
+	// 余白の内側だけ離れた箱・余白より離れた箱
+	proxies.push_back({ { { 8.0f + kBoundsMargin, 0.0f, 0.0f }, { 9.0f, 1.0f, 1.0f } }, 1 });
+	proxies.push_back({ { { 8.0f + kBoundsMargin * 4.0f, 0.0f, 0.0f }, { 9.0f, 1.0f, 1.0f } }, 0 });
+	// 余白を足すとちょうど接する箱
+	proxies.push_back({ { { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 1.0f } }, 3 });
+	proxies.push_back({ { { kBoundsMargin * 2.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } }, 4 });
+	// 大きさ0の点
+	proxies.push_back({ { { 0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } }, 2 });
+	proxies.push_back({ { { 0.5f, 0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f } }, 2 });
+	CheckMatchesBruteForce(proxies);
+
+	// プロキシが0個・1個
+	CheckMatchesBruteForce({});
+	CheckMatchesBruteForce({ proxies.front() });
+}
+
+//============================================================================
+// Clear 後の再利用
+//============================================================================
+TAKEC_TEST(SweepAndPrune_ClearResetsPairs) {
+	SweepAndPrune broadPhase;
+	broadPhase.AddProxy({ { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } }, 0, 0);
+	broadPhase.AddProxy({ { 0.5f, 0.5f, 0.5f }, { 1.5f, 1.5f, 1.5f } }, 1, 1);
+	TAKEC_CHECK_EQ(broadPhase.ComputePairs().size(), size_t{ 1 });
+
+	broadPhase.Clear();
+	TAKEC_CHECK(broadPhase.ComputePairs().empty());
+}
@@ -0,0 +1,245 @@
+#include "TestFramework.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+using namespace TakeC;
+
+//============================================================================
+// MatrixMath(SSE)のテスト
+//============================================================================
+// Matrix4x4 の積と MatrixMath::Transform は m2 の行をブロードキャストした要素で線形結合しており、
+// 各要素の加算の順序は普通のスカラーの計算 ((a0*b0 + a1*b1) + a2*b2) + a3*b3 と同じになる。
+// そのためスカラーの計算とビット単位で一致することを確認する。転置・加減算も同様にビット単位で比べる。
+// 逆行列は2x2のブロックに分けて求めるため丸め誤差の出方が変わる。double で求めた逆行列との差を許容誤差で比べる。
+
+namespace {
+
+	//確認する行列の数
+	constexpr uint32_t kMatrixCount = 1000;
+	//逆行列の許容誤差(要素の大きさに対する相対誤差)
+	constexpr double kInverseTolerance = 2e-6;
+
+	Matrix4x4 MakeRandomMatrix(FastRandom& random) {
+		Matrix4x4 result;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				result.m[row][col] = random.NextFloat(-4.0f, 4.0f);
+			}
+		}
+		return result;
+	}
+
+	//逆行列を求める行列(対角成分を大きくして条件数を抑える)
+	Matrix4x4 MakeInvertibleMatrix(FastRandom& random) {
+		Matrix4x4 result = MakeRandomMatrix(random);
+		for (int i = 0; i < 4; i++) {
+			result.m[i][i] += (result.m[i][i] < 0.0f) ? -12.0f : 12.0f;
+		}
+		return result;
+	}
+
+	Matrix4x4 MakeRandomAffineMatrix(FastRandom& random) {
+		const Vector3 scale = { random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f), random.NextFloat(0.5f, 2.0f) };
+		const Vector3 rotate = { random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f), random.NextFloat(-3.14f, 3.14f) };
+		const Vector3 translate = { random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f) };
+		return MatrixMath::MakeAffineMatrix(scale, rotate, translate);
+	}
+
+	bool IsBitwiseEqual(const Matrix4x4& a, const Matrix4x4& b) {
+		return std::memcmp(a.m, b.m, sizeof(a.m)) == 0;
+	}
+
+	bool IsBitwiseEqual(const Vector3& a, const Vector3& b) {
+		return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+	}
+
+	//値の一致(符号付きのゼロを区別しない)
+	bool IsEqual(const Matrix4x4& a, const Matrix4x4& b) {
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				if (a.m[row][col] != b.m[row][col]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	//スカラーの積(結果の各要素を左から順に加算する)
+	Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2) {
+		Matrix4x4 result;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				result.m[row][col] = m1.m[row][0] * m2.m[0][col] + m1.m[row][1] * m2.m[1][col] + m1.m[row][2] * m2.m[2][col] + m1.m[row][3] * m2.m[3][col];
+			}
+		}
+		return result;
+	}
+
+	//スカラーの座標変換(wで割る)
+	Vector3 TransformScalar(const Vector3& v, const Matrix4x4& m) {
+		const float x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0];
+		const float y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1];
+		const float z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2];
+		const float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + m.m[3][3];
+		return { x / w, y / w, z / w };
+	}
+
+	//doubleで求めた逆行列(部分ピボット選択付きのガウス・ジョルダン法)
+	void InverseReference(const Matrix4x4& m, double result[4][4]) {
+		double work[4][8] = {};
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				work[row][col] = m.m[row][col];
+			}
+			work[row][4 + row] = 1.0;
+		}
+
+		for (int col = 0; col < 4; col++) {
+			int pivot = col;
+			for (int row = col + 1; row < 4; row++) {
+				if (std::abs(work[row][col]) > std::abs(work[pivot][col])) {
+					pivot = row;
+				}
+			}
+			for (int i = 0; i < 8; i++) {
+				std::swap(work[col][i], work[pivot][i]);
+			}
+
+			const double scale = 1.0 / work[col][col];
+			for (int i = 0; i < 8; i++) {
+				work[col][i] *= scale;
+			}
+			for (int row = 0; row < 4; row++) {
+				if (row == col) {
+					continue;
+				}
+				const double factor = work[row][col];
+				for (int i = 0; i < 8; i++) {
+					work[row][i] -= factor * work[col][i];
+				}
+			}
+		}
+
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				result[row][col] = work[row][4 + col];
+			}
+		}
+	}
+
+	//逆行列とdoubleの逆行列との最大の相対誤差(行列の最大要素を基準にする)
+	double InverseError(const Matrix4x4& m) {
+		const Matrix4x4 inverse = MatrixMath::Inverse(m);
+		double reference[4][4] = {};
+		InverseReference(m, reference);
+
+		double maxElement = 0.0;
+		double maxError = 0.0;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				maxElement = (std::max)(maxElement, std::abs(reference[row][col]));
+				maxError = (std::max)(maxError, std::abs(static_cast<double>(inverse.m[row][col]) - reference[row][col]));
+			}
+		}
+		return maxError / maxElement;
+	}
+}
+
+//============================================================================
+// 積はスカラーの計算とビット単位で一致する
+//============================================================================
+TAKEC_TEST(MatrixMath_MultiplyMatchesScalar) {
+	FastRandom random(5);
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		const Matrix4x4 a = MakeRandomMatrix(random);
+		const Matrix4x4 b = (i % 2 == 0) ? MakeRandomMatrix(random) : MakeRandomAffineMatrix(random);
+		const Matrix4x4 expected = MultiplyScalar(a, b);
+
+		mismatchCount += IsBitwiseEqual(MatrixMath::Multiply(a, b), expected) ? 0 : 1;
+
+		//operator*= は自分自身を読み終えてから書き込む
+		Matrix4x4 assigned = a;
+		assigned *= b;
+		mismatchCount += IsBitwiseEqual(assigned, expected) ? 0 : 1;
+
+		Matrix4x4 squared = a;
+		squared *= squared;
+		mismatchCount += IsBitwiseEqual(squared, MultiplyScalar(a, a)) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+}
+
+//============================================================================
+// 転置・加減算はスカラーの計算とビット単位で一致する
+//============================================================================
+TAKEC_TEST(MatrixMath_TransposeAddSubtractMatchScalar) {
+	FastRandom random(6);
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		const Matrix4x4 a = MakeRandomMatrix(random);
+		const Matrix4x4 b = MakeRandomMatrix(random);
+
+		Matrix4x4 transposed;
+		Matrix4x4 sum;
+		Matrix4x4 difference;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				transposed.m[row][col] = a.m[col][row];
+				sum.m[row][col] = a.m[row][col] + b.m[row][col];
+				difference.m[row][col] = a.m[row][col] - b.m[row][col];
+			}
+		}
+
+		mismatchCount += IsBitwiseEqual(MatrixMath::Transpose(a), transposed) ? 0 : 1;
+		mismatchCount += IsBitwiseEqual(MatrixMath::Add(a, b), sum) ? 0 : 1;
+		mismatchCount += IsBitwiseEqual(MatrixMath::Subtract(a, b), difference) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+}
+
+//============================================================================
+// 座標変換はスカラーの計算とビット単位で一致する(透視投影のwでの除算を含む)
+//============================================================================
+TAKEC_TEST(MatrixMath_TransformMatchesScalar) {
+	FastRandom random(7);
+	const Matrix4x4 projection = MatrixMath::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		const Matrix4x4 world = MakeRandomAffineMatrix(random);
+		const Matrix4x4 worldViewProjection = MatrixMath::Multiply(world, projection);
+		const Vector3 point = { random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f), random.NextFloat(-10.0f, 10.0f) };
+
+		mismatchCount += IsBitwiseEqual(MatrixMath::Transform(point, world), TransformScalar(point, world)) ? 0 : 1;
+		mismatchCount += IsBitwiseEqual(MatrixMath::Transform(point, worldViewProjection), TransformScalar(point, worldViewProjection)) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(mismatchCount, 0u);
+}
+
+//============================================================================
+// 逆行列はdoubleで求めた逆行列と許容誤差内で一致する
+//============================================================================
+TAKEC_TEST(MatrixMath_InverseMatchesReference) {
+	FastRandom random(8);
+	double maxGeneralError = 0.0;
+	double maxAffineError = 0.0;
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		maxGeneralError = (std::max)(maxGeneralError, InverseError(MakeInvertibleMatrix(random)));
+		maxAffineError = (std::max)(maxAffineError, InverseError(MakeRandomAffineMatrix(random)));
+	}
+	TAKEC_CHECK_NEAR(maxGeneralError, 0.0, kInverseTolerance);
+	TAKEC_CHECK_NEAR(maxAffineError, 0.0, kInverseTolerance);
+
+	//単位行列・平行移動行列は誤差無く求まる
+	TAKEC_CHECK(IsEqual(MatrixMath::Inverse(MatrixMath::MakeIdentity4x4()), MatrixMath::MakeIdentity4x4()));
+	TAKEC_CHECK(IsEqual(MatrixMath::Inverse(MatrixMath::MakeTranslateMatrix({ 1.0f, -2.0f, 4.0f })),
+		MatrixMath::MakeTranslateMatrix({ -1.0f, 2.0f, -4.0f })));
+}
@@ -0,0 +1,186 @@
+#include "TestFramework.h"
+#include "engine/3d/Particle/EffectGroupPool.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// EffectGroupPool のテスト
+//============================================================================
+// EffectGroupPool は設定ファイル毎に構築済みの EffectGroup を持ち、Acquire で空きを貸し出して(なければ構築し)、
+// Release・PlayOneShot の終了で空きへ戻す。エミッターの無い設定の EffectGroup はデバイスを使わないため、
+// JsonLoader の代わりに設定を返す読み込み関数を渡したプールで、Prewarm・貸し出し・返却・1回再生の
+// 自動返却と、ヒット・ミス・貸し出し中の数の集計を確認する。
+
+namespace {
+
+	//テストで使う設定ファイル名
+	const std::string kHitEffect = "Hit.json";
+	const std::string kLoopEffect = "Loop.json";
+
+	/// <summary>
+	/// 設定ファイル毎の読み込み回数を数える、エミッターの無い設定の読み込み
+	/// </summary>
+	struct TestConfigLoader {
+		std::map<std::string, uint32_t> loadCounts;
+
+		EffectGroupPool::ConfigLoader Get() {
+			return [this](const std::string& configFilePath) {
+				++loadCounts[configFilePath];
+				EffectGroupConfig config;
+				config.effectName = configFilePath;
+				config.isLooping = (configFilePath == kLoopEffect);
+				return config;
+			};
+		}
+	};
+
+	//設定ファイルの統計のコピー(未使用の設定ファイルは全て0)
+	EffectGroupPool::Stats GetStats(const EffectGroupPool& pool, const std::string& configFilePath) {
+		const EffectGroupPool::Stats* stats = pool.GetStats(configFilePath);
+		return stats ? *stats : EffectGroupPool::Stats{};
+	}
+}
+
+//============================================================================
+// Prewarm した分は貸し出しでヒットし、足りない分だけ構築する
+//============================================================================
+TAKEC_TEST(EffectGroupPool_PrewarmThenBorrow) {
+	TestConfigLoader loader;
+	EffectGroupPool pool(loader.Get());
+	TAKEC_CHECK(pool.GetStats(kHitEffect) == nullptr);
+
+	pool.Prewarm(kHitEffect, 2);
+	EffectGroupPool::Stats stats = GetStats(pool, kHitEffect);
+	TAKEC_CHECK_EQ(stats.prewarmCount, 2u);
+	TAKEC_CHECK_EQ(stats.totalCount, 2u);
+	TAKEC_CHECK_EQ(stats.inUseCount, 0u);
+
+	//2つはプールから、3つ目は新しく構築する
+	std::vector<EffectGroup*> effects;
+	for (uint32_t i = 0; i < 3; ++i) {
+		effects.push_back(pool.Acquire(kHitEffect));
+	}
+	TAKEC_CHECK(effects[0] != effects[1] && effects[1] != effects[2] && effects[0] != effects[2]);
+	stats = GetStats(pool, kHitEffect);
+	TAKEC_CHECK_EQ(stats.hitCount, 2u);
+	TAKEC_CHECK_EQ(stats.missCount, 1u);
+	TAKEC_CHECK_EQ(stats.inUseCount, 3u);
+	TAKEC_CHECK_EQ(stats.peakInUse, 3u);
+	TAKEC_CHECK_EQ(stats.totalCount, 3u);
+
+	//返却したものを次の貸し出しで再利用する(初期化直後の状態に戻っている)
+	effects[1]->Play({ 1.0f, 2.0f, 3.0f });
+	pool.Release(effects[1]);
+	TAKEC_CHECK_EQ(GetStats(pool, kHitEffect).inUseCount, 2u);
+	EffectGroup* reused = pool.Acquire(kHitEffect);
+	TAKEC_CHECK(reused == effects[1]);
+	TAKEC_CHECK(!reused->IsPlaying());
+	TAKEC_CHECK_EQ(reused->GetPosition().x, 0.0f);
+
+	//構築済みの数が足りていれば Prewarm は何もしない
+	pool.Prewarm(kHitEffect, 3);
+	stats = GetStats(pool, kHitEffect);
+	TAKEC_CHECK_EQ(stats.hitCount, 3u);
+	TAKEC_CHECK_EQ(stats.missCount, 1u);
+	TAKEC_CHECK_EQ(stats.prewarmCount, 2u);
+	TAKEC_CHECK_EQ(stats.inUseCount, 3u);
+	TAKEC_CHECK_EQ(stats.peakInUse, 3u);
+	TAKEC_CHECK_EQ(stats.totalCount, 3u);
+
+	//設定の読み込みは設定ファイル毎に1回だけ
+	TAKEC_CHECK_EQ(loader.loadCounts[kHitEffect], 1u);
+}
+
+//============================================================================
+// PlayOneShot で再生したものは終了した Update で自動で返却される
+//============================================================================
+TAKEC_TEST(EffectGroupPool_OneShotAutoRelease) {
+	TestConfigLoader loader;
+	EffectGroupPool pool(loader.Get());
+
+	//ループ設定のエフェクトでも1回で終わる
+	EffectGroup* oneShot = pool.PlayOneShot(kLoopEffect, { 0.0f, 5.0f, 0.0f });
+	TAKEC_CHECK(oneShot->IsPlaying());
+	TAKEC_CHECK(!oneShot->IsLooping());
+	TAKEC_CHECK_EQ(oneShot->GetPosition().y, 5.0f);
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).inUseCount, 1u);
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).missCount, 1u);
+
+	pool.Update();
+	TAKEC_CHECK(oneShot->IsFinished());
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).inUseCount, 0u);
+
+	//返却後の貸し出しでは設定のループ再生に戻る
+	EffectGroup* borrowed = pool.Acquire(kLoopEffect);
+	TAKEC_CHECK(borrowed == oneShot);
+	TAKEC_CHECK(borrowed->IsLooping());
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).hitCount, 1u);
+
+	//貸し出し中のものは Update で返却しない
+	pool.Update();
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).inUseCount, 1u);
+	pool.Release(borrowed);
+	TAKEC_CHECK_EQ(GetStats(pool, kLoopEffect).inUseCount, 0u);
+}
+
+//============================================================================
+// 終了前に返却した1回再生は、Update で二重に返却しない
+//============================================================================
+TAKEC_TEST(EffectGroupPool_ReleaseOneShotBeforeFinish) {
+	TestConfigLoader loader;
+	EffectGroupPool pool(loader.Get());
+	pool.Prewarm(kHitEffect, 1);
+
+	EffectGroup* oneShot = pool.PlayOneShot(kHitEffect, { 0.0f, 0.0f, 0.0f });
+	pool.Release(oneShot);
+	TAKEC_CHECK_EQ(GetStats(pool, kHitEffect).inUseCount, 0u);
+
+	//別の使用者に貸し出した後の Update で、前の1回再生として返却されない
+	EffectGroup* borrowed = pool.Acquire(kHitEffect);
+	TAKEC_CHECK(borrowed == oneShot);
+	pool.Update();
+	const EffectGroupPool::Stats stats = GetStats(pool, kHitEffect);
+	TAKEC_CHECK_EQ(stats.inUseCount, 1u);
+	TAKEC_CHECK_EQ(stats.hitCount, 2u);
+	TAKEC_CHECK_EQ(stats.missCount, 0u);
+	TAKEC_CHECK_EQ(stats.totalCount, 1u);
+}
+
+//============================================================================
+// ReleaseAll は全ての設定ファイルの貸し出しを返却し、統計は合計できる
+//============================================================================
+TAKEC_TEST(EffectGroupPool_ReleaseAllAndTotals) {
+	TestConfigLoader loader;
+	EffectGroupPool pool(loader.Get());
+	pool.Prewarm(kHitEffect, 1);
+	pool.Acquire(kHitEffect);
+	pool.Acquire(kHitEffect);
+	pool.PlayOneShot(kLoopEffect, { 0.0f, 0.0f, 0.0f });
+
+	EffectGroupPool::Stats total = pool.GetTotalStats();
+	TAKEC_CHECK_EQ(total.hitCount, 1u);
+	TAKEC_CHECK_EQ(total.missCount, 2u);
+	TAKEC_CHECK_EQ(total.prewarmCount, 1u);
+	TAKEC_CHECK_EQ(total.inUseCount, 3u);
+	TAKEC_CHECK_EQ(total.totalCount, 3u);
+
+	pool.ReleaseAll();
+	total = pool.GetTotalStats();
+	TAKEC_CHECK_EQ(total.inUseCount, 0u);
+	TAKEC_CHECK_EQ(total.totalCount, 3u);
+
+	//返却済みの1回再生は Update で返却しない(貸し出し中の数が負にならない)
+	pool.Update();
+	TAKEC_CHECK_EQ(pool.GetTotalStats().inUseCount, 0u);
+
+	//Clear 後は設定を読み込み直す
+	pool.Clear();
+	TAKEC_CHECK(pool.GetStats(kHitEffect) == nullptr);
+	pool.Acquire(kHitEffect);
+	TAKEC_CHECK_EQ(loader.loadCounts[kHitEffect], 2u);
+}
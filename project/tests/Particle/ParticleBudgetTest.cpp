@@ -0,0 +1,249 @@
+#include "TestFramework.h"
+#include "engine/3d/Particle/ParticleBudget.h"
+#include "engine/math/FastRandom.h"
+#include "engine/math/MatrixMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// ParticleBudget のテスト
+//============================================================================
+// ParticleManager は毎フレーム、全グループの生存数で BeginFrame を呼び、アクティブなカメラを SetView で設定してから、
+// Emit の度に RequestEmit で発生数を予算の範囲に収める。PrimitiveParticle の生成にはデバイスが必要なため、
+// 同じ手順を寿命だけを持つパーティクルで再現し、多数のエミッターが上限を大きく超えて発生させ続ける場面でも
+// 生存数が上限を超えないこと・優先度の高いエフェクトの分が残ること・画面外と遠距離の発生が減ることを確認する。
+
+namespace {
+
+	//カメラ(原点から+zを向く)
+	constexpr float kFovY = 0.45f;
+	constexpr float kAspectRatio = 16.0f / 9.0f;
+	constexpr float kNearClip = 0.1f;
+	constexpr float kFarClip = 1000.0f;
+
+	/// <summary>
+	/// Camera と同じ手順で作ったビュープロジェクション行列
+	/// </summary>
+	Matrix4x4 MakeViewProjection(const Vector3& cameraPosition) {
+		Matrix4x4 world = MatrixMath::MakeTranslateMatrix(cameraPosition);
+		Matrix4x4 projection = MatrixMath::MakePerspectiveFovMatrix(kFovY, kAspectRatio, kNearClip, kFarClip);
+		return MatrixMath::Multiply(MatrixMath::Inverse(world), projection);
+	}
+
+	ParticleAttributes MakeAttributes(ParticlePriority priority) {
+		ParticleAttributes attributes;
+		attributes.budgetPriority = static_cast<uint32_t>(priority);
+		return attributes;
+	}
+
+	/// <summary>
+	/// テスト用のエミッター(一定間隔で一定数を発生させる)
+	/// </summary>
+	struct TestEmitter {
+		ParticleAttributes attributes;
+		Vector3 position;
+		uint32_t count = 0;
+		uint32_t interval = 1;     //発生させるフレームの間隔
+		uint32_t minLifetime = 0;  //発生したパーティクルの寿命(フレーム数)
+		uint32_t maxLifetime = 0;
+	};
+
+	/// <summary>
+	/// テスト用のパーティクル(寿命と発生元の優先度だけを持つ)
+	/// </summary>
+	struct TestParticle {
+		uint32_t deathFrame = 0;
+		uint32_t priority = 0;
+	};
+}
+
+//============================================================================
+// 上限を大きく超える発生が続いても生存数が上限を超えず、優先度の高い発生が通る
+//============================================================================
+TAKEC_TEST(ParticleBudget_CapRespectedInWorstCaseScene) {
+	constexpr uint32_t kMaxParticles = 4096;
+	constexpr uint32_t kFrameCount = 600;
+
+	ParticleBudget budget;
+	budget.Initialize(kMaxParticles);
+	budget.SetRandomSeed(61);
+
+	FastRandom random(62);
+	std::vector<TestEmitter> emitters;
+	//常に発生し続ける煙(低優先度)と火花(通常)。どちらも単独で上限を超える量を発生させる
+	for (uint32_t i = 0; i < 64; ++i) {
+		const Vector3 position = { random.NextFloat(-10.0f, 10.0f), random.NextFloat(-5.0f, 5.0f), random.NextFloat(15.0f, 25.0f) };
+		emitters.push_back({ MakeAttributes(ParticlePriority::Low), position, 32, 1, 120, 240 });
+		emitters.push_back({ MakeAttributes(ParticlePriority::Normal), position, 16, 2, 60, 120 });
+	}
+	//一定間隔の爆発(高優先度)。寿命が間隔より短く、上限の1割の余白に収まる量
+	for (uint32_t i = 0; i < 4; ++i) {
+		const Vector3 position = { random.NextFloat(-5.0f, 5.0f), 0.0f, 20.0f };
+		emitters.push_back({ MakeAttributes(ParticlePriority::High), position, 96, 30, 10, 25 });
+	}
+
+	const Vector3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+	const Matrix4x4 viewProjection = MakeViewProjection(cameraPosition);
+
+	std::vector<TestParticle> particles;
+	uint64_t requestedCount = 0;
+	uint32_t maxLiveCount = 0;
+	uint32_t overBudgetFrameCount = 0;
+	uint32_t mismatchFrameCount = 0;
+	uint32_t highRequestedCount = 0;
+	uint32_t highAllowedCount = 0;
+	for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+		//寿命の尽きたパーティクルを削除してから、生存数で予算を更新する
+		std::erase_if(particles, [frame](const TestParticle& particle) { return particle.deathFrame <= frame; });
+		budget.BeginFrame(static_cast<uint32_t>(particles.size()));
+		budget.SetView(viewProjection, cameraPosition);
+
+		for (const TestEmitter& emitter : emitters) {
+			if (frame % emitter.interval != 0) {
+				continue;
+			}
+			requestedCount += emitter.count;
+			const uint32_t allowed = budget.RequestEmit(emitter.attributes, emitter.position, emitter.count);
+			TAKEC_CHECK(allowed <= emitter.count);
+			if (emitter.attributes.budgetPriority == static_cast<uint32_t>(ParticlePriority::High)) {
+				highRequestedCount += emitter.count;
+				highAllowedCount += allowed;
+			}
+			for (uint32_t i = 0; i < allowed; ++i) {
+				const uint32_t lifetime = emitter.minLifetime + random.NextUInt() % (emitter.maxLifetime - emitter.minLifetime + 1);
+				particles.push_back({ frame + lifetime, emitter.attributes.budgetPriority });
+			}
+		}
+
+		const uint32_t liveCount = static_cast<uint32_t>(particles.size());
+		maxLiveCount = (std::max)(maxLiveCount, liveCount);
+		overBudgetFrameCount += liveCount > kMaxParticles ? 1 : 0;
+		//予算の数える生存数と、実際に発生させた数が一致する
+		mismatchFrameCount += liveCount == budget.GetLiveCount() ? 0 : 1;
+	}
+
+	//上限を大きく超える発生を要求した場面である
+	TAKEC_CHECK(requestedCount > static_cast<uint64_t>(kMaxParticles) * 20);
+	TAKEC_CHECK_EQ(overBudgetFrameCount, 0u);
+	TAKEC_CHECK_EQ(mismatchFrameCount, 0u);
+	//上限付近まで使われている(予算が厳しすぎない)
+	TAKEC_CHECK(maxLiveCount > kMaxParticles * 9 / 10);
+	//低・通常の優先度が上限の手前で止まるので、高優先度の爆発は毎回全て発生する
+	TAKEC_CHECK(highRequestedCount > 0);
+	TAKEC_CHECK_EQ(highAllowedCount, highRequestedCount);
+
+	//上限を下げると、次のフレームから新たな発生が止まる
+	budget.SetMaxParticles(1024);
+	budget.BeginFrame(static_cast<uint32_t>(particles.size()));
+	TAKEC_CHECK_EQ(budget.GetRemaining(), 0u);
+	TAKEC_CHECK_EQ(budget.RequestEmit(MakeAttributes(ParticlePriority::High), { 0.0f, 0.0f, 20.0f }, 10), 0u);
+	TAKEC_CHECK_EQ(budget.GetDroppedCount(), 10u);
+}
+
+//============================================================================
+// 優先度毎に使える割合(低:7割・通常:9割・高:全て)で止まる
+//============================================================================
+TAKEC_TEST(ParticleBudget_PriorityShares) {
+	constexpr uint32_t kMaxParticles = 1000;
+	const ParticlePriority priorities[] = { ParticlePriority::Low, ParticlePriority::Normal, ParticlePriority::High };
+	const uint32_t limits[] = { 700, 900, 1000 };
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		ParticleBudget budget;
+		budget.Initialize(kMaxParticles);
+		budget.BeginFrame(0);
+		uint32_t allowed = 0;
+		for (uint32_t request = 0; request < 100; ++request) {
+			allowed += budget.RequestEmit(MakeAttributes(priorities[i]), { 0.0f, 0.0f, 0.0f }, 50);
+		}
+		TAKEC_CHECK_EQ(allowed, limits[i]);
+		TAKEC_CHECK_EQ(budget.GetLiveCount(), limits[i]);
+		TAKEC_CHECK_EQ(budget.GetDroppedCount(), 5000u - limits[i]);
+	}
+
+	//範囲外の優先度は高優先度として扱う
+	ParticleBudget budget;
+	budget.Initialize(kMaxParticles);
+	budget.BeginFrame(0);
+	ParticleAttributes attributes;
+	attributes.budgetPriority = 10;
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, 0.0f }, 2000), kMaxParticles);
+}
+
+//============================================================================
+// 画面外のエミッターは発生させない(発生範囲の分は画面外でも発生させる)
+//============================================================================
+TAKEC_TEST(ParticleBudget_CullsOffscreenEmitters) {
+	ParticleBudget budget;
+	budget.Initialize(100000);
+	budget.BeginFrame(0);
+	const Vector3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+	budget.SetView(MakeViewProjection(cameraPosition), cameraPosition);
+
+	ParticleAttributes attributes = MakeAttributes(ParticlePriority::Normal);
+	attributes.positionRange = { -1.0f, 1.0f };
+
+	//正面
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, 10.0f }, 20), 20u);
+	//背後・真横・遠クリップの外
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, -10.0f }, 20), 0u);
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 50.0f, 0.0f, 10.0f }, 20), 0u);
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, kFarClip + 50.0f }, 20), 0u);
+	TAKEC_CHECK_EQ(budget.GetCulledEmitCount(), 3u);
+	TAKEC_CHECK_EQ(budget.GetDroppedCount(), 60u);
+
+	//中心は画面の少し外でも、発生範囲が画面に入るなら発生させる
+	const float edgeX = 10.0f * std::tan(kFovY * 0.5f) * kAspectRatio;
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { edgeX + 2.0f, 0.0f, 10.0f }, 20), 20u);
+	attributes.positionRange = { -0.1f, 0.1f };
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { edgeX + 3.0f, 0.0f, 10.0f }, 20), 0u);
+
+	//画面外判定を無効にする・カメラを解除すると発生させる
+	budget.SetEnableCulling(false);
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, -10.0f }, 20), 20u);
+	budget.SetEnableCulling(true);
+	budget.ClearView();
+	TAKEC_CHECK_EQ(budget.RequestEmit(attributes, { 0.0f, 0.0f, -10.0f }, 20), 20u);
+
+	//統計は BeginFrame でリセットされる
+	budget.BeginFrame(0);
+	TAKEC_CHECK_EQ(budget.GetCulledEmitCount(), 0u);
+	TAKEC_CHECK_EQ(budget.GetDroppedCount(), 0u);
+}
+
+//============================================================================
+// カメラからの距離に応じて発生数が減り、平均の発生率が保たれる
+//============================================================================
+TAKEC_TEST(ParticleBudget_ScalesEmissionWithDistance) {
+	constexpr uint32_t kRequestCount = 4000;
+	constexpr uint32_t kCount = 5;
+
+	ParticleBudget budget;
+	budget.Initialize(kRequestCount * kCount);
+	budget.SetRandomSeed(63);
+	budget.SetLodDistance(30.0f, 150.0f);
+	budget.SetMinEmitRate(0.2f);
+	const Vector3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+	budget.SetView(MakeViewProjection(cameraPosition), cameraPosition);
+
+	//距離と期待する発生率(間引き始める距離まで1、最も遠い距離で最小の発生率、その間は線形)
+	const float distances[] = { 20.0f, 90.0f, 150.0f, 400.0f };
+	const float rates[] = { 1.0f, 0.6f, 0.2f, 0.2f };
+	//上限で止まらないよう、全ての発生が上限に収まる高優先度で要求する
+	const ParticleAttributes attributes = MakeAttributes(ParticlePriority::High);
+	for (uint32_t i = 0; i < 4; ++i) {
+		budget.BeginFrame(0);
+		uint32_t allowed = 0;
+		for (uint32_t request = 0; request < kRequestCount; ++request) {
+			allowed += budget.RequestEmit(attributes, { 0.0f, 0.0f, distances[i] }, kCount);
+		}
+		const float rate = static_cast<float>(allowed) / static_cast<float>(kRequestCount * kCount);
+		TAKEC_CHECK_NEAR(rate, rates[i], 0.02f);
+		TAKEC_CHECK_EQ(budget.GetCulledEmitCount(), 0u);
+	}
+}
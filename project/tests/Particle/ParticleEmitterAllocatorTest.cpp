@@ -0,0 +1,181 @@
+#include "TestFramework.h"
+#include "engine/3d/Particle/ParticleEmitterAllocater.h"
+#include "engine/3d/Particle/ParticleEmitter.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+//============================================================================
+// ParticleEmitterAllocator のテスト
+//============================================================================
+// エミッターIDは「世代(上位15bit) | スロット番号(下位16bit)」で、解放の度にスロットの世代を進めて
+// 解放済みのIDを無効にする。パーティクル側はIDを int32_t で保持するため、世代は1～0x7FFFを循環し、
+// IDは常に正の値になる必要がある。ParticleEmitter は Initialize を呼ばなければデバイスを使わないため、
+// 位置・方向・スケールだけを設定したエミッターで割り当て・解放・再利用・Clear・世代の循環を確認する。
+
+namespace {
+
+	//スロット番号のビット数と、世代の最大値(ParticleEmitterAllocator と同じ)
+	constexpr uint32_t kSlotIndexBits = 16;
+	constexpr uint32_t kMaxGeneration = 0x7FFFu;
+
+	uint32_t ToSlotIndex(uint32_t emitterID) { return emitterID & ((1u << kSlotIndexBits) - 1); }
+	uint32_t ToGeneration(uint32_t emitterID) { return emitterID >> kSlotIndexBits; }
+
+	std::unique_ptr<ParticleEmitter> MakeEmitter(float x) {
+		auto emitter = std::make_unique<ParticleEmitter>();
+		emitter->SetTranslate({ x, 0.0f, 0.0f });
+		emitter->SetScale({ 1.0f, 1.0f, 1.0f });
+		emitter->SetEmitDirection({ 0.0f, 1.0f, 0.0f });
+		return emitter;
+	}
+
+	//IDで引ける全ての取得が無効になっているか
+	bool IsInvalid(const ParticleEmitterAllocator& allocator, uint32_t emitterID) {
+		return allocator.GetEmitter(emitterID) == nullptr &&
+			allocator.FindTransform(emitterID) == nullptr &&
+			!allocator.GetEmitterPosition(emitterID).has_value() &&
+			!allocator.GetEmitDirection(emitterID).has_value() &&
+			!allocator.GetEmitterScale(emitterID).has_value();
+	}
+}
+
+//============================================================================
+// 割り当て・解放・空きスロットの再利用
+//============================================================================
+TAKEC_TEST(ParticleEmitterAllocator_AllocateReleaseReuse) {
+	ParticleEmitterAllocator allocator;
+	std::vector<std::unique_ptr<ParticleEmitter>> emitters;
+	std::vector<uint32_t> ids;
+	for (uint32_t i = 0; i < 3; ++i) {
+		emitters.push_back(MakeEmitter(static_cast<float>(i)));
+		ids.push_back(allocator.Allocate(emitters.back().get()));
+	}
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 3u);
+	for (uint32_t i = 0; i < 3; ++i) {
+		TAKEC_CHECK(static_cast<int32_t>(ids[i]) > 0);
+		TAKEC_CHECK_EQ(ToSlotIndex(ids[i]), i);
+		TAKEC_CHECK(allocator.GetEmitter(ids[i]) == emitters[i].get());
+		const std::optional<Vector3> position = allocator.GetEmitterPosition(ids[i]);
+		TAKEC_CHECK(position.has_value() && position->x == static_cast<float>(i));
+		TAKEC_CHECK(allocator.FindTransform(ids[i]) != nullptr);
+	}
+
+	//0(追従なし)と範囲外のスロットは無効
+	TAKEC_CHECK(IsInvalid(allocator, 0));
+	TAKEC_CHECK(IsInvalid(allocator, (1u << kSlotIndexBits) | 100u));
+
+	//解放したIDは無効になり、2回目の解放は何もしない
+	allocator.Release(ids[1]);
+	TAKEC_CHECK(IsInvalid(allocator, ids[1]));
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 2u);
+	allocator.Release(ids[1]);
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 2u);
+
+	//空きスロットを再利用し、世代の違う新しいIDを発行する(古いIDは無効のまま)
+	auto reused = MakeEmitter(10.0f);
+	const uint32_t reusedID = allocator.Allocate(reused.get());
+	TAKEC_CHECK_EQ(ToSlotIndex(reusedID), ToSlotIndex(ids[1]));
+	TAKEC_CHECK(reusedID != ids[1]);
+	TAKEC_CHECK(allocator.GetEmitter(reusedID) == reused.get());
+	TAKEC_CHECK(IsInvalid(allocator, ids[1]));
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 3u);
+
+	//古いIDでの解放は新しい登録を消さない
+	allocator.Release(ids[1]);
+	TAKEC_CHECK(allocator.GetEmitter(reusedID) == reused.get());
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 3u);
+}
+
+//============================================================================
+// 姿勢のスナップショットは SyncTransforms で更新される
+//============================================================================
+TAKEC_TEST(ParticleEmitterAllocator_SyncTransforms) {
+	ParticleEmitterAllocator allocator;
+	auto emitter = MakeEmitter(1.0f);
+	const uint32_t id = allocator.Allocate(emitter.get());
+	TAKEC_CHECK_EQ(allocator.FindTransform(id)->position.x, 1.0f);
+
+	//登録中のエミッターを動かしても、次の SyncTransforms までは割り当て時の姿勢のまま
+	emitter->SetTranslate({ 5.0f, 0.0f, 0.0f });
+	emitter->SetEmitDirection({ 0.0f, 0.0f, 1.0f });
+	TAKEC_CHECK_EQ(allocator.FindTransform(id)->position.x, 1.0f);
+	const std::optional<Vector3> position = allocator.GetEmitterPosition(id);
+	TAKEC_CHECK(position.has_value() && position->x == 5.0f);
+
+	allocator.SyncTransforms();
+	TAKEC_CHECK_EQ(allocator.FindTransform(id)->position.x, 5.0f);
+	TAKEC_CHECK_EQ(allocator.FindTransform(id)->direction.z, 1.0f);
+}
+
+//============================================================================
+// Clear は発行済みの全てのIDを無効にし、スロットは再利用される
+//============================================================================
+TAKEC_TEST(ParticleEmitterAllocator_ClearInvalidatesAll) {
+	ParticleEmitterAllocator allocator;
+	std::vector<std::unique_ptr<ParticleEmitter>> emitters;
+	std::vector<uint32_t> ids;
+	for (uint32_t i = 0; i < 8; ++i) {
+		emitters.push_back(MakeEmitter(static_cast<float>(i)));
+		ids.push_back(allocator.Allocate(emitters.back().get()));
+	}
+	allocator.Release(ids[3]);
+
+	allocator.Clear();
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 0u);
+	uint32_t validCount = 0;
+	for (uint32_t id : ids) {
+		validCount += IsInvalid(allocator, id) ? 0 : 1;
+	}
+	TAKEC_CHECK_EQ(validCount, 0u);
+
+	//再割り当てはスロットを増やさずに再利用し、Clear 前のIDとは一致しない
+	uint32_t reusedCount = 0;
+	uint32_t collidedCount = 0;
+	for (uint32_t i = 0; i < 8; ++i) {
+		const uint32_t id = allocator.Allocate(emitters[i].get());
+		reusedCount += ToSlotIndex(id) < 8 ? 1 : 0;
+		for (uint32_t oldID : ids) {
+			collidedCount += (id == oldID) ? 1 : 0;
+		}
+	}
+	TAKEC_CHECK_EQ(reusedCount, 8u);
+	TAKEC_CHECK_EQ(collidedCount, 0u);
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 8u);
+}
+
+//============================================================================
+// 世代は 0x7FFF の次に 1 へ戻り、IDは int32_t で常に正の値になる
+//============================================================================
+TAKEC_TEST(ParticleEmitterAllocator_GenerationWraps) {
+	ParticleEmitterAllocator allocator;
+	auto emitter = MakeEmitter(0.0f);
+
+	//同じスロットを割り当て・解放し続けて世代を一周させる
+	uint32_t previousID = allocator.Allocate(emitter.get());
+	TAKEC_CHECK_EQ(ToGeneration(previousID), 1u);
+	uint32_t nonPositiveCount = 0;
+	uint32_t staleValidCount = 0;
+	uint32_t wrapCount = 0;
+	for (uint32_t i = 0; i < kMaxGeneration + 1; ++i) {
+		allocator.Release(previousID);
+		const uint32_t id = allocator.Allocate(emitter.get());
+		nonPositiveCount += static_cast<int32_t>(id) > 0 ? 0 : 1;
+		staleValidCount += IsInvalid(allocator, previousID) ? 0 : 1;
+		if (ToGeneration(previousID) == kMaxGeneration) {
+			//0x7FFF の次は 0 や 0x8000 ではなく 1
+			TAKEC_CHECK_EQ(ToGeneration(id), 1u);
+			++wrapCount;
+		} else {
+			TAKEC_CHECK_EQ(ToGeneration(id), ToGeneration(previousID) + 1);
+		}
+		TAKEC_CHECK_EQ(ToSlotIndex(id), 0u);
+		previousID = id;
+	}
+	TAKEC_CHECK_EQ(nonPositiveCount, 0u);
+	TAKEC_CHECK_EQ(staleValidCount, 0u);
+	TAKEC_CHECK_EQ(wrapCount, 1u);
+	TAKEC_CHECK_EQ(allocator.GetActiveEmitterCount(), 1u);
+}
@@ -0,0 +1,327 @@
+#include "TestFramework.h"
+#include "engine/3d/Particle/ParticlePool.h"
+#include "engine/Utility/JobSystem.h"
+#include "engine/base/TakeCFrameWork.h"
+#include "engine/math/FastRandom.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// 並列のパーティクル更新のテスト
+//============================================================================
+// ParticleManager は PrimitiveParticle の更新を BeginUpdate → UpdateRange(並列) → MergeUpdate(直列) に分け、
+// JobSystem::ParallelFor でチャンク毎に処理している。結果がスレッド数に依らず1スレッドと同じになるには、
+//  - 各インデックスがちょうど1回だけ処理されること
+//  - UpdateRange が自分の範囲だけを書き、生成予約をチャンク毎のリストに積むこと
+//  - MergeUpdate が削除と予約の反映を固定の順序で行うこと
+// が必要になる。PrimitiveParticle の生成にはデバイスが必要なため、同じ手順を ParticlePool 上で再現し、
+// ワーカー有り・無しで多数のパーティクルを長時間更新した結果がビット単位で一致することを確認する。
+
+namespace {
+
+	//PrimitiveParticle::kUpdateChunkSize_ と同じチャンクの大きさ
+	constexpr uint32_t kUpdateChunkSize = 2048;
+	//テストで使うワーカースレッド数
+	constexpr uint32_t kWorkerCount = 4;
+
+	/// <summary>
+	/// テスト中だけワーカースレッドを起動する(終了時は他のテストのためにワーカー無しへ戻す)
+	/// </summary>
+	struct ScopedWorkers {
+		explicit ScopedWorkers(uint32_t workerCount) {
+			if (workerCount == 0) {
+				JobSystem::GetInstance().Finalize();
+			} else {
+				JobSystem::GetInstance().Initialize(workerCount);
+			}
+		}
+		~ScopedWorkers() { JobSystem::GetInstance().Finalize(); }
+	};
+
+	/// <summary>
+	/// PrimitiveParticle の BeginUpdate / UpdateRange / MergeUpdate と同じ分担で更新するパーティクル群
+	/// </summary>
+	class TestParticleGroup {
+	public:
+
+		//寿命の範囲
+		static constexpr float kMinLifeTime = 0.2f;
+		static constexpr float kMaxLifeTime = 2.0f;
+		//トレイル(子パーティクル)を生成する間隔
+		static constexpr float kTrailInterval = 0.1f;
+		//重力加速度
+		static constexpr float kGravity = 9.8f;
+
+		TestParticleGroup(uint32_t capacity, uint64_t seed) : random_(seed) {
+			particles_.Initialize(capacity);
+			particles_.SetTrailEnabled(true);
+		}
+
+		/// <summary>
+		/// ランダムなパーティクルの発生
+		/// </summary>
+		void Emit(uint32_t count) {
+			for (uint32_t i = 0; i < count; ++i) {
+				Particle particle;
+				particle.transforms_.translate = { random_.NextFloat(-10.0f, 10.0f), random_.NextFloat(0.0f, 10.0f), random_.NextFloat(-10.0f, 10.0f) };
+				particle.transforms_.scale = { 1.0f, 1.0f, 1.0f };
+				particle.transforms_.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+				particle.velocity_ = { random_.NextFloat(-5.0f, 5.0f), random_.NextFloat(0.0f, 10.0f), random_.NextFloat(-5.0f, 5.0f) };
+				particle.color_ = { random_.NextFloat(), random_.NextFloat(), random_.NextFloat(), 1.0f };
+				particle.lifeTimer_.Initialize(random_.NextFloat(kMinLifeTime, kMaxLifeTime), 0.0f);
+				particle.trailSpawnTimer_ = random_.NextFloat(0.0f, kTrailInterval);
+				particle.emitterID_ = static_cast<int32_t>(random_.NextUInt() % 8);
+				if (!particles_.Add(particle)) {
+					return;
+				}
+			}
+		}
+
+		/// <summary>
+		/// 1フレーム分の更新(ワーカーの有無は JobSystem の状態に従う)
+		/// </summary>
+		void Update() {
+			const uint32_t count = BeginUpdate();
+			JobSystem::GetInstance().ParallelFor(count, kUpdateChunkSize, [this](uint32_t begin, uint32_t end) {
+				UpdateRange(begin, end);
+			});
+			MergeUpdate();
+		}
+
+		const ParticlePool& GetParticles() const { return particles_; }
+
+	private:
+
+		//並列更新の準備
+		uint32_t BeginUpdate() {
+			const uint32_t count = particles_.GetCount();
+			deadFlags_.resize(count);
+			pendingTrails_.resize(JobSystem::GetChunkCount(count, kUpdateChunkSize));
+			for (std::vector<Particle>& pending : pendingTrails_) {
+				pending.clear();
+			}
+			return count;
+		}
+
+		//範囲の移動更新(自分の範囲とチャンクの生成予約だけを書く)
+		void UpdateRange(uint32_t begin, uint32_t end) {
+			std::vector<Particle>& pending = pendingTrails_[begin / kUpdateChunkSize];
+			const float deltaTime = TakeCFrameWork::GetDeltaTime();
+
+			for (uint32_t index = begin; index < end; ++index) {
+				Timer& lifeTimer = particles_.lifeTimer[index];
+				deadFlags_[index] = lifeTimer.IsFinished() ? 1 : 0;
+				if (deadFlags_[index]) {
+					continue;
+				}
+
+				Vector3& velocity = particles_.velocity[index];
+				Vector3& translate = particles_.translate[index];
+				velocity.y -= kGravity * deltaTime;
+				translate += velocity * deltaTime;
+				particles_.drawColor[index] = particles_.color[index];
+				particles_.drawColor[index].w = 1.0f - lifeTimer.GetProgress();
+				lifeTimer.Update();
+
+				float& trailSpawnTimer = particles_.trailSpawnTimer[index];
+				trailSpawnTimer += deltaTime;
+				if (trailSpawnTimer >= kTrailInterval) {
+					trailSpawnTimer -= kTrailInterval;
+					particles_.trailHistory[index].Push(translate);
+
+					Particle trail;
+					trail.transforms_.translate = translate;
+					trail.transforms_.scale = { 0.5f, 0.5f, 0.5f };
+					trail.transforms_.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+					trail.velocity_ = { 0.0f, 0.0f, 0.0f };
+					trail.color_ = particles_.color[index];
+					trail.lifeTimer_.Initialize(kMinLifeTime, 0.0f);
+					trail.trailSpawnTimer_ = -kMaxLifeTime; //トレイルからはトレイルを出さない
+					trail.emitterID_ = particles_.emitterID[index];
+					pending.push_back(trail);
+				}
+			}
+		}
+
+		//同期点: 固定の順序で削除し、チャンク順に生成予約を反映する
+		void MergeUpdate() {
+			for (uint32_t index = 0; index < particles_.GetCount(); ) {
+				if (deadFlags_[index]) {
+					const uint32_t last = particles_.GetCount() - 1;
+					deadFlags_[index] = deadFlags_[last];
+					deadFlags_.pop_back();
+					particles_.Remove(index);
+					continue;
+				}
+				++index;
+			}
+
+			for (const std::vector<Particle>& pending : pendingTrails_) {
+				for (const Particle& trail : pending) {
+					if (!particles_.Add(trail)) {
+						return;
+					}
+				}
+			}
+		}
+
+	private:
+
+		ParticlePool particles_;
+		std::vector<uint8_t> deadFlags_;
+		std::vector<std::vector<Particle>> pendingTrails_; //チャンク毎のトレイルの生成予約
+		FastRandom random_;
+	};
+
+	//配列の中身がビット単位で一致するか
+	template<typename T>
+	bool IsSameBits(const std::vector<T>& a, const std::vector<T>& b) {
+		return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), sizeof(T) * a.size()) == 0);
+	}
+
+	//2つのプールの全要素の比較
+	void CheckSamePool(const ParticlePool& actual, const ParticlePool& expected) {
+		TAKEC_CHECK_EQ(actual.GetCount(), expected.GetCount());
+		TAKEC_CHECK(IsSameBits(actual.translate, expected.translate));
+		TAKEC_CHECK(IsSameBits(actual.rotate, expected.rotate));
+		TAKEC_CHECK(IsSameBits(actual.scale, expected.scale));
+		TAKEC_CHECK(IsSameBits(actual.velocity, expected.velocity));
+		TAKEC_CHECK(IsSameBits(actual.color, expected.color));
+		TAKEC_CHECK(IsSameBits(actual.drawColor, expected.drawColor));
+		TAKEC_CHECK(IsSameBits(actual.trailSpawnTimer, expected.trailSpawnTimer));
+		TAKEC_CHECK(IsSameBits(actual.emitterID, expected.emitterID));
+
+		bool isSameLife = actual.lifeTimer.size() == expected.lifeTimer.size();
+		bool isSameTrail = actual.trailHistory.size() == expected.trailHistory.size();
+		for (size_t i = 0; isSameLife && i < actual.lifeTimer.size(); ++i) {
+			isSameLife = actual.lifeTimer[i].GetTimerCurrentTime() == expected.lifeTimer[i].GetTimerCurrentTime() &&
+				actual.lifeTimer[i].GetDuration() == expected.lifeTimer[i].GetDuration();
+		}
+		for (size_t i = 0; isSameTrail && i < actual.trailHistory.size(); ++i) {
+			const TrailHistory& a = actual.trailHistory[i];
+			const TrailHistory& b = expected.trailHistory[i];
+			isSameTrail = a.count == b.count;
+			for (uint32_t sample = 0; isSameTrail && sample < a.count; ++sample) {
+				isSameTrail = std::memcmp(&a.GetSample(sample), &b.GetSample(sample), sizeof(Vector3)) == 0;
+			}
+		}
+		TAKEC_CHECK(isSameLife);
+		TAKEC_CHECK(isSameTrail);
+	}
+
+	//指定したワーカー数でのシミュレーション
+	std::unique_ptr<TestParticleGroup> Simulate(uint32_t workerCount, uint32_t capacity, uint32_t initialCount, uint32_t emitPerFrame, uint32_t frameCount) {
+		ScopedWorkers workers(workerCount);
+		auto group = std::make_unique<TestParticleGroup>(capacity, 11);
+		group->Emit(initialCount);
+		for (uint32_t frame = 0; frame < frameCount; ++frame) {
+			group->Update();
+			group->Emit(emitPerFrame);
+		}
+		return group;
+	}
+}
+
+//============================================================================
+// 各インデックスがちょうど1回処理され、チャンクの境界が grainSize の倍数になる
+//============================================================================
+TAKEC_TEST(JobSystem_ParallelForVisitsEachIndexOnce) {
+	ScopedWorkers workers(kWorkerCount);
+	TAKEC_CHECK_EQ(JobSystem::GetInstance().GetWorkerCount(), kWorkerCount);
+
+	FastRandom random(21);
+	for (uint32_t trial = 0; trial < 200; ++trial) {
+		const uint32_t count = random.NextUInt() % 20000;
+		const uint32_t grainSize = 1 + random.NextUInt() % 700;
+
+		std::vector<std::atomic<uint32_t>> visits(count);
+		std::atomic<uint32_t> chunkCount = 0;
+		std::atomic<uint32_t> badChunkCount = 0;
+		JobSystem::GetInstance().ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end) {
+			++chunkCount;
+			if (begin % grainSize != 0 || end <= begin || end - begin > grainSize || end > count) {
+				++badChunkCount;
+			}
+			for (uint32_t index = begin; index < end; ++index) {
+				visits[index].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		uint32_t wrongVisitCount = 0;
+		for (const std::atomic<uint32_t>& visit : visits) {
+			wrongVisitCount += (visit.load() != 1) ? 1 : 0;
+		}
+		TAKEC_CHECK_EQ(wrongVisitCount, 0u);
+		TAKEC_CHECK_EQ(badChunkCount.load(), 0u);
+		TAKEC_CHECK_EQ(chunkCount.load(), JobSystem::GetChunkCount(count, grainSize));
+	}
+}
+
+//============================================================================
+// チャンクの処理中に呼ばれた ParallelFor はその場で最後まで処理される(呼び出し元スレッドが処理するチャンクからも)
+//============================================================================
+TAKEC_TEST(JobSystem_NestedParallelForCompletes) {
+	ScopedWorkers workers(kWorkerCount);
+
+	constexpr uint32_t kOuterCount = 64;
+	constexpr uint32_t kInnerCount = 1000;
+	std::vector<std::atomic<uint32_t>> visits(kOuterCount * kInnerCount);
+	JobSystem::GetInstance().ParallelFor(kOuterCount, 1, [&](uint32_t outerBegin, uint32_t outerEnd) {
+		for (uint32_t outer = outerBegin; outer < outerEnd; ++outer) {
+			JobSystem::GetInstance().ParallelFor(kInnerCount, 64, [&, outer](uint32_t begin, uint32_t end) {
+				for (uint32_t inner = begin; inner < end; ++inner) {
+					visits[outer * kInnerCount + inner].fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		}
+	});
+
+	uint32_t wrongVisitCount = 0;
+	for (const std::atomic<uint32_t>& visit : visits) {
+		wrongVisitCount += (visit.load() != 1) ? 1 : 0;
+	}
+	TAKEC_CHECK_EQ(wrongVisitCount, 0u);
+}
+
+//============================================================================
+// 多数のパーティクルの長時間の更新が、ワーカーの有無に依らずビット単位で一致する
+//============================================================================
+TAKEC_TEST(ParticleParallelUpdate_MatchesSingleThreaded) {
+	constexpr uint32_t kCapacity = 65536;
+	constexpr uint32_t kInitialCount = 32768;
+	constexpr uint32_t kEmitPerFrame = 400;
+	constexpr uint32_t kFrameCount = 240;
+
+	std::unique_ptr<TestParticleGroup> expected = Simulate(0, kCapacity, kInitialCount, kEmitPerFrame, kFrameCount);
+	std::unique_ptr<TestParticleGroup> actual = Simulate(kWorkerCount, kCapacity, kInitialCount, kEmitPerFrame, kFrameCount);
+
+	//途中で削除・トレイルの生成が起きていること(一致が自明な状態になっていないこと)
+	TAKEC_CHECK(expected->GetParticles().GetCount() > kUpdateChunkSize);
+	CheckSamePool(actual->GetParticles(), expected->GetParticles());
+
+	//ワーカー有りで繰り返しても同じ結果になる
+	std::unique_ptr<TestParticleGroup> repeated = Simulate(kWorkerCount, kCapacity, kInitialCount, kEmitPerFrame, kFrameCount);
+	CheckSamePool(repeated->GetParticles(), actual->GetParticles());
+}
+
+//============================================================================
+// ワーカーの起動・停止を繰り返しても ParallelFor が完了する
+//============================================================================
+TAKEC_TEST(JobSystem_RestartWhileDispatching) {
+	for (uint32_t round = 0; round < 20; ++round) {
+		ScopedWorkers workers(1 + round % kWorkerCount);
+		for (uint32_t dispatch = 0; dispatch < 50; ++dispatch) {
+			std::atomic<uint32_t> total = 0;
+			JobSystem::GetInstance().ParallelFor(4096, 128, [&total](uint32_t begin, uint32_t end) {
+				total.fetch_add(end - begin, std::memory_order_relaxed);
+			});
+			TAKEC_CHECK_EQ(total.load(), 4096u);
+		}
+	}
+}
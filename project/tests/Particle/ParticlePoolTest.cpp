@@ -0,0 +1,119 @@
+#include "TestFramework.h"
+#include "engine/3d/Particle/ParticlePool.h"
+
+#include <cstdint>
+
+using namespace TakeC;
+
+//============================================================================
+// ParticlePool のテスト
+//============================================================================
+// トレイルの軌跡(TrailHistory)は1要素が約200バイトあり、上限32k個のプールでは1グループあたり約6MBになる。
+// そのため軌跡は SetTrailEnabled(true) のプールだけが持ち、追加・削除で他の配列と同じ要素数に保つ。
+// トレイルを使わないプールが軌跡の領域を持たないことと、有効にした後の入れ替え削除で軌跡が要素に付いて動くことを確認する。
+
+namespace {
+
+	//プールの上限
+	constexpr uint32_t kCapacity = 64;
+
+	//位置だけを設定したパーティクル
+	Particle MakeParticle(float x) {
+		Particle particle;
+		particle.transforms_.translate = { x, 0.0f, 0.0f };
+		particle.transforms_.scale = { 1.0f, 1.0f, 1.0f };
+		particle.transforms_.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+		return particle;
+	}
+}
+
+//============================================================================
+// トレイルを使わないプールは軌跡の領域を持たない
+//============================================================================
+TAKEC_TEST(ParticlePool_NoTrailStorageWhenDisabled) {
+	ParticlePool pool;
+	pool.Initialize(kCapacity);
+	TAKEC_CHECK(!pool.IsTrailEnabled());
+
+	for (uint32_t i = 0; i < kCapacity; ++i) {
+		pool.Add(MakeParticle(static_cast<float>(i)));
+	}
+	pool.Remove(0);
+	TAKEC_CHECK_EQ(pool.Extend(8), 1u);
+	TAKEC_CHECK_EQ(pool.GetCount(), kCapacity);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 0u);
+	TAKEC_CHECK_EQ(pool.trailHistory.capacity(), 0u);
+
+	//有効にしてから無効に戻すと領域を解放する
+	pool.SetTrailEnabled(true);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), static_cast<size_t>(kCapacity));
+	pool.SetTrailEnabled(false);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 0u);
+	TAKEC_CHECK_EQ(pool.trailHistory.capacity(), 0u);
+}
+
+//============================================================================
+// 軌跡は入れ替え削除で要素に付いて動く
+//============================================================================
+TAKEC_TEST(ParticlePool_TrailFollowsSwapRemove) {
+	ParticlePool pool;
+	pool.Initialize(kCapacity);
+	pool.Add(MakeParticle(0.0f));
+
+	//生存中の要素には空の軌跡が割り当てられる
+	pool.SetTrailEnabled(true);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 1u);
+	TAKEC_CHECK_EQ(static_cast<uint32_t>(pool.trailHistory[0].count), 0u);
+
+	pool.Add(MakeParticle(1.0f));
+	TAKEC_CHECK_EQ(pool.Extend(2), 2u);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 4u);
+	for (uint32_t index = 0; index < pool.GetCount(); ++index) {
+		//要素毎に index + 1 個のサンプルを持たせる
+		for (uint32_t sample = 0; sample <= index; ++sample) {
+			pool.trailHistory[index].Push({ static_cast<float>(index), static_cast<float>(sample), 0.0f });
+		}
+	}
+
+	//末尾(サンプル4個)が先頭へ移る
+	pool.Remove(0);
+	TAKEC_CHECK_EQ(pool.GetCount(), 3u);
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 3u);
+	TAKEC_CHECK_EQ(static_cast<uint32_t>(pool.trailHistory[0].count), 4u);
+	TAKEC_CHECK_EQ(pool.trailHistory[0].GetSample(3).x, 3.0f);
+	TAKEC_CHECK_EQ(static_cast<uint32_t>(pool.trailHistory[1].count), 2u);
+
+	pool.Clear();
+	TAKEC_CHECK_EQ(pool.trailHistory.size(), 0u);
+	TAKEC_CHECK(pool.IsTrailEnabled());
+}
+
+//============================================================================
+// 初期化時に上限分を確保し、満杯まで追加しても再確保しない
+//============================================================================
+TAKEC_TEST(ParticlePool_ReservesCapacityOnInitialize) {
+	ParticlePool pool;
+	pool.Initialize(kCapacity);
+	TAKEC_CHECK(pool.translate.capacity() >= kCapacity);
+	TAKEC_CHECK(pool.lifeTimer.capacity() >= kCapacity);
+	TAKEC_CHECK(pool.emitterID.capacity() >= kCapacity);
+
+	const Vector3* translateData = pool.translate.data();
+	const Timer* lifeTimerData = pool.lifeTimer.data();
+	for (uint32_t i = 0; i < kCapacity / 2; ++i) {
+		pool.Add(MakeParticle(static_cast<float>(i)));
+	}
+	TAKEC_CHECK_EQ(pool.Extend(kCapacity), kCapacity / 2);
+	TAKEC_CHECK(pool.IsFull());
+	TAKEC_CHECK(pool.translate.data() == translateData);
+	TAKEC_CHECK(pool.lifeTimer.data() == lifeTimerData);
+
+	//軌跡はトレイルを有効にした時に上限分を確保する
+	TAKEC_CHECK_EQ(pool.trailHistory.capacity(), 0u);
+	pool.Clear();
+	pool.SetTrailEnabled(true);
+	TAKEC_CHECK(pool.trailHistory.capacity() >= kCapacity);
+	const TrailHistory* trailData = pool.trailHistory.data();
+	TAKEC_CHECK_EQ(pool.Extend(kCapacity), kCapacity);
+	TAKEC_CHECK(pool.trailHistory.data() == trailData);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//============================================================================
+// TestFramework
+//============================================================================
+/// <summary>
+/// TakeCEngineTestsで使う最小限のテスト登録・判定の仕組みです。
+/// TAKEC_TEST で定義した関数は静的初期化時に登録され、main から順に実行されます。
+/// 判定マクロは失敗しても処理を続け、失敗の内容を出力してテストを失敗扱いにします。
+/// </summary>
+namespace TakeC::Test {
+
+	/// <summary>
+	/// 登録されたテスト1件分
+	/// </summary>
+	struct TestCase {
+		const char* name = nullptr;
+		void (*function)() = nullptr;
+	};
+
+	/// <summary>
+	/// 登録済みテストの取得(静的初期化の順序に依存しないよう関数内staticで保持する)
+	/// </summary>
+	std::vector<TestCase>& GetTestCases();
+
+	/// <summary>
+	/// 失敗の記録。実行中のテストを失敗扱いにして内容を出力する
+	/// </summary>
+	/// <param name="file">ファイル名</param>
+	/// <param name="line">行番号</param>
+	/// <param name="message">失敗の内容</param>
+	void ReportFailure(const char* file, int line, const std::string& message);
+
+	/// <summary>
+	/// テストの静的登録用
+	/// </summary>
+	struct TestRegistrar {
+		TestRegistrar(const char* name, void (*function)()) {
+			GetTestCases().push_back({ name, function });
+		}
+	};
+
+	/// <summary>
+	/// 失敗時のメッセージ作成用
+	/// </summary>
+	template<typename A, typename B>
+	std::string FormatComparison(const char* expression, const A& actual, const B& expected) {
+		std::ostringstream stream;
+		stream << expression << " (actual: " << actual << ", expected: " << expected << ")";
+		return stream.str();
+	}
+}
+
+//テストの定義
+#define TAKEC_TEST(name) \
+	static void name(); \
+	static const TakeC::Test::TestRegistrar name##Registrar_(#name, &name); \
+	static void name()
+
+//条件の判定
+#define TAKEC_CHECK(expression) \
+	do { \
+		if (!(expression)) { \
+			TakeC::Test::ReportFailure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
+
+//値の一致の判定
+#define TAKEC_CHECK_EQ(actual, expected) \
+	do { \
+		const auto& takecActual_ = (actual); \
+		const auto& takecExpected_ = (expected); \
+		if (!(takecActual_ == takecExpected_)) { \
+			TakeC::Test::ReportFailure(__FILE__, __LINE__, \
+				TakeC::Test::FormatComparison(#actual " == " #expected, takecActual_, takecExpected_)); \
+		} \
+	} while (false)
+
+//許容誤差内での一致の判定
+#define TAKEC_CHECK_NEAR(actual, expected, tolerance) \
+	do { \
+		const double takecActual_ = static_cast<double>(actual); \
+		const double takecExpected_ = static_cast<double>(expected); \
+		if (!(std::abs(takecActual_ - takecExpected_) <= static_cast<double>(tolerance))) { \
+			TakeC::Test::ReportFailure(__FILE__, __LINE__, \
+				TakeC::Test::FormatComparison(#actual " ~= " #expected, takecActual_, takecExpected_)); \
+		} \
+	} while (false)
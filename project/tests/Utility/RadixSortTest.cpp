@@ -0,0 +1,147 @@
+#include "TestFramework.h"
+#include "engine/Utility/JobSystem.h"
+#include "engine/Utility/RadixSort.h"
+#include "engine/math/FastRandom.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+using namespace TakeC;
+
+//============================================================================
+// RadixSort のテスト
+//============================================================================
+// PrimitiveParticle::SortByDepth は奥行きを16bitに量子化したキーで、描画順のインデックスを RadixSort で並べ替える。
+// RadixSort は8bitずつ2回の分配を行い、各回はチャンク毎のヒストグラムから各チャンクの書き込み開始位置を求めて
+// 並列に分配する。また全要素の8bitが同じ値の回は分配を省略する。
+// 0～1M個のキーを、ワーカー無し・4つのワーカーで並べ替えた結果が std::stable_sort と一致することを確認する。
+// キーの値は、分配を省略する回を含むもの(下位・上位の8bitが一定、全て同じ値)と、チャンク毎に値の分布が偏るものを使う。
+
+namespace {
+
+	//テストで使うワーカースレッド数
+	constexpr uint32_t kWorkerCount = 4;
+	constexpr uint32_t kGrainSize = RadixSort::kGrainSize_;
+
+	/// <summary>
+	/// テスト中だけワーカースレッドを起動する(終了時は他のテストのためにワーカー無しへ戻す)
+	/// </summary>
+	struct ScopedWorkers {
+		explicit ScopedWorkers(uint32_t workerCount) {
+			if (workerCount == 0) {
+				JobSystem::GetInstance().Finalize();
+			} else {
+				JobSystem::GetInstance().Initialize(workerCount);
+			}
+		}
+		~ScopedWorkers() { JobSystem::GetInstance().Finalize(); }
+	};
+
+	/// <summary>
+	/// キーの値の分布
+	/// </summary>
+	enum class KeyPattern {
+		Random,        //16bit全体がランダム
+		LowByteFixed,  //下位8bitが一定(1回目の分配を省略する)
+		HighByteFixed, //上位8bitが一定(2回目の分配を省略する)
+		AllEqual,      //全て同じ値(両方の分配を省略する)
+		FewValues,     //少数の値の重複(安定性の確認)
+		ChunkSkewed,   //チャンク毎に値の範囲が異なる(チャンク毎の書き込み開始位置の確認)
+	};
+
+	constexpr KeyPattern kKeyPatterns[] = {
+		KeyPattern::Random, KeyPattern::LowByteFixed, KeyPattern::HighByteFixed,
+		KeyPattern::AllEqual, KeyPattern::FewValues, KeyPattern::ChunkSkewed,
+	};
+
+	std::vector<uint16_t> MakeKeys(KeyPattern pattern, uint32_t count, FastRandom& random) {
+		std::vector<uint16_t> keys(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			const uint32_t value = random.NextUInt();
+			switch (pattern) {
+			case KeyPattern::Random:        keys[i] = static_cast<uint16_t>(value); break;
+			case KeyPattern::LowByteFixed:  keys[i] = static_cast<uint16_t>((value & 0xFF00u) | 0x5Au); break;
+			case KeyPattern::HighByteFixed: keys[i] = static_cast<uint16_t>(0x3300u | (value & 0xFFu)); break;
+			case KeyPattern::AllEqual:      keys[i] = 0x1234u; break;
+			case KeyPattern::FewValues:     keys[i] = static_cast<uint16_t>((value % 5) * 0x0101u); break;
+			case KeyPattern::ChunkSkewed:
+				//後ろのチャンクほど小さい値に寄せ、チャンク内では一部の値だけを使う
+				keys[i] = static_cast<uint16_t>(0xFFFFu - ((i / kGrainSize) % 64) * 0x0301u - (value % 3) * 0x0100u - (value % 4));
+				break;
+			}
+		}
+		return keys;
+	}
+
+	//並べ替える前のインデックス(0～count-1をランダムに並べたもの。安定性の確認のため元の順序を持たせる)
+	std::vector<uint32_t> MakeShuffledIndices(uint32_t count, FastRandom& random) {
+		std::vector<uint32_t> indices(count);
+		std::iota(indices.begin(), indices.end(), 0u);
+		for (uint32_t i = count; i > 1; --i) {
+			std::swap(indices[i - 1], indices[random.NextUInt() % i]);
+		}
+		return indices;
+	}
+
+	/// <summary>
+	/// ワーカー数を指定して、全てのキーの分布と要素数で std::stable_sort と比べる
+	/// </summary>
+	/// <returns>一致しなかった組み合わせの数</returns>
+	uint32_t CountMismatches(uint32_t workerCount) {
+		constexpr uint32_t kCounts[] = {
+			0, 1, 2, 255, kGrainSize - 1, kGrainSize, kGrainSize + 1, 3 * kGrainSize + 17, 100000, 1u << 20,
+		};
+
+		ScopedWorkers workers(workerCount);
+		FastRandom random(17 + workerCount);
+		//作業用の配列を使い回す場合も確認するため、同じインスタンスで並べ替える
+		RadixSort sorter;
+		uint32_t mismatchCount = 0;
+		for (KeyPattern pattern : kKeyPatterns) {
+			for (uint32_t count : kCounts) {
+				const std::vector<uint16_t> keys = MakeKeys(pattern, count, random);
+				std::vector<uint32_t> indices = MakeShuffledIndices(count, random);
+				std::vector<uint32_t> expected = indices;
+				std::stable_sort(expected.begin(), expected.end(), [&keys](uint32_t a, uint32_t b) {
+					return keys[a] < keys[b];
+				});
+
+				sorter.Sort(keys.data(), indices);
+				mismatchCount += (indices == expected) ? 0 : 1;
+			}
+		}
+		return mismatchCount;
+	}
+}
+
+//============================================================================
+// ワーカー無しの並べ替えは std::stable_sort と一致する
+//============================================================================
+TAKEC_TEST(RadixSort_MatchesStableSortSingleThreaded) {
+	TAKEC_CHECK_EQ(CountMismatches(0), 0u);
+}
+
+//============================================================================
+// 4つのワーカーでの並べ替えは std::stable_sort と一致する
+//============================================================================
+TAKEC_TEST(RadixSort_MatchesStableSortWithWorkers) {
+	TAKEC_CHECK_EQ(CountMismatches(kWorkerCount), 0u);
+}
+
+//============================================================================
+// 全て同じキーの場合は並びを変えない(分配を省略する)
+//============================================================================
+TAKEC_TEST(RadixSort_AllEqualKeysKeepOrder) {
+	ScopedWorkers workers(kWorkerCount);
+	FastRandom random(19);
+	const std::vector<uint16_t> keys(3 * kGrainSize, 0xABCDu);
+	const std::vector<uint32_t> original = MakeShuffledIndices(3 * kGrainSize, random);
+	std::vector<uint32_t> indices = original;
+
+	RadixSort sorter;
+	sorter.Sort(keys.data(), indices);
+	TAKEC_CHECK(indices == original);
+}
@@ -0,0 +1,54 @@
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+
+//============================================================================
+// TakeCEngineTests
+//============================================================================
+// 使い方: TakeCEngineTests.exe [テスト名の一部]
+// 引数を指定した場合は名前にその文字列を含むテストだけを実行する。
+// 1件でも失敗すると終了コード1を返す。
+
+namespace {
+
+	//実行中のテストの失敗数
+	int currentFailureCount = 0;
+}
+
+std::vector<TakeC::Test::TestCase>& TakeC::Test::GetTestCases() {
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+void TakeC::Test::ReportFailure(const char* file, int line, const std::string& message) {
+	++currentFailureCount;
+	std::printf("  %s(%d): failed: %s\n", file, line, message.c_str());
+}
+
+int main(int argc, char** argv) {
+
+	const char* filter = (argc > 1) ? argv[1] : nullptr;
+
+	int runCount = 0;
+	int failedCount = 0;
+	for (const TakeC::Test::TestCase& testCase : TakeC::Test::GetTestCases()) {
+		if (filter && !std::strstr(testCase.name, filter)) {
+			continue;
+		}
+
+		std::printf("[ RUN    ] %s\n", testCase.name);
+		currentFailureCount = 0;
+		testCase.function();
+		++runCount;
+
+		if (currentFailureCount == 0) {
+			std::printf("[     OK ] %s\n", testCase.name);
+		} else {
+			std::printf("[ FAILED ] %s\n", testCase.name);
+			++failedCount;
+		}
+	}
+
+	std::printf("%d test(s) run, %d failed\n", runCount, failedCount);
+	return (failedCount == 0) ? 0 : 1;
+}